@@ -131,6 +131,30 @@ set(JSON_BuildTests OFF)
 FetchContent_MakeAvailable(json)
 silence_warnings(TARGETS nlohmann_json)
 
+# ---------------------------------------------------------
+# zstd
+# ---------------------------------------------------------
+message(STATUS "Fetching dependency `zstd` ...")
+FetchContent_Declare(
+    zstd
+    GIT_REPOSITORY "https://github.com/facebook/zstd.git"
+    GIT_TAG        "v1.5.7"
+    SOURCE_SUBDIR  "build/cmake"
+    SYSTEM
+)
+# static lib only, no cli/tests
+set(ZSTD_BUILD_PROGRAMS OFF CACHE BOOL "" FORCE)
+set(ZSTD_BUILD_TESTS OFF CACHE BOOL "" FORCE)
+set(ZSTD_BUILD_SHARED OFF CACHE BOOL "" FORCE)
+set(ZSTD_BUILD_STATIC ON CACHE BOOL "" FORCE)
+if(MSVC)
+    set(ZSTD_USE_STATIC_RUNTIME ON CACHE BOOL "" FORCE)
+endif()
+FetchContent_MakeAvailable(zstd)
+silence_warnings(TARGETS libzstd_static)
+# zstd.h and zdict.h live next to the sources
+target_include_directories(libzstd_static SYSTEM INTERFACE "${zstd_SOURCE_DIR}/lib")
+
 # ---------------------------------------------------------
 # GLEW
 # ---------------------------------------------------------
@@ -321,7 +345,7 @@ FetchContent_Declare(
     SYSTEM
     OVERRIDE_FIND_PACKAGE
 )
-# static lib, no tools/tests, OBJ importer only for now, no exporters
+# static lib, no tools/tests, OBJ and glTF importers only for now, no exporters
 set(BUILD_SHARED_LIBS OFF CACHE BOOL "" FORCE)
 set(ASSIMP_BUILD_TESTS OFF CACHE BOOL "" FORCE)
 set(ASSIMP_BUILD_ASSIMP_TOOLS OFF CACHE BOOL "" FORCE)
@@ -331,6 +355,7 @@ set(ASSIMP_NO_EXPORT ON CACHE BOOL "" FORCE)
 set(ASSIMP_BUILD_ALL_EXPORTERS_BY_DEFAULT OFF CACHE BOOL "" FORCE)
 set(ASSIMP_BUILD_ALL_IMPORTERS_BY_DEFAULT OFF CACHE BOOL "" FORCE)
 set(ASSIMP_BUILD_OBJ_IMPORTER ON CACHE BOOL "" FORCE)
+set(ASSIMP_BUILD_GLTF_IMPORTER ON CACHE BOOL "" FORCE)
 set(ASSIMP_BUILD_ZLIB ON CACHE BOOL "" FORCE)
 set(ASSIMP_WARNINGS_AS_ERRORS OFF CACHE BOOL "" FORCE)
 if(MSVC)
@@ -1,12 +1,16 @@
 #pragma once 
 
 #include <utility>
+#include <atomic>
+#include <memory>
+#include <optional>
 
 #include <spdlog/spdlog.h>
 #include <imgui.h>
 
 #include "math/math.hpp"
 #include "render/render.hpp"
+#include "render/raycast_scene.hpp"
 #include "input/input.hpp"
 #include "ecs/ecs.hpp"
 #include "pipeline/pipeline.hpp"
@@ -17,6 +21,12 @@
 
 namespace astre::editor::controller
 {
+    enum class PickingMode
+    {
+        RayCast,  // CPU ray against proxy bounds and mesh triangles
+        IdBuffer  // entity ids rendered into the picking FBO and read back
+    };
+
     class ViewportEntityPicker
     {
     public:
@@ -24,10 +34,12 @@ namespace astre::editor::controller
             render::IRenderer & renderer,
             const input::InputService & input,
             const pipeline::PickingResources & picking_resources,
+            const render::RaycastScene & raycast_scene,
             const model::WorldSnapshot  & world_snapshot)
         :   _renderer(renderer),
             _input(input),
             _picking_resources(picking_resources),
+            _raycast_scene(raycast_scene),
             _world_snapshot(world_snapshot)
         {}
 
@@ -42,22 +54,158 @@ namespace astre::editor::controller
             _vp_size = size;
         }
 
-        asio::awaitable<void> updateSelectedEntity(SelectionController & selection_controller)
+        // chosen in the viewport panel, reads still in flight for the previous mode are dropped
+        void setMode(PickingMode mode) noexcept
+        {
+            if(_mode == mode) return;
+            _mode = mode;
+            _pending_click.reset();
+            _pending_hover.reset();
+            _hovered_entity.reset();
+        }
+        // picking ids need to be rendered only in IdBuffer mode
+        [[nodiscard]] PickingMode getMode() const noexcept { return _mode; }
+
+        /**
+         * @brief Update hovered entity and select the clicked one
+         *
+         * In RayCast mode the answer is immediate.
+         * In IdBuffer mode reads complete a frame or two after they are issued, so the selection
+         * follows the click with that delay instead of stalling the renderer.
+         *
+         * @param frame frame whose camera the viewport shows
+         */
+        asio::awaitable<void> updateSelectedEntity(SelectionController & selection_controller, const render::Frame & frame)
         {
-            if(_vp_hovered && _input.isKeyJustPressed(proto::input::InputCode::MOUSE_LEFT))
+            if(_mode == PickingMode::RayCast)
+            {
+                updateFromRayCast(selection_controller, frame);
+                co_return;
+            }
+
+            const auto executor = co_await asio::this_coro::executor;
+
+            if(auto region = takeFinished(_pending_click))
+            {
+                applySelection(selection_controller, region->at(_click_pixel.first, _click_pixel.second));
+            }
+
+            if(auto region = takeFinished(_pending_hover))
+            {
+                _hovered_entity = region->nearestNonZero(_hover_pixel.first, _hover_pixel.second);
+            }
+
+            if(_vp_hovered == false)
+            {
+                _hovered_entity.reset();
+                co_return;
+            }
+
+            const auto pixel = mousePixel();
+
+            if(_input.isKeyJustPressed(proto::input::InputCode::MOUSE_LEFT) && _pending_click == nullptr)
+            {
+                _click_pixel = pixel;
+                _pending_click = startRead(executor, render::PixelRect{.x = pixel.first, .y = pixel.second});
+            }
+
+            if(_pending_hover == nullptr)
+            {
+                _hover_pixel = pixel;
+                _pending_hover = startRead(executor, render::PixelRect{
+                    .x = pixel.first - HOVER_RADIUS,
+                    .y = pixel.second - HOVER_RADIUS,
+                    .width = 2 * HOVER_RADIUS + 1,
+                    .height = 2 * HOVER_RADIUS + 1
+                });
+            }
+
+            co_return;
+        } 
+
+        // entity under or next to the cursor, std::nullopt when there is none or viewport is not hovered
+        [[nodiscard]] std::optional<ecs::Entity> getHoveredEntity() const noexcept { return _hovered_entity; }
+
+        private:
+            // written by the render strand, taken by the logic loop once `done` is set
+            struct PendingRead
+            {
+                std::atomic<bool> done{false};
+                std::optional<render::PixelRegionUint64> region;
+            };
+
+            // radius in pixels of the region read around the cursor
+            static constexpr int HOVER_RADIUS = 2;
+            static constexpr float MAX_PICK_DISTANCE = 10000.0f;
+
+            void updateFromRayCast(SelectionController & selection_controller, const render::Frame & frame)
+            {
+                if(_vp_hovered == false)
+                {
+                    _hovered_entity.reset();
+                    return;
+                }
+
+                const render::Ray ray = render::screenPointToRay(mouseNDC(), frame.view_matrix, frame.proj_matrix);
+                const auto hit = _raycast_scene.raycast(ray, MAX_PICK_DISTANCE);
+
+                _hovered_entity = hit ? std::optional<ecs::Entity>(hit->entity) : std::nullopt;
+
+                if(hit && _input.isKeyJustPressed(proto::input::InputCode::MOUSE_LEFT))
+                {
+                    applySelection(selection_controller, hit->entity);
+                }
+            }
+
+            math::Vec2 mouseNDC() const
+            {
+                auto relative_mouse_pos = _input.getMousePosition() - _vp_pos;
+
+                relative_mouse_pos.x = std::clamp(relative_mouse_pos.x / _vp_size.x, 0.0f, 1.0f);
+                relative_mouse_pos.y = std::clamp(relative_mouse_pos.y / _vp_size.y, 0.0f, 1.0f);
+
+                return math::Vec2(relative_mouse_pos.x * 2.0f - 1.0f, 1.0f - relative_mouse_pos.y * 2.0f);
+            }
+
+            std::pair<int, int> mousePixel() const
             {
                 auto relative_mouse_pos = _input.getMousePosition() - _vp_pos;
 
                 relative_mouse_pos.x = std::clamp(relative_mouse_pos.x / _vp_size.x, 0.0f, 0.99f); // [0,1)
                 relative_mouse_pos.y = std::clamp(relative_mouse_pos.y / _vp_size.y, 0.0f, 0.99f); // [0,1)
 
-                int x = relative_mouse_pos.x * _picking_resources.size.first;
-                int y = (1.0f - relative_mouse_pos.y) * _picking_resources.size.second;
+                const int x = relative_mouse_pos.x * _picking_resources.size.first;
+                const int y = (1.0f - relative_mouse_pos.y) * _picking_resources.size.second;
+                return {x, y};
+            }
+
+            template<class Executor>
+            std::shared_ptr<PendingRead> startRead(const Executor & executor, render::PixelRect rect)
+            {
+                auto pending = std::make_shared<PendingRead>();
+                asio::co_spawn(executor, _renderer.readRegionUint64(_picking_resources.fbo, 0, rect),
+                    [pending](std::exception_ptr, std::optional<render::PixelRegionUint64> region)
+                    {
+                        pending->region = std::move(region);
+                        pending->done.store(true, std::memory_order_release);
+                    });
+                return pending;
+            }
+
+            static std::optional<render::PixelRegionUint64> takeFinished(std::shared_ptr<PendingRead> & pending)
+            {
+                if(pending == nullptr || pending->done.load(std::memory_order_acquire) == false)return std::nullopt;
+
+                auto region = std::move(pending->region);
+                pending.reset();
+                return region;
+            }
+
+            void applySelection(SelectionController & selection_controller, std::optional<std::uint64_t> selected_id) const
+            {
+                if(selected_id == std::nullopt) return;
+                const ecs::Entity selected_entity = *selected_id;
 
-                auto selected_id_res = co_await _renderer.readPixelUint64(_picking_resources.fbo, 0, x, y);
-                if(selected_id_res == std::nullopt) co_return;
-                const ecs::Entity selected_entity = *selected_id_res;
-                
                 // update selected entity in selection controller
                 // we need to map entity id obtained from texture to chunk id and EntityDefinition
                 // to do that we need mapping 
@@ -66,24 +214,29 @@ namespace astre::editor::controller
                     if(entities.contains(selected_entity))
                     {
                         selection_controller.setSelection(chunk_id, entities.at(selected_entity));
-                        co_return;
+                        return;
                     }
                 }
             }
 
-            co_return;
-        } 
-
-        private:
             render::IRenderer & _renderer;
             const input::InputService & _input;
 
             const pipeline::PickingResources & _picking_resources;
+            const render::RaycastScene & _raycast_scene;
             const model::WorldSnapshot & _world_snapshot;
 
             math::Vec2 _vp_pos{0,0};
             math::Vec2 _vp_size{0,0};
             bool _vp_hovered{false};
             bool _captured{false};
+
+            PickingMode _mode{PickingMode::RayCast};
+
+            std::shared_ptr<PendingRead> _pending_click;
+            std::pair<int, int> _click_pixel{0, 0};
+            std::shared_ptr<PendingRead> _pending_hover;
+            std::pair<int, int> _hover_pixel{0, 0};
+            std::optional<ecs::Entity> _hovered_entity;
     };
 }
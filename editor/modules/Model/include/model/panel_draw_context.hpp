@@ -2,6 +2,7 @@
 
 #include <utility>
 #include <optional>
+#include <string>
 
 #include "math/math.hpp"
 #include "render/render.hpp"
@@ -27,6 +28,9 @@ namespace astre::editor::model
 
         math::Vec3 camera_position;
 
+        // name of the entity under the cursor in the viewport
+        std::optional<std::string> hovered_entity_name;
+
         controller::SelectionController selection_controller;
     };
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <string_view>
 
 #include "panel/panel_interface.hpp"
+#include "controller/viewport_entity_picker.hpp"
 
 namespace astre::editor::panel 
 {
@@ -24,10 +25,13 @@ namespace astre::editor::panel
 
         bool showChunkBorders() const noexcept { return _show_chunk_borders; }
 
+        controller::PickingMode pickingMode() const noexcept { return _picking_mode; }
+
     private:
         bool _visible{true};
         bool _hovered{false};
         bool _show_chunk_borders{false};
+        controller::PickingMode _picking_mode{controller::PickingMode::RayCast};
 
         math::Vec2 _img_pos;
         math::Vec2 _img_size;
@@ -75,8 +75,13 @@ namespace astre::editor::panel
         ImGui::Text("Logic FPS: %.1f", logic_fps);
         ImGui::Text("Logic Frame Time: %.2f ms", logic_frame_time);
         ImGui::Text("Draw Calls: %d", stats.draw_calls);
+        ImGui::Text("Instances: %d", stats.instances);
         ImGui::Text("Vertices: %d", stats.vertices);
         ImGui::Text("Triangles: %d", stats.triangles);
+        ImGui::Text("Culled: %d", stats.culled);
+        ImGui::Text("Shader Binds: %d", stats.shader_binds);
+        ImGui::Text("VAO Binds: %d", stats.vao_binds);
+        ImGui::Text("FBO Binds: %d", stats.fbo_binds);
 
         ImGui::End();
         ImGui::PopStyleVar();
@@ -101,6 +106,14 @@ namespace astre::editor::panel
             ImGui::TextUnformatted("Viewport");
             ImGui::SameLine();
             ImGui::Checkbox("Show chunk borders", &_show_chunk_borders);
+            ImGui::SameLine();
+            ImGui::TextUnformatted("Picking:");
+            ImGui::SameLine();
+            if (ImGui::RadioButton("Ray cast", _picking_mode == controller::PickingMode::RayCast))
+                _picking_mode = controller::PickingMode::RayCast;
+            ImGui::SameLine();
+            if (ImGui::RadioButton("ID buffer", _picking_mode == controller::PickingMode::IdBuffer))
+                _picking_mode = controller::PickingMode::IdBuffer;
 
             const ImVec2 avail = ImGui::GetContentRegionAvail();
 
@@ -124,6 +137,9 @@ namespace astre::editor::panel
                 _img_pos.y = img_min.y;
 
                 _hovered = ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenBlockedByActiveItem);
+
+                if (_hovered && ctx.hovered_entity_name)
+                    ImGui::SetTooltip("%s", ctx.hovered_entity_name->c_str());
             }
 
             // Compute anchor at top-left
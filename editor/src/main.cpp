@@ -37,7 +37,7 @@ struct EditorState
 
 struct EditorRenderState
 {
-    const pipeline::RendererState & render_state;
+    pipeline::RendererState & render_state;
     const pipeline::PickingResources & picking_resources;
 };
 
@@ -52,6 +52,9 @@ asio::awaitable<void> runMainLoop(async::LifecycleToken & token, pipeline::AppSt
         co_return;
     }
 
+    // linked programs from previous runs skip shader compilation
+    co_await app_state.renderer.enableProgramBinaryCache(paths.cache / "shaders");
+
     // stream (import -> cache) then load (cache -> runtime) per asset type;
     // each streamer names its assets by file stem.
     const auto shader_dir = paths.resources / "shaders" / "glsl";
@@ -78,6 +81,8 @@ asio::awaitable<void> runMainLoop(async::LifecycleToken & token, pipeline::AppSt
 
     // basic prefabs already exists in memory, we only need to load them into renderer
     co_await app_state.loaders.mesh_loader.loadPrefabs();
+    // shared with the game, meshes either of them imported skip assimp
+    app_state.streamers.mesh_streamer.enableCookedCache(paths.cache / "meshes");
 
     model::WorldSnapshot world_snapshot;
 
@@ -125,6 +130,7 @@ asio::awaitable<void> runMainLoop(async::LifecycleToken & token, pipeline::AppSt
                     app_state.renderer,
                     app_state.input,
                     *picking_resources_res,
+                    app_state.systems.visual.getRaycastScene(),
                     world_snapshot)
         },
 
@@ -174,6 +180,7 @@ asio::awaitable<void> runMainLoop(async::LifecycleToken & token, pipeline::AppSt
                 editor_state.viewport_panel.getImgPos(),
                 editor_state.viewport_panel.getImgSize());
             editor_state.viewport_entity_picker.setHovered(editor_state.viewport_panel.isHovered());
+            editor_state.viewport_entity_picker.setMode(editor_state.viewport_panel.pickingMode());
 
             editor_state.flycam.setViewportRect(    
                 editor_state.viewport_panel.getImgPos(),
@@ -272,7 +279,7 @@ asio::awaitable<void> runMainLoop(async::LifecycleToken & token, pipeline::AppSt
             editor_state.translate_overlay_controller.update(editor_state.ctx, editor_state.app_state.input, editor_frame.render_frame);
 
             if(!editor_state.translate_overlay_controller.isDragging()){
-                co_await editor_state.viewport_entity_picker.updateSelectedEntity(editor_state.ctx.selection_controller);
+                co_await editor_state.viewport_entity_picker.updateSelectedEntity(editor_state.ctx.selection_controller, editor_frame.render_frame);
             }
             else
             {
@@ -289,6 +296,19 @@ asio::awaitable<void> runMainLoop(async::LifecycleToken & token, pipeline::AppSt
                 }
             }
 
+            editor_state.ctx.hovered_entity_name.reset();
+            if(const auto hovered_entity = editor_state.viewport_entity_picker.getHoveredEntity())
+            {
+                for(const auto & [chunk_id, entities] : world_snapshot.mapping)
+                {
+                    if(const auto it = entities.find(*hovered_entity); it != entities.end())
+                    {
+                        editor_state.ctx.hovered_entity_name = it->second.name();
+                        break;
+                    }
+                }
+            }
+
             if(
                 editor_state.ctx.selection_controller.isAnyChunkSelected() &&
                 editor_state.ctx.selection_controller.isAnyEntitySelected() &&
@@ -336,6 +356,7 @@ asio::awaitable<void> runMainLoop(async::LifecycleToken & token, pipeline::AppSt
             editor_state.ctx.stats = co_await pipeline::deferredShadingStage(
                 editor_state.app_state.renderer,
                 editor_render_state.render_state.deferred_shading,
+                editor_render_state.render_state.shadow_map_cache,
                 interpolated_frame,
                 editor_render_state.render_state.display.viewport_fbo);
 
@@ -356,11 +377,13 @@ asio::awaitable<void> runMainLoop(async::LifecycleToken & token, pipeline::AppSt
                     interpolated_frame.proj_matrix,
                     editor_render_state.render_state.display.viewport_fbo);
 
-            co_await pipeline::renderPickingIds(
-                editor_state.app_state.renderer,
-                editor_render_state.picking_resources,
-                interpolated_frame
-            ); 
+            // ray cast picking works on CPU, ids are rendered only for the ID buffer fallback
+            if(editor_state.viewport_entity_picker.getMode() == controller::PickingMode::IdBuffer)
+                co_await pipeline::renderPickingIds(
+                    editor_state.app_state.renderer,
+                    editor_render_state.picking_resources,
+                    interpolated_frame
+                ); 
         }
     );
 
@@ -2,6 +2,7 @@
 
 #include <concepts>
 #include <functional>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -11,10 +12,56 @@
 #include <asio/experimental/parallel_group.hpp>
 #include <spdlog/spdlog.h>
 
+#include "file/async_file_reader.hpp"
+
 #include "asset/asset_cache.hpp"
 
 namespace astre::asset
 {
+    // Sources whose read(arg) splits into the byte ranges it needs and the parse of
+    // their contents (file::ShaderFile, ScriptFile, MeshFile, IWorldFile), so the
+    // ranges of a whole stream call can be read as one batch.
+    template<class Source, class Def, class Arg>
+    concept BatchedSource =
+        requires(const Source & s, const Arg & a, std::vector<std::optional<std::string>> contents) {
+            { s.requests(a) } -> std::same_as<std::vector<native::ReadRequest>>;
+            { s.parse(a, std::move(contents)) } -> std::same_as<std::optional<Def>>;
+        };
+
+    namespace detail
+    {
+        template<class Key>
+        void logImportFailure(const Key & key)
+        {
+            if constexpr (std::convertible_to<const Key &, std::string_view>)
+                spdlog::error("[stream-assets] Failed to import {}", std::string_view(key));
+            else
+                spdlog::error("[stream-assets] Failed to import a source key");
+        }
+
+        // Runs importOne(i) for every i < count on the executor and waits for all of them.
+        template<class Executor, class ImportOne>
+        asio::awaitable<bool> importAll(Executor executor, std::size_t count, ImportOne & importOne)
+        {
+            using op_type = decltype(asio::co_spawn(executor, importOne(std::size_t{}), asio::deferred));
+            std::vector<op_type> ops;
+            ops.reserve(count);
+            for(std::size_t i = 0; i < count; ++i)
+                ops.emplace_back(asio::co_spawn(executor, importOne(i), asio::deferred));
+
+            auto g = asio::experimental::make_parallel_group(std::move(ops));
+            const auto no_cancel = asio::bind_cancellation_slot(asio::cancellation_slot{}, asio::use_awaitable);
+            auto [order, excs, results] = co_await g.async_wait(asio::experimental::wait_for_all(), no_cancel);
+
+            for(std::size_t i = 0; i < excs.size(); ++i)
+            {
+                if(excs[i]) std::rethrow_exception(excs[i]);
+                if(!results[i]) co_return false;
+            }
+            co_return true;
+        }
+    }
+
     // Stage 1+2: import each source arg into the cache, fanned out over the pool.
     // The read arg and the cache key can differ:
     // ShaderStreamer/ScriptStreamer read a full path and key by its stem
@@ -32,39 +79,67 @@ namespace astre::asset
                                        const std::vector<Arg> & args,
                                        KeyFn keyFn)
     {
-        auto importOne = [&](Arg arg) -> asio::awaitable<bool>
+        auto importOne = [&](std::size_t i) -> asio::awaitable<bool>
         {
             co_await asio::post(cache.executor(), asio::use_awaitable);
-            Key key = keyFn(arg);
-            auto def = source.read(arg);
+            Key key = keyFn(args[i]);
+            auto def = source.read(args[i]);
             if(!def)
             {
-                if constexpr (std::convertible_to<const Key &, std::string_view>)
-                    spdlog::error("[stream-assets] Failed to import {}", std::string_view(key));
-                else
-                    spdlog::error("[stream-assets] Failed to import a source key");
+                detail::logImportFailure(key);
                 co_return false;
             }
             co_await cache.put(std::move(key), std::move(*def));
             co_return true;
         };
 
-        using op_type = decltype(asio::co_spawn(cache.executor(), importOne(Arg{}), asio::deferred));
-        std::vector<op_type> ops;
-        ops.reserve(args.size());
+        co_return co_await detail::importAll(cache.executor(), args.size(), importOne);
+    }
+
+    // Batched form: the byte ranges of every arg are read as one batch by `reader` on
+    // its I/O thread, only parsing fans out over the pool. Pool threads never wait
+    // in read(), so logic coroutines sharing the pool keep running while hundreds of
+    // assets load.
+    template<class Key, class Def, class Arg, class Source, class KeyFn>
+        requires BatchedSource<Source, Def, Arg>
+    asio::awaitable<bool> streamAssets(AssetCache<Key, Def> & cache,
+                                       const Source & source,
+                                       const std::vector<Arg> & args,
+                                       KeyFn keyFn,
+                                       file::AsyncFileReader & reader)
+    {
+        // requests of arg i are [first[i], first[i + 1])
+        std::vector<native::ReadRequest> requests;
+        std::vector<std::size_t> first;
+        first.reserve(args.size() + 1);
         for(const auto & arg : args)
-            ops.emplace_back(asio::co_spawn(cache.executor(), importOne(arg), asio::deferred));
+        {
+            first.push_back(requests.size());
+            auto arg_requests = source.requests(arg);
+            requests.insert(requests.end(), std::make_move_iterator(arg_requests.begin()), std::make_move_iterator(arg_requests.end()));
+        }
+        first.push_back(requests.size());
 
-        auto g = asio::experimental::make_parallel_group(std::move(ops));
-        const auto no_cancel = asio::bind_cancellation_slot(asio::cancellation_slot{}, asio::use_awaitable);
-        auto [order, excs, results] = co_await g.async_wait(asio::experimental::wait_for_all(), no_cancel);
+        auto contents = co_await reader.read(std::move(requests));
 
-        for(std::size_t i = 0; i < excs.size(); ++i)
+        auto importOne = [&](std::size_t i) -> asio::awaitable<bool>
         {
-            if(excs[i]) std::rethrow_exception(excs[i]);
-            if(!results[i]) co_return false;
-        }
-        co_return true;
+            co_await asio::post(cache.executor(), asio::use_awaitable);
+            Key key = keyFn(args[i]);
+            std::vector<std::optional<std::string>> arg_contents(
+                std::make_move_iterator(contents.begin() + (std::ptrdiff_t)first[i]),
+                std::make_move_iterator(contents.begin() + (std::ptrdiff_t)first[i + 1]));
+            auto def = source.parse(args[i], std::move(arg_contents));
+            if(!def)
+            {
+                detail::logImportFailure(key);
+                co_return false;
+            }
+            co_await cache.put(std::move(key), std::move(*def));
+            co_return true;
+        };
+
+        co_return co_await detail::importAll(cache.executor(), args.size(), importOne);
     }
 
     // Identity form: the read arg is itself the cache key (WorldStreamer's ChunkID).
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <queue>
+#include <vector>
+
+#include <absl/container/flat_hash_set.h>
+
+#include "math/math.hpp"
+#include "file/world_file.hpp"
+
+#include "asset/chunk_residency.hpp"
+
+#include "proto/File/world_chunk.pb.h"
+
+namespace astre::asset
+{
+    struct PrefetchSettings
+    {
+        // chunks the camera is expected to reach within this many seconds are prefetched
+        float lookahead = 2.0f;
+
+        // approach speed assumed in every direction, in chunks per second,
+        // so a still camera prefetches the ring next to the required chunks
+        float idle_speed = 0.5f;
+
+        // prefetch ring never extends further than this many chunks past the load radius
+        int max_ring = 3;
+
+        // prefetch reads running at once
+        std::size_t max_in_flight = 8;
+
+        // weight of the newest sample in the velocity estimate, 1 disables smoothing
+        float velocity_smoothing = 0.5f;
+    };
+
+    struct PrefetchRequest
+    {
+        proto::file::ChunkID id;
+        float time_to_arrival; // seconds until the chunk would become required
+        float distance;        // from the streaming position to the chunk center
+    };
+
+    // priority_queue comparator, the soonest arrival is on top, the nearer chunk breaks ties
+    struct LaterArrival
+    {
+        bool operator()(const PrefetchRequest & a, const PrefetchRequest & b) const
+        {
+            if(a.time_to_arrival != b.time_to_arrival) return a.time_to_arrival > b.time_to_arrival;
+            return a.distance > b.distance;
+        }
+    };
+
+    using PrefetchQueue = std::priority_queue<PrefetchRequest, std::vector<PrefetchRequest>, LaterArrival>;
+
+    // Predicts which chunks outside the load radius the streaming position is about
+    // to need. Velocity is estimated from consecutive positions; a chunk's
+    // time-to-arrival is the gap to the required region divided by the velocity
+    // component pointing at it, so the ring stretches along the direction of
+    // travel and chunks behind fall out of it.
+    class ChunkPrefetcher
+    {
+        public:
+            explicit ChunkPrefetcher(float chunk_size, PrefetchSettings settings = {});
+
+            void update(const math::Vec3 & position, std::chrono::steady_clock::time_point time);
+
+            // Chunks of `available` to prefetch around `center`, outside the load
+            // radius. Empty before the first update.
+            PrefetchQueue predict(const proto::file::ChunkID & center, const StreamingRadius & load_radius,
+                const absl::flat_hash_set<proto::file::ChunkID> & available) const;
+
+            const math::Vec3 & velocity() const { return _velocity; }
+
+            const PrefetchSettings & settings() const { return _settings; }
+
+        private:
+            float _chunk_size;
+            PrefetchSettings _settings;
+
+            math::Vec3 _position{0.0f};
+            math::Vec3 _velocity{0.0f};
+            std::optional<std::chrono::steady_clock::time_point> _time;
+    };
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "file/world_file.hpp"
+
+#include "proto/File/world_chunk.pb.h"
+
+namespace astre::asset
+{
+    enum class RadiusShape { Box, Sphere };
+
+    // Streaming radius in chunks around the center chunk, per axis. A sphere is an
+    // ellipsoid through the half-chunk past each radius, so radius 1 keeps the
+    // face and edge neighbours but not the corners.
+    struct StreamingRadius
+    {
+        RadiusShape shape = RadiusShape::Box;
+        int x = 1;
+        int y = 1;
+        int z = 1;
+
+        bool contains(int dx, int dy, int dz) const;
+
+        // same shape, every axis larger by `chunks`
+        StreamingRadius grown(int chunks) const;
+
+        int largest() const;
+    };
+
+    struct ResidencyBudget
+    {
+        // 0 leaves the dimension unlimited
+        std::size_t max_chunks = 0;
+        std::size_t max_bytes = 0;
+
+        bool exceeded(std::size_t chunks, std::size_t bytes) const;
+    };
+
+    struct StreamingSettings
+    {
+        StreamingRadius load;
+
+        // Resident chunks stay required until they leave the load radius grown by
+        // this many chunks, so pacing along a chunk border doesn't reload anything.
+        int unload_margin = 1;
+
+        // least recently used chunks outside the load radius are dropped past it
+        ResidencyBudget budget;
+    };
+
+    // Resident chunks in least recently used order, with their serialized size.
+    class ChunkResidency
+    {
+        public:
+            // marks the chunk most recently used, tracking it if it is new
+            void touch(const proto::file::ChunkID & id);
+
+            void resize(const proto::file::ChunkID & id, std::size_t bytes);
+
+            void forget(const proto::file::ChunkID & id);
+
+            bool contains(const proto::file::ChunkID & id) const;
+
+            std::size_t chunks() const;
+            std::size_t bytes() const;
+
+            // Least recently used chunks accepted by `evictable` that must go so the
+            // rest fits the budget. Fewer when evictable chunks run out first.
+            std::vector<proto::file::ChunkID> overBudget(const ResidencyBudget & budget,
+                const std::function<bool(const proto::file::ChunkID &)> & evictable) const;
+
+        private:
+            struct Entry
+            {
+                std::list<proto::file::ChunkID>::iterator position;
+                std::size_t bytes = 0;
+            };
+
+            std::list<proto::file::ChunkID> _order; // least recently used first
+            absl::flat_hash_map<proto::file::ChunkID, Entry> _entries;
+            std::size_t _bytes = 0;
+    };
+}
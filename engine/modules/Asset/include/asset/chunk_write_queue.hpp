@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "native/native.h"
+#include <asio.hpp>
+#include <absl/container/flat_hash_map.h>
+
+#include "async/async.hpp"
+#include "file/world_file.hpp"
+
+#include "proto/File/world_chunk.pb.h"
+
+namespace astre::asset
+{
+    // longest time a queued chunk waits before its batch is written
+    static constexpr std::chrono::milliseconds DEFAULT_PERSIST_LATENCY = 250ms;
+
+    // queued chunks that trigger a flush without waiting for the latency bound
+    static constexpr std::size_t PERSIST_BATCH_SIZE = 64;
+
+    // Write-behind queue of chunk snapshots for one world archive. push() only
+    // copies the chunk under a mutex, a newer snapshot of the same chunk replaces
+    // the queued one. Batches are written by a dedicated I/O thread, so neither the
+    // cache strand nor the pool waits for the disk. Until a snapshot is written it
+    // is visible through pending(), readers must prefer it over the archive.
+    class ChunkWriteQueue
+    {
+        public:
+            explicit ChunkWriteQueue(std::chrono::milliseconds max_latency = DEFAULT_PERSIST_LATENCY);
+
+            ChunkWriteQueue(const ChunkWriteQueue &) = delete;
+            ChunkWriteQueue & operator=(const ChunkWriteQueue &) = delete;
+
+            // writes what is still queued, then stops the I/O thread
+            ~ChunkWriteQueue();
+
+            // archive the following batches are written to
+            void open(std::shared_ptr<file::IWorldFile> archive);
+
+            void push(proto::file::WorldChunk chunk);
+
+            std::optional<proto::file::WorldChunk> pending(const proto::file::ChunkID & id) const;
+
+            bool contains(const proto::file::ChunkID & id) const;
+
+            // Entity in the queued snapshots, which are newer than the archive's entity
+            // index. Scans at most two batches of chunks.
+            std::optional<file::EntityLocation> findEntity(std::uint64_t entity) const;
+
+            // Drop the queued snapshot of the chunk. Blocks while a batch is being
+            // written, so after it returns no older snapshot can reach the archive.
+            void discard(const proto::file::ChunkID & id);
+
+            // Write everything queued now. False if any chunk failed, those stay queued.
+            asio::awaitable<bool> drain();
+
+            std::size_t size() const;
+
+            std::chrono::milliseconds maxLatency() const { return _max_latency; }
+
+        private:
+            // on the I/O thread
+            bool _flush();
+            void _scheduleFlush();
+
+            std::chrono::milliseconds _max_latency;
+
+            std::unique_ptr<async::ThreadContext> _io;
+            asio::steady_timer _timer; // I/O thread only
+            bool _timer_armed = false; // I/O thread only
+
+            // held while a batch is written, see discard()
+            std::mutex _flush_mutex;
+
+            mutable std::mutex _mutex;
+            std::shared_ptr<file::IWorldFile> _archive;
+            absl::flat_hash_map<proto::file::ChunkID, proto::file::WorldChunk> _pending;
+            absl::flat_hash_map<proto::file::ChunkID, proto::file::WorldChunk> _in_flight; // batch being written
+    };
+}
@@ -1,18 +1,22 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <vector>
 
 #include <asio.hpp>
+#include <spdlog/spdlog.h>
 
 #include "process/process.hpp"
 
 #include "asset/asset_cache.hpp"
 #include "asset/asset_streamer.hpp"
 
+#include "file/async_file_reader.hpp"
 #include "file/data_type.hpp"
+#include "file/mesh_cache.hpp"
 #include "file/mesh_file.hpp"
 
 #include "proto/Render/mesh_definition.pb.h"
@@ -28,17 +32,29 @@ namespace astre::asset
     class MeshStreamer
     {
         public:
-            explicit MeshStreamer(process::IProcess & process)
-            :   _cache(process)
+            // reader: shared batched reader, without one every file is read on the pool
+            explicit MeshStreamer(process::IProcess & process, std::shared_ptr<file::AsyncFileReader> reader = nullptr)
+            :   _cache(process),
+                _reader(std::move(reader))
             {}
 
+            // Imported meshes are cooked into `directory` and later streams of the
+            // same source bytes load them from there instead of importing again.
+            // Not synchronized with stream(), enable it before streaming.
+            void enableCookedCache(std::filesystem::path directory)
+            {
+                spdlog::info("[mesh-streamer] Cooked meshes cached in {}", directory.string());
+                _source = file::MeshFile(std::make_shared<const file::CookedMeshCache>(std::move(directory)));
+            }
+
             template<class Mode>
             asio::awaitable<bool> stream(const std::vector<std::filesystem::path> & files, Mode)
             {
                 static_assert(std::is_same_v<Mode, file::use_obj_t>,
                     "MeshStreamer only supports file::use_obj for now");
-                return streamAssets(_cache, _source, files,
-                    [](const std::filesystem::path & p){ return p.stem().string(); });
+                const auto key = [](const std::filesystem::path & p){ return p.stem().string(); };
+                if(_reader) return streamAssets(_cache, _source, files, key, *_reader);
+                return streamAssets(_cache, _source, files, key);
             }
 
             absl::flat_hash_set<std::string> keys() const { return _cache.keys(); }
@@ -51,5 +67,6 @@ namespace astre::asset
         private:
             file::MeshFile _source;
             AssetCache<std::string, proto::render::MeshDefinition> _cache;
+            std::shared_ptr<file::AsyncFileReader> _reader;
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -11,6 +12,7 @@
 #include "asset/asset_cache.hpp"
 #include "asset/asset_streamer.hpp"
 
+#include "file/async_file_reader.hpp"
 #include "file/shader_file.hpp"
 
 #include "proto/Render/shader_definition.pb.h"
@@ -24,14 +26,17 @@ namespace astre::asset
     class ShaderStreamer
     {
         public:
-            explicit ShaderStreamer(process::IProcess & process)
-            :   _cache(process)
+            // reader: shared batched reader, without one every file is read on the pool
+            explicit ShaderStreamer(process::IProcess & process, std::shared_ptr<file::AsyncFileReader> reader = nullptr)
+            :   _cache(process),
+                _reader(std::move(reader))
             {}
 
             asio::awaitable<bool> stream(const std::vector<std::filesystem::path> & files)
             {
-                return streamAssets(_cache, _source, files,
-                    [](const std::filesystem::path & p){ return p.stem().string(); });
+                const auto key = [](const std::filesystem::path & p){ return p.stem().string(); };
+                if(_reader) return streamAssets(_cache, _source, files, key, *_reader);
+                return streamAssets(_cache, _source, files, key);
             }
 
             absl::flat_hash_set<std::string> keys() const { return _cache.keys(); }
@@ -44,5 +49,6 @@ namespace astre::asset
         private:
             file::ShaderFile _source;
             AssetCache<std::string, proto::render::ShaderDefinition> _cache;
+            std::shared_ptr<file::AsyncFileReader> _reader;
     };
 }
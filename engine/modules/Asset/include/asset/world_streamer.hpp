@@ -1,7 +1,10 @@
 #pragma once
 
+#include <chrono>
 #include <filesystem>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -16,43 +19,58 @@
 #include "math/math.hpp"
 
 #include "ecs/entity.hpp"
+#include "file/async_file_reader.hpp"
 #include "file/world_file.hpp"
 
 #include "asset/asset_cache.hpp"
 #include "asset/asset_streamer.hpp"
+#include "asset/chunk_write_queue.hpp"
+#include "asset/chunk_prefetcher.hpp"
+#include "asset/chunk_residency.hpp"
 
 #include "proto/ECS/entity_definition.pb.h"
 #include "proto/File/world_chunk.pb.h"
 
 namespace astre::asset
 {
-    // load X chunk in each direction from streaming position
-    // when 0 load only the chunk at streaming position
-    static constexpr int LOAD_RADIUS = 1;
-
     // A writable, position-streamed asset. Like ShaderStreamer/ScriptStreamer it
     // opens no file at construction, holding only an AssetCache — _archive is null
     // until stream(file, mode) opens the WorldFile. After that, chunks are imported
     // from the file::IWorldFile (Stage 1) into the cache (Stage 2) via the same
     // asset::streamAssets the other streamers use, as the load position moves, and
-    // evicted when they leave the radius. read(ChunkID) makes it a DefinitionSource
+    // evicted when they leave the unload radius or the residency budget needs
+    // room. read(ChunkID) makes it a DefinitionSource
     // like any other cache; write()/remove() are the read+write half no immutable
     // asset has. It has no strand of its own — all its state runs on the cache's
-    // strand, so cache access stays single-strand.
+    // strand, so cache access stays single-strand. Dirty chunks are written
+    // behind through a ChunkWriteQueue on its own I/O thread. Chunks the camera is
+    // heading for are prefetched into the cache ahead of being required, see
+    // ChunkPrefetcher; they are not part of keys() until they are required.
     class WorldStreamer
     {
         public:
             // Per-chunk streaming state for debug visualization. Precedence when a
-            // chunk sits in several sets: Dirty > ToReload > Loaded > Required > Unloaded.
-            enum class ChunkDebugState { Unloaded, Required, Loaded, ToReload, Dirty };
+            // chunk sits in several sets: Dirty > ToReload > Prefetched > Loaded > Required > Unloaded.
+            enum class ChunkDebugState { Unloaded, Prefetched, Required, Loaded, ToReload, Dirty };
 
+            // reader: shared batched reader for required chunks, without one they are read on the pool
+            // persist_latency: longest time an unloaded dirty chunk waits before it is written
             WorldStreamer(
                 process::IProcess & process,
-                float chunk_size
+                float chunk_size,
+                std::shared_ptr<file::AsyncFileReader> reader = nullptr,
+                StreamingSettings streaming_settings = {},
+                std::chrono::milliseconds persist_latency = DEFAULT_PERSIST_LATENCY,
+                PrefetchSettings prefetch_settings = {}
             )
             :   _archive(nullptr),
+                _write_queue(std::make_shared<ChunkWriteQueue>(persist_latency)),
                 _cache(process),
-                _chunk_size(chunk_size)
+                _reader(std::move(reader)),
+                _chunk_size(chunk_size),
+                _streaming(std::move(streaming_settings)),
+                _prefetcher(chunk_size, prefetch_settings),
+                _prefetch_results(std::make_shared<PrefetchResults>())
             {}
 
             // Opens the WorldFile at `file_path` in the given format
@@ -68,6 +86,7 @@ namespace astre::asset
             {
                 co_await asio::post(_cache.executor(), asio::use_awaitable);
                 _archive = file::openWorldArchive(std::move(file_path), mode);
+                _write_queue->open(_archive);
                 co_return _archive != nullptr;
             }
 
@@ -75,16 +94,22 @@ namespace astre::asset
             // until ChunkLoader has migrated/unloaded their entities.
             absl::flat_hash_set<proto::file::ChunkID> keys() const { return _required_chunks; }
 
-            const absl::flat_hash_set<proto::file::ChunkID> & getAllChunks() const;
+            // snapshot, the archive may be written behind on another thread meanwhile
+            absl::flat_hash_set<proto::file::ChunkID> getAllChunks() const;
 
             float chunkSize() const { return _chunk_size; }
 
+            // Radii and budget used from the next updateLoadPosition on.
+            asio::awaitable<void> configure(StreamingSettings settings);
+            const StreamingSettings & streamingSettings() const { return _streaming; }
+
             // Snapshot every known chunk with its debug state, for the chunk-border
             // overlay. Runs on the cache strand so cache access stays single-strand.
             asio::awaitable<absl::flat_hash_map<proto::file::ChunkID, ChunkDebugState>> snapshotChunkStates() const;
 
             asio::awaitable<void> updateLoadPosition(const math::Vec3 & pos);
             proto::file::ChunkID chunkIdForPosition(const math::Vec3 & pos) const;
+            // Last persisted or queued position, from the archive's entity index.
             std::optional<math::Vec3> findEntityPosition(ecs::Entity entity) const;
 
             const proto::file::WorldChunk * read(proto::file::ChunkID id) const;
@@ -94,18 +119,68 @@ namespace astre::asset
             asio::awaitable<bool> removeCachedEntity(proto::file::ChunkID id, ecs::Entity entity);
             asio::awaitable<bool> unloadCachedChunks(const std::vector<proto::file::ChunkID> & ids);
 
-            // Flush every dirty cached chunk to the archive. Call on shutdown: chunks
-            // still resident then never hit the unload path that would persist them.
+            // Flush every dirty cached chunk to the archive and drain the write queue.
+            // Call on shutdown: chunks still resident then never hit the unload path
+            // that would persist them.
             asio::awaitable<bool> persistAll();
 
         private:
             asio::awaitable<void> _unloadChunk(const proto::file::ChunkID& id);
+            // queues a snapshot of the cached chunk, does not wait for the write
             asio::awaitable<bool> _persistChunkIfDirty(const proto::file::ChunkID& id);
 
-            std::unique_ptr<file::IWorldFile> _archive;
+            // Newest known version of a chunk that is not resident: the queued
+            // snapshot if it has not been written yet, else the archive.
+            std::optional<proto::file::WorldChunk> _readBehind(const proto::file::ChunkID& id) const;
+
+            // Moves finished prefetch reads into the cache, unless the chunk got
+            // resident or queued for writing in the meantime.
+            asio::awaitable<void> _collectPrefetched();
+
+            // Cancels prefetches and evicts prefetched chunks the new prediction
+            // dropped, then issues the most urgent requests on the pool.
+            asio::awaitable<void> _prefetch(const proto::file::ChunkID & center);
+
+            // A running read of the chunk may be older than what is about to happen to it.
+            void _cancelPrefetch(const proto::file::ChunkID & id);
+
+            // Marks a resident chunk most recently used. Its size is measured when it
+            // was just put into the cache or is not tracked yet.
+            void _touch(const proto::file::ChunkID & id, bool replaced);
+
+            // Drops least recently used chunks outside the load radius while the
+            // residency budget is exceeded.
+            asio::awaitable<void> _enforceBudget(const absl::flat_hash_set<proto::file::ChunkID> & in_load_radius);
+
+            // Reads finished on the pool, shared with the read tasks so they may
+            // outlive the streamer.
+            struct PrefetchResults
+            {
+                struct Read
+                {
+                    proto::file::ChunkID id;
+                    std::shared_ptr<std::atomic<bool>> cancelled;
+                    std::optional<proto::file::WorldChunk> chunk;
+                };
+
+                std::mutex mutex;
+                std::vector<Read> done;
+            };
+
+            // After archive mutations: once superseded records take enough space,
+            // compact the archive on the pool. The task shares ownership of the
+            // archive, so it may outlive the streamer.
+            void _compactArchiveIfNeeded();
+
+            std::shared_ptr<file::IWorldFile> _archive;
+            std::shared_ptr<ChunkWriteQueue> _write_queue; // shared with prefetch reads
             AssetCache<proto::file::ChunkID, proto::file::WorldChunk> _cache;
+            std::shared_ptr<file::AsyncFileReader> _reader;
 
             float _chunk_size;
+            StreamingSettings _streaming;
+            // required and prefetched chunks, chunks leaving the cache are not counted
+            ChunkResidency _residency;
 
             // archive/disk is newer than the cached chunk. 
             // write(chunk) writes to the archive, then marks the loaded chunk for reload.
@@ -114,8 +189,15 @@ namespace astre::asset
             absl::flat_hash_set<proto::file::ChunkID> _required_chunks;
 
             //_dirty_chunks: cached chunk is newer than archive/disk.
-            // Before unloading, _persistChunkIfDirty() would write the cached chunk back to the archive,
-            // then clear _dirty_chunks
+            // Before unloading, _persistChunkIfDirty() queues a snapshot of the cached chunk
+            // in _write_queue, then clears _dirty_chunks
             absl::flat_hash_set<proto::file::ChunkID> _dirty_chunks;
+
+            ChunkPrefetcher _prefetcher;
+            // running prefetch reads, with the flag that cancels each
+            absl::flat_hash_map<proto::file::ChunkID, std::shared_ptr<std::atomic<bool>>> _prefetching;
+            std::shared_ptr<PrefetchResults> _prefetch_results;
+            // resident because of a prefetch, promoted to required once the camera gets there
+            absl::flat_hash_set<proto::file::ChunkID> _prefetched;
     };
 }
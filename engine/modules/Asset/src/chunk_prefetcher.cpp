@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "asset/chunk_prefetcher.hpp"
+
+namespace astre::asset
+{
+    ChunkPrefetcher::ChunkPrefetcher(float chunk_size, PrefetchSettings settings)
+    :   _chunk_size(chunk_size),
+        _settings(settings)
+    {}
+
+    void ChunkPrefetcher::update(const math::Vec3 & position, std::chrono::steady_clock::time_point time)
+    {
+        if(_time)
+        {
+            const float dt = std::chrono::duration<float>(time - *_time).count();
+            // several updates within one clock tick carry no velocity information
+            if(dt <= 0.0f) return;
+
+            const math::Vec3 sample = (position - _position) / dt;
+            _velocity = _velocity + (sample - _velocity) * _settings.velocity_smoothing;
+        }
+
+        _position = position;
+        _time = time;
+    }
+
+    PrefetchQueue ChunkPrefetcher::predict(const proto::file::ChunkID & center, const StreamingRadius & load_radius,
+        const absl::flat_hash_set<proto::file::ChunkID> & available) const
+    {
+        PrefetchQueue queue;
+        if(!_time || _settings.max_ring <= 0) return queue;
+
+        const float speed = glm::length(_velocity);
+        const float idle_speed = _settings.idle_speed * _chunk_size;
+
+        // how far the ring reaches past the load radius grows with speed
+        const int ring = std::clamp((int)std::ceil(speed * _settings.lookahead / _chunk_size), 1, _settings.max_ring);
+        const StreamingRadius extent = load_radius.grown(ring);
+
+        for(int dx = -extent.x; dx <= extent.x; ++dx)
+        {
+            for(int dy = -extent.y; dy <= extent.y; ++dy)
+            {
+                for(int dz = -extent.z; dz <= extent.z; ++dz)
+                {
+                    if(load_radius.contains(dx, dy, dz)) continue;
+                    if(!extent.contains(dx, dy, dz)) continue;
+
+                    proto::file::ChunkID id;
+                    id.set_x(center.x() + dx);
+                    id.set_y(center.y() + dy);
+                    id.set_z(center.z() + dz);
+                    if(!available.contains(id)) continue;
+
+                    const math::Vec3 chunk_center{
+                        (id.x() + 0.5f) * _chunk_size,
+                        (id.y() + 0.5f) * _chunk_size,
+                        (id.z() + 0.5f) * _chunk_size};
+                    const math::Vec3 offset = chunk_center - _position;
+                    const float distance = glm::length(offset);
+
+                    // distance already covered by required chunks in the direction of this one
+                    const float weight = (float)(std::abs(dx) + std::abs(dy) + std::abs(dz));
+                    const float radius = (std::abs(dx) * load_radius.x + std::abs(dy) * load_radius.y + std::abs(dz) * load_radius.z) / weight;
+                    const float reach = (radius + 0.5f) * _chunk_size;
+                    const float gap = std::max(distance - reach, 0.0f);
+
+                    // velocity component pointing at the chunk
+                    const float approach = distance > 0.0f ? glm::dot(offset, _velocity) / distance : speed;
+                    const float toward = std::max(approach, idle_speed);
+                    if(gap > 0.0f && toward <= 0.0f) continue;
+
+                    const float time_to_arrival = gap > 0.0f ? gap / toward : 0.0f;
+                    if(time_to_arrival > _settings.lookahead) continue;
+
+                    queue.push(PrefetchRequest{
+                        .id = std::move(id),
+                        .time_to_arrival = time_to_arrival,
+                        .distance = distance
+                    });
+                }
+            }
+        }
+
+        return queue;
+    }
+}
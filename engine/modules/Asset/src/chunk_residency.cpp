@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include "asset/chunk_residency.hpp"
+
+namespace astre::asset
+{
+    bool StreamingRadius::contains(int dx, int dy, int dz) const
+    {
+        if(std::abs(dx) > x || std::abs(dy) > y || std::abs(dz) > z) return false;
+        if(shape == RadiusShape::Box) return true;
+
+        const auto axis = [](int d, int radius)
+        {
+            const float r = radius + 0.5f;
+            return (d * d) / (r * r);
+        };
+        return axis(dx, x) + axis(dy, y) + axis(dz, z) <= 1.0f;
+    }
+
+    StreamingRadius StreamingRadius::grown(int chunks) const
+    {
+        return StreamingRadius{
+            .shape = shape,
+            .x = x + chunks,
+            .y = y + chunks,
+            .z = z + chunks
+        };
+    }
+
+    int StreamingRadius::largest() const
+    {
+        return std::max({x, y, z});
+    }
+
+    bool ResidencyBudget::exceeded(std::size_t chunks, std::size_t bytes) const
+    {
+        if(max_chunks > 0 && chunks > max_chunks) return true;
+        if(max_bytes > 0 && bytes > max_bytes) return true;
+        return false;
+    }
+
+    void ChunkResidency::touch(const proto::file::ChunkID & id)
+    {
+        auto it = _entries.find(id);
+        if(it == _entries.end())
+        {
+            _order.push_back(id);
+            _entries.emplace(id, Entry{.position = std::prev(_order.end())});
+            return;
+        }
+        _order.splice(_order.end(), _order, it->second.position);
+    }
+
+    void ChunkResidency::resize(const proto::file::ChunkID & id, std::size_t bytes)
+    {
+        auto it = _entries.find(id);
+        if(it == _entries.end()) return;
+
+        _bytes = _bytes - it->second.bytes + bytes;
+        it->second.bytes = bytes;
+    }
+
+    void ChunkResidency::forget(const proto::file::ChunkID & id)
+    {
+        auto it = _entries.find(id);
+        if(it == _entries.end()) return;
+
+        _bytes -= it->second.bytes;
+        _order.erase(it->second.position);
+        _entries.erase(it);
+    }
+
+    bool ChunkResidency::contains(const proto::file::ChunkID & id) const
+    {
+        return _entries.contains(id);
+    }
+
+    std::size_t ChunkResidency::chunks() const
+    {
+        return _entries.size();
+    }
+
+    std::size_t ChunkResidency::bytes() const
+    {
+        return _bytes;
+    }
+
+    std::vector<proto::file::ChunkID> ChunkResidency::overBudget(const ResidencyBudget & budget,
+        const std::function<bool(const proto::file::ChunkID &)> & evictable) const
+    {
+        std::vector<proto::file::ChunkID> evicted;
+
+        std::size_t chunks = _entries.size();
+        std::size_t bytes = _bytes;
+        for(auto it = _order.begin(); it != _order.end() && budget.exceeded(chunks, bytes); ++it)
+        {
+            if(!evictable(*it)) continue;
+
+            evicted.push_back(*it);
+            chunks -= 1;
+            bytes -= _entries.at(*it).bytes;
+        }
+        return evicted;
+    }
+}
@@ -0,0 +1,181 @@
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "asset/chunk_write_queue.hpp"
+
+namespace astre::asset
+{
+    ChunkWriteQueue::ChunkWriteQueue(std::chrono::milliseconds max_latency)
+    :   _max_latency(max_latency),
+        _io(std::make_unique<async::ThreadContext>()),
+        _timer(*_io)
+    {
+        _io->start([io = _io.get()]()
+        {
+            spdlog::debug("[chunk-write-queue] I/O thread started");
+            io->run();
+            spdlog::debug("[chunk-write-queue] I/O thread ended");
+        });
+    }
+
+    ChunkWriteQueue::~ChunkWriteQueue()
+    {
+        asio::post(*_io, [this]()
+        {
+            _timer.cancel();
+            _flush();
+        });
+        _io->close();
+        _io->join();
+    }
+
+    void ChunkWriteQueue::open(std::shared_ptr<file::IWorldFile> archive)
+    {
+        std::scoped_lock lock(_mutex);
+        _archive = std::move(archive);
+    }
+
+    void ChunkWriteQueue::push(proto::file::WorldChunk chunk)
+    {
+        bool full = false;
+        {
+            std::scoped_lock lock(_mutex);
+            proto::file::ChunkID id = chunk.id();
+            _pending.insert_or_assign(std::move(id), std::move(chunk));
+            full = _pending.size() >= PERSIST_BATCH_SIZE;
+        }
+
+        asio::post(*_io, [this, full]()
+        {
+            if(full) _flush();
+            else _scheduleFlush();
+        });
+    }
+
+    std::optional<proto::file::WorldChunk> ChunkWriteQueue::pending(const proto::file::ChunkID & id) const
+    {
+        std::scoped_lock lock(_mutex);
+        if(auto it = _pending.find(id); it != _pending.end()) return it->second;
+        if(auto it = _in_flight.find(id); it != _in_flight.end()) return it->second;
+        return std::nullopt;
+    }
+
+    bool ChunkWriteQueue::contains(const proto::file::ChunkID & id) const
+    {
+        std::scoped_lock lock(_mutex);
+        return _pending.contains(id) || _in_flight.contains(id);
+    }
+
+    std::optional<file::EntityLocation> ChunkWriteQueue::findEntity(std::uint64_t entity) const
+    {
+        std::scoped_lock lock(_mutex);
+
+        std::optional<file::EntityLocation> found;
+        const auto find = [&](const auto & chunks)
+        {
+            for(const auto & [id, chunk] : chunks)
+            {
+                for(const auto & entity_def : chunk.entities())
+                {
+                    if(entity_def.id() != entity) continue;
+
+                    found = file::EntityLocation{
+                        .chunk = id,
+                        .position = entity_def.has_transform() ? std::make_optional(entity_def.transform().position()) : std::nullopt
+                    };
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        // queued snapshots are newer than the batch being written
+        if(!find(_pending)) find(_in_flight);
+        return found;
+    }
+
+    void ChunkWriteQueue::discard(const proto::file::ChunkID & id)
+    {
+        std::scoped_lock flush_lock(_flush_mutex);
+        std::scoped_lock lock(_mutex);
+        _pending.erase(id);
+    }
+
+    asio::awaitable<bool> ChunkWriteQueue::drain()
+    {
+        auto caller = co_await asio::this_coro::executor;
+
+        co_await asio::post(_io->get_executor(), asio::use_awaitable);
+        const bool flushed = _flush();
+
+        co_await asio::post(caller, asio::use_awaitable);
+        co_return flushed;
+    }
+
+    std::size_t ChunkWriteQueue::size() const
+    {
+        std::scoped_lock lock(_mutex);
+        return _pending.size() + _in_flight.size();
+    }
+
+    void ChunkWriteQueue::_scheduleFlush()
+    {
+        if(_timer_armed) return;
+        _timer_armed = true;
+
+        _timer.expires_after(_max_latency);
+        _timer.async_wait([this](const asio::error_code & error)
+        {
+            _timer_armed = false;
+            if(error) return;
+            _flush();
+        });
+    }
+
+    bool ChunkWriteQueue::_flush()
+    {
+        std::shared_ptr<file::IWorldFile> archive;
+        std::vector<proto::file::ChunkID> failed;
+        {
+            std::scoped_lock flush_lock(_flush_mutex);
+            {
+                std::scoped_lock lock(_mutex);
+                if(_pending.empty()) return true;
+                if(!_archive)
+                {
+                    spdlog::error("[chunk-write-queue] No archive to persist {} chunks to", _pending.size());
+                    return false;
+                }
+                archive = _archive;
+                // written chunks stay visible through pending() until the whole batch is done
+                _in_flight.swap(_pending);
+            }
+
+            // _in_flight only changes on this thread, pending() just reads it
+            for(const auto & [id, chunk] : _in_flight)
+            {
+                if(archive->writeChunk(chunk)) continue;
+
+                spdlog::error("[chunk-write-queue] Failed to persist chunk ({}, {}, {})", id.x(), id.y(), id.z());
+                failed.push_back(id);
+            }
+
+            spdlog::debug("[chunk-write-queue] Persisted {} chunks", _in_flight.size() - failed.size());
+
+            std::scoped_lock lock(_mutex);
+            for(const auto & id : failed)
+            {
+                // a newer snapshot queued meanwhile supersedes the failed one
+                _pending.try_emplace(id, std::move(_in_flight.at(id)));
+            }
+            _in_flight.clear();
+        }
+
+        // outside the flush lock, discard() must not wait for a compaction
+        if(archive->needsCompaction() && !archive->compact())
+            spdlog::warn("[chunk-write-queue] Failed to compact world archive");
+
+        return failed.empty();
+    }
+}
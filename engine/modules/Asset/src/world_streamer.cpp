@@ -23,13 +23,177 @@ namespace astre::asset
 
         spdlog::debug("Unloading chunk  ({};{};{})", id.x(), id.y(), id.z());
         _cache.remove(id);
+        _residency.forget(id);
         spdlog::debug("Chunk unloaded  ({};{};{})", id.x(), id.y(), id.z());
     }
 
-    const absl::flat_hash_set<proto::file::ChunkID> & WorldStreamer::getAllChunks() const
+    void WorldStreamer::_compactArchiveIfNeeded()
     {
-        static const absl::flat_hash_set<proto::file::ChunkID> empty;
-        return _archive ? _archive->getAllChunks() : empty;
+        if (!_archive || !_archive->needsCompaction()) return;
+
+        asio::post(_cache.executor(), [archive = _archive]()
+        {
+            if (!archive->compact())
+                spdlog::warn("[world-streamer] Failed to compact world archive");
+        });
+    }
+
+    std::optional<proto::file::WorldChunk> WorldStreamer::_readBehind(const proto::file::ChunkID& id) const
+    {
+        if (auto queued = _write_queue->pending(id)) return queued;
+        if (!_archive) return std::nullopt;
+        return _archive->read(id);
+    }
+
+    void WorldStreamer::_cancelPrefetch(const proto::file::ChunkID & id)
+    {
+        auto it = _prefetching.find(id);
+        if (it == _prefetching.end()) return;
+
+        it->second->store(true);
+        _prefetching.erase(it);
+    }
+
+    asio::awaitable<void> WorldStreamer::_collectPrefetched()
+    {
+        co_await _cache.ensureOnStrand();
+
+        std::vector<PrefetchResults::Read> done;
+        {
+            std::scoped_lock lock(_prefetch_results->mutex);
+            done.swap(_prefetch_results->done);
+        }
+
+        for (auto & read : done)
+        {
+            // cancelled reads already left _prefetching, a newer read of the chunk may be running
+            if (read.cancelled->load()) continue;
+            _prefetching.erase(read.id);
+
+            if (!read.chunk) continue;
+            if (_cache.contains(read.id) || _write_queue->pending(read.id)) continue;
+
+            spdlog::debug("Chunk prefetched  ({};{};{})", read.id.x(), read.id.y(), read.id.z());
+            _prefetched.insert(read.id);
+            co_await _cache.put(read.id, std::move(*read.chunk));
+            _touch(read.id, true);
+        }
+    }
+
+    asio::awaitable<void> WorldStreamer::_prefetch(const proto::file::ChunkID & center)
+    {
+        co_await _cache.ensureOnStrand();
+
+        PrefetchQueue queue = _prefetcher.predict(center, _streaming.load, getAllChunks());
+
+        std::vector<PrefetchRequest> ordered;
+        ordered.reserve(queue.size());
+        absl::flat_hash_set<proto::file::ChunkID> predicted;
+        while (!queue.empty())
+        {
+            predicted.insert(queue.top().id);
+            ordered.push_back(queue.top());
+            queue.pop();
+        }
+
+        // the camera turned or stopped, drop what it is no longer heading for
+        for (auto it = _prefetching.begin(); it != _prefetching.end();)
+        {
+            if (predicted.contains(it->first)) { ++it; continue; }
+            it->second->store(true);
+            _prefetching.erase(it++);
+        }
+
+        std::vector<proto::file::ChunkID> evicted;
+        for (const auto & id : _prefetched)
+            if (!predicted.contains(id)) evicted.push_back(id);
+
+        for (const auto & id : evicted)
+        {
+            _prefetched.erase(id);
+            // entities may have been re-homed into it meanwhile
+            if (!co_await _persistChunkIfDirty(id)) continue;
+            co_await _unloadChunk(id);
+        }
+
+        for (const PrefetchRequest & request : ordered)
+        {
+            if (_prefetching.size() >= _prefetcher.settings().max_in_flight) break;
+            // prefetched chunks would be the next to go
+            if (_streaming.budget.exceeded(_residency.chunks() + _prefetching.size() + 1, _residency.bytes())) break;
+            if (_cache.contains(request.id) || _prefetching.contains(request.id)) continue;
+
+            auto cancelled = std::make_shared<std::atomic<bool>>(false);
+            _prefetching.emplace(request.id, cancelled);
+
+            // owns everything it touches, the streamer may be gone when it runs
+            asio::post(_cache.executor(),
+                [archive = _archive, write_queue = _write_queue, results = _prefetch_results, id = request.id, cancelled]()
+                {
+                    if (cancelled->load()) return;
+
+                    std::optional<proto::file::WorldChunk> chunk = write_queue->pending(id);
+                    if (!chunk) chunk = archive->read(id);
+
+                    std::scoped_lock lock(results->mutex);
+                    results->done.push_back(PrefetchResults::Read{
+                        .id = id,
+                        .cancelled = cancelled,
+                        .chunk = std::move(chunk)
+                    });
+                });
+        }
+    }
+
+    void WorldStreamer::_touch(const proto::file::ChunkID & id, bool replaced)
+    {
+        const auto * chunk = _cache.read(id);
+        if (!chunk) return;
+
+        const bool tracked = _residency.contains(id);
+        _residency.touch(id);
+        if (tracked && !replaced) return;
+
+        _residency.resize(id, chunk->ByteSizeLong());
+    }
+
+    asio::awaitable<void> WorldStreamer::_enforceBudget(const absl::flat_hash_set<proto::file::ChunkID> & in_load_radius)
+    {
+        co_await _cache.ensureOnStrand();
+
+        const auto evicted = _residency.overBudget(_streaming.budget,
+            [&](const proto::file::ChunkID & id)
+            {
+                if (in_load_radius.contains(id)) return false;
+                return _required_chunks.contains(id) || _prefetched.contains(id);
+            });
+
+        for (const auto & id : evicted)
+        {
+            spdlog::debug("[world-streamer] Evicting chunk ({}, {}, {}) over the residency budget", id.x(), id.y(), id.z());
+
+            if (_prefetched.erase(id))
+            {
+                if (co_await _persistChunkIfDirty(id)) co_await _unloadChunk(id);
+                continue;
+            }
+
+            // ChunkLoader unloads its entities on the next sync, which drops it from the cache
+            _required_chunks.erase(id);
+            _residency.forget(id);
+        }
+    }
+
+    asio::awaitable<void> WorldStreamer::configure(StreamingSettings settings)
+    {
+        co_await _cache.ensureOnStrand();
+        _streaming = std::move(settings);
+    }
+
+    absl::flat_hash_set<proto::file::ChunkID> WorldStreamer::getAllChunks() const
+    {
+        if (!_archive) return {};
+        return _archive->getAllChunks();
     }
 
     proto::file::ChunkID WorldStreamer::chunkIdForPosition(const math::Vec3 & pos) const
@@ -49,6 +213,7 @@ namespace astre::asset
         {
             if (_dirty_chunks.contains(id))     return ChunkDebugState::Dirty;
             if (_to_reload.contains(id))        return ChunkDebugState::ToReload;
+            if (_prefetched.contains(id))       return ChunkDebugState::Prefetched;
             if (resident.contains(id))          return ChunkDebugState::Loaded;
             if (_required_chunks.contains(id))  return ChunkDebugState::Required;
             return ChunkDebugState::Unloaded;
@@ -70,19 +235,16 @@ namespace astre::asset
     {
         if (!_archive) return std::nullopt;
 
-        for (const auto & chunk_id : _archive->getAllChunks())
+        auto location = _write_queue->findEntity(entity);
+        if (!location)
         {
-            const auto chunk = _archive->read(chunk_id);
-            if (!chunk) continue;
-
-            for (const auto & entity_def : chunk->entities())
-            {
-                if (entity_def.id() == entity && entity_def.has_transform())
-                    return math::deserialize(entity_def.transform().position());
-            }
+            location = _archive->findEntity(entity);
+            // the snapshot queued for that chunk no longer holds the entity
+            if (location && _write_queue->contains(location->chunk)) return std::nullopt;
         }
 
-        return std::nullopt;
+        if (!location || !location->position) return std::nullopt;
+        return math::deserialize(*location->position);
     }
 
     asio::awaitable<void> WorldStreamer::updateLoadPosition(const math::Vec3 & pos)
@@ -91,38 +253,81 @@ namespace astre::asset
 
         co_await _cache.ensureOnStrand();
 
+        _prefetcher.update(pos, std::chrono::steady_clock::now());
+        co_await _collectPrefetched();
+
         const proto::file::ChunkID center = chunkIdForPosition(pos);
 
-        const auto & all_available_chunks = getAllChunks();
+        const auto all_available_chunks = getAllChunks();
 
-        absl::flat_hash_set<proto::file::ChunkID> required;
-        for (int dx = -LOAD_RADIUS; dx <= LOAD_RADIUS; ++dx)
+        const StreamingRadius & load = _streaming.load;
+        absl::flat_hash_set<proto::file::ChunkID> in_load_radius;
+        for (int dx = -load.x; dx <= load.x; ++dx)
         {
-            for (int dy = -LOAD_RADIUS; dy <= LOAD_RADIUS; ++dy)
+            for (int dy = -load.y; dy <= load.y; ++dy)
             {
-                for (int dz = -LOAD_RADIUS; dz <= LOAD_RADIUS; ++dz)
+                for (int dz = -load.z; dz <= load.z; ++dz)
                 {
+                    if (!load.contains(dx, dy, dz)) continue;
+
                     proto::file::ChunkID id;
                     id.set_x(center.x() + dx);
                     id.set_y(center.y() + dy);
                     id.set_z(center.z() + dz);
-                    required.insert(std::move(id));
+                    in_load_radius.insert(std::move(id));
                 }
             }
         }
+
+        // Hysteresis: a resident chunk stays required until it leaves the larger
+        // unload radius, so moving back and forth over a border loads nothing.
+        const StreamingRadius unload = load.grown(std::max(_streaming.unload_margin, 0));
+        absl::flat_hash_set<proto::file::ChunkID> required = in_load_radius;
+        for (const proto::file::ChunkID& cid : _required_chunks)
+        {
+            if (!_cache.contains(cid)) continue;
+            if (unload.contains(cid.x() - center.x(), cid.y() - center.y(), cid.z() - center.z()))
+                required.insert(cid);
+        }
+
+        // chunks leaving now are on their way out of the cache, the budget ignores them
+        for (const proto::file::ChunkID& cid : _required_chunks)
+            if (!required.contains(cid)) _residency.forget(cid);
+
         _required_chunks = required;
 
+        for (const proto::file::ChunkID& cid : required)
+        {
+            // the camera arrived, a prefetched chunk is simply kept
+            _prefetched.erase(cid);
+            // a read still running is too late, the load below takes over
+            _cancelPrefetch(cid);
+        }
+
         // Keys needing a (re)load: missing, or resident but marked dirty. streamAssets
         // overwrites via put (insert_or_assign), so it doubles as the reload path.
         std::vector<proto::file::ChunkID> to_load;
         for (const proto::file::ChunkID& cid : required)
         {
+            if (!_cache.contains(cid) || _to_reload.contains(cid))
+            {
+                // unloaded dirty chunk whose snapshot is not written yet, the archive is stale
+                if (auto queued = _write_queue->pending(cid))
+                {
+                    co_await _cache.put(cid, std::move(*queued));
+                    _touch(cid, true);
+                    _to_reload.erase(cid);
+                    continue;
+                }
+            }
+
             if(!_cache.contains(cid) && !all_available_chunks.contains(cid))
             {
                 proto::file::WorldChunk empty;
                 empty.mutable_id()->CopyFrom(cid);
                 spdlog::debug("Creating empty chunk  ({};{};{})", cid.x(), cid.y(), cid.z());
                 co_await _cache.put(cid, std::move(empty));
+                _touch(cid, true);
                 spdlog::debug("Empty chunk created  ({};{};{})", cid.x(), cid.y(), cid.z());
 
                 continue;
@@ -136,17 +341,30 @@ namespace astre::asset
         {
             spdlog::debug("Loading chunks  ({};{};{}),...", to_load.at(0).x(), to_load.at(0).y(), to_load.at(0).z());
 
-            // Same pool fan-out as the other streamers; IWorldFile::read is const
-            // and uses a local stream, so the parallel reads are safe.
-            if (!co_await streamAssets(_cache, *_archive, to_load))
+            // Same fan-out as the other streamers: records are read as one batch
+            // when there is a reader, else IWorldFile::read (const, safe to call
+            // concurrently) runs on the pool per chunk.
+            const bool loaded = _reader
+                ? co_await streamAssets(_cache, *_archive, to_load, std::identity{}, *_reader)
+                : co_await streamAssets(_cache, *_archive, to_load);
+            if (!loaded)
                 spdlog::error("Failed to stream world chunks");
 
             spdlog::debug("Chunks loaded ({};{};{}),...", to_load.at(0).x(), to_load.at(0).y(), to_load.at(0).z());
 
             co_await _cache.ensureOnStrand();
-            for (const proto::file::ChunkID& cid : to_load) _to_reload.erase(cid);
+            for (const proto::file::ChunkID& cid : to_load)
+            {
+                _to_reload.erase(cid);
+                _touch(cid, true);
+            }
         }
 
+        for (const proto::file::ChunkID& cid : in_load_radius)
+            _touch(cid, false);
+
+        co_await _enforceBudget(in_load_radius);
+        co_await _prefetch(center);
         co_return;
     }
 
@@ -166,7 +384,12 @@ namespace astre::asset
             // if loaded we need also to update it
             _to_reload.emplace(chunk.id());
         }
-        co_return _archive->writeChunk(chunk);
+        // an older queued snapshot must not overwrite this version later
+        _write_queue->discard(chunk.id());
+        _cancelPrefetch(chunk.id());
+        const bool written = _archive->writeChunk(chunk);
+        _compactArchiveIfNeeded();
+        co_return written;
     }
 
     asio::awaitable<bool> WorldStreamer::upsertCachedEntity(proto::file::ChunkID id, proto::ecs::EntityDefinition entity_def)
@@ -186,7 +409,7 @@ namespace astre::asset
         proto::file::WorldChunk chunk;
         if(const auto * existing = _cache.read(id))
             chunk.CopyFrom(*existing);
-        else if(auto on_disk = _archive->read(id))
+        else if(auto on_disk = _readBehind(id))
             chunk = std::move(*on_disk);
         else
             chunk.mutable_id()->CopyFrom(id);
@@ -203,10 +426,13 @@ namespace astre::asset
         else
             entities->Add()->CopyFrom(entity_def);
 
+        _cancelPrefetch(id);
+
         // Deferred write: cache holds the newest copy, disk catches up on unload
         // via _persistChunkIfDirty (or persistAll at shutdown).
         _dirty_chunks.insert(id);
-        co_await _cache.put(std::move(id), std::move(chunk));
+        co_await _cache.put(id, std::move(chunk));
+        _touch(id, true);
         co_return true;
     }
 
@@ -234,7 +460,8 @@ namespace astre::asset
             {
                 entities->DeleteSubrange(i, 1);
                 _dirty_chunks.insert(id);
-                co_await _cache.put(std::move(id), std::move(chunk));
+                co_await _cache.put(id, std::move(chunk));
+                _touch(id, true);
                 co_return true;
             }
         }
@@ -257,20 +484,17 @@ namespace astre::asset
             co_return true;
         }
 
-        if(chunk->entities_size() == 0 && !_archive->getAllChunks().contains(id))
+        if(chunk->entities_size() == 0 && !_archive->containsChunk(id))
         {
             _dirty_chunks.erase(id);
             co_return true;
         }
 
-        if(!_archive->writeChunk(*chunk))
-        {
-            spdlog::error("[world-streamer] Failed to persist dirty chunk ({}, {}, {})",
-                id.x(), id.y(), id.z());
-            co_return false;
-        }
+        // snapshot, the write happens behind on the queue's I/O thread
+        _write_queue->push(*chunk);
+        _cancelPrefetch(id);
 
-        spdlog::debug("[world-streamer] Persisted dirty chunk ({}, {}, {})",
+        spdlog::debug("[world-streamer] Queued dirty chunk ({}, {}, {})",
             id.x(), id.y(), id.z());
 
         _dirty_chunks.erase(id);
@@ -288,7 +512,9 @@ namespace astre::asset
         for(const auto & id : dirty)
             if(!co_await _persistChunkIfDirty(id)) co_return false;
 
-        co_return true;
+        const bool drained = co_await _write_queue->drain();
+        co_await _cache.ensureOnStrand();
+        co_return drained;
     }
 
     asio::awaitable<bool> WorldStreamer::unloadCachedChunks(const std::vector<proto::file::ChunkID> & ids)
@@ -312,7 +538,12 @@ namespace astre::asset
         co_await _unloadChunk(id);
         _to_reload.erase(id);
         _dirty_chunks.erase(id);
+        _prefetched.erase(id);
+        _cancelPrefetch(id);
+        _write_queue->discard(id);
 
-        co_return _archive->removeChunk(id);
+        const bool removed = _archive->removeChunk(id);
+        _compactArchiveIfNeeded();
+        co_return removed;
     }
 }
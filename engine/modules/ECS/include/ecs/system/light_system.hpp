@@ -15,7 +15,7 @@ namespace astre::ecs::system
         using Reads = std::tuple<proto::ecs::TransformComponent>;
         using Writes = std::tuple<proto::ecs::CameraComponent>;
 
-        static constexpr uint16_t MAX_LIGHTS = 256;
+        static constexpr uint16_t MAX_LIGHTS = 1024;
         static constexpr uint16_t MAX_SHADOW_CASTERS = 16;
 
         LightSystem(Registry & registry);
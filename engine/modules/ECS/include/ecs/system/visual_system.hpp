@@ -3,7 +3,10 @@
 #include <optional>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+
 #include "render/render.hpp"
+#include "render/raycast_scene.hpp"
 #include "ecs/system/system.hpp"
 
 #include "proto/ECS/components/visual_component.pb.h"
@@ -19,7 +22,8 @@ namespace astre::ecs::system
         VisualSystem(const render::IRenderer & renderer, Registry & registry);
 
         inline VisualSystem(VisualSystem && other)
-            : System(std::move(other)), _renderer(other._renderer)
+            : System(std::move(other)), _renderer(other._renderer), _lod_levels(std::move(other._lod_levels)),
+            _raycast_scene(std::move(other._raycast_scene))
         {}
 
         VisualSystem & operator=(VisualSystem && other) = delete;
@@ -30,6 +34,9 @@ namespace astre::ecs::system
         ~VisualSystem() = default;
         
         asio::awaitable<void> run(float dt, render::Frame & frame);
+
+        // proxies of the last run, for CPU picking and gameplay ray casts
+        const render::RaycastScene & getRaycastScene() const { return _raycast_scene; }
         
         std::vector<std::type_index> getReads() const override {
             return expand<Reads>();
@@ -42,5 +49,10 @@ namespace astre::ecs::system
 
     private:
         const render::IRenderer & _renderer;
+
+        // LOD selected in previous run, kept for hysteresis
+        absl::flat_hash_map<Entity, std::size_t> _lod_levels;
+
+        render::RaycastScene _raycast_scene;
     };
 }
\ No newline at end of file
@@ -14,6 +14,10 @@ namespace astre::ecs::system
     asio::awaitable<void> VisualSystem::run(float dt, render::Frame & frame)
     {
         frame.render_proxies.clear();
+
+        // LOD selection uses camera written by CameraSystem earlier this frame
+        const unsigned int viewport_height = _renderer.getViewportSize().second;
+        absl::flat_hash_map<Entity, std::size_t> lod_levels;
         
         std::optional<std::size_t> vb_id;
         std::optional<std::size_t> sh_id;
@@ -33,6 +37,23 @@ namespace astre::ecs::system
 
                 frame.render_proxies[e].vertex_buffer = *vb_id;
                 frame.render_proxies[e].shader = *sh_id;
+                frame.render_proxies[e].bounds = _renderer.getVertexBufferBounds(*vb_id);
+
+                // bounds stay those of LOD 0, coarser levels only swap the vertex buffer
+                const auto lods = _renderer.getVertexBufferLODs(*vb_id);
+                if(lods.size() > 1 && frame.render_proxies[e].bounds)
+                {
+                    const float pixels_per_unit = render::pixelsPerMeshUnit(*frame.render_proxies[e].bounds,
+                        math::deserialize(transform_component.transform_matrix()),
+                        frame.camera_position, frame.proj_matrix, viewport_height);
+
+                    const auto previous_it = _lod_levels.find(e);
+                    const std::size_t level = render::selectLOD(lods, pixels_per_unit,
+                        previous_it != _lod_levels.end() ? previous_it->second : 0);
+
+                    frame.render_proxies[e].vertex_buffer = lods[level].vertex_buffer;
+                    lod_levels[e] = level;
+                }
 
                 frame.render_proxies[e].inputs.in_bool["useTexture"] = false;
                 
@@ -57,6 +78,12 @@ namespace astre::ecs::system
 
         );
 
+        // entities gone since last run drop out here
+        _lod_levels = std::move(lod_levels);
+
+        // refitted while the same proxies stay, rebuilt otherwise
+        _raycast_scene.update(frame.render_proxies, _renderer);
+
         co_return;
     }     
     
@@ -15,6 +15,7 @@ namespace astre::entry
         const std::filesystem::path assets;
         const std::filesystem::path saves;
         const std::filesystem::path logs;
+        const std::filesystem::path cache; // data derived from resources, safe to delete
 
         explicit AppPaths(const std::filesystem::path& baseDir);
     };
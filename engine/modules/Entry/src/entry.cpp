@@ -20,7 +20,8 @@ namespace astre::entry
             resources(base / "resources"),
             assets(base / "assets"),
             saves(base / "saves"),
-            logs(base / "logs")
+            logs(base / "logs"),
+            cache(base / "cache")
     {}
 }
 
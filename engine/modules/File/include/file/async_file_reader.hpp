@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "native/native.h"
+#include <asio.hpp>
+
+#include "async/async.hpp"
+
+namespace astre::file
+{
+    // reads submitted to the kernel per system call
+    constexpr unsigned int DEFAULT_READ_QUEUE_DEPTH = 64;
+
+    // Awaitable batched reads for the asset sources. A batch is handed to a dedicated
+    // I/O thread which reads it with native::BatchFileReader (one io_uring submission
+    // per queue depth on Linux), so pool threads keep running CPU work while hundreds
+    // of chunks or meshes load. The awaiting coroutine resumes on its own executor.
+    // Batches are read one after another; read() is safe to call concurrently.
+    class AsyncFileReader
+    {
+        public:
+            explicit AsyncFileReader(unsigned int queue_depth = DEFAULT_READ_QUEUE_DEPTH);
+
+            AsyncFileReader(const AsyncFileReader &) = delete;
+            AsyncFileReader & operator=(const AsyncFileReader &) = delete;
+
+            // finishes the batches already posted, then stops the I/O thread
+            ~AsyncFileReader();
+
+            // contents of every request in order, nullopt for the ones that failed
+            asio::awaitable<std::vector<std::optional<std::string>>> read(std::vector<native::ReadRequest> requests);
+
+            // whether the platform reader submits batches to io_uring
+            bool batched() const { return _batched; }
+
+        private:
+            std::unique_ptr<async::ThreadContext> _io;
+            native::BatchFileReader _reader; // I/O thread only
+            bool _batched;
+    };
+
+    // The same requests read on the calling thread, for the synchronous read() of the sources.
+    std::vector<std::optional<std::string>> readFiles(const std::vector<native::ReadRequest> & requests);
+}
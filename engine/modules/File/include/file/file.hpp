@@ -1,10 +1,16 @@
 #pragma once
 
 #include "file/data_type.hpp"
+#include "file/file_utils.hpp"
+#include "file/async_file_reader.hpp"
+#include "file/record_compressor.hpp"
 #include "file/world_file.hpp"
 #include "file/shader_file.hpp"
 #include "file/script_file.hpp"
+#include "file/mesh_cache.hpp"
 #include "file/mesh_file.hpp"
+#include "file/mesh_optimizer.hpp"
+#include "file/mesh_simplifier.hpp"
 
 namespace astre::file
 {
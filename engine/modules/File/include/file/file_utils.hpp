@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <string_view>
+
+namespace astre::file
+{
+    constexpr std::uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+
+    /**
+     * @brief FNV-1a of `size` bytes, continuing from `hash`
+     *
+     * Content keys and checksums of on-disk caches and archives, also cheap enough
+     * to fingerprint per-frame render state. Not meant to resist deliberate collisions.
+     */
+    inline std::uint64_t hashBytes(std::uint64_t hash, const void * data, std::size_t size)
+    {
+        const auto * bytes = static_cast<const std::uint8_t *>(data);
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    inline std::uint64_t hashBytes(const void * data, std::size_t size)
+    {
+        return hashBytes(FNV_OFFSET_BASIS, data, size);
+    }
+
+    /**
+     * @brief Replace `path` with `parts` written one after another
+     *
+     * Parts go to a temporary file next to `path` that is then renamed over it, so readers
+     * see the old file or the whole new one, never a truncated write. The temporary is
+     * named per thread, threads writing the same path at once do not clobber each other.
+     * Missing parent directories are created.
+     */
+    bool writeFileAtomically(const std::filesystem::path & path, std::initializer_list<std::string_view> parts);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "proto/Render/mesh_definition.pb.h"
+
+namespace astre::file
+{
+    // Bumped whenever the blob layout or the steps MeshFile runs after the import
+    // (optimizeMesh, generateMeshLODs) change, so older entries simply miss.
+    constexpr std::uint32_t COOKED_MESH_VERSION = 3;
+
+    /**
+     * @brief On-disk cache of imported, optimized meshes
+     *
+     * Meshes are keyed by a hash of the source file contents, its format hint and the
+     * import flags, so an edited model or a changed import simply misses the cache.
+     * An entry also lists the files the import opened besides the source (OBJ materials,
+     * glTF buffers) with a hash of their contents, `load` misses once any of them changed.
+     * An entry is the raw vertex (position, normal, uv) and index arrays of every LOD
+     * plus the bounds, read back through a memory mapping without touching assimp.
+     * The name is not stored; identical sources share one entry.
+     * Every mesh is one file in `directory`, replaced with file::writeFileAtomically.
+     * Safe to use from many threads at once (asset::MeshStreamer parses over the pool).
+     */
+    class CookedMeshCache
+    {
+        public:
+            explicit CookedMeshCache(std::filesystem::path directory);
+
+            /**
+             * @param format assimp format hint the source is imported with
+             */
+            std::uint64_t key(std::string_view source, std::string_view format, std::uint32_t import_flags) const;
+
+            /**
+             * @param source_directory the listed dependencies are resolved against
+             * @return `std::nullopt` if there is no entry, it is damaged or written for another key,
+             *         or a dependency is gone or differs from the one the entry was cooked from
+             */
+            std::optional<proto::render::MeshDefinition> load(std::uint64_t key,
+                const std::filesystem::path & source_directory = {}) const;
+
+            /**
+             * @param dependencies files the import opened besides the source, hashed now and
+             *        kept relative to `source_directory`
+             */
+            bool store(std::uint64_t key, const proto::render::MeshDefinition & mesh_def,
+                const std::filesystem::path & source_directory = {},
+                const std::vector<std::filesystem::path> & dependencies = {}) const;
+
+            const std::filesystem::path & directory() const;
+
+        private:
+            std::filesystem::path entryPath(std::uint64_t key) const;
+
+            std::filesystem::path _directory;
+    };
+}
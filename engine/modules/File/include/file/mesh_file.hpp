@@ -1,7 +1,14 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <optional>
+#include <string>
+#include <vector>
+
+#include "native/native.h"
+
+#include "file/mesh_cache.hpp"
 
 #include "proto/Render/mesh_definition.pb.h"
 
@@ -9,13 +16,31 @@ namespace astre::file
 {
     // Stateless disk reader for meshes, backed by assimp. read(file) imports the
     // model at `file`, naming the definition by `file.stem()`, and flattens every
-    // submesh into one vertex/index buffer. OBJ today; assimp handles the rest once
+    // submesh into one vertex/index buffer, then reorders it with optimizeMesh
+    // (mesh_optimizer.hpp) and fills its LODs (mesh_simplifier.hpp). OBJ and glTF today; assimp handles the rest once
     // more importers are enabled. File owns disk IO; Asset only ever sees the
     // in-memory definition. Stateless and touches an independent file, so it is safe
     // to call concurrently (asset::MeshStreamer fans reads over the pool).
+    // read() is parse() of requests() read on the calling thread, see ShaderFile;
+    // parse() imports through the path with the model served from `contents`, files
+    // it references (OBJ materials, glTF buffers) are opened from disk next to it.
+    // With a CookedMeshCache, parse() looks the source bytes up there first and only
+    // imports, optimizes and simplifies on a miss, storing the result for next time.
     class MeshFile
     {
         public:
+            MeshFile() = default;
+
+            explicit MeshFile(std::shared_ptr<const CookedMeshCache> cache);
+
             std::optional<proto::render::MeshDefinition> read(const std::filesystem::path & file) const;
+
+            std::vector<native::ReadRequest> requests(const std::filesystem::path & file) const;
+
+            std::optional<proto::render::MeshDefinition> parse(const std::filesystem::path & file,
+                std::vector<std::optional<std::string>> contents) const;
+
+        private:
+            std::shared_ptr<const CookedMeshCache> _cache;
     };
 }
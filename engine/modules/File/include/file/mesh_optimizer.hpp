@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math/math.hpp"
+
+#include "proto/Render/mesh_definition.pb.h"
+
+namespace astre::file
+{
+    // Import-time index/vertex reordering, run by MeshFile::read after the assimp
+    // flatten and before the definition reaches asset::MeshStreamer's cache. Pure CPU
+    // and stateless, so it runs on whichever pool thread did the read.
+    //
+    //  1. vertex cache: Forsyth's linear-speed ordering, triangles emitted so recently
+    //     transformed vertices are reused while still in the post-transform cache
+    //  2. overdraw: the cache-ordered triangles are cut into clusters at cache restarts
+    //     and clusters are sorted outward-facing first; rejected if ACMR degrades by
+    //     more than `threshold`
+    //  3. vertex fetch: vertices renumbered in order of first use so the vertex fetch
+    //     walks the buffer linearly, unreferenced vertices are dropped
+
+    // cache size the ordering is tuned for
+    constexpr std::size_t VERTEX_CACHE_SIZE = 32;
+
+    /**
+     * @brief Average cache miss ratio: transformed vertices per triangle for a FIFO cache
+     *
+     * @return 3.0 worst case, ~0.5 ideal for regular grids
+     */
+    float computeACMR(const std::vector<std::uint32_t> & indices, std::size_t vertex_count, std::size_t cache_size);
+
+    std::vector<std::uint32_t> optimizeVertexCache(const std::vector<std::uint32_t> & indices, std::size_t vertex_count);
+
+    std::vector<std::uint32_t> optimizeOverdraw(const std::vector<std::uint32_t> & indices,
+        const std::vector<math::Vec3> & positions, float threshold = 1.05f);
+
+    /**
+     * @brief Vertex renumbering in order of first use
+     *
+     * @return old index -> new index, `UINT32_MAX` for unreferenced vertices
+     */
+    std::vector<std::uint32_t> optimizeVertexFetchRemap(const std::vector<std::uint32_t> & indices, std::size_t vertex_count);
+
+    /**
+     * @brief Run all stages on the definition in place
+     *
+     * @return false if the definition was left untouched (not a valid triangle list)
+     */
+    bool optimizeMesh(proto::render::MeshDefinition & mesh_def);
+    bool optimizeMesh(proto::render::MeshLODDefinition & lod_def);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math/math.hpp"
+
+#include "proto/Render/mesh_definition.pb.h"
+
+namespace astre::file
+{
+    // Import-time LOD generation, run by MeshFile::read after optimizeMesh. Quadric
+    // error metric edge collapse (Garland & Heckbert) restricted to collapsing a
+    // vertex onto one of its neighbours, so every LOD reuses LOD 0 vertex data and
+    // only the index buffer shrinks. Open borders may only slide along the border and
+    // attribute seams (coincident positions, different normal/uv) never move, so LODs
+    // do not tear. LODs are stored in `MeshDefinition::lods`, each compacted to the
+    // vertices it uses and reordered with the mesh optimizer.
+
+    // number of LODs generated on import, each targets half of the previous triangles
+    constexpr std::size_t MESH_LOD_COUNT = 3;
+
+    // stop simplifying once deviation reaches this fraction of the mesh extent
+    constexpr float MESH_LOD_MAX_ERROR = 0.05f;
+
+    /**
+     * @brief Simplify triangle list towards `target_index_count` indices
+     *
+     * @param target_error largest allowed deviation from the input surface, in mesh units
+     * @param result_error if not null, receives the deviation of the result, in mesh units
+     * @return indices into the same `positions`; may stop above target when `target_error` is reached
+     */
+    std::vector<std::uint32_t> simplifyMesh(const std::vector<std::uint32_t> & indices,
+        const std::vector<math::Vec3> & positions,
+        std::size_t target_index_count,
+        float target_error,
+        float * result_error = nullptr);
+
+    /**
+     * @brief Fill `mesh_def.lods` with up to `lod_count` coarser versions of the mesh
+     *
+     * LOD generation stops early once a level cannot remove at least 20% of the previous one.
+     *
+     * @return number of generated LODs
+     */
+    std::size_t generateMeshLODs(proto::render::MeshDefinition & mesh_def, std::size_t lod_count = MESH_LOD_COUNT);
+}
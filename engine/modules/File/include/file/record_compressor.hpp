@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace astre::file
+{
+    // zstd level records are compressed with by default, 0 stores them raw
+    constexpr int DEFAULT_RECORD_COMPRESSION_LEVEL = 3;
+
+    // upper bound of a trained dictionary
+    constexpr std::size_t RECORD_DICTIONARY_CAPACITY = 64 * 1024;
+
+    /**
+     * @brief zstd compression of archive records, with an optional shared dictionary
+     *
+     * Records of one archive are small and alike (entities of near-identical components),
+     * so a dictionary trained from them carries most of their redundancy. Immutable once
+     * constructed, compress/decompress are safe to call concurrently.
+     */
+    class RecordCompressor
+    {
+        public:
+            explicit RecordCompressor(int level = DEFAULT_RECORD_COMPRESSION_LEVEL, std::string dictionary = {});
+            ~RecordCompressor();
+
+            RecordCompressor(const RecordCompressor &) = delete;
+            RecordCompressor & operator=(const RecordCompressor &) = delete;
+
+            /**
+             * @brief Train a dictionary from sample records
+             *
+             * @return empty if there are too few samples to train from
+             */
+            static std::string trainDictionary(const std::vector<std::string> & samples, std::size_t capacity = RECORD_DICTIONARY_CAPACITY);
+
+            /**
+             * @return zstd frame, `std::nullopt` if compression is disabled or fails
+             */
+            std::optional<std::string> compress(std::string_view data) const;
+
+            /**
+             * @return `std::nullopt` if the frame is damaged or needs another dictionary
+             */
+            std::optional<std::string> decompress(std::string_view frame) const;
+
+            bool enabled() const { return _level > 0; }
+            int level() const { return _level; }
+            const std::string & dictionary() const { return _dictionary; }
+
+        private:
+            struct CDictDeleter { void operator()(ZSTD_CDict_s * dictionary) const; };
+            struct DDictDeleter { void operator()(ZSTD_DDict_s * dictionary) const; };
+
+            int _level;
+            std::string _dictionary;
+            std::unique_ptr<ZSTD_CDict_s, CDictDeleter> _compression_dictionary;
+            std::unique_ptr<ZSTD_DDict_s, DDictDeleter> _decompression_dictionary;
+    };
+}
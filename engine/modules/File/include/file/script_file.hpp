@@ -2,6 +2,10 @@
 
 #include <filesystem>
 #include <optional>
+#include <string>
+#include <vector>
+
+#include "native/native.h"
 
 #include "proto/Script/script_definition.pb.h"
 
@@ -11,10 +15,16 @@ namespace astre::file
     // `file`, naming the definition by `file.stem()`. File owns disk IO; Asset
     // only ever sees the in-memory definition. Stateless and touches an
     // independent file, so it is safe to call concurrently (asset::ScriptStreamer
-    // fans reads over the pool).
+    // fans reads over the pool). read() is parse() of requests() read on the
+    // calling thread, see ShaderFile.
     class ScriptFile
     {
         public:
             std::optional<proto::script::ScriptDefinition> read(const std::filesystem::path & file) const;
+
+            std::vector<native::ReadRequest> requests(const std::filesystem::path & file) const;
+
+            std::optional<proto::script::ScriptDefinition> parse(const std::filesystem::path & file,
+                std::vector<std::optional<std::string>> contents) const;
     };
 }
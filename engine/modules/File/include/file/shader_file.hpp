@@ -2,6 +2,10 @@
 
 #include <filesystem>
 #include <optional>
+#include <string>
+#include <vector>
+
+#include "native/native.h"
 
 #include "proto/Render/shader_definition.pb.h"
 
@@ -12,9 +16,17 @@ namespace astre::file
     // the definition by `dir.stem()`. File owns disk IO; Asset only ever sees the
     // in-memory definition. Stateless and touches independent files, so it is safe
     // to call concurrently (asset::ShaderStreamer fans reads over the pool).
+    // read() is requests() read on the calling thread, then parse(); batched
+    // streaming reads the requests through file::AsyncFileReader instead.
     class ShaderFile
     {
         public:
             std::optional<proto::render::ShaderDefinition> read(const std::filesystem::path & dir) const;
+
+            // vertex stage, then fragment stage
+            std::vector<native::ReadRequest> requests(const std::filesystem::path & dir) const;
+
+            std::optional<proto::render::ShaderDefinition> parse(const std::filesystem::path & dir,
+                std::vector<std::optional<std::string>> contents) const;
     };
 }
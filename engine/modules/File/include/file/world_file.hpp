@@ -5,17 +5,24 @@
 #include <memory>
 #include <optional>
 #include <vector>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
 
 #include <absl/container/flat_hash_map.h>
 #include <absl/container/flat_hash_set.h>
 
+#include "native/native.h"
 #include "type/type.hpp"
 
 #include "file/data_type.hpp"
+#include "file/record_compressor.hpp"
 
 #include "proto/ECS/entity_definition.pb.h"
 #include "proto/File/world_chunk.pb.h"
 #include "proto/File/world_file_data.pb.h"
+#include "proto/Math/math.pb.h"
 
 namespace astre::proto::file
 {
@@ -45,6 +52,15 @@ namespace astre::file
 
         std::streamoff offset;
         std::size_t size;
+
+        std::uint64_t checksum = 0; // binary archive only
+    };
+
+    // Chunk an entity was last written in, with its position there.
+    struct EntityLocation
+    {
+        proto::file::ChunkID chunk;
+        std::optional<proto::math::Vec3Serialized> position; // absent if the entity has no transform
     };
     
     class IWorldFile : type::InterfaceBase
@@ -55,22 +71,47 @@ namespace astre::file
             virtual bool writeChunk(const proto::file::WorldChunk & chunk) = 0;
 
             // Source-read shape (like file::ShaderFile/ScriptFile::read): loads one
-            // chunk off disk by id. const + uses a local stream per call, so
-            // concurrent reads are safe — that is what lets asset::WorldStreamer
+            // chunk off disk by id. const + parses from a shared read-only mapping
+            // (binary) or a local stream per call (json), so concurrent reads are safe — that is what lets asset::WorldStreamer
             // fan chunk loads over the pool through asset::streamAssets.
-            // reads are concurrent-safe among themselves; a concurrent
-            // write()/remove() (editor) still mutates the index unsynchronized —
-            // fine today (streaming and edits don't overlap), revisit if they do.
+            // reads are concurrent-safe among themselves and both archives guard
+            // their indexes against write()/remove()/compact(); the json one still
+            // rewrites its file unsynchronized with readers of it.
             virtual std::optional<proto::file::WorldChunk> read(const proto::file::ChunkID& id) const = 0;
 
+            // read() split for batched streaming (file::AsyncFileReader): the byte ranges
+            // the chunk is stored in, and the chunk decoded from their contents. parse()
+            // falls back to read() if there are no ranges (json) or they went stale in
+            // between because compaction moved the record.
+            virtual std::vector<native::ReadRequest> requests(const proto::file::ChunkID & id) const = 0;
+            virtual std::optional<proto::file::WorldChunk> parse(const proto::file::ChunkID & id,
+                std::vector<std::optional<std::string>> contents) const = 0;
+
             virtual bool removeChunk(const proto::file::ChunkID& id) = 0;
 
-            virtual const absl::flat_hash_set<proto::file::ChunkID> & getAllChunks() const = 0;
+            // Copy of the stored chunk ids. Not a reference: the write-behind queue
+            // mutates the archive from its own thread while streaming iterates this.
+            virtual absl::flat_hash_set<proto::file::ChunkID> getAllChunks() const = 0;
+
+            virtual bool containsChunk(const proto::file::ChunkID & id) const = 0;
 
 
             virtual bool writeEntity(const proto::file::ChunkID & chunk_id, const proto::ecs::EntityDefinition & entity_def) = 0;
 
             virtual bool removeEntity(const proto::file::ChunkID & chunk_id, const proto::ecs::EntityDefinition & entity_def) = 0;
+
+            // Where the entity was last written, without reading any chunk. The index is
+            // kept up to date by the mutating calls; if two chunks hold the same entity
+            // the one written last wins.
+            virtual std::optional<EntityLocation> findEntity(std::uint64_t entity) const = 0;
+
+            // Whether superseded data takes enough space for compact() to pay off.
+            virtual bool needsCompaction() const = 0;
+
+            // Reclaims space of superseded chunk versions. Blocking, meant to run on the
+            // pool; safe to call concurrently with read() and the mutating calls.
+            // Formats without dead space return true without doing anything.
+            virtual bool compact() = 0;
     };
 
     template<class Mode>
@@ -80,34 +121,121 @@ namespace astre::file
     class WorldFile<use_binary_t> : public IWorldFile
     {
         public:
-            WorldFile(std::filesystem::path file_path);
+            // compression_level: zstd level of records written from now on, 0 stores them raw
+            WorldFile(std::filesystem::path file_path, int compression_level = DEFAULT_RECORD_COMPRESSION_LEVEL);
+
+            // writes the table of contents, so the next open doesn't scan the log
+            ~WorldFile() override;
 
             // whether the archive opened + scanned successfully at construction
             bool good() const { return _valid; }
 
+            // format version of the opened file, 0 for legacy archives without a header
+            std::uint32_t version() const { return _version; }
+
             bool writeChunk(const proto::file::WorldChunk & chunk) override;
             std::optional<proto::file::WorldChunk> read(const proto::file::ChunkID& id) const override;
+            std::vector<native::ReadRequest> requests(const proto::file::ChunkID & id) const override;
+            std::optional<proto::file::WorldChunk> parse(const proto::file::ChunkID & id,
+                std::vector<std::optional<std::string>> contents) const override;
             bool removeChunk(const proto::file::ChunkID& id) override;
-            const absl::flat_hash_set<proto::file::ChunkID> & getAllChunks() const override;
+            absl::flat_hash_set<proto::file::ChunkID> getAllChunks() const override;
+            bool containsChunk(const proto::file::ChunkID & id) const override;
 
             bool writeEntity(const proto::file::ChunkID & chunk_id, const proto::ecs::EntityDefinition & entity_def) override;
             bool removeEntity(const proto::file::ChunkID & chunk_id, const proto::ecs::EntityDefinition & entity_def) override;
 
+            std::optional<EntityLocation> findEntity(std::uint64_t entity) const override;
+
+            bool needsCompaction() const override;
+            bool compact() override;
+
+            // bytes of records superseded by a newer version or a tombstone
+            std::size_t deadBytes() const;
+
+            // size of the dictionary records are compressed with, trained by compact()
+            std::size_t dictionarySize() const;
+
     private:
+        // compaction pays off once dead records take at least this much
+        // and at least as much as live ones
+        static constexpr std::size_t COMPACTION_MIN_DEAD_BYTES = 1 << 20;
+
         bool _openStream(std::ios::openmode mode);
         bool _closeStream();
 
-        // Whole-file read/rewrite. The binary format is a flat stream of delimited
-        // chunks, so any mutation (write/remove) rewrites the file and rebuilds the
-        // offset index — the same all-or-nothing approach WorldFile<use_json_t> uses.
-        std::vector<proto::file::WorldChunk> _readAllChunks() const;
-        bool _writeAllChunks(const std::vector<proto::file::WorldChunk> & chunks);
+        // Appends one delimited record at the end of the log, O(record) regardless
+        // of the archive size. Caller holds the exclusive lock.
+        std::optional<ChunkIndexEntry> _appendRecord(const std::string & payload);
+
+        // Loads the index from the table of contents at the end of the file,
+        // false if there is none or it doesn't match the file. `entities_indexed`
+        // tells whether it also held the entity index.
+        bool _readTableOfContents(std::istream & stream, std::streamoff file_size, std::streamoff & log_end, bool & entities_indexed);
+
+        // Replaces the entities indexed for the chunk with the ones it holds now.
+        // Caller holds the exclusive lock.
+        void _indexEntities(const proto::file::WorldChunk & chunk);
+
+        // Drops the entities indexed for the chunk. Caller holds the exclusive lock.
+        void _unindexEntities(const proto::file::ChunkID & id);
+
+        // Reads every live chunk to index its entities, for archives whose table of
+        // contents doesn't carry the index. Only called from the constructor; the
+        // table of contents is written again on close so the next open has the index.
+        void _rebuildEntityIndex();
+
+        // Replays records in [begin, end), the last record of every chunk wins.
+        void _scanLog(std::istream & stream, std::streamoff begin, std::streamoff end);
+
+        // Chunk of a record payload whose checksum was verified. Caller holds the shared lock.
+        std::optional<proto::file::WorldChunk> _parseRecord(const proto::file::ChunkID & id, const char * payload, std::size_t size) const;
+
+        // Mapped view of the archive, mapped by the first read after a mutation.
+        // Caller holds the shared lock, null if the file could not be mapped.
+        const native::MappedFile * _mapped() const;
+
+        // Drops the mapped view before the file is modified. Caller holds the exclusive lock,
+        // so no reader uses the view anymore.
+        void _unmap();
 
         std::filesystem::path _file_path;
         std::fstream _stream;
         bool _valid = false;
         absl::flat_hash_set<proto::file::ChunkID> _all_chunks;
         absl::flat_hash_map<proto::file::ChunkID, ChunkIndexEntry> _chunk_index;
+        absl::flat_hash_map<std::uint64_t, EntityLocation> _entity_index;
+        absl::flat_hash_map<proto::file::ChunkID, std::vector<std::uint64_t>> _chunk_entities; // entities indexed per chunk
+
+        // The binary format is an append-only log of delimited records: writing a
+        // chunk appends its new version, removing one appends a tombstone, and the
+        // index points at the latest live version. Superseded records stay in the
+        // file as dead bytes until compact() rewrites the live ones.
+        // Versioned files start with a header and end with a table of contents,
+        // which is cut off before the first append and written again on close.
+        // Without it (legacy file, or the process died) the log is replayed at open.
+        // The table of contents also stores the entity index, so findEntity() needs
+        // no chunk read even right after open.
+        // _mutex guards the indexes, log size and dead bytes. Readers take it shared,
+        // appends and the final swap of compact() take it exclusive.
+        // Since version 2 records are compressed with zstd if that makes them smaller,
+        // with a dictionary stored in the header. compact() trains a new one from
+        // the live chunks and recompresses them.
+        mutable std::shared_mutex _mutex;
+        std::uint32_t _version = 0;
+        std::streamoff _log_begin = 0; // end of the header
+        int _compression_level;
+        std::shared_ptr<const RecordCompressor> _compressor; // null for versions without compression
+        bool _has_table_of_contents = false;
+        bool _table_of_contents_stale = false; // present but without the entity index
+        std::streamoff _log_size = 0;
+        std::size_t _dead_bytes = 0;
+        std::atomic<bool> _compacting = false;
+
+        // Reads parse chunks straight from the mapping, so concurrent reads share
+        // one view instead of opening the file each. Appends and compaction drop it.
+        mutable std::mutex _mapping_mutex;
+        mutable std::optional<native::MappedFile> _mapping;
     };
 
 
@@ -122,22 +250,40 @@ namespace astre::file
 
             bool writeChunk(const proto::file::WorldChunk & chunk) override;
             std::optional<proto::file::WorldChunk> read(const proto::file::ChunkID& id) const override;
+            std::vector<native::ReadRequest> requests(const proto::file::ChunkID & id) const override;
+            std::optional<proto::file::WorldChunk> parse(const proto::file::ChunkID & id,
+                std::vector<std::optional<std::string>> contents) const override;
             bool removeChunk(const proto::file::ChunkID& id) override;
-            const absl::flat_hash_set<proto::file::ChunkID> & getAllChunks() const override;
+            absl::flat_hash_set<proto::file::ChunkID> getAllChunks() const override;
+            bool containsChunk(const proto::file::ChunkID & id) const override;
 
             bool writeEntity(const proto::file::ChunkID & chunk_id, const proto::ecs::EntityDefinition & entity_def) override;
             bool removeEntity(const proto::file::ChunkID & chunk_id, const proto::ecs::EntityDefinition & entity_def) override;
 
+            std::optional<EntityLocation> findEntity(std::uint64_t entity) const override;
+
+            // every mutation rewrites the whole file, nothing to reclaim
+            bool needsCompaction() const override { return false; }
+            bool compact() override { return true; }
+
     private:
         bool _openStream(std::ios::openmode mode);
         bool _closeStream();
         std::stringstream _readStream() const;
 
+        // every mutation has the whole file parsed anyway, so the index is rebuilt from it
+        void _indexEntities(const proto::file::WorldFileData & archive);
+
         std::filesystem::path _file_path;
         std::fstream _stream;
         bool _valid = false;
+
+        // _mutex guards the indexes only; the file itself is rewritten whole by
+        // every mutation and read with a local stream.
+        mutable std::shared_mutex _mutex;
         absl::flat_hash_set<proto::file::ChunkID> _all_chunks;
         absl::flat_hash_map<proto::file::ChunkID, ChunkIndexEntry> _chunk_index;
+        absl::flat_hash_map<std::uint64_t, EntityLocation> _entity_index;
     };
 
     // Stage-1 archive factory: picks the on-disk format from the mode tag. The
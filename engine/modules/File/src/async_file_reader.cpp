@@ -0,0 +1,69 @@
+#include "file/async_file_reader.hpp"
+
+#include <fstream>
+
+#include <spdlog/spdlog.h>
+
+namespace astre::file
+{
+    AsyncFileReader::AsyncFileReader(unsigned int queue_depth)
+    :   _io(std::make_unique<async::ThreadContext>()),
+        _reader(queue_depth),
+        _batched(_reader.batched())
+    {
+        _io->start([io = _io.get()]()
+        {
+            spdlog::debug("[async-file-reader] I/O thread started");
+            io->run();
+            spdlog::debug("[async-file-reader] I/O thread ended");
+        });
+    }
+
+    AsyncFileReader::~AsyncFileReader()
+    {
+        _io->close();
+        _io->join();
+    }
+
+    asio::awaitable<std::vector<std::optional<std::string>>> AsyncFileReader::read(std::vector<native::ReadRequest> requests)
+    {
+        auto caller = co_await asio::this_coro::executor;
+
+        co_await asio::post(_io->get_executor(), asio::use_awaitable);
+        auto contents = _reader.read(requests);
+
+        co_await asio::post(caller, asio::use_awaitable);
+        co_return contents;
+    }
+
+    std::vector<std::optional<std::string>> readFiles(const std::vector<native::ReadRequest> & requests)
+    {
+        std::vector<std::optional<std::string>> results(requests.size());
+        for(std::size_t i = 0; i < requests.size(); ++i)
+        {
+            const native::ReadRequest & request = requests[i];
+
+            std::ifstream in(request.path, std::ios::in | std::ios::binary);
+            if(!in.is_open()) continue;
+
+            std::size_t size = 0;
+            if(request.size)
+            {
+                size = *request.size;
+            }
+            else
+            {
+                in.seekg(0, std::ios::end);
+                const std::streamoff end = in.tellg();
+                if(end < 0 || (std::uint64_t)end < request.offset) continue;
+                size = (std::size_t)((std::uint64_t)end - request.offset);
+            }
+
+            std::string buffer(size, '\0');
+            in.seekg((std::streamoff)request.offset);
+            if(!in.read(buffer.data(), (std::streamsize)size)) continue;
+            results[i] = std::move(buffer);
+        }
+        return results;
+    }
+}
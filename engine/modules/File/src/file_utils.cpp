@@ -0,0 +1,54 @@
+#include "file/file_utils.hpp"
+
+#include <format>
+#include <fstream>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+#include <spdlog/spdlog.h>
+
+namespace astre::file
+{
+    bool writeFileAtomically(const std::filesystem::path & path, std::initializer_list<std::string_view> parts)
+    {
+        std::error_code ec;
+        if(path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path(), ec);
+            if(ec)
+            {
+                spdlog::warn("[file] Cannot create directory {} : {}", path.parent_path().string(), ec.message());
+                return false;
+            }
+        }
+
+        std::filesystem::path temporary_path = path;
+        temporary_path += std::format(".{:x}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if(!file.is_open())
+            {
+                spdlog::warn("[file] Cannot write {}", temporary_path.string());
+                return false;
+            }
+            for(const auto part : parts) file.write(part.data(), (std::streamsize)part.size());
+            if(!file.good())
+            {
+                spdlog::warn("[file] Cannot write {}", temporary_path.string());
+                file.close();
+                std::filesystem::remove(temporary_path, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary_path, path, ec);
+        if(ec)
+        {
+            spdlog::warn("[file] Cannot replace {} : {}", path.string(), ec.message());
+            std::filesystem::remove(temporary_path, ec);
+            return false;
+        }
+        return true;
+    }
+}
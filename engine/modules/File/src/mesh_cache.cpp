@@ -0,0 +1,352 @@
+#include "file/mesh_cache.hpp"
+
+#include <cstring>
+#include <format>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "native/native.h"
+
+#include "file/async_file_reader.hpp"
+#include "file/file_utils.hpp"
+#include "file/mesh_simplifier.hpp"
+
+namespace astre::file
+{
+    static constexpr std::uint32_t COOKED_MESH_MAGIC = 0x434d5341; // "ASMC"
+
+    // per vertex: position xyz, normal xyz, uv
+    static constexpr std::size_t COOKED_VERTEX_FLOATS = 8;
+
+    static constexpr std::uint32_t COOKED_MESH_QUANTIZE_POSITIONS = 1u << 0;
+    static constexpr std::uint32_t COOKED_MESH_HAS_BOUNDS = 1u << 1;
+
+    #pragma pack(push, 1)
+    struct CookedMeshHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t key;
+        std::uint32_t flags;
+        std::uint32_t level_count; // LOD 0 and every coarser LOD
+        std::uint32_t dependency_count; // files the import opened besides the source
+        float bounds_min[3];
+        float bounds_max[3];
+        float bounds_radius;
+        std::uint64_t size;     // of everything after the header
+        std::uint64_t checksum; // of everything after the header
+    };
+
+    // followed by `path_size` bytes of the path relative to the source directory
+    struct CookedDependencyHeader
+    {
+        std::uint64_t hash; // of the contents
+        std::uint32_t path_size;
+    };
+
+    // followed by `vertex_count` vertices of COOKED_VERTEX_FLOATS and `index_count` indices
+    struct CookedLevelHeader
+    {
+        std::uint32_t vertex_count;
+        std::uint32_t index_count;
+        float error;
+    };
+    #pragma pack(pop)
+
+    template<class Vertices>
+    static void _appendLevel(std::string & payload, const Vertices & vertices,
+        const google::protobuf::RepeatedField<std::uint32_t> & indices, float error)
+    {
+        const CookedLevelHeader level{
+            .vertex_count = (std::uint32_t)vertices.size(),
+            .index_count = (std::uint32_t)indices.size(),
+            .error = error
+        };
+        payload.append(reinterpret_cast<const char *>(&level), sizeof(level));
+
+        std::vector<float> data;
+        data.reserve(vertices.size() * COOKED_VERTEX_FLOATS);
+        for(const auto & vertex : vertices)
+        {
+            data.insert(data.end(), {
+                vertex.position().x(), vertex.position().y(), vertex.position().z(),
+                vertex.normal().x(), vertex.normal().y(), vertex.normal().z(),
+                vertex.uv().x(), vertex.uv().y()});
+        }
+        payload.append(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(float));
+        payload.append(reinterpret_cast<const char *>(indices.data()), indices.size() * sizeof(std::uint32_t));
+    }
+
+    // Reads one level at `offset`, advancing it. False if the level runs past `size`.
+    template<class Vertices>
+    static bool _readLevel(const std::byte * data, std::size_t size, std::size_t & offset,
+        Vertices & vertices, google::protobuf::RepeatedField<std::uint32_t> & indices, float & error)
+    {
+        CookedLevelHeader level;
+        if(size - offset < sizeof(level)) return false;
+        std::memcpy(&level, data + offset, sizeof(level));
+        offset += sizeof(level);
+
+        const std::size_t vertex_bytes = (std::size_t)level.vertex_count * COOKED_VERTEX_FLOATS * sizeof(float);
+        const std::size_t index_bytes = (std::size_t)level.index_count * sizeof(std::uint32_t);
+        if(size - offset < vertex_bytes || size - offset - vertex_bytes < index_bytes) return false;
+
+        // copied out, a mapping gives no alignment guarantee past the page
+        std::vector<float> floats(level.vertex_count * COOKED_VERTEX_FLOATS);
+        std::memcpy(floats.data(), data + offset, vertex_bytes);
+        offset += vertex_bytes;
+
+        vertices.Reserve((int)level.vertex_count);
+        for(std::size_t v = 0; v < level.vertex_count; ++v)
+        {
+            const float * f = floats.data() + v * COOKED_VERTEX_FLOATS;
+            auto * vertex = vertices.Add();
+            auto * position = vertex->mutable_position();
+            position->set_x(f[0]); position->set_y(f[1]); position->set_z(f[2]);
+            auto * normal = vertex->mutable_normal();
+            normal->set_x(f[3]); normal->set_y(f[4]); normal->set_z(f[5]);
+            auto * uv = vertex->mutable_uv();
+            uv->set_x(f[6]); uv->set_y(f[7]);
+        }
+
+        indices.Resize((int)level.index_count, 0);
+        std::memcpy(indices.mutable_data(), data + offset, index_bytes);
+        offset += index_bytes;
+
+        error = level.error;
+        return true;
+    }
+
+    // Appends every dependency with the hash of its current contents. False if one cannot be read.
+    static bool _appendDependencies(std::string & payload, const std::filesystem::path & source_directory,
+        const std::vector<std::filesystem::path> & dependencies)
+    {
+        std::vector<native::ReadRequest> requests;
+        requests.reserve(dependencies.size());
+        for(const auto & dependency : dependencies)
+            requests.push_back(native::ReadRequest{.path = dependency});
+
+        const auto contents = readFiles(requests);
+        for(std::size_t i = 0; i < dependencies.size(); ++i)
+        {
+            if(!contents[i]) return false;
+
+            // kept absolute when it lies on another root than the source
+            std::filesystem::path relative = dependencies[i].lexically_relative(source_directory);
+            if(relative.empty()) relative = dependencies[i];
+            const std::string path = relative.generic_string();
+
+            const CookedDependencyHeader dependency{
+                .hash = hashBytes(contents[i]->data(), contents[i]->size()),
+                .path_size = (std::uint32_t)path.size()
+            };
+            payload.append(reinterpret_cast<const char *>(&dependency), sizeof(dependency));
+            payload.append(path);
+        }
+        return true;
+    }
+
+    // Reads `count` dependencies at `offset`, advancing it. False if they run past `size`,
+    // or any of them is gone or changed since the entry was stored.
+    static bool _checkDependencies(const std::byte * data, std::size_t size, std::size_t & offset,
+        std::uint32_t count, const std::filesystem::path & source_directory)
+    {
+        std::vector<native::ReadRequest> requests;
+        std::vector<std::uint64_t> hashes;
+        requests.reserve(count);
+        hashes.reserve(count);
+        for(std::uint32_t i = 0; i < count; ++i)
+        {
+            CookedDependencyHeader dependency;
+            if(size - offset < sizeof(dependency)) return false;
+            std::memcpy(&dependency, data + offset, sizeof(dependency));
+            offset += sizeof(dependency);
+
+            if(size - offset < dependency.path_size) return false;
+            const std::string path(reinterpret_cast<const char *>(data + offset), dependency.path_size);
+            offset += dependency.path_size;
+
+            requests.push_back(native::ReadRequest{.path = source_directory / std::filesystem::path(path)});
+            hashes.push_back(dependency.hash);
+        }
+
+        const auto contents = readFiles(requests);
+        for(std::size_t i = 0; i < contents.size(); ++i)
+        {
+            if(!contents[i] || hashBytes(contents[i]->data(), contents[i]->size()) != hashes[i])
+            {
+                spdlog::debug("[mesh-cache] Dependency {} changed", requests[i].path.string());
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Maps the entry and validates its header and checksum, `data()` is null otherwise.
+    static native::MappedFile _mapEntry(const std::filesystem::path & path, std::uint64_t key, CookedMeshHeader & header)
+    {
+        // a miss is the common case on a first run, not worth the mapping error
+        std::error_code ec;
+        if(!std::filesystem::exists(path, ec)) return {};
+
+        native::MappedFile file(path);
+        if(file.data() == nullptr || file.size() < sizeof(header)) return {};
+
+        std::memcpy(&header, file.data(), sizeof(header));
+        if(header.magic != COOKED_MESH_MAGIC || header.version != COOKED_MESH_VERSION || header.key != key)
+        {
+            spdlog::debug("[mesh-cache] Cooked mesh {:016x} has unexpected header", key);
+            return {};
+        }
+
+        if(header.size != file.size() - sizeof(header))
+        {
+            spdlog::debug("[mesh-cache] Cooked mesh {:016x} is truncated", key);
+            return {};
+        }
+
+        if(hashBytes(file.data() + sizeof(header), header.size) != header.checksum)
+        {
+            spdlog::debug("[mesh-cache] Cooked mesh {:016x} is damaged", key);
+            return {};
+        }
+
+        return file;
+    }
+
+    CookedMeshCache::CookedMeshCache(std::filesystem::path directory)
+    :   _directory(std::move(directory))
+    {}
+
+    std::uint64_t CookedMeshCache::key(std::string_view source, std::string_view format, std::uint32_t import_flags) const
+    {
+        std::uint64_t hash = FNV_OFFSET_BASIS;
+        hash = hashBytes(hash, &COOKED_MESH_VERSION, sizeof(COOKED_MESH_VERSION));
+        hash = hashBytes(hash, &import_flags, sizeof(import_flags));
+
+        // LOD generation settings shape the entry as much as the import does
+        const std::uint64_t lod_count = MESH_LOD_COUNT;
+        hash = hashBytes(hash, &lod_count, sizeof(lod_count));
+        hash = hashBytes(hash, &MESH_LOD_MAX_ERROR, sizeof(MESH_LOD_MAX_ERROR));
+
+        // length keeps ("ob", "j...") and ("obj", "...") apart
+        const std::uint64_t format_size = format.size();
+        hash = hashBytes(hash, &format_size, sizeof(format_size));
+        hash = hashBytes(hash, format.data(), format.size());
+        return hashBytes(hash, source.data(), source.size());
+    }
+
+    std::optional<proto::render::MeshDefinition> CookedMeshCache::load(std::uint64_t key,
+        const std::filesystem::path & source_directory) const
+    {
+        CookedMeshHeader header;
+        const native::MappedFile file = _mapEntry(entryPath(key), key, header);
+        if(file.data() == nullptr) return std::nullopt;
+
+        std::size_t offset = sizeof(header);
+        if(!_checkDependencies(file.data(), file.size(), offset, header.dependency_count, source_directory))
+        {
+            spdlog::debug("[mesh-cache] Cooked mesh {:016x} is stale", key);
+            return std::nullopt;
+        }
+
+        proto::render::MeshDefinition mesh_def;
+        mesh_def.set_quantize_positions((header.flags & COOKED_MESH_QUANTIZE_POSITIONS) != 0);
+        if(header.flags & COOKED_MESH_HAS_BOUNDS)
+        {
+            auto * bounds = mesh_def.mutable_bounds();
+            auto * aabb_min = bounds->mutable_aabb_min();
+            aabb_min->set_x(header.bounds_min[0]); aabb_min->set_y(header.bounds_min[1]); aabb_min->set_z(header.bounds_min[2]);
+            auto * aabb_max = bounds->mutable_aabb_max();
+            aabb_max->set_x(header.bounds_max[0]); aabb_max->set_y(header.bounds_max[1]); aabb_max->set_z(header.bounds_max[2]);
+            bounds->set_radius(header.bounds_radius);
+        }
+
+        for(std::uint32_t level = 0; level < header.level_count; ++level)
+        {
+            float error = 0.0f;
+            bool read = false;
+            if(level == 0)
+            {
+                read = _readLevel(file.data(), file.size(), offset, *mesh_def.mutable_vertices(), *mesh_def.mutable_indices(), error);
+            }
+            else
+            {
+                auto * lod = mesh_def.add_lods();
+                read = _readLevel(file.data(), file.size(), offset, *lod->mutable_vertices(), *lod->mutable_indices(), error);
+                lod->set_error(error);
+            }
+
+            if(!read)
+            {
+                spdlog::debug("[mesh-cache] Cooked mesh {:016x} level {} runs past the entry", key, level);
+                return std::nullopt;
+            }
+        }
+
+        if(offset != file.size() || mesh_def.vertices().empty())
+        {
+            spdlog::debug("[mesh-cache] Cooked mesh {:016x} does not match its header", key);
+            return std::nullopt;
+        }
+
+        return mesh_def;
+    }
+
+    bool CookedMeshCache::store(std::uint64_t key, const proto::render::MeshDefinition & mesh_def,
+        const std::filesystem::path & source_directory, const std::vector<std::filesystem::path> & dependencies) const
+    {
+        std::string payload;
+        if(!_appendDependencies(payload, source_directory, dependencies))
+        {
+            spdlog::warn("[mesh-cache] Cannot read dependencies of cooked mesh {:016x}", key);
+            return false;
+        }
+
+        _appendLevel(payload, mesh_def.vertices(), mesh_def.indices(), 0.0f);
+        for(const auto & lod : mesh_def.lods())
+            _appendLevel(payload, lod.vertices(), lod.indices(), lod.error());
+
+        std::uint32_t flags = 0;
+        if(mesh_def.quantize_positions()) flags |= COOKED_MESH_QUANTIZE_POSITIONS;
+        if(mesh_def.has_bounds()) flags |= COOKED_MESH_HAS_BOUNDS;
+
+        const auto & bounds = mesh_def.bounds();
+        const CookedMeshHeader header{
+            .magic = COOKED_MESH_MAGIC,
+            .version = COOKED_MESH_VERSION,
+            .key = key,
+            .flags = flags,
+            .level_count = (std::uint32_t)(1 + mesh_def.lods_size()),
+            .dependency_count = (std::uint32_t)dependencies.size(),
+            .bounds_min = {bounds.aabb_min().x(), bounds.aabb_min().y(), bounds.aabb_min().z()},
+            .bounds_max = {bounds.aabb_max().x(), bounds.aabb_max().y(), bounds.aabb_max().z()},
+            .bounds_radius = bounds.radius(),
+            .size = payload.size(),
+            .checksum = hashBytes(payload.data(), payload.size())
+        };
+
+        // pool threads cooking the same source at once each write their own temporary
+        if(!writeFileAtomically(entryPath(key), {
+            std::string_view(reinterpret_cast<const char *>(&header), sizeof(header)), payload}))
+        {
+            spdlog::warn("[mesh-cache] Cannot store cooked mesh {:016x}", key);
+            return false;
+        }
+        return true;
+    }
+
+    const std::filesystem::path & CookedMeshCache::directory() const
+    {
+        return _directory;
+    }
+
+    std::filesystem::path CookedMeshCache::entryPath(std::uint64_t key) const
+    {
+        return _directory / std::format("{:016x}.mesh", key);
+    }
+}
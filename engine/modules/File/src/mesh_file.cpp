@@ -1,34 +1,153 @@
 #include "file/mesh_file.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <limits>
 
 #include <spdlog/spdlog.h>
 
+#include <assimp/DefaultIOSystem.h>
 #include <assimp/Importer.hpp>
+#include <assimp/MemoryIOWrapper.h>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
 #include "math/math.hpp"
 
+#include "file/async_file_reader.hpp"
+#include "file/mesh_optimizer.hpp"
+#include "file/mesh_simplifier.hpp"
+
 namespace astre::file
 {
+    static constexpr unsigned int MESH_IMPORT_FLAGS =
+        aiProcess_Triangulate |
+        aiProcess_GenSmoothNormals |
+        aiProcess_JoinIdenticalVertices |
+        aiProcess_FlipUVs;
+
+    // Serves the model itself from the bytes read in the batch and everything it
+    // references (OBJ materials, glTF buffers) from disk, next to the model. The
+    // referenced files opened are recorded for the cooked entry.
+    class PrefetchedIOSystem : public Assimp::DefaultIOSystem
+    {
+        public:
+            PrefetchedIOSystem(const std::filesystem::path & file, const std::string & contents)
+            :   _file(file.lexically_normal()), _contents(contents)
+            {}
+
+            bool Exists(const char * path) const override
+            {
+                return isPrefetched(path) || Assimp::DefaultIOSystem::Exists(path);
+            }
+
+            Assimp::IOStream * Open(const char * path, const char * mode = "rb") override
+            {
+                if(isPrefetched(path))
+                    return new Assimp::MemoryIOStream(reinterpret_cast<const std::uint8_t *>(_contents.data()), _contents.size());
+
+                Assimp::IOStream * stream = Assimp::DefaultIOSystem::Open(path, mode);
+                const std::filesystem::path dependency = std::filesystem::path(path).lexically_normal();
+                if(stream && std::find(_dependencies.begin(), _dependencies.end(), dependency) == _dependencies.end())
+                    _dependencies.push_back(dependency);
+                return stream;
+            }
+
+            const std::vector<std::filesystem::path> & dependencies() const
+            {
+                return _dependencies;
+            }
+
+        private:
+            bool isPrefetched(const char * path) const
+            {
+                return std::filesystem::path(path).lexically_normal() == _file;
+            }
+
+            std::filesystem::path _file;
+            const std::string & _contents;
+            std::vector<std::filesystem::path> _dependencies;
+    };
+
+    // AABB of LOD 0 and the sphere around its middle, as render::computeBoundingVolume
+    static void _computeBounds(proto::render::MeshDefinition & mesh_def)
+    {
+        math::Vec3 aabb_min(std::numeric_limits<float>::max());
+        math::Vec3 aabb_max(std::numeric_limits<float>::lowest());
+        for(const auto & vertex : mesh_def.vertices())
+        {
+            const math::Vec3 position = math::deserialize(vertex.position());
+            aabb_min = glm::min(aabb_min, position);
+            aabb_max = glm::max(aabb_max, position);
+        }
+
+        const math::Vec3 center = (aabb_min + aabb_max) * 0.5f;
+        float radius2 = 0.0f;
+        for(const auto & vertex : mesh_def.vertices())
+        {
+            const math::Vec3 offset = math::deserialize(vertex.position()) - center;
+            radius2 = std::max(radius2, glm::dot(offset, offset));
+        }
+
+        auto * bounds = mesh_def.mutable_bounds();
+        *bounds->mutable_aabb_min() = math::serialize(aabb_min);
+        *bounds->mutable_aabb_max() = math::serialize(aabb_max);
+        bounds->set_radius(math::sqrt(radius2));
+    }
+
+    MeshFile::MeshFile(std::shared_ptr<const CookedMeshCache> cache)
+    :   _cache(std::move(cache))
+    {}
+
     std::optional<proto::render::MeshDefinition> MeshFile::read(const std::filesystem::path & file) const
+    {
+        if(!std::filesystem::exists(file))
+        {
+            spdlog::error("Mesh file does not exist: {}", file.string());
+            return std::nullopt;
+        }
+
+        return parse(file, readFiles(requests(file)));
+    }
+
+    std::vector<native::ReadRequest> MeshFile::requests(const std::filesystem::path & file) const
+    {
+        return { native::ReadRequest{.path = file} };
+    }
+
+    std::optional<proto::render::MeshDefinition> MeshFile::parse(const std::filesystem::path & file,
+        std::vector<std::optional<std::string>> contents) const
     {
         const std::string name = file.stem().string();
         spdlog::debug("[mesh-file] Reading mesh from file {}", file.string());
 
-        if(!std::filesystem::exists(file))
+        if(contents.size() != 1 || !contents[0])
         {
-            spdlog::error("Mesh file does not exist: {}", file.string());
+            spdlog::error("Failed to read mesh file: {}", file.string());
             return std::nullopt;
         }
 
+        // the extension without its dot, an .obj and a .gltf of the same bytes cook differently
+        std::string format = file.extension().string();
+        if(!format.empty()) format.erase(0, 1);
+
+        std::optional<std::uint64_t> cache_key;
+        if(_cache)
+        {
+            cache_key = _cache->key(*contents[0], format, MESH_IMPORT_FLAGS);
+            if(auto cooked = _cache->load(*cache_key, file.parent_path()))
+            {
+                spdlog::debug("[mesh-file] Mesh {} loaded from cooked entry {:016x}", file.string(), *cache_key);
+                cooked->set_name(name);
+                return cooked;
+            }
+        }
+
+        // imported through the path so relative references resolve, the importer owns the IO system
         Assimp::Importer importer;
-        const aiScene * scene = importer.ReadFile(file.string(),
-            aiProcess_Triangulate |
-            aiProcess_GenSmoothNormals |
-            aiProcess_JoinIdenticalVertices |
-            aiProcess_FlipUVs);
+        auto * io_system = new PrefetchedIOSystem(file, *contents[0]);
+        importer.SetIOHandler(io_system);
+        const aiScene * scene = importer.ReadFile(file.string(), MESH_IMPORT_FLAGS);
 
         if(scene == nullptr || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) || scene->mRootNode == nullptr)
         {
@@ -78,6 +197,14 @@ namespace astre::file
             return std::nullopt;
         }
 
+        // reorder for post-transform cache, overdraw and vertex fetch, then simplify
+        // into LODs, all before the cache sees the definition
+        optimizeMesh(mesh_def);
+        generateMeshLODs(mesh_def);
+        _computeBounds(mesh_def);
+
+        if(cache_key) _cache->store(*cache_key, mesh_def, file.parent_path(), io_system->dependencies());
+
         return mesh_def;
     }
 }
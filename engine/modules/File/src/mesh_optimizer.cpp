@@ -0,0 +1,339 @@
+#include "file/mesh_optimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include <spdlog/spdlog.h>
+
+namespace astre::file
+{
+    // Forsyth, "Linear-Speed Vertex Cache Optimisation" scoring constants
+    static constexpr float CACHE_DECAY_POWER = 1.5f;
+    static constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+    static constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    static constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+    static float _vertexScore(int cache_position, std::uint32_t remaining_triangles)
+    {
+        // no triangles left to emit, vertex is worthless
+        if(remaining_triangles == 0) return -1.0f;
+
+        float score = 0.0f;
+        if(cache_position >= 0)
+        {
+            // vertices of the last triangle get a fixed score so the next triangle
+            // does not prefer sharing an edge just emitted (strip-like, poor reuse)
+            if(cache_position < 3) score = LAST_TRIANGLE_SCORE;
+            else
+            {
+                const float scaler = 1.0f / (float)(VERTEX_CACHE_SIZE - 3);
+                score = std::pow(1.0f - (float)(cache_position - 3) * scaler, CACHE_DECAY_POWER);
+            }
+        }
+
+        // boost vertices with few triangles left, so we do not leave lone triangles behind
+        score += VALENCE_BOOST_SCALE * std::pow((float)remaining_triangles, -VALENCE_BOOST_POWER);
+        return score;
+    }
+
+    float computeACMR(const std::vector<std::uint32_t> & indices, std::size_t vertex_count, std::size_t cache_size)
+    {
+        if(indices.size() < 3) return 0.0f;
+
+        // FIFO cache via timestamps: vertex is resident if it was pushed less than cache_size pushes ago
+        std::vector<std::size_t> timestamps(vertex_count, 0);
+        std::size_t time = cache_size + 1;
+        std::size_t misses = 0;
+
+        for(const auto index : indices)
+        {
+            if(time - timestamps[index] > cache_size)
+            {
+                timestamps[index] = time++;
+                misses++;
+            }
+        }
+
+        return (float)misses / (float)(indices.size() / 3);
+    }
+
+    std::vector<std::uint32_t> optimizeVertexCache(const std::vector<std::uint32_t> & indices, std::size_t vertex_count)
+    {
+        const std::size_t triangle_count = indices.size() / 3;
+        if(triangle_count == 0) return indices;
+
+        // vertex -> triangles adjacency, live triangles of vertex v are
+        // adjacency[offsets[v], offsets[v] + remaining[v])
+        std::vector<std::uint32_t> remaining(vertex_count, 0);
+        for(const auto index : indices) remaining[index]++;
+
+        std::vector<std::uint32_t> offsets(vertex_count + 1, 0);
+        std::inclusive_scan(remaining.begin(), remaining.end(), offsets.begin() + 1);
+
+        std::vector<std::uint32_t> adjacency(indices.size());
+        {
+            std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for(std::size_t i = 0; i < indices.size(); ++i)
+                adjacency[fill[indices[i]]++] = (std::uint32_t)(i / 3);
+        }
+
+        std::vector<int> cache_position(vertex_count, -1);
+        std::vector<float> vertex_score(vertex_count);
+        for(std::size_t v = 0; v < vertex_count; ++v)
+            vertex_score[v] = _vertexScore(-1, remaining[v]);
+
+        std::vector<float> triangle_score(triangle_count, 0.0f);
+        for(std::size_t i = 0; i < indices.size(); ++i)
+            triangle_score[i / 3] += vertex_score[indices[i]];
+
+        std::vector<bool> emitted(triangle_count, false);
+
+        std::vector<std::uint32_t> cache;
+        std::vector<std::uint32_t> next_cache;
+        cache.reserve(VERTEX_CACHE_SIZE + 3);
+        next_cache.reserve(VERTEX_CACHE_SIZE + 3);
+
+        std::vector<std::uint32_t> result;
+        result.reserve(indices.size());
+
+        std::size_t best_triangle = std::distance(triangle_score.begin(),
+            std::max_element(triangle_score.begin(), triangle_score.end()));
+        std::size_t cursor = 0;
+
+        for(std::size_t step = 0; step < triangle_count; ++step)
+        {
+            if(best_triangle == std::numeric_limits<std::size_t>::max())
+            {
+                // nothing adjacent to the cache left, continue from the next unemitted triangle
+                while(emitted[cursor]) cursor++;
+                best_triangle = cursor;
+            }
+
+            const std::uint32_t * triangle = &indices[best_triangle * 3];
+            result.insert(result.end(), triangle, triangle + 3);
+            emitted[best_triangle] = true;
+
+            // detach emitted triangle from its vertices
+            for(int k = 0; k < 3; ++k)
+            {
+                const std::uint32_t v = triangle[k];
+                std::uint32_t * begin = &adjacency[offsets[v]];
+                std::uint32_t * end = begin + remaining[v];
+                std::uint32_t * it = std::find(begin, end, (std::uint32_t)best_triangle);
+                if(it == end) continue;
+                std::iter_swap(it, end - 1);
+                remaining[v]--;
+            }
+
+            // emitted vertices move to the front of the LRU cache
+            next_cache.clear();
+            for(int k = 0; k < 3; ++k)
+                if(std::find(next_cache.begin(), next_cache.end(), triangle[k]) == next_cache.end())
+                    next_cache.push_back(triangle[k]);
+            for(const auto v : cache)
+                if(std::find(next_cache.begin(), next_cache.end(), v) == next_cache.end())
+                    next_cache.push_back(v);
+
+            // rescore every vertex whose cache position changed, including those pushed out
+            for(std::size_t i = 0; i < next_cache.size(); ++i)
+            {
+                const std::uint32_t v = next_cache[i];
+                cache_position[v] = i < VERTEX_CACHE_SIZE ? (int)i : -1;
+
+                const float score = _vertexScore(cache_position[v], remaining[v]);
+                const float delta = score - vertex_score[v];
+                vertex_score[v] = score;
+
+                for(std::uint32_t j = 0; j < remaining[v]; ++j)
+                    triangle_score[adjacency[offsets[v] + j]] += delta;
+            }
+
+            if(next_cache.size() > VERTEX_CACHE_SIZE) next_cache.resize(VERTEX_CACHE_SIZE);
+            std::swap(cache, next_cache);
+
+            // next triangle is the best one touching the cache
+            best_triangle = std::numeric_limits<std::size_t>::max();
+            float best_score = -std::numeric_limits<float>::max();
+            for(const auto v : cache)
+            {
+                for(std::uint32_t j = 0; j < remaining[v]; ++j)
+                {
+                    const std::uint32_t t = adjacency[offsets[v] + j];
+                    if(triangle_score[t] > best_score)
+                    {
+                        best_score = triangle_score[t];
+                        best_triangle = t;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<std::uint32_t> optimizeOverdraw(const std::vector<std::uint32_t> & indices,
+        const std::vector<math::Vec3> & positions, float threshold)
+    {
+        const std::size_t triangle_count = indices.size() / 3;
+        if(triangle_count == 0) return indices;
+
+        // clusters begin wherever the cache restarts (triangle with no resident vertex),
+        // reordering whole clusters then costs at most one restart per cluster
+        std::vector<std::size_t> cluster_begin{0};
+        {
+            std::vector<std::size_t> timestamps(positions.size(), 0);
+            std::size_t time = VERTEX_CACHE_SIZE + 1;
+            for(std::size_t t = 0; t < triangle_count; ++t)
+            {
+                int misses = 0;
+                for(int k = 0; k < 3; ++k)
+                {
+                    const auto index = indices[t * 3 + k];
+                    if(time - timestamps[index] > VERTEX_CACHE_SIZE)
+                    {
+                        timestamps[index] = time++;
+                        misses++;
+                    }
+                }
+                if(t > 0 && misses == 3) cluster_begin.push_back(t);
+            }
+        }
+        if(cluster_begin.size() < 2) return indices;
+        cluster_begin.push_back(triangle_count);
+
+        const std::size_t cluster_count = cluster_begin.size() - 1;
+        std::vector<math::Vec3> cluster_centroid(cluster_count, math::Vec3(0.0f));
+        std::vector<math::Vec3> cluster_normal(cluster_count, math::Vec3(0.0f));
+
+        math::Vec3 mesh_centroid(0.0f);
+        float mesh_area = 0.0f;
+
+        for(std::size_t c = 0; c < cluster_count; ++c)
+        {
+            float cluster_area = 0.0f;
+            for(std::size_t t = cluster_begin[c]; t < cluster_begin[c + 1]; ++t)
+            {
+                const math::Vec3 & p0 = positions[indices[t * 3 + 0]];
+                const math::Vec3 & p1 = positions[indices[t * 3 + 1]];
+                const math::Vec3 & p2 = positions[indices[t * 3 + 2]];
+
+                const math::Vec3 normal = math::cross(p1 - p0, p2 - p0);
+                const float area = math::length(normal) * 0.5f;
+
+                cluster_centroid[c] += (p0 + p1 + p2) * (area / 3.0f);
+                cluster_normal[c] += normal;
+                cluster_area += area;
+            }
+
+            mesh_centroid += cluster_centroid[c];
+            mesh_area += cluster_area;
+            if(cluster_area > 0.0f) cluster_centroid[c] /= cluster_area;
+        }
+        if(mesh_area > 0.0f) mesh_centroid /= mesh_area;
+
+        // clusters facing away from the mesh center are likely to occlude the rest, draw them first
+        std::vector<float> sort_key(cluster_count, 0.0f);
+        for(std::size_t c = 0; c < cluster_count; ++c)
+        {
+            const float normal_length = math::length(cluster_normal[c]);
+            if(normal_length <= 0.0f) continue;
+            sort_key[c] = glm::dot(cluster_centroid[c] - mesh_centroid, cluster_normal[c] / normal_length);
+        }
+
+        std::vector<std::size_t> order(cluster_count);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+            [&](std::size_t a, std::size_t b){ return sort_key[a] > sort_key[b]; });
+
+        std::vector<std::uint32_t> result;
+        result.reserve(indices.size());
+        for(const auto c : order)
+            result.insert(result.end(), indices.begin() + cluster_begin[c] * 3, indices.begin() + cluster_begin[c + 1] * 3);
+
+        // keep the cache order if cluster sorting costs too much vertex reuse
+        if(computeACMR(result, positions.size(), VERTEX_CACHE_SIZE) >
+            computeACMR(indices, positions.size(), VERTEX_CACHE_SIZE) * threshold)
+        {
+            return indices;
+        }
+
+        return result;
+    }
+
+    std::vector<std::uint32_t> optimizeVertexFetchRemap(const std::vector<std::uint32_t> & indices, std::size_t vertex_count)
+    {
+        std::vector<std::uint32_t> remap(vertex_count, std::numeric_limits<std::uint32_t>::max());
+        std::uint32_t next = 0;
+        for(const auto index : indices)
+        {
+            if(remap[index] == std::numeric_limits<std::uint32_t>::max())
+                remap[index] = next++;
+        }
+        return remap;
+    }
+
+    template<class MeshDef>
+    static bool _optimizeMesh(MeshDef & mesh_def, const std::string & name)
+    {
+        const std::size_t vertex_count = (std::size_t)mesh_def.vertices_size();
+        if(mesh_def.indices_size() == 0 || mesh_def.indices_size() % 3 != 0)
+        {
+            spdlog::warn("[mesh-optimizer] Mesh {} is not a triangle list, skipping", name);
+            return false;
+        }
+
+        std::vector<std::uint32_t> indices(mesh_def.indices().begin(), mesh_def.indices().end());
+        if(std::any_of(indices.begin(), indices.end(), [&](std::uint32_t i){ return i >= vertex_count; }))
+        {
+            spdlog::warn("[mesh-optimizer] Mesh {} has out of range indices, skipping", name);
+            return false;
+        }
+
+        std::vector<math::Vec3> positions;
+        positions.reserve(vertex_count);
+        for(const auto & vertex : mesh_def.vertices())
+            positions.push_back(math::deserialize(vertex.position()));
+
+        const float acmr_before = computeACMR(indices, vertex_count, VERTEX_CACHE_SIZE);
+
+        indices = optimizeVertexCache(indices, vertex_count);
+        indices = optimizeOverdraw(indices, positions);
+
+        const auto remap = optimizeVertexFetchRemap(indices, vertex_count);
+        std::uint32_t used_vertices = 0;
+        for(auto & index : indices)
+        {
+            index = remap[index];
+            used_vertices = std::max(used_vertices, index + 1);
+        }
+
+        google::protobuf::RepeatedPtrField<proto::render::VertexDefinition> vertices;
+        vertices.Reserve((int)used_vertices);
+        for(std::uint32_t i = 0; i < used_vertices; ++i) vertices.Add();
+        for(std::size_t v = 0; v < vertex_count; ++v)
+        {
+            if(remap[v] == std::numeric_limits<std::uint32_t>::max()) continue;
+            vertices.Mutable((int)remap[v])->Swap(mesh_def.mutable_vertices((int)v));
+        }
+
+        mesh_def.mutable_vertices()->Swap(&vertices);
+        mesh_def.mutable_indices()->Assign(indices.begin(), indices.end());
+
+        spdlog::debug("[mesh-optimizer] Mesh {} ACMR {:.3f} -> {:.3f}, vertices {} -> {}", name,
+            acmr_before, computeACMR(indices, used_vertices, VERTEX_CACHE_SIZE), vertex_count, used_vertices);
+
+        return true;
+    }
+
+    bool optimizeMesh(proto::render::MeshDefinition & mesh_def)
+    {
+        return _optimizeMesh(mesh_def, mesh_def.name());
+    }
+
+    bool optimizeMesh(proto::render::MeshLODDefinition & lod_def)
+    {
+        return _optimizeMesh(lod_def, "lod");
+    }
+}
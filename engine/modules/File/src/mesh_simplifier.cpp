@@ -0,0 +1,406 @@
+#include "file/mesh_simplifier.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+#include <spdlog/spdlog.h>
+#include <absl/container/flat_hash_map.h>
+
+#include "file/mesh_optimizer.hpp"
+
+namespace astre::file
+{
+    namespace detail
+    {
+        /**
+         * @brief Symmetric 4x4 quadric accumulating weighted squared distances to planes
+         */
+        struct Quadric
+        {
+            double a00 = 0.0, a11 = 0.0, a22 = 0.0;
+            double a01 = 0.0, a02 = 0.0, a12 = 0.0;
+            double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+            double c = 0.0;
+            double w = 0.0;
+
+            Quadric & operator+=(const Quadric & other)
+            {
+                a00 += other.a00; a11 += other.a11; a22 += other.a22;
+                a01 += other.a01; a02 += other.a02; a12 += other.a12;
+                b0 += other.b0; b1 += other.b1; b2 += other.b2;
+                c += other.c;
+                w += other.w;
+                return *this;
+            }
+        };
+
+        // plane n.p + d = 0, `normal` must be unit length
+        static Quadric planeQuadric(const math::Vec3 & normal, float d, double weight)
+        {
+            Quadric q;
+            q.a00 = weight * normal.x * normal.x;
+            q.a11 = weight * normal.y * normal.y;
+            q.a22 = weight * normal.z * normal.z;
+            q.a01 = weight * normal.x * normal.y;
+            q.a02 = weight * normal.x * normal.z;
+            q.a12 = weight * normal.y * normal.z;
+            q.b0 = weight * normal.x * d;
+            q.b1 = weight * normal.y * d;
+            q.b2 = weight * normal.z * d;
+            q.c = weight * d * d;
+            q.w = weight;
+            return q;
+        }
+
+        // weighted mean squared distance of `p` to the accumulated planes
+        static double evaluate(const Quadric & q, const math::Vec3 & p)
+        {
+            if(q.w <= 0.0) return 0.0;
+
+            const double x = p.x, y = p.y, z = p.z;
+            const double result =
+                q.a00 * x * x + q.a11 * y * y + q.a22 * z * z +
+                2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z) +
+                2.0 * (q.b0 * x + q.b1 * y + q.b2 * z) +
+                q.c;
+
+            return std::max(result, 0.0) / q.w;
+        }
+
+        static std::uint64_t edgeKey(std::uint32_t a, std::uint32_t b)
+        {
+            if(a > b) std::swap(a, b);
+            return ((std::uint64_t)a << 32) | b;
+        }
+
+        enum class VertexKind : std::uint8_t
+        {
+            Manifold,   // free to collapse onto any neighbour
+            Border,     // open edge, may only collapse along the border
+            Locked      // attribute seam or non-manifold, never moves
+        };
+    }
+
+    // border planes dominate the face planes, so open edges keep their silhouette
+    static constexpr double BORDER_WEIGHT = 10.0;
+
+    std::vector<std::uint32_t> simplifyMesh(const std::vector<std::uint32_t> & indices,
+        const std::vector<math::Vec3> & positions,
+        std::size_t target_index_count,
+        float target_error,
+        float * result_error)
+    {
+        using detail::Quadric;
+        using detail::VertexKind;
+
+        const std::size_t vertex_count = positions.size();
+        std::vector<std::uint32_t> result = indices;
+        double max_cost = 0.0;
+
+        if(result_error) *result_error = 0.0f;
+        if(result.size() % 3 != 0 || result.size() <= target_index_count) return result;
+
+        // vertices sharing a position with a different normal/uv are seams, moving one side tears the surface
+        std::vector<VertexKind> seam_kind(vertex_count, VertexKind::Manifold);
+        {
+            absl::flat_hash_map<std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>, std::uint32_t> first_vertex;
+            for(std::uint32_t v = 0; v < vertex_count; ++v)
+            {
+                const auto key = std::make_tuple(
+                    std::bit_cast<std::uint32_t>(positions[v].x),
+                    std::bit_cast<std::uint32_t>(positions[v].y),
+                    std::bit_cast<std::uint32_t>(positions[v].z));
+
+                const auto [it, inserted] = first_vertex.try_emplace(key, v);
+                if(inserted) continue;
+                seam_kind[v] = VertexKind::Locked;
+                seam_kind[it->second] = VertexKind::Locked;
+            }
+        }
+
+        // face quadrics, area weighted
+        std::vector<Quadric> quadrics(vertex_count);
+        for(std::size_t t = 0; t < result.size(); t += 3)
+        {
+            const math::Vec3 & p0 = positions[result[t + 0]];
+            const math::Vec3 & p1 = positions[result[t + 1]];
+            const math::Vec3 & p2 = positions[result[t + 2]];
+
+            const math::Vec3 normal = math::cross(p1 - p0, p2 - p0);
+            const float length = math::length(normal);
+            if(length <= 0.0f) continue;
+
+            const math::Vec3 unit = normal / length;
+            const Quadric q = detail::planeQuadric(unit, -glm::dot(unit, p0), length * 0.5);
+            for(int k = 0; k < 3; ++k) quadrics[result[t + k]] += q;
+        }
+
+        // border quadrics, plane through the open edge perpendicular to its face
+        {
+            absl::flat_hash_map<std::uint64_t, std::uint32_t> edge_count;
+            for(std::size_t t = 0; t < result.size(); t += 3)
+                for(int k = 0; k < 3; ++k)
+                    edge_count[detail::edgeKey(result[t + k], result[t + (k + 1) % 3])]++;
+
+            for(std::size_t t = 0; t < result.size(); t += 3)
+            {
+                const math::Vec3 & p0 = positions[result[t + 0]];
+                const math::Vec3 face_normal = math::cross(positions[result[t + 1]] - p0, positions[result[t + 2]] - p0);
+
+                for(int k = 0; k < 3; ++k)
+                {
+                    const std::uint32_t a = result[t + k];
+                    const std::uint32_t b = result[t + (k + 1) % 3];
+                    if(edge_count[detail::edgeKey(a, b)] != 1) continue;
+
+                    const math::Vec3 edge = positions[b] - positions[a];
+                    const math::Vec3 normal = math::cross(edge, face_normal);
+                    const float length = math::length(normal);
+                    if(length <= 0.0f) continue;
+
+                    const math::Vec3 unit = normal / length;
+                    const Quadric q = detail::planeQuadric(unit, -glm::dot(unit, positions[a]),
+                        BORDER_WEIGHT * glm::dot(edge, edge));
+                    quadrics[a] += q;
+                    quadrics[b] += q;
+                }
+            }
+        }
+
+        const double max_error_sq = (double)target_error * (double)target_error;
+
+        std::vector<VertexKind> kind(vertex_count);
+        std::vector<std::uint32_t> offsets(vertex_count + 1);
+        std::vector<std::uint32_t> adjacency;
+        std::vector<std::uint32_t> remap(vertex_count);
+        std::vector<bool> touched(vertex_count);
+
+        struct Collapse
+        {
+            std::uint32_t from;
+            std::uint32_t to;
+            double cost;
+        };
+        std::vector<Collapse> collapses;
+
+        // each pass collapses a set of independent edges, cheapest first
+        while(result.size() > target_index_count)
+        {
+            // topology of the current triangles
+            absl::flat_hash_map<std::uint64_t, std::uint32_t> edge_count;
+            for(std::size_t t = 0; t < result.size(); t += 3)
+                for(int k = 0; k < 3; ++k)
+                    edge_count[detail::edgeKey(result[t + k], result[t + (k + 1) % 3])]++;
+
+            kind = seam_kind;
+            for(const auto & [key, count] : edge_count)
+            {
+                const std::uint32_t a = (std::uint32_t)(key >> 32);
+                const std::uint32_t b = (std::uint32_t)(key & 0xFFFFFFFFu);
+                if(count > 2)
+                {
+                    kind[a] = VertexKind::Locked;
+                    kind[b] = VertexKind::Locked;
+                }
+                else if(count == 1)
+                {
+                    if(kind[a] == VertexKind::Manifold) kind[a] = VertexKind::Border;
+                    if(kind[b] == VertexKind::Manifold) kind[b] = VertexKind::Border;
+                }
+            }
+
+            // vertex -> triangles adjacency
+            std::fill(offsets.begin(), offsets.end(), 0);
+            for(const auto index : result) offsets[index + 1]++;
+            for(std::size_t v = 0; v < vertex_count; ++v) offsets[v + 1] += offsets[v];
+            adjacency.resize(result.size());
+            {
+                std::vector<std::uint32_t> fill(offsets.begin(), offsets.end() - 1);
+                for(std::size_t i = 0; i < result.size(); ++i)
+                    adjacency[fill[result[i]]++] = (std::uint32_t)(i / 3);
+            }
+
+            // candidate collapses, cheaper direction of every edge that may collapse
+            collapses.clear();
+            for(const auto & [key, count] : edge_count)
+            {
+                const std::uint32_t a = (std::uint32_t)(key >> 32);
+                const std::uint32_t b = (std::uint32_t)(key & 0xFFFFFFFFu);
+                if(count > 2) continue;
+
+                const auto allowed = [&](std::uint32_t from){
+                    if(kind[from] == VertexKind::Locked) return false;
+                    if(kind[from] == VertexKind::Border) return count == 1;
+                    return true;
+                };
+
+                const auto cost = [&](std::uint32_t from, std::uint32_t to){
+                    Quadric q = quadrics[from];
+                    q += quadrics[to];
+                    return detail::evaluate(q, positions[to]);
+                };
+
+                if(allowed(a) && allowed(b))
+                {
+                    const double cost_ab = cost(a, b);
+                    const double cost_ba = cost(b, a);
+                    collapses.push_back(cost_ab <= cost_ba ? Collapse{a, b, cost_ab} : Collapse{b, a, cost_ba});
+                }
+                else if(allowed(a)) collapses.push_back({a, b, cost(a, b)});
+                else if(allowed(b)) collapses.push_back({b, a, cost(b, a)});
+            }
+
+            std::sort(collapses.begin(), collapses.end(),
+                [](const Collapse & l, const Collapse & r){ return l.cost < r.cost; });
+
+            for(std::uint32_t v = 0; v < vertex_count; ++v) remap[v] = v;
+            std::fill(touched.begin(), touched.end(), false);
+
+            const std::size_t triangles_to_remove = (result.size() - target_index_count + 2) / 3;
+            std::size_t removed = 0;
+
+            for(const auto & collapse : collapses)
+            {
+                if(collapse.cost > max_error_sq || removed >= triangles_to_remove) break;
+
+                const std::uint32_t u = collapse.from;
+                const std::uint32_t v = collapse.to;
+                if(touched[u] || touched[v]) continue;
+
+                // neighbours shared by u and v must be exactly the opposite corners of the
+                // triangles on edge (u, v), otherwise the collapse pinches the surface
+                std::vector<std::uint32_t> neighbours_u;
+                std::vector<std::uint32_t> neighbours_v;
+                std::size_t shared_triangles = 0;
+                bool valid = true;
+
+                for(std::uint32_t i = offsets[u]; i < offsets[u + 1]; ++i)
+                {
+                    const std::uint32_t * triangle = &result[adjacency[i] * 3];
+                    const bool has_v = triangle[0] == v || triangle[1] == v || triangle[2] == v;
+                    if(has_v) shared_triangles++;
+
+                    for(int k = 0; k < 3; ++k)
+                        if(triangle[k] != u && triangle[k] != v) neighbours_u.push_back(triangle[k]);
+
+                    if(has_v) continue;
+
+                    // triangle keeps its orientation when u moves onto v
+                    const int corner = triangle[0] == u ? 0 : (triangle[1] == u ? 1 : 2);
+                    const math::Vec3 & p1 = positions[triangle[(corner + 1) % 3]];
+                    const math::Vec3 & p2 = positions[triangle[(corner + 2) % 3]];
+                    const math::Vec3 before = math::cross(p1 - positions[u], p2 - positions[u]);
+                    const math::Vec3 after = math::cross(p1 - positions[v], p2 - positions[v]);
+                    if(glm::dot(before, after) <= 0.0f)
+                    {
+                        valid = false;
+                        break;
+                    }
+                }
+                if(!valid || shared_triangles == 0) continue;
+
+                for(std::uint32_t i = offsets[v]; i < offsets[v + 1]; ++i)
+                {
+                    const std::uint32_t * triangle = &result[adjacency[i] * 3];
+                    for(int k = 0; k < 3; ++k)
+                        if(triangle[k] != u && triangle[k] != v) neighbours_v.push_back(triangle[k]);
+                }
+
+                std::sort(neighbours_u.begin(), neighbours_u.end());
+                neighbours_u.erase(std::unique(neighbours_u.begin(), neighbours_u.end()), neighbours_u.end());
+                std::sort(neighbours_v.begin(), neighbours_v.end());
+                neighbours_v.erase(std::unique(neighbours_v.begin(), neighbours_v.end()), neighbours_v.end());
+
+                std::vector<std::uint32_t> common;
+                std::set_intersection(neighbours_u.begin(), neighbours_u.end(),
+                    neighbours_v.begin(), neighbours_v.end(), std::back_inserter(common));
+                if(common.size() != shared_triangles) continue;
+
+                remap[u] = v;
+                quadrics[v] += quadrics[u];
+                max_cost = std::max(max_cost, collapse.cost);
+                removed += shared_triangles;
+
+                touched[u] = true;
+                touched[v] = true;
+                for(const auto n : neighbours_u) touched[n] = true;
+            }
+
+            if(removed == 0) break;
+
+            // apply collapses, dropping triangles that became degenerate
+            std::size_t write = 0;
+            for(std::size_t t = 0; t < result.size(); t += 3)
+            {
+                const std::uint32_t a = remap[result[t + 0]];
+                const std::uint32_t b = remap[result[t + 1]];
+                const std::uint32_t c = remap[result[t + 2]];
+                if(a == b || b == c || a == c) continue;
+
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+            result.resize(write);
+        }
+
+        if(result_error) *result_error = (float)std::sqrt(max_cost);
+        return result;
+    }
+
+    std::size_t generateMeshLODs(proto::render::MeshDefinition & mesh_def, std::size_t lod_count)
+    {
+        mesh_def.clear_lods();
+
+        const std::size_t vertex_count = (std::size_t)mesh_def.vertices_size();
+        if(mesh_def.indices_size() == 0 || mesh_def.indices_size() % 3 != 0) return 0;
+
+        const std::vector<std::uint32_t> indices(mesh_def.indices().begin(), mesh_def.indices().end());
+        if(std::any_of(indices.begin(), indices.end(), [&](std::uint32_t i){ return i >= vertex_count; })) return 0;
+
+        std::vector<math::Vec3> positions;
+        positions.reserve(vertex_count);
+        math::Vec3 aabb_min(std::numeric_limits<float>::max());
+        math::Vec3 aabb_max(std::numeric_limits<float>::lowest());
+        for(const auto & vertex : mesh_def.vertices())
+        {
+            positions.push_back(math::deserialize(vertex.position()));
+            aabb_min = glm::min(aabb_min, positions.back());
+            aabb_max = glm::max(aabb_max, positions.back());
+        }
+
+        const float max_error = MESH_LOD_MAX_ERROR * math::length(aabb_max - aabb_min);
+
+        std::size_t previous_count = indices.size();
+        float previous_error = 0.0f;
+
+        for(std::size_t lod = 1; lod <= lod_count; ++lod)
+        {
+            // always simplify LOD 0, errors then measure distance to the original surface
+            const std::size_t target = ((indices.size() / 3) >> lod) * 3;
+
+            float error = 0.0f;
+            auto lod_indices = simplifyMesh(indices, positions, target, max_error, &error);
+            if(lod_indices.empty() || (float)lod_indices.size() > (float)previous_count * 0.8f) break;
+
+            auto * lod_def = mesh_def.add_lods();
+            lod_def->set_error(std::max(error, previous_error));
+            lod_def->mutable_indices()->Assign(lod_indices.begin(), lod_indices.end());
+            *lod_def->mutable_vertices() = mesh_def.vertices();
+
+            // drops vertices LOD no longer references
+            optimizeMesh(*lod_def);
+
+            spdlog::debug("[mesh-simplifier] Mesh {} LOD {}: {} -> {} triangles, error {:.5f}", mesh_def.name(), lod,
+                indices.size() / 3, lod_indices.size() / 3, lod_def->error());
+
+            previous_count = lod_indices.size();
+            previous_error = lod_def->error();
+        }
+
+        return (std::size_t)mesh_def.lods_size();
+    }
+}
@@ -0,0 +1,135 @@
+#include "file/record_compressor.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include <zstd.h>
+#include <zdict.h>
+#include <spdlog/spdlog.h>
+
+namespace astre::file
+{
+    // records never get anywhere close, a bigger size means a damaged frame
+    static constexpr unsigned long long MAX_RECORD_SIZE = 1ull << 30;
+
+    // a dictionary smaller than this isn't worth storing
+    static constexpr std::size_t MIN_DICTIONARY_SIZE = 1024;
+
+    // contexts are reused per thread, reads run on many pool threads at once
+    static ZSTD_CCtx * _compressionContext()
+    {
+        thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+        return context.get();
+    }
+
+    static ZSTD_DCtx * _decompressionContext()
+    {
+        thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+        return context.get();
+    }
+
+    void RecordCompressor::CDictDeleter::operator()(ZSTD_CDict_s * dictionary) const
+    {
+        ZSTD_freeCDict(dictionary);
+    }
+
+    void RecordCompressor::DDictDeleter::operator()(ZSTD_DDict_s * dictionary) const
+    {
+        ZSTD_freeDDict(dictionary);
+    }
+
+    RecordCompressor::RecordCompressor(int level, std::string dictionary)
+        : _level(level), _dictionary(std::move(dictionary))
+    {
+        if(_dictionary.empty())return;
+
+        _compression_dictionary.reset(ZSTD_createCDict(_dictionary.data(), _dictionary.size(), std::max(_level, 1)));
+        _decompression_dictionary.reset(ZSTD_createDDict(_dictionary.data(), _dictionary.size()));
+        if(_compression_dictionary == nullptr || _decompression_dictionary == nullptr)
+        {
+            spdlog::error("[record-compressor] Failed to load dictionary");
+        }
+    }
+
+    RecordCompressor::~RecordCompressor() = default;
+
+    std::string RecordCompressor::trainDictionary(const std::vector<std::string> & samples, std::size_t capacity)
+    {
+        std::string buffer;
+        std::vector<std::size_t> sizes;
+        buffer.reserve(std::accumulate(samples.begin(), samples.end(), std::size_t{0},
+            [](std::size_t total, const std::string & sample){ return total + sample.size(); }));
+        sizes.reserve(samples.size());
+        for(const auto & sample : samples)
+        {
+            buffer.append(sample);
+            sizes.push_back(sample.size());
+        }
+
+        // zstd suggests samples of about hundred times the dictionary size
+        capacity = std::min(capacity, buffer.size() / 8);
+        if(capacity < MIN_DICTIONARY_SIZE || samples.size() < 8)return {};
+
+        std::string dictionary(capacity, '\0');
+        const std::size_t size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(),
+            buffer.data(), sizes.data(), (unsigned)sizes.size());
+        if(ZDICT_isError(size))
+        {
+            spdlog::debug("[record-compressor] No dictionary trained from {} samples: {}", samples.size(), ZDICT_getErrorName(size));
+            return {};
+        }
+
+        dictionary.resize(size);
+        return dictionary;
+    }
+
+    std::optional<std::string> RecordCompressor::compress(std::string_view data) const
+    {
+        if(!enabled())return std::nullopt;
+
+        std::string frame(ZSTD_compressBound(data.size()), '\0');
+        const std::size_t size = _compression_dictionary != nullptr ?
+            ZSTD_compress_usingCDict(_compressionContext(), frame.data(), frame.size(), data.data(), data.size(), _compression_dictionary.get()) :
+            ZSTD_compressCCtx(_compressionContext(), frame.data(), frame.size(), data.data(), data.size(), _level);
+
+        if(ZSTD_isError(size))
+        {
+            spdlog::error("[record-compressor] Failed to compress record: {}", ZSTD_getErrorName(size));
+            return std::nullopt;
+        }
+
+        frame.resize(size);
+        return frame;
+    }
+
+    std::optional<std::string> RecordCompressor::decompress(std::string_view frame) const
+    {
+        const unsigned long long content_size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+        if(content_size == ZSTD_CONTENTSIZE_UNKNOWN || content_size == ZSTD_CONTENTSIZE_ERROR || content_size > MAX_RECORD_SIZE)
+        {
+            spdlog::error("[record-compressor] Invalid record frame");
+            return std::nullopt;
+        }
+
+        // frames written without a dictionary must not be decoded with one
+        const bool uses_dictionary = ZSTD_getDictID_fromFrame(frame.data(), frame.size()) != 0;
+        if(uses_dictionary && _decompression_dictionary == nullptr)
+        {
+            spdlog::error("[record-compressor] Record needs a dictionary");
+            return std::nullopt;
+        }
+
+        std::string data(content_size, '\0');
+        const std::size_t size = uses_dictionary ?
+            ZSTD_decompress_usingDDict(_decompressionContext(), data.data(), data.size(), frame.data(), frame.size(), _decompression_dictionary.get()) :
+            ZSTD_decompressDCtx(_decompressionContext(), data.data(), data.size(), frame.data(), frame.size());
+
+        if(ZSTD_isError(size) || size != content_size)
+        {
+            spdlog::error("[record-compressor] Failed to decompress record: {}", ZSTD_isError(size) ? ZSTD_getErrorName(size) : "size mismatch");
+            return std::nullopt;
+        }
+
+        return data;
+    }
+}
@@ -1,31 +1,38 @@
 #include "file/script_file.hpp"
 
-#include <fstream>
-#include <sstream>
 #include <string>
 
 #include <spdlog/spdlog.h>
 
+#include "file/async_file_reader.hpp"
+
 namespace astre::file
 {
     std::optional<proto::script::ScriptDefinition> ScriptFile::read(const std::filesystem::path & file) const
+    {
+        return parse(file, readFiles(requests(file)));
+    }
+
+    std::vector<native::ReadRequest> ScriptFile::requests(const std::filesystem::path & file) const
+    {
+        return { native::ReadRequest{.path = file} };
+    }
+
+    std::optional<proto::script::ScriptDefinition> ScriptFile::parse(const std::filesystem::path & file,
+        std::vector<std::optional<std::string>> contents) const
     {
         const std::string name = file.stem().string();
         spdlog::debug("[script-file] Reading script from file {}", file.string());
 
-        std::ifstream in(file);
-        if(!in.is_open())
+        if(contents.size() != 1 || !contents[0])
         {
             spdlog::error("Failed to open lua script: {}", file.string());
             return std::nullopt;
         }
 
-        std::stringstream buffer;
-        buffer << in.rdbuf();
-
         proto::script::ScriptDefinition def;
         def.set_name(name);
-        def.add_code(buffer.str());
+        def.add_code(std::move(*contents[0]));
 
         return def;
     }
@@ -1,60 +1,76 @@
 #include "file/shader_file.hpp"
 
-#include <fstream>
+#include <sstream>
 
 #include <spdlog/spdlog.h>
 
+#include "file/async_file_reader.hpp"
+
 namespace astre::file
 {
-    std::optional<proto::render::ShaderDefinition> ShaderFile::read(const std::filesystem::path & dir) const
+    // every line of a stage is its own code entry, newline included
+    static void _addLines(const std::string & code, auto && add)
     {
-        const std::string name = dir.stem().string();
-        spdlog::debug("[shader-file] Reading shader: {}", name);
+        std::istringstream stream(code);
+        std::string line;
+        while(std::getline(stream, line))
+        {
+            // sources are read as bytes, not through a text mode stream
+            if(!line.empty() && line.back() == '\r') line.pop_back();
+            add(line + "\n");
+        }
+    }
 
+    std::optional<proto::render::ShaderDefinition> ShaderFile::read(const std::filesystem::path & dir) const
+    {
         if(!std::filesystem::exists(dir))
         {
             spdlog::error("Shader source directory does not exist: {}", dir.string());
             return std::nullopt;
         }
 
-        proto::render::ShaderDefinition shader_def;
-        shader_def.set_name(name);
+        return parse(dir, readFiles(requests(dir)));
+    }
 
-        std::ifstream shader_file;
-        std::string line;
+    std::vector<native::ReadRequest> ShaderFile::requests(const std::filesystem::path & dir) const
+    {
+        return {
+            native::ReadRequest{.path = dir / "vertex.glsl"},
+            native::ReadRequest{.path = dir / "fragment.glsl"}
+        };
+    }
 
-        // vertex stage (required)
-        const std::filesystem::path vs_path = dir / "vertex.glsl";
-        if(!std::filesystem::exists(vs_path))
+    std::optional<proto::render::ShaderDefinition> ShaderFile::parse(const std::filesystem::path & dir,
+        std::vector<std::optional<std::string>> contents) const
+    {
+        const std::string name = dir.stem().string();
+        spdlog::debug("[shader-file] Reading shader: {}", name);
+
+        if(contents.size() != 2)
         {
-            spdlog::error("Vertex shader file does not exist: {}", vs_path.string());
+            spdlog::error("Expected 2 shader stages of {}, got {}", name, contents.size());
             return std::nullopt;
         }
-        shader_file.open(vs_path);
-        if(!shader_file.is_open())
+
+        proto::render::ShaderDefinition shader_def;
+        shader_def.set_name(name);
+
+        // vertex stage (required)
+        if(!contents[0])
         {
-            spdlog::error("Failed to open shader file: {}", vs_path.string());
+            spdlog::error("Failed to read vertex shader file: {}", (dir / "vertex.glsl").string());
             return std::nullopt;
         }
-        while(std::getline(shader_file, line)) shader_def.add_vertex_code(line + "\n");
-        shader_file.close();
+        _addLines(*contents[0], [&](std::string line){ shader_def.add_vertex_code(std::move(line)); });
 
         // fragment stage (optional)
-        const std::filesystem::path fs_path = dir / "fragment.glsl";
-        if(!std::filesystem::exists(fs_path))
+        if(!contents[1])
         {
-            spdlog::warn("Fragment shader file does not exist: {}", fs_path.string());
+            spdlog::warn("Fragment shader file does not exist: {}", (dir / "fragment.glsl").string());
         }
         else
         {
-            shader_file.open(fs_path);
-            if(!shader_file.is_open())
-            {
-                spdlog::error("Failed to open shader file: {}", fs_path.string());
-                return std::nullopt;
-            }
-            while(std::getline(shader_file, line)) shader_def.add_fragment_code(line + "\n");
-            shader_file.close();
+            _addLines(*contents[1], [&](std::string line){ shader_def.add_fragment_code(std::move(line)); });
         }
 
         return shader_def;
@@ -1,65 +1,493 @@
 #include "file/world_file.hpp"
 
 #include <algorithm>
+#include <array>
 
-#include <google/protobuf/util/delimited_message_util.h>
-#include <google/protobuf/util/json_util.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/wire_format_lite.h>
 #include <spdlog/spdlog.h>
 
+#include "proto/File/world_archive.pb.h"
+
+#include "file/file_utils.hpp"
+
 namespace astre::file 
 {
-    static constexpr std::int32_t MAGIC = 0xABCD1234;
-
-    // layout of binary file
-    //<varint_size><chunk_0_bytes>
-    //<varint_size><chunk_1_bytes>
+    // layout of binary file, an append-only log
+    //<magic><version>                      header, absent in legacy files
+    //<dictionary_size><dictionary>         since version 2, zstd dictionary of the records
+    //<varint_size><record_0_bytes>
+    //<varint_size><record_1_bytes>
     //...
-    WorldFile<use_binary_t>::WorldFile(std::filesystem::path file_path)
-        : _file_path(std::move(file_path))
+    //<toc_bytes>                           WorldArchiveToc, absent while the file is open
+    //<toc_offset><toc_checksum><toc_size><magic>
+    // A record is a WorldChunk, or a WorldArchiveRecord tombstone with `removed` set,
+    // or (since version 2) a WorldArchiveRecord holding the `compressed` chunk.
+    // Later records of the same chunk supersede earlier ones.
+    // Integers of the header and trailer are little endian.
+
+    // wire type 7 in the second byte, so no legacy file (plain records) starts with it
+    static constexpr std::array<char, 4> MAGIC = {'A', 'W', 'L', 'D'};
+    static constexpr std::uint32_t ARCHIVE_VERSION = 2;
+    static constexpr std::uint32_t FIRST_COMPRESSED_VERSION = 2;
+
+    static constexpr std::streamoff HEADER_PREFIX_SIZE = 8; // magic + version
+    static constexpr std::streamoff DICTIONARY_SIZE_SIZE = 4;
+    static constexpr std::streamoff TRAILER_SIZE = 24;
+
+    static std::uint64_t _checksum(const char * data, std::size_t size)
+    {
+        return hashBytes(data, size);
+    }
+
+    static std::uint64_t _checksum(const std::string & bytes)
+    {
+        return _checksum(bytes.data(), bytes.size());
+    }
+
+    // size of a record in the file, length prefix included
+    static std::size_t _recordSize(const ChunkIndexEntry & entry)
+    {
+        return google::protobuf::io::CodedOutputStream::VarintSize32((uint32_t)entry.size) + entry.size;
+    }
+
+    // payload of a record, length prefix skipped
+    static std::optional<std::string> _readRecord(std::istream & from, const ChunkIndexEntry & entry)
+    {
+        std::string payload(entry.size, '\0');
+        from.clear();
+        from.seekg(entry.offset + (std::streamoff)(_recordSize(entry) - entry.size));
+        if(!from.read(payload.data(), (std::streamsize)payload.size()))
+        {
+            return std::nullopt;
+        }
+        return payload;
+    }
+
+    // payload with its length prefix
+    static std::string _delimited(const std::string & payload)
     {
-        _openStream(std::ios::in | std::ios::binary);
+        std::string bytes;
+        bytes.reserve(google::protobuf::io::CodedOutputStream::VarintSize32((uint32_t)payload.size()) + payload.size());
+        {
+            google::protobuf::io::StringOutputStream raw(&bytes);
+            google::protobuf::io::CodedOutputStream coded_output(&raw);
+            coded_output.WriteVarint32((uint32_t)payload.size());
+            coded_output.WriteRaw(payload.data(), (int)payload.size());
+        }
+        return bytes;
+    }
+
+    // samples the dictionary is trained from during compaction, about hundred times its capacity
+    static constexpr std::size_t DICTIONARY_SAMPLE_BYTES = 100 * RECORD_DICTIONARY_CAPACITY;
+
+    static std::string _header(const std::string & dictionary)
+    {
+        std::string header(MAGIC.begin(), MAGIC.end());
+        header.resize(HEADER_PREFIX_SIZE + DICTIONARY_SIZE_SIZE);
+        google::protobuf::io::CodedOutputStream::WriteLittleEndian32ToArray(ARCHIVE_VERSION, (std::uint8_t *)header.data() + 4);
+        google::protobuf::io::CodedOutputStream::WriteLittleEndian32ToArray((std::uint32_t)dictionary.size(), (std::uint8_t *)header.data() + 8);
+        header.append(dictionary);
+        return header;
+    }
+
+    // Frame of a compressed record, without parsing it. Records are serialized in field
+    // order, so `compressed` directly follows the id.
+    static std::optional<std::string_view> _compressedFrame(const char * payload, std::size_t size)
+    {
+        using google::protobuf::internal::WireFormatLite;
+
+        google::protobuf::io::CodedInputStream input((const std::uint8_t *)payload, (int)size);
+        std::uint32_t tag = input.ReadTag();
+        if (tag == WireFormatLite::MakeTag(proto::file::WorldArchiveRecord::kIdFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+        {
+            std::uint32_t length = 0;
+            if (!input.ReadVarint32(&length) || !input.Skip((int)length)) return std::nullopt;
+            tag = input.ReadTag();
+        }
+
+        if (tag != WireFormatLite::MakeTag(proto::file::WorldArchiveRecord::kCompressedFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+            return std::nullopt;
+
+        std::uint32_t length = 0;
+        if (!input.ReadVarint32(&length)) return std::nullopt;
+
+        const std::size_t begin = (std::size_t)input.CurrentPosition();
+        if (begin + length > size) return std::nullopt;
+        return std::string_view(payload + begin, length);
+    }
+
+    // record payload of a serialized chunk, compressed if that makes it smaller
+    static std::string _encodeRecord(const proto::file::ChunkID & id, std::string chunk_bytes, const RecordCompressor * compressor)
+    {
+        if (compressor == nullptr) return chunk_bytes;
+
+        auto frame = compressor->compress(chunk_bytes);
+        if (!frame || frame->size() >= chunk_bytes.size()) return chunk_bytes;
+
+        proto::file::WorldArchiveRecord record;
+        record.mutable_id()->CopyFrom(id);
+        record.set_compressed(std::move(*frame));
+        return record.SerializeAsString();
+    }
+
+    // serialized chunk of a record payload
+    static std::optional<std::string> _decodeRecord(const std::string & payload, const RecordCompressor * compressor)
+    {
+        const auto frame = _compressedFrame(payload.data(), payload.size());
+        if (!frame) return payload;
+        if (compressor == nullptr) return std::nullopt;
+        return compressor->decompress(*frame);
+    }
+
+    // table of contents of `index` and `entities` followed by the trailer, for a log ending at `log_end`
+    static std::string _tableOfContents(const absl::flat_hash_map<proto::file::ChunkID, ChunkIndexEntry> & index,
+        const absl::flat_hash_map<std::uint64_t, EntityLocation> & entities, std::size_t dead_bytes, std::streamoff log_end)
+    {
+        proto::file::WorldArchiveToc toc;
+        toc.mutable_chunks()->Reserve((int)index.size());
+        for(const auto & [id, entry] : index)
+        {
+            auto * toc_entry = toc.add_chunks();
+            toc_entry->mutable_id()->CopyFrom(id);
+            toc_entry->set_offset((std::uint64_t)entry.offset);
+            toc_entry->set_size((std::uint32_t)entry.size);
+            toc_entry->set_checksum(entry.checksum);
+        }
+        toc.set_dead_bytes(dead_bytes);
+
+        toc.mutable_entities()->Reserve((int)entities.size());
+        for(const auto & [entity, location] : entities)
+        {
+            auto * toc_entity = toc.add_entities();
+            toc_entity->set_entity(entity);
+            toc_entity->mutable_chunk()->CopyFrom(location.chunk);
+            if(location.position) toc_entity->mutable_position()->CopyFrom(*location.position);
+        }
+        toc.set_indexed_entities(true);
+
+        std::string bytes = toc.SerializeAsString();
+        const std::uint64_t toc_checksum = _checksum(bytes);
+        const std::uint32_t toc_size = (std::uint32_t)bytes.size();
+
+        std::array<std::uint8_t, TRAILER_SIZE> trailer;
+        google::protobuf::io::CodedOutputStream::WriteLittleEndian64ToArray((std::uint64_t)log_end, trailer.data());
+        google::protobuf::io::CodedOutputStream::WriteLittleEndian64ToArray(toc_checksum, trailer.data() + 8);
+        google::protobuf::io::CodedOutputStream::WriteLittleEndian32ToArray(toc_size, trailer.data() + 16);
+        std::copy(MAGIC.begin(), MAGIC.end(), trailer.begin() + 20);
+
+        bytes.append((const char *)trailer.data(), trailer.size());
+        return bytes;
+    }
+
+    WorldFile<use_binary_t>::WorldFile(std::filesystem::path file_path, int compression_level)
+        : _file_path(std::move(file_path)),
+        _compression_level(compression_level)
+    {
+        _openStream(std::ios::in | std::ios::out | std::ios::binary);
 
         if (!_stream.is_open() || !_stream.good())
             return;
 
-        // need to load WorldFileData from binary file 
-        // then scan it and add all indexes, and their offsets and sizes
-        // such that we  then can read from file only given part
-        google::protobuf::io::IstreamInputStream raw(&_stream);
+        std::error_code ec;
+        const std::streamoff file_size = (std::streamoff)std::filesystem::file_size(_file_path, ec);
+        if (ec)
+        {
+            spdlog::error("[world-file] Failed to get size of {}: {}", _file_path.string(), ec.message());
+            return;
+        }
+
+        if (file_size == 0)
+        {
+            // new archive, no dictionary until there are records to train one from
+            const std::string header = _header({});
+            _stream.write(header.data(), (std::streamsize)header.size());
+            _stream.flush();
+            if (!_stream.good())
+            {
+                spdlog::error("[world-file] Failed to write header of {}", _file_path.string());
+                return;
+            }
+
+            _version = ARCHIVE_VERSION;
+            _log_begin = (std::streamoff)header.size();
+            _log_size = _log_begin;
+            _compressor = std::make_shared<RecordCompressor>(_compression_level);
+            _closeStream();
+            _valid = true;
+            return;
+        }
+
+        std::array<char, HEADER_PREFIX_SIZE> header{};
+        _stream.read(header.data(), header.size());
+        const bool has_header = _stream.gcount() == HEADER_PREFIX_SIZE && std::equal(MAGIC.begin(), MAGIC.end(), header.begin());
+        _stream.clear();
+
+        if (!has_header)
+        {
+            spdlog::debug("[world-file] {} has no header, replaying legacy log", _file_path.string());
+            _scanLog(_stream, 0, file_size);
+            _closeStream();
+            _rebuildEntityIndex();
+            _valid = true;
+            return;
+        }
+
+        google::protobuf::io::CodedInputStream::ReadLittleEndian32FromArray((const std::uint8_t *)header.data() + 4, &_version);
+        if (_version > ARCHIVE_VERSION)
+        {
+            spdlog::error("[world-file] {} has version {}, newest supported is {}", _file_path.string(), _version, ARCHIVE_VERSION);
+            _closeStream();
+            return;
+        }
+
+        _log_begin = HEADER_PREFIX_SIZE;
+        if (_version >= FIRST_COMPRESSED_VERSION)
+        {
+            std::array<std::uint8_t, DICTIONARY_SIZE_SIZE> dictionary_size_bytes;
+            std::uint32_t dictionary_size = 0;
+            if (_stream.read((char *)dictionary_size_bytes.data(), dictionary_size_bytes.size()))
+                google::protobuf::io::CodedInputStream::ReadLittleEndian32FromArray(dictionary_size_bytes.data(), &dictionary_size);
+
+            std::string dictionary(dictionary_size, '\0');
+            if (!_stream || HEADER_PREFIX_SIZE + DICTIONARY_SIZE_SIZE + (std::streamoff)dictionary_size > file_size ||
+                !_stream.read(dictionary.data(), (std::streamsize)dictionary.size()))
+            {
+                spdlog::error("[world-file] {} has a damaged header", _file_path.string());
+                _closeStream();
+                return;
+            }
+
+            _log_begin += DICTIONARY_SIZE_SIZE + (std::streamoff)dictionary_size;
+            _compressor = std::make_shared<RecordCompressor>(_compression_level, std::move(dictionary));
+        }
+
+        std::streamoff log_end = file_size;
+        bool entities_indexed = false;
+        if (_readTableOfContents(_stream, file_size, log_end, entities_indexed))
+        {
+            _has_table_of_contents = true;
+            _log_size = log_end;
+        }
+        else
+        {
+            // closed without writing it, the records themselves are intact
+            spdlog::warn("[world-file] {} has no valid table of contents, replaying log", _file_path.string());
+            _scanLog(_stream, _log_begin, log_end);
+        }
+
+        _closeStream();
+        if (!entities_indexed)
+        {
+            _rebuildEntityIndex();
+            // written again on close with the index, so only this open scans the chunks
+            _table_of_contents_stale = true;
+        }
+        _valid = true;
+    }
+
+    WorldFile<use_binary_t>::~WorldFile()
+    {
+        if (!_valid || _version == 0 || (_has_table_of_contents && !_table_of_contents_stale))
+            return;
+
+        _unmap();
+
+        // whatever follows the log (a torn tail, an older table of contents) would
+        // otherwise stay behind the new trailer, and the next open looks at the end
+        std::error_code ec;
+        std::filesystem::resize_file(_file_path, (std::uintmax_t)_log_size, ec);
+        if (ec)
+        {
+            spdlog::error("[world-file] Failed to trim {} before writing table of contents: {}", _file_path.string(), ec.message());
+            return;
+        }
+
+        if (!_openStream(std::ios::in | std::ios::out | std::ios::binary))
+        {
+            spdlog::error("[world-file] Failed to open {} to write table of contents", _file_path.string());
+            return;
+        }
+
+        const std::string toc = _tableOfContents(_chunk_index, _entity_index, _dead_bytes, _log_size);
+        _stream.seekp(_log_size);
+        _stream.write(toc.data(), (std::streamsize)toc.size());
+        _stream.flush();
+
+        if (!_stream.good())
+            spdlog::error("[world-file] Failed to write table of contents of {}", _file_path.string());
+
+        _closeStream();
+    }
+
+    bool WorldFile<use_binary_t>::_readTableOfContents(std::istream & stream, std::streamoff file_size, std::streamoff & log_end, bool & entities_indexed)
+    {
+        if (file_size < _log_begin + TRAILER_SIZE)
+            return false;
+
+        std::array<std::uint8_t, TRAILER_SIZE> trailer;
+        stream.seekg(file_size - TRAILER_SIZE);
+        if (!stream.read((char *)trailer.data(), trailer.size()))
+            return false;
+
+        if (!std::equal(MAGIC.begin(), MAGIC.end(), trailer.begin() + 20))
+            return false;
+
+        std::uint64_t toc_offset = 0;
+        std::uint64_t toc_checksum = 0;
+        std::uint32_t toc_size = 0;
+        google::protobuf::io::CodedInputStream::ReadLittleEndian64FromArray(trailer.data(), &toc_offset);
+        google::protobuf::io::CodedInputStream::ReadLittleEndian64FromArray(trailer.data() + 8, &toc_checksum);
+        google::protobuf::io::CodedInputStream::ReadLittleEndian32FromArray(trailer.data() + 16, &toc_size);
+
+        if (toc_offset < (std::uint64_t)_log_begin || toc_offset + toc_size + TRAILER_SIZE != (std::uint64_t)file_size)
+            return false;
+
+        // records end where the table of contents starts, even if the table itself is damaged
+        log_end = (std::streamoff)toc_offset;
+
+        std::string bytes(toc_size, '\0');
+        stream.seekg((std::streamoff)toc_offset);
+        if (!stream.read(bytes.data(), (std::streamsize)bytes.size()))
+            return false;
+
+        if (_checksum(bytes) != toc_checksum)
+        {
+            spdlog::warn("[world-file] Table of contents checksum mismatch");
+            return false;
+        }
+
+        proto::file::WorldArchiveToc toc;
+        if (!toc.ParseFromString(bytes))
+            return false;
+
+        _chunk_index.reserve(toc.chunks_size());
+        _all_chunks.reserve(toc.chunks_size());
+        for (const auto & toc_entry : toc.chunks())
+        {
+            _chunk_index[toc_entry.id()] = ChunkIndexEntry{0, (std::streamoff)toc_entry.offset(), toc_entry.size(), toc_entry.checksum()};
+            _all_chunks.emplace(toc_entry.id());
+        }
+        _dead_bytes = toc.dead_bytes();
+
+        entities_indexed = toc.indexed_entities();
+        _entity_index.reserve(toc.entities_size());
+        for (const auto & toc_entity : toc.entities())
+        {
+            _entity_index[toc_entity.entity()] = EntityLocation{
+                .chunk = toc_entity.chunk(),
+                .position = toc_entity.has_position() ? std::make_optional(toc_entity.position()) : std::nullopt
+            };
+            _chunk_entities[toc_entity.chunk()].push_back(toc_entity.entity());
+        }
+        return true;
+    }
+
+    void WorldFile<use_binary_t>::_indexEntities(const proto::file::WorldChunk & chunk)
+    {
+        _unindexEntities(chunk.id());
+
+        auto & indexed = _chunk_entities[chunk.id()];
+        indexed.reserve(chunk.entities_size());
+        for (const auto & entity_def : chunk.entities())
+        {
+            _entity_index[entity_def.id()] = EntityLocation{
+                .chunk = chunk.id(),
+                .position = entity_def.has_transform() ? std::make_optional(entity_def.transform().position()) : std::nullopt
+            };
+            indexed.push_back(entity_def.id());
+        }
+    }
+
+    void WorldFile<use_binary_t>::_unindexEntities(const proto::file::ChunkID & id)
+    {
+        const auto it = _chunk_entities.find(id);
+        if (it == _chunk_entities.end()) return;
+
+        for (const auto entity : it->second)
+        {
+            // an entity that moved was already indexed under the chunk it moved to
+            const auto entity_it = _entity_index.find(entity);
+            if (entity_it != _entity_index.end() && entity_it->second.chunk == id)
+                _entity_index.erase(entity_it);
+        }
+        _chunk_entities.erase(it);
+    }
+
+    void WorldFile<use_binary_t>::_rebuildEntityIndex()
+    {
+        spdlog::debug("[world-file] Indexing entities of {} chunks in {}", _chunk_index.size(), _file_path.string());
+
+        _entity_index.clear();
+        _chunk_entities.clear();
+
+        const std::vector<proto::file::ChunkID> chunks(_all_chunks.begin(), _all_chunks.end());
+        for (const auto & id : chunks)
+        {
+            if (const auto chunk = read(id))
+                _indexEntities(*chunk);
+        }
+    }
+
+    std::optional<EntityLocation> WorldFile<use_binary_t>::findEntity(std::uint64_t entity) const
+    {
+        std::shared_lock lock(_mutex);
+
+        const auto it = _entity_index.find(entity);
+        if (it == _entity_index.end()) return std::nullopt;
+        return it->second;
+    }
+
+    void WorldFile<use_binary_t>::_scanLog(std::istream & stream, std::streamoff begin, std::streamoff end)
+    {
+        stream.clear();
+        stream.seekg(begin);
+        _log_size = begin;
+
+        google::protobuf::io::IstreamInputStream raw(&stream);
         google::protobuf::io::CodedInputStream coded_input(&raw);
 
-        while (true)
+        std::string payload;
+        while (begin + coded_input.CurrentPosition() < end)
         {
-            std::streamoff offset = coded_input.CurrentPosition();
+            const std::streamoff offset = begin + coded_input.CurrentPosition();
 
             uint32_t message_size = 0;
             if (!coded_input.ReadVarint32(&message_size))
                 break;  // EOF
 
-            // Limit reading to current message size
-            auto limit = coded_input.PushLimit(message_size);
-
-            proto::file::WorldChunk chunk;
-            if (!chunk.ParseFromCodedStream(&coded_input))
+            // entities are skipped, only id and tombstone flag are needed for the index
+            proto::file::WorldArchiveRecord record;
+            if (offset + (std::streamoff)message_size > end ||
+                !coded_input.ReadString(&payload, (int)message_size) ||
+                !record.ParseFromString(payload))
             {
-                spdlog::warn("Failed to parse chunk at offset {}", offset);
+                // torn tail of an interrupted append, next append overwrites it
+                spdlog::warn("[world-file] Failed to parse record at offset {}", offset);
                 break;
             }
 
-            coded_input.PopLimit(limit);
+            _log_size = begin + coded_input.CurrentPosition();
 
-            // Build logical index: ChunkID → index
-            // such that we can read from file only given part
-            // we need to store offset as absolute offset from the beginning of the file
+            const ChunkIndexEntry entry{0, offset, message_size, _checksum(payload)};
 
-            _chunk_index[chunk.id()].offset = offset;
-            _chunk_index[chunk.id()].size = message_size;
+            if (const auto it = _chunk_index.find(record.id()); it != _chunk_index.end())
+            {
+                _dead_bytes += _recordSize(it->second);
+            }
 
-            _all_chunks.emplace(chunk.id());
-        }
+            if (record.removed())
+            {
+                _dead_bytes += _recordSize(entry);
+                _chunk_index.erase(record.id());
+                _all_chunks.erase(record.id());
+                continue;
+            }
 
-        _stream.close();
-        _valid = true;
+            _chunk_index[record.id()] = entry;
+            _all_chunks.emplace(record.id());
+        }
     }
 
     bool WorldFile<use_binary_t>::_openStream(std::ios::openmode mode) {
@@ -92,170 +520,404 @@ namespace astre::file
         return !_stream.is_open();
     }
 
-    const absl::flat_hash_set<proto::file::ChunkID> & WorldFile<use_binary_t>::getAllChunks() const
+    absl::flat_hash_set<proto::file::ChunkID> WorldFile<use_binary_t>::getAllChunks() const
     {
+        std::shared_lock lock(_mutex);
         return _all_chunks;
     }
 
-    std::vector<proto::file::WorldChunk> WorldFile<use_binary_t>::_readAllChunks() const
+    bool WorldFile<use_binary_t>::containsChunk(const proto::file::ChunkID & id) const
     {
-        std::vector<proto::file::WorldChunk> chunks;
+        std::shared_lock lock(_mutex);
+        return _all_chunks.contains(id);
+    }
 
-        std::ifstream stream(_file_path, std::ios::in | std::ios::binary);
-        if (!stream.is_open())
-            return chunks;
+    std::optional<ChunkIndexEntry> WorldFile<use_binary_t>::_appendRecord(const std::string & payload)
+    {
+        const std::string bytes = _delimited(payload);
 
-        google::protobuf::io::IstreamInputStream raw(&stream);
-        google::protobuf::io::CodedInputStream coded_input(&raw);
+        _unmap();
 
-        while (true)
+        if (_has_table_of_contents)
         {
-            uint32_t message_size = 0;
-            if (!coded_input.ReadVarint32(&message_size))
-                break;  // EOF
-
-            auto limit = coded_input.PushLimit(message_size);
-
-            proto::file::WorldChunk chunk;
-            if (!chunk.ParseFromCodedStream(&coded_input))
+            // cut it off so a crash before close leaves a plain log, which is replayed at open
+            std::error_code ec;
+            std::filesystem::resize_file(_file_path, (std::uintmax_t)_log_size, ec);
+            if (ec)
             {
-                spdlog::warn("[world-file] Failed to parse chunk while reading all");
-                break;
+                spdlog::error("[world-file] Failed to drop table of contents: {}", ec.message());
+                return std::nullopt;
             }
+            _has_table_of_contents = false;
+        }
 
-            coded_input.PopLimit(limit);
-            chunks.push_back(std::move(chunk));
+        if (!_openStream(std::ios::in | std::ios::out | std::ios::binary))
+        {
+            spdlog::error("[world-file] Failed to open stream for writing");
+            return std::nullopt;
         }
 
-        return chunks;
+        // seek to the end of the last valid record rather than the end of the file,
+        // so a torn tail left by an interrupted append gets overwritten
+        _stream.seekp(_log_size);
+        _stream.write(bytes.data(), (std::streamsize)bytes.size());
+        _stream.flush();
+
+        const bool written = _stream.good();
+        _closeStream();
+        if (!written)
+        {
+            spdlog::error("[world-file] Failed to append record");
+            return std::nullopt;
+        }
+
+        const ChunkIndexEntry entry{0, _log_size, payload.size(), _checksum(payload)};
+        _log_size += (std::streamoff)bytes.size();
+        return entry;
     }
 
-    bool WorldFile<use_binary_t>::_writeAllChunks(const std::vector<proto::file::WorldChunk> & chunks)
+    bool WorldFile<use_binary_t>::writeChunk(const proto::file::WorldChunk & chunk)
     {
-        if (!_openStream(std::ios::out | std::ios::trunc | std::ios::binary))
+        std::unique_lock lock(_mutex);
+
+        // older versions store records raw, so their readers still understand every record
+        const auto entry = _appendRecord(_encodeRecord(chunk.id(), chunk.SerializeAsString(), _compressor.get()));
+        if (!entry)
         {
-            spdlog::error("[world-file] Failed to open stream for writing");
             return false;
         }
 
-        _chunk_index.clear();
-        _all_chunks.clear();
-
+        if (const auto it = _chunk_index.find(chunk.id()); it != _chunk_index.end())
         {
-            google::protobuf::io::OstreamOutputStream raw(&_stream);
-            google::protobuf::io::CodedOutputStream coded_output(&raw);
-
-            for (const auto & chunk : chunks)
-            {
-                // ByteCount() is the absolute file offset here: we write
-                // sequentially into a freshly-truncated stream. It marks the start
-                // of the varint length prefix, matching the constructor's index.
-                const std::streamoff offset = coded_output.ByteCount();
-                const std::size_t payload_size = chunk.ByteSizeLong();
-
-                if (!google::protobuf::util::SerializeDelimitedToCodedStream(chunk, &coded_output))
-                {
-                    spdlog::error("[world-file] Failed to serialize chunk to stream");
-                    _closeStream();
-                    return false;
-                }
-
-                _chunk_index[chunk.id()] = ChunkIndexEntry{0, offset, payload_size};
-                _all_chunks.emplace(chunk.id());
-            }
+            _dead_bytes += _recordSize(it->second);
         }
 
-        _closeStream();
+        _chunk_index[chunk.id()] = *entry;
+        _all_chunks.emplace(chunk.id());
+        _indexEntities(chunk);
         return true;
     }
 
-    bool WorldFile<use_binary_t>::writeChunk(const proto::file::WorldChunk & chunk)
+    const native::MappedFile * WorldFile<use_binary_t>::_mapped() const
     {
-        std::vector<proto::file::WorldChunk> chunks = _readAllChunks();
-
-        bool replaced = false;
-        for (auto & c : chunks)
+        std::lock_guard lock(_mapping_mutex);
+        if (!_mapping)
         {
-            if (c.id() == chunk.id())
-            {
-                c = chunk;
-                replaced = true;
-                break;
-            }
+            _mapping.emplace(_file_path);
         }
-        if (!replaced)
-            chunks.push_back(chunk);
+        return _mapping->data() != nullptr ? &*_mapping : nullptr;
+    }
 
-        return _writeAllChunks(chunks);
+    void WorldFile<use_binary_t>::_unmap()
+    {
+        std::lock_guard lock(_mapping_mutex);
+        _mapping.reset();
     }
 
     std::optional<proto::file::WorldChunk> WorldFile<use_binary_t>::read(const proto::file::ChunkID & id) const
     {
+        // shared for the whole read, mutations must not drop the mapping underneath
+        std::shared_lock lock(_mutex);
+
         const auto index_it = _chunk_index.find(id);
         if (index_it == _chunk_index.end())
         {
             return std::nullopt;
         }
+        const ChunkIndexEntry & entry = index_it->second;
+
+        // skip the length prefix, the index already knows the size
+        const std::streamoff payload_offset = entry.offset + (std::streamoff)google::protobuf::io::CodedOutputStream::VarintSize32((uint32_t)entry.size);
+
+        const char * payload = nullptr;
+        std::string buffer;
+
+        const native::MappedFile * mapping = _mapped();
+        if (mapping != nullptr && (std::size_t)payload_offset + entry.size <= mapping->size())
+        {
+            payload = reinterpret_cast<const char *>(mapping->data()) + payload_offset;
+        }
+        else
+        {
+            // could not map, read through a local stream (not the member _stream): const + safe to call concurrently.
+            std::ifstream stream(_file_path, std::ios::in | std::ios::binary);
+            if (!stream.is_open())
+            {
+                spdlog::error("Failed to open stream for reading");
+                return std::nullopt;
+            }
 
-        // local stream (not the member _stream): const + safe to call concurrently.
-        std::ifstream stream(_file_path, std::ios::in | std::ios::binary);
-        if (!stream.is_open())
+            buffer.resize(entry.size);
+            stream.seekg(payload_offset);
+            if (!stream.read(buffer.data(), (std::streamsize)buffer.size()))
+            {
+                spdlog::error("Failed to read chunk");
+                return std::nullopt;
+            }
+            payload = buffer.data();
+        }
+
+        if (_checksum(payload, entry.size) != entry.checksum)
         {
-            spdlog::error("Failed to open stream for reading");
+            spdlog::error("[world-file] Checksum mismatch of chunk ({}, {}, {})", id.x(), id.y(), id.z());
             return std::nullopt;
         }
 
-        // in binary format we need to seek to the offset
-        stream.seekg(index_it->second.offset);
+        return _parseRecord(id, payload, entry.size);
+    }
 
-        google::protobuf::io::IstreamInputStream raw(&stream);
-        google::protobuf::io::CodedInputStream coded_input(&raw);
+    std::vector<native::ReadRequest> WorldFile<use_binary_t>::requests(const proto::file::ChunkID & id) const
+    {
+        std::shared_lock lock(_mutex);
 
-        // read message size
-        uint32_t message_size = 0;
-        if (!coded_input.ReadVarint32(&message_size))
+        const auto index_it = _chunk_index.find(id);
+        if (index_it == _chunk_index.end())
         {
-            spdlog::error("Failed to read size prefix");
-            return std::nullopt;
+            return {};
         }
+        const ChunkIndexEntry & entry = index_it->second;
 
-        assert(message_size == index_it->second.size && "Chunk size mismatch");
+        const std::streamoff payload_offset = entry.offset + (std::streamoff)google::protobuf::io::CodedOutputStream::VarintSize32((uint32_t)entry.size);
+        return { native::ReadRequest{.path = _file_path, .offset = (std::uint64_t)payload_offset, .size = entry.size} };
+    }
+
+    std::optional<proto::file::WorldChunk> WorldFile<use_binary_t>::parse(const proto::file::ChunkID & id,
+        std::vector<std::optional<std::string>> contents) const
+    {
+        {
+            std::shared_lock lock(_mutex);
+
+            const auto index_it = _chunk_index.find(id);
+            if (index_it != _chunk_index.end() && contents.size() == 1 && contents[0])
+            {
+                const ChunkIndexEntry & entry = index_it->second;
+                const std::string & payload = *contents[0];
+                if (payload.size() == entry.size && _checksum(payload) == entry.checksum)
+                    return _parseRecord(id, payload.data(), payload.size());
+            }
+        }
+
+        // written, removed or moved by compaction since the request was made
+        if (!contents.empty())
+            spdlog::debug("[world-file] Chunk ({}, {}, {}) changed since it was requested, reading it again", id.x(), id.y(), id.z());
+        return read(id);
+    }
 
-        // Limit reading to current message size
-        google::protobuf::io::CodedInputStream::Limit limit = coded_input.PushLimit(message_size);
+    std::optional<proto::file::WorldChunk> WorldFile<use_binary_t>::_parseRecord(const proto::file::ChunkID & id,
+        const char * payload, std::size_t size) const
+    {
+        // decompressed on the calling thread, which is a pool thread when streaming
+        std::string decompressed;
+        if (const auto frame = _compressedFrame(payload, size))
+        {
+            auto data = _compressor ? _compressor->decompress(*frame) : std::nullopt;
+            if (!data)
+            {
+                spdlog::error("[world-file] Failed to decompress chunk ({}, {}, {})", id.x(), id.y(), id.z());
+                return std::nullopt;
+            }
+            decompressed = std::move(*data);
+            payload = decompressed.data();
+            size = decompressed.size();
+        }
 
-        // read chunk
+        google::protobuf::io::ArrayInputStream input(payload, (int)size);
         proto::file::WorldChunk result;
-        if (!result.ParseFromCodedStream(&coded_input))
+        if (!result.ParseFromZeroCopyStream(&input))
         {
             spdlog::error("Failed to parse chunk");
             return std::nullopt;
         }
 
-        coded_input.PopLimit(limit);
-
         return result;
     }
 
     bool WorldFile<use_binary_t>::removeChunk(const proto::file::ChunkID& id)
     {
-        if (!_chunk_index.contains(id))
+        std::unique_lock lock(_mutex);
+
+        const auto it = _chunk_index.find(id);
+        if (it == _chunk_index.end())
         {
             return false;
         }
 
-        std::vector<proto::file::WorldChunk> chunks = _readAllChunks();
+        proto::file::WorldArchiveRecord tombstone;
+        tombstone.mutable_id()->CopyFrom(id);
+        tombstone.set_removed(true);
 
-        const auto new_end = std::remove_if(chunks.begin(), chunks.end(),
-            [&](const proto::file::WorldChunk & c){ return c.id() == id; });
-        if (new_end == chunks.end())
+        const auto entry = _appendRecord(tombstone.SerializeAsString());
+        if (!entry)
         {
-            spdlog::warn("[world-file] chunk present in index but not in file");
             return false;
         }
-        chunks.erase(new_end, chunks.end());
 
-        return _writeAllChunks(chunks);
+        // both the removed version and the tombstone itself are dead now
+        _dead_bytes += _recordSize(it->second) + _recordSize(*entry);
+        _chunk_index.erase(it);
+        _all_chunks.erase(id);
+        _unindexEntities(id);
+        return true;
+    }
+
+    bool WorldFile<use_binary_t>::needsCompaction() const
+    {
+        if (_compacting) return false;
+
+        std::shared_lock lock(_mutex);
+        return _dead_bytes >= COMPACTION_MIN_DEAD_BYTES && _dead_bytes * 2 >= (std::size_t)_log_size;
+    }
+
+    std::size_t WorldFile<use_binary_t>::deadBytes() const
+    {
+        std::shared_lock lock(_mutex);
+        return _dead_bytes;
+    }
+
+    std::size_t WorldFile<use_binary_t>::dictionarySize() const
+    {
+        std::shared_lock lock(_mutex);
+        return _compressor ? _compressor->dictionary().size() : 0;
+    }
+
+    bool WorldFile<use_binary_t>::compact()
+    {
+        // one compaction at a time, a concurrent call has nothing left to do
+        if (_compacting.exchange(true)) return true;
+        struct ResetFlag { std::atomic<bool> & flag; ~ResetFlag(){ flag = false; } } reset{_compacting};
+
+        // Records are never modified once appended, so the live ones can be rewritten
+        // without holding the lock while writes keep appending behind them.
+        absl::flat_hash_map<proto::file::ChunkID, ChunkIndexEntry> snapshot;
+        std::shared_ptr<const RecordCompressor> compressor;
+        {
+            std::shared_lock lock(_mutex);
+            snapshot = _chunk_index;
+            compressor = _compressor;
+        }
+
+        std::ifstream log(_file_path, std::ios::in | std::ios::binary);
+        if (!log.is_open())
+        {
+            spdlog::error("[world-file] Failed to open stream for compaction");
+            return false;
+        }
+
+        // live chunks are stored again, compressed with a dictionary trained from them
+        std::vector<std::string> samples;
+        std::size_t sample_bytes = 0;
+        for (auto it = snapshot.begin(); _compression_level > 0 && it != snapshot.end() && sample_bytes < DICTIONARY_SAMPLE_BYTES; ++it)
+        {
+            const auto payload = _readRecord(log, it->second);
+            auto chunk_bytes = payload ? _decodeRecord(*payload, compressor.get()) : std::nullopt;
+            if (!chunk_bytes) continue;
+
+            sample_bytes += chunk_bytes->size();
+            samples.push_back(std::move(*chunk_bytes));
+        }
+        const auto recompressor = std::make_shared<const RecordCompressor>(_compression_level, RecordCompressor::trainDictionary(samples));
+        samples.clear();
+
+        std::filesystem::path compacted_path = _file_path;
+        compacted_path += ".compact";
+
+        std::ofstream compacted(compacted_path, std::ios::out | std::ios::trunc | std::ios::binary);
+        if (!compacted.is_open())
+        {
+            spdlog::error("[world-file] Failed to open {} for compaction", compacted_path.string());
+            return false;
+        }
+
+        // legacy archives are upgraded on the way
+        const std::string header = _header(recompressor->dictionary());
+        compacted.write(header.data(), (std::streamsize)header.size());
+
+        std::streamoff compacted_size = (std::streamoff)header.size();
+        const auto rewrite = [&](const proto::file::ChunkID & id, const ChunkIndexEntry & entry) -> std::optional<ChunkIndexEntry>
+        {
+            const auto payload = _readRecord(log, entry);
+            auto chunk_bytes = payload ? _decodeRecord(*payload, compressor.get()) : std::nullopt;
+            if (!chunk_bytes) return std::nullopt;
+
+            const std::string record = _encodeRecord(id, std::move(*chunk_bytes), recompressor.get());
+            const std::string bytes = _delimited(record);
+            if (!compacted.write(bytes.data(), (std::streamsize)bytes.size())) return std::nullopt;
+
+            const ChunkIndexEntry moved{entry.index, compacted_size, record.size(), _checksum(record)};
+            compacted_size += (std::streamoff)bytes.size();
+            return moved;
+        };
+
+        // id -> (old entry, entry in the compacted file)
+        absl::flat_hash_map<proto::file::ChunkID, std::pair<ChunkIndexEntry, ChunkIndexEntry>> rewritten;
+        rewritten.reserve(snapshot.size());
+
+        for (const auto & [id, entry] : snapshot)
+        {
+            const auto moved = rewrite(id, entry);
+            if (!moved)
+            {
+                spdlog::error("[world-file] Failed to rewrite record during compaction");
+                std::filesystem::remove(compacted_path);
+                return false;
+            }
+            rewritten.emplace(id, std::make_pair(entry, *moved));
+        }
+
+        std::unique_lock lock(_mutex);
+
+        // catch up with chunks written since the snapshot, removed ones are simply not copied
+        absl::flat_hash_map<proto::file::ChunkID, ChunkIndexEntry> compacted_index;
+        compacted_index.reserve(_chunk_index.size());
+        for (const auto & [id, entry] : _chunk_index)
+        {
+            const auto rewritten_it = rewritten.find(id);
+            if (rewritten_it != rewritten.end() && rewritten_it->second.first.offset == entry.offset)
+            {
+                compacted_index.emplace(id, rewritten_it->second.second);
+                continue;
+            }
+
+            const auto moved = rewrite(id, entry);
+            if (!moved)
+            {
+                spdlog::error("[world-file] Failed to rewrite record during compaction");
+                std::filesystem::remove(compacted_path);
+                return false;
+            }
+            compacted_index.emplace(id, *moved);
+        }
+
+        const std::string toc = _tableOfContents(compacted_index, _entity_index, 0, compacted_size);
+        compacted.write(toc.data(), (std::streamsize)toc.size());
+
+        log.close();
+        // a mapped file can't be replaced on every platform
+        _unmap();
+        compacted.flush();
+        const bool written = compacted.good();
+        compacted.close();
+
+        std::error_code ec;
+        if (written) std::filesystem::rename(compacted_path, _file_path, ec);
+        if (!written || ec)
+        {
+            spdlog::error("[world-file] Failed to replace archive with its compacted copy: {}", ec.message());
+            std::filesystem::remove(compacted_path, ec);
+            return false;
+        }
+
+        spdlog::debug("[world-file] Compacted {}, reclaimed {} bytes, dictionary of {} bytes",
+            _file_path.string(), _log_size - compacted_size, recompressor->dictionary().size());
+
+        _chunk_index = std::move(compacted_index);
+        _compressor = recompressor;
+        _version = ARCHIVE_VERSION;
+        _has_table_of_contents = true;
+        _log_begin = (std::streamoff)header.size();
+        _log_size = compacted_size;
+        _dead_bytes = 0;
+        return true;
     }
 
     bool WorldFile<use_binary_t>::writeEntity(const proto::file::ChunkID& chunk_id,
@@ -292,7 +954,7 @@ namespace astre::file
             entities->Add()->CopyFrom(entity_def);
         }
 
-        // Persist updated chunk via existing logic (handles rewrite & index)
+        // Persist updated chunk, appends its new version and updates the index
         return writeChunk(chunk);
     }
 
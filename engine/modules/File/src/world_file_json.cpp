@@ -40,10 +40,47 @@ namespace astre::file
             _chunk_index[chunk.id()].index = i;
             _all_chunks.emplace(chunk.id());
         }
+        _indexEntities(data);
 
         _valid = true;
     }
 
+    // Caller holds the exclusive lock, except the constructor.
+    void WorldFile<use_json_t>::_indexEntities(const proto::file::WorldFileData & archive)
+    {
+        _entity_index.clear();
+        for (const auto & chunk : archive.chunks())
+        {
+            for (const auto & entity_def : chunk.entities())
+            {
+                _entity_index[entity_def.id()] = EntityLocation{
+                    .chunk = chunk.id(),
+                    .position = entity_def.has_transform() ? std::make_optional(entity_def.transform().position()) : std::nullopt
+                };
+            }
+        }
+    }
+
+    std::vector<native::ReadRequest> WorldFile<use_json_t>::requests(const proto::file::ChunkID &) const
+    {
+        // a chunk has no byte range of its own, the whole file is parsed per read
+        return {};
+    }
+
+    std::optional<proto::file::WorldChunk> WorldFile<use_json_t>::parse(const proto::file::ChunkID & id,
+        std::vector<std::optional<std::string>>) const
+    {
+        return read(id);
+    }
+
+    std::optional<EntityLocation> WorldFile<use_json_t>::findEntity(std::uint64_t entity) const
+    {
+        std::shared_lock lock(_mutex);
+        const auto it = _entity_index.find(entity);
+        if (it == _entity_index.end()) return std::nullopt;
+        return it->second;
+    }
+
 
     bool WorldFile<use_json_t>::_openStream(std::ios::openmode mode) {
         if (_stream.is_open()) {
@@ -81,11 +118,18 @@ namespace astre::file
         return buffer;
     }
 
-    const absl::flat_hash_set<proto::file::ChunkID> & WorldFile<use_json_t>::getAllChunks() const
+    absl::flat_hash_set<proto::file::ChunkID> WorldFile<use_json_t>::getAllChunks() const
     {
+        std::shared_lock lock(_mutex);
         return _all_chunks;
     }
 
+    bool WorldFile<use_json_t>::containsChunk(const proto::file::ChunkID & id) const
+    {
+        std::shared_lock lock(_mutex);
+        return _all_chunks.contains(id);
+    }
+
     bool WorldFile<use_json_t>::writeChunk(const proto::file::WorldChunk & chunk) 
     {
         // Load existing
@@ -141,6 +185,9 @@ namespace astre::file
 
         _closeStream();
 
+        std::unique_lock lock(_mutex);
+        _indexEntities(archive);
+
         // append
         if(!replaced)
         {
@@ -160,10 +207,15 @@ namespace astre::file
 
     std::optional<proto::file::WorldChunk> WorldFile<use_json_t>::read(const proto::file::ChunkID & id) const
     {
-        const auto index_it = _chunk_index.find(id);
-        if (index_it == _chunk_index.end())
+        std::size_t index;
         {
-            return std::nullopt;
+            std::shared_lock lock(_mutex);
+            const auto index_it = _chunk_index.find(id);
+            if (index_it == _chunk_index.end())
+            {
+                return std::nullopt;
+            }
+            index = index_it->second.index;
         }
 
         // local stream (not the member _stream): const + safe to call concurrently.
@@ -190,7 +242,6 @@ namespace astre::file
             return std::nullopt;
         }
 
-        const std::size_t index = index_it->second.index;
         if (index >= static_cast<std::size_t>(archive.chunks_size()))
         {
             spdlog::error("Invalid index in chunk map");
@@ -204,7 +255,7 @@ namespace astre::file
 
     bool WorldFile<use_json_t>::removeChunk(const proto::file::ChunkID& id)
     {
-        if (!_chunk_index.contains(id))
+        if (!containsChunk(id))
         {
             return false;
         }
@@ -275,6 +326,7 @@ namespace astre::file
             _closeStream();
             
             // Update caches
+            std::unique_lock lock(_mutex);
             _all_chunks.erase(id);
 
             // rebuild indexes
@@ -289,6 +341,7 @@ namespace astre::file
                 };
                 _all_chunks.emplace(ch.id());
             }
+            _indexEntities(archive);
 
             spdlog::debug("[world-file] chunk removed");
             return true;
@@ -430,6 +483,8 @@ namespace astre::file
         }
 
         // Note: _chunk_index / _all_chunks unchanged (we only modified entities within a chunk)
+        std::unique_lock lock(_mutex);
+        _indexEntities(archive);
         spdlog::debug("[world-file] entity '{}' removed from chunk ({},{},{})",
                       entity_id, chunk_id.x(), chunk_id.y(), chunk_id.z());
         return true;
@@ -52,10 +52,12 @@ namespace astre::loader
         asio::awaitable<bool> unload(const proto::file::ChunkID & chunk);
 
     private:
-        std::optional<proto::file::ChunkID> _cachedTransformChunk(
+        // Chunk of the cached transform of every entity in the cached chunk, in one
+        // pass over it rather than one per entity.
+        void _cachedTransformChunks(
             asset::WorldStreamer & world_streamer,
             const proto::file::ChunkID & chunk_id,
-            ecs::Entity entity) const;
+            absl::flat_hash_map<ecs::Entity, proto::file::ChunkID> & out) const;
 
         asio::awaitable<bool> _syncStaleChunkEntities(
             asset::WorldStreamer & world_streamer,
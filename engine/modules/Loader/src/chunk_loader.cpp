@@ -22,7 +22,7 @@ namespace astre::loader
         }
 
         // Re-home entities that crossed a chunk border. The stale pass below
-        // only fires when a chunk leaves the radius, so at LOAD_RADIUS >= 1 a
+        // only fires when a chunk leaves the radius, so at a load radius >= 1 a
         // border cross between two resident chunks needs this. Entities that
         // crossed into an unloaded chunk get re-homed here too, then unloaded by
         // the stale pass (their new chunk is not required, so it goes stale).
@@ -105,21 +105,19 @@ namespace astre::loader
         co_return true;
     }
 
-    std::optional<proto::file::ChunkID> ChunkLoader::_cachedTransformChunk(
+    void ChunkLoader::_cachedTransformChunks(
         asset::WorldStreamer & world_streamer,
         const proto::file::ChunkID & chunk_id,
-        ecs::Entity entity) const
+        absl::flat_hash_map<ecs::Entity, proto::file::ChunkID> & out) const
     {
         const auto * chunk = world_streamer.read(chunk_id);
-        if(!chunk) return std::nullopt;
+        if(!chunk) return;
 
         for(const auto & entity_def : chunk->entities())
         {
-            if(entity_def.id() != entity || !entity_def.has_transform()) continue;
-            return world_streamer.chunkIdForPosition(math::deserialize(entity_def.transform().position()));
+            if(!entity_def.has_transform()) continue;
+            out[entity_def.id()] = world_streamer.chunkIdForPosition(math::deserialize(entity_def.transform().position()));
         }
-
-        return std::nullopt;
     }
 
     asio::awaitable<bool> ChunkLoader::_syncStaleChunkEntities(
@@ -129,6 +127,7 @@ namespace astre::loader
     {
         EntitySerializer serializer;
         std::vector<std::pair<ecs::Entity, proto::file::ChunkID>> owned;
+        absl::flat_hash_map<ecs::Entity, proto::file::ChunkID> cached_chunks;
         for(const auto & chunk : stale)
         {
             auto it = _chunk_entities.find(chunk);
@@ -136,6 +135,7 @@ namespace astre::loader
 
             for(const auto entity : it->second)
                 owned.emplace_back(entity, chunk);
+            _cachedTransformChunks(world_streamer, chunk, cached_chunks);
         }
 
         for(const auto & [entity, old_chunk] : owned)
@@ -160,8 +160,8 @@ namespace astre::loader
                 continue;
             }
 
-            const auto cached_chunk = _cachedTransformChunk(world_streamer, old_chunk, entity);
-            if(cached_chunk.has_value() && *cached_chunk == new_chunk) continue;
+            const auto cached_chunk = cached_chunks.find(entity);
+            if(cached_chunk != cached_chunks.end() && cached_chunk->second == new_chunk) continue;
 
             if(!co_await _rehomeEntity(world_streamer, entity, std::move(entity_def), old_chunk, new_chunk)) co_return false;
         }
@@ -20,7 +20,38 @@ namespace astre::loader
             });
         }
 
-        if((co_await _renderer.createVertexBuffer(mesh_def.name(), mesh)) == std::nullopt)
+        mesh.lods.reserve(mesh_def.lods().size());
+        for(const auto & lod_def : mesh_def.lods())
+        {
+            render::MeshLOD & lod = mesh.lods.emplace_back();
+            lod.indices.assign(lod_def.indices().begin(), lod_def.indices().end());
+            lod.vertices.reserve(lod_def.vertices().size());
+            for(const auto & v : lod_def.vertices())
+            {
+                lod.vertices.push_back({
+                    math::deserialize(v.position()),
+                    math::deserialize(v.normal()),
+                    math::deserialize(v.uv())
+                });
+            }
+            lod.error = lod_def.error();
+        }
+
+        if(mesh_def.has_bounds())
+        {
+            const math::Vec3 aabb_min = math::deserialize(mesh_def.bounds().aabb_min());
+            const math::Vec3 aabb_max = math::deserialize(mesh_def.bounds().aabb_max());
+            mesh.bounds = render::BoundingVolume{
+                .aabb_min = aabb_min,
+                .aabb_max = aabb_max,
+                .center = (aabb_min + aabb_max) * 0.5f,
+                .radius = mesh_def.bounds().radius()
+            };
+        }
+
+        const render::VertexFormat format = mesh_def.quantize_positions() ? render::VertexFormat::Quantized : render::VertexFormat::Compact;
+
+        if((co_await _renderer.createVertexBuffer(mesh_def.name(), mesh, format)) == std::nullopt)
         {
             spdlog::error("Failed to create vertex buffer for mesh: {}", mesh_def.name());
             co_return false;
@@ -10,6 +10,11 @@
 #   error "Error, unsupported platform"
 #endif
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -23,4 +28,82 @@ namespace astre::native
      * @param args The arguments to pass to the command
      */
     std::pair<int, std::string> runProcess(const std::string & command, std::vector<std::string> args = {});
-}
\ No newline at end of file
+
+    /**
+     * Read-only memory mapping of a whole file.
+     * The view stays valid while the object lives, even if the file is replaced on disk
+     * (except on Windows, where a mapped file can't be replaced or truncated).
+     */
+    class MappedFile
+    {
+        public:
+            MappedFile() = default;
+
+            /**
+             * Maps the file, `data()` is null if it could not be mapped or is empty.
+             */
+            explicit MappedFile(const std::filesystem::path & path);
+
+            MappedFile(MappedFile && other) noexcept;
+            MappedFile & operator=(MappedFile && other) noexcept;
+
+            MappedFile(const MappedFile &) = delete;
+            MappedFile & operator=(const MappedFile &) = delete;
+
+            ~MappedFile();
+
+            const std::byte * data() const { return _data; }
+            std::size_t size() const { return _size; }
+
+        private:
+            void _unmap();
+
+            const std::byte * _data = nullptr;
+            std::size_t _size = 0;
+    };
+
+    /**
+     * One read of a batch: `size` bytes at `offset`, or the rest of the file when `size` is unset.
+     */
+    struct ReadRequest
+    {
+        std::filesystem::path path;
+        std::uint64_t offset = 0;
+        std::optional<std::size_t> size;
+    };
+
+    /**
+     * Reads many file ranges with as few system calls as the platform allows.
+     * On Linux a batch is submitted to an io_uring at once, up to the queue depth per
+     * system call. Where io_uring is unavailable (other platforms, old kernels, or
+     * disabled by the sandbox) the ranges are read one by one.
+     * Requests are taken a queue depth at a time, so no more files than that are open at once.
+     * Blocking and not thread safe, meant to be owned by a single I/O thread.
+     */
+    class BatchFileReader
+    {
+        public:
+            explicit BatchFileReader(unsigned int queue_depth = 64);
+
+            BatchFileReader(const BatchFileReader &) = delete;
+            BatchFileReader & operator=(const BatchFileReader &) = delete;
+
+            ~BatchFileReader();
+
+            /**
+             * Contents of every request, in order. Nullopt for requests whose file could
+             * not be opened or that reach past its end.
+             */
+            std::vector<std::optional<std::string>> read(const std::vector<ReadRequest> & requests);
+
+            /**
+             * Whether batches are submitted to io_uring.
+             */
+            bool batched() const { return _ring != nullptr; }
+
+        private:
+            struct Ring;
+            unsigned int _queue_depth;
+            std::unique_ptr<Ring> _ring;
+    };
+}
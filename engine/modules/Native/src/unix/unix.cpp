@@ -1,4 +1,20 @@
-#include "unix/unix.h"
+#include "native/native.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ASTRE_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+#include <spdlog/spdlog.h>
 
 namespace astre::native {
 
@@ -73,4 +89,364 @@ namespace astre::native {
 
         return {exit_code, output};
     }
-} // namespace astre::native
\ No newline at end of file
+
+    MappedFile::MappedFile(const std::filesystem::path & path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            spdlog::error("Failed to open {} for mapping: {}", path.string(), strerror(errno));
+            return;
+        }
+
+        struct stat status;
+        if (fstat(fd, &status) == -1 || status.st_size == 0)
+        {
+            close(fd);
+            return;
+        }
+
+        void * data = mmap(nullptr, (std::size_t)status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        // the mapping keeps its own reference to the file
+        close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            spdlog::error("Failed to map {}: {}", path.string(), strerror(errno));
+            return;
+        }
+
+        _data = static_cast<const std::byte *>(data);
+        _size = (std::size_t)status.st_size;
+    }
+
+    MappedFile::MappedFile(MappedFile && other) noexcept
+        : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0))
+    {}
+
+    MappedFile & MappedFile::operator=(MappedFile && other) noexcept
+    {
+        if (this != &other)
+        {
+            _unmap();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        _unmap();
+    }
+
+    void MappedFile::_unmap()
+    {
+        if (_data == nullptr) return;
+
+        munmap(const_cast<std::byte *>(_data), _size);
+        _data = nullptr;
+        _size = 0;
+    }
+
+#ifdef ASTRE_HAS_IO_URING
+    // Submission and completion rings shared with the kernel, driven through the raw
+    // system calls. The reader is the only producer of submissions and the only
+    // consumer of completions.
+    struct BatchFileReader::Ring
+    {
+        int fd = -1;
+        unsigned int entries = 0;
+
+        void * sq_ring = MAP_FAILED;
+        std::size_t sq_ring_size = 0;
+        void * cq_ring = MAP_FAILED;
+        std::size_t cq_ring_size = 0;
+        io_uring_sqe * sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+        std::size_t sqes_size = 0;
+
+        unsigned int * sq_tail = nullptr;
+        unsigned int * sq_mask = nullptr;
+        unsigned int * sq_array = nullptr;
+        unsigned int * cq_head = nullptr;
+        unsigned int * cq_tail = nullptr;
+        unsigned int * cq_mask = nullptr;
+        io_uring_cqe * cqes = nullptr;
+
+        ~Ring()
+        {
+            if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+            if (cq_ring != MAP_FAILED && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+            if (sq_ring != MAP_FAILED) munmap(sq_ring, sq_ring_size);
+            if (fd != -1) close(fd);
+        }
+
+        static std::unique_ptr<Ring> create(unsigned int queue_depth)
+        {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+
+            auto ring = std::make_unique<Ring>();
+            ring->fd = (int)syscall(__NR_io_uring_setup, queue_depth, &params);
+            if (ring->fd < 0)
+            {
+                spdlog::debug("[batch-file-reader] io_uring unavailable ({}), reading files one by one", strerror(errno));
+                return nullptr;
+            }
+
+            ring->entries = params.sq_entries;
+            ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+            ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+            const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (single_mmap)
+                ring->sq_ring_size = ring->cq_ring_size = std::max(ring->sq_ring_size, ring->cq_ring_size);
+
+            ring->sq_ring = mmap(nullptr, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+            if (ring->sq_ring == MAP_FAILED)
+            {
+                spdlog::warn("[batch-file-reader] Failed to map io_uring submission ring: {}", strerror(errno));
+                return nullptr;
+            }
+
+            ring->cq_ring = single_mmap ? ring->sq_ring
+                : mmap(nullptr, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+            ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+            ring->sqes = static_cast<io_uring_sqe *>(mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES));
+            if (ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED)
+            {
+                spdlog::warn("[batch-file-reader] Failed to map io_uring rings: {}", strerror(errno));
+                return nullptr;
+            }
+
+            auto * sq = static_cast<std::uint8_t *>(ring->sq_ring);
+            ring->sq_tail = reinterpret_cast<unsigned int *>(sq + params.sq_off.tail);
+            ring->sq_mask = reinterpret_cast<unsigned int *>(sq + params.sq_off.ring_mask);
+            ring->sq_array = reinterpret_cast<unsigned int *>(sq + params.sq_off.array);
+
+            auto * cq = static_cast<std::uint8_t *>(ring->cq_ring);
+            ring->cq_head = reinterpret_cast<unsigned int *>(cq + params.cq_off.head);
+            ring->cq_tail = reinterpret_cast<unsigned int *>(cq + params.cq_off.tail);
+            ring->cq_mask = reinterpret_cast<unsigned int *>(cq + params.cq_off.ring_mask);
+            ring->cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+            spdlog::debug("[batch-file-reader] io_uring with {} entries", ring->entries);
+            return ring;
+        }
+
+        // Reads `iovecs[i]` of `fds[i]` at `offsets[i]` for every index in `pending`,
+        // `entries` requests per system call. `done[i]` receives the bytes read or -errno.
+        // False if the ring failed, the requests without a result are then left at 0.
+        // Requests already submitted are reaped before returning even then; `in_flight`
+        // counts those the kernel did not complete, whose buffers and files it may
+        // still be using.
+        bool read(const std::vector<std::size_t> & pending, const std::vector<int> & fds,
+            const std::vector<std::uint64_t> & offsets, std::vector<iovec> & iovecs, std::vector<long long> & done,
+            unsigned int & in_flight)
+        {
+            in_flight = 0;
+            for (std::size_t next = 0; next < pending.size();)
+            {
+                const unsigned int count = (unsigned int)std::min<std::size_t>(entries, pending.size() - next);
+
+                unsigned int tail = *sq_tail;
+                for (unsigned int k = 0; k < count; ++k)
+                {
+                    const std::size_t i = pending[next + k];
+                    const unsigned int index = tail & *sq_mask;
+
+                    io_uring_sqe & sqe = sqes[index];
+                    std::memset(&sqe, 0, sizeof(sqe));
+                    sqe.opcode = IORING_OP_READV;
+                    sqe.fd = fds[i];
+                    sqe.off = offsets[i];
+                    sqe.addr = (std::uint64_t)(std::uintptr_t)&iovecs[i];
+                    sqe.len = 1;
+                    sqe.user_data = i;
+
+                    sq_array[index] = index;
+                    ++tail;
+                }
+                // the kernel must see the entries before the new tail
+                __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+
+                unsigned int submitted = 0;
+                unsigned int completed = 0;
+                while (completed < count)
+                {
+                    const int entered = (int)syscall(__NR_io_uring_enter, fd, count - submitted, count - completed, IORING_ENTER_GETEVENTS, nullptr, 0);
+                    if (entered < 0)
+                    {
+                        if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+
+                        spdlog::error("[batch-file-reader] io_uring_enter failed: {}", strerror(errno));
+                        in_flight = drain(submitted - completed, done);
+                        return false;
+                    }
+                    submitted += (unsigned int)entered;
+                    completed += reap(done);
+                }
+
+                next += count;
+            }
+            return true;
+        }
+
+        // Moves every available completion into `done`, returns how many there were.
+        unsigned int reap(std::vector<long long> & done)
+        {
+            unsigned int head = *cq_head;
+            const unsigned int available = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+            unsigned int reaped = 0;
+            for (; head != available; ++head, ++reaped)
+            {
+                const io_uring_cqe & cqe = cqes[head & *cq_mask];
+                done[(std::size_t)cqe.user_data] = cqe.res;
+            }
+            __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+            return reaped;
+        }
+
+        // Waits for `outstanding` submitted requests without submitting more. Closing
+        // the ring does not wait for them, so this is the only point after which their
+        // buffers are free again. Returns how many could not be waited for.
+        unsigned int drain(unsigned int outstanding, std::vector<long long> & done)
+        {
+            while (outstanding > 0)
+            {
+                outstanding -= std::min(outstanding, reap(done));
+                if (outstanding == 0) break;
+
+                if (syscall(__NR_io_uring_enter, fd, 0, outstanding, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)
+                {
+                    spdlog::error("[batch-file-reader] Failed to wait for {} io_uring reads: {}", outstanding, strerror(errno));
+                    break;
+                }
+            }
+            return outstanding;
+        }
+    };
+#else
+    struct BatchFileReader::Ring
+    {
+        static std::unique_ptr<Ring> create(unsigned int) { return nullptr; }
+
+        bool read(const std::vector<std::size_t> &, const std::vector<int> &,
+            const std::vector<std::uint64_t> &, std::vector<iovec> &, std::vector<long long> &, unsigned int & in_flight)
+        {
+            in_flight = 0;
+            return false;
+        }
+    };
+#endif
+
+    BatchFileReader::BatchFileReader(unsigned int queue_depth)
+        : _queue_depth(std::max(queue_depth, 1u)),
+        _ring(Ring::create(_queue_depth))
+    {}
+
+    BatchFileReader::~BatchFileReader() = default;
+
+    std::vector<std::optional<std::string>> BatchFileReader::read(const std::vector<ReadRequest> & requests)
+    {
+        std::vector<std::optional<std::string>> results(requests.size());
+
+        // files are opened per window, a large batch would otherwise run out of descriptors
+        for (std::size_t begin = 0; begin < requests.size(); begin += _queue_depth)
+        {
+            const std::size_t count = std::min<std::size_t>(_queue_depth, requests.size() - begin);
+
+            // the kernel reads into these, they move into the results once it is done
+            std::vector<std::optional<std::string>> buffers(count);
+            std::vector<int> fds(count, -1);
+            std::vector<std::uint64_t> offsets(count, 0);
+            std::vector<iovec> iovecs(count);
+            std::vector<long long> done(count, 0);
+            std::vector<std::size_t> pending;
+            pending.reserve(count);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const ReadRequest & request = requests[begin + i];
+
+                // missing files are not an error of the reader, optional sources are asked for too
+                fds[i] = open(request.path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fds[i] == -1)
+                {
+                    spdlog::debug("[batch-file-reader] Failed to open {}: {}", request.path.string(), strerror(errno));
+                    continue;
+                }
+
+                std::size_t size = 0;
+                if (request.size)
+                {
+                    size = *request.size;
+                }
+                else
+                {
+                    struct stat status;
+                    if (fstat(fds[i], &status) == -1 || (std::uint64_t)status.st_size < request.offset)
+                    {
+                        spdlog::debug("[batch-file-reader] Failed to get size of {}", request.path.string());
+                        continue;
+                    }
+                    size = (std::size_t)((std::uint64_t)status.st_size - request.offset);
+                }
+
+                buffers[i].emplace(size, '\0');
+                offsets[i] = request.offset;
+                iovecs[i] = iovec{buffers[i]->data(), size};
+                if (size > 0) pending.push_back(i);
+            }
+
+            unsigned int in_flight = 0;
+            if (_ring && !_ring->read(pending, fds, offsets, iovecs, done, in_flight))
+            {
+                _ring.reset();
+                if (in_flight > 0)
+                {
+                    // the kernel may still write into the buffers and read the files,
+                    // releasing either is unsafe, so they are left to the process
+                    spdlog::error("[batch-file-reader] Abandoning {} reads the kernel still owns", in_flight);
+                    (void)new std::vector<std::optional<std::string>>(std::move(buffers));
+                    (void)new std::vector<iovec>(std::move(iovecs));
+                    continue;
+                }
+            }
+
+            for (const std::size_t i : pending)
+            {
+                if (done[i] < 0)
+                {
+                    // retried below, the ring may refuse a file pread still handles
+                    spdlog::debug("[batch-file-reader] io_uring read of {} failed: {}", requests[begin + i].path.string(), strerror((int)-done[i]));
+                    done[i] = 0;
+                }
+
+                // short reads and everything the ring did not take are finished here
+                std::string & buffer = *buffers[i];
+                std::size_t filled = (std::size_t)done[i];
+                while (filled < buffer.size())
+                {
+                    const ssize_t read_count = pread(fds[i], buffer.data() + filled, buffer.size() - filled, (off_t)(offsets[i] + filled));
+                    if (read_count < 0 && errno == EINTR) continue;
+                    if (read_count <= 0) break;
+                    filled += (std::size_t)read_count;
+                }
+
+                if (filled < buffer.size())
+                {
+                    spdlog::debug("[batch-file-reader] Failed to read {} bytes of {}", buffer.size(), requests[begin + i].path.string());
+                    buffers[i].reset();
+                }
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (fds[i] != -1) close(fds[i]);
+                results[begin + i] = std::move(buffers[i]);
+            }
+        }
+        return results;
+    }
+} // namespace astre::native
@@ -1,4 +1,7 @@
-#include "native/windows/win.h"
+#include "native/native.h"
+
+#include <algorithm>
+#include <utility>
 
 #include <spdlog/spdlog.h>
 
@@ -134,4 +137,141 @@ std::string GetLastErrorAsString() {
 
         return {static_cast<int>(exit_code), output};
     }
-} // namespace astre::native
\ No newline at end of file
+
+    MappedFile::MappedFile(const std::filesystem::path & path)
+    {
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            spdlog::error("Failed to open {} for mapping: {}", path.string(), GetLastErrorAsString());
+            return;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        CloseHandle(file);
+        if (mapping == NULL)
+        {
+            spdlog::error("Failed to create mapping of {}: {}", path.string(), GetLastErrorAsString());
+            return;
+        }
+
+        const void * data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        // the view keeps the mapping object alive
+        CloseHandle(mapping);
+
+        if (data == NULL)
+        {
+            spdlog::error("Failed to map view of {}: {}", path.string(), GetLastErrorAsString());
+            return;
+        }
+
+        _data = static_cast<const std::byte *>(data);
+        _size = (std::size_t)size.QuadPart;
+    }
+
+    MappedFile::MappedFile(MappedFile && other) noexcept
+        : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0))
+    {}
+
+    MappedFile & MappedFile::operator=(MappedFile && other) noexcept
+    {
+        if (this != &other)
+        {
+            _unmap();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        _unmap();
+    }
+
+    void MappedFile::_unmap()
+    {
+        if (_data == nullptr) return;
+
+        UnmapViewOfFile(_data);
+        _data = nullptr;
+        _size = 0;
+    }
+
+    // no io_uring, every range is a positional ReadFile
+    struct BatchFileReader::Ring {};
+
+    BatchFileReader::BatchFileReader(unsigned int queue_depth)
+        : _queue_depth(queue_depth)
+    {}
+
+    BatchFileReader::~BatchFileReader() = default;
+
+    std::vector<std::optional<std::string>> BatchFileReader::read(const std::vector<ReadRequest> & requests)
+    {
+        std::vector<std::optional<std::string>> results(requests.size());
+
+        for (std::size_t i = 0; i < requests.size(); ++i)
+        {
+            const ReadRequest & request = requests[i];
+
+            HANDLE file = CreateFileW(request.path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                spdlog::debug("[batch-file-reader] Failed to open {}: {}", request.path.string(), GetLastErrorAsString());
+                continue;
+            }
+
+            std::size_t size = 0;
+            LARGE_INTEGER file_size;
+            if (request.size)
+            {
+                size = *request.size;
+            }
+            else if (GetFileSizeEx(file, &file_size) && (std::uint64_t)file_size.QuadPart >= request.offset)
+            {
+                size = (std::size_t)((std::uint64_t)file_size.QuadPart - request.offset);
+            }
+            else
+            {
+                spdlog::debug("[batch-file-reader] Failed to get size of {}", request.path.string());
+                CloseHandle(file);
+                continue;
+            }
+
+            std::string buffer(size, '\0');
+            std::size_t filled = 0;
+            while (filled < size)
+            {
+                const std::uint64_t offset = request.offset + filled;
+                OVERLAPPED position{};
+                position.Offset = (DWORD)(offset & 0xffffffffull);
+                position.OffsetHigh = (DWORD)(offset >> 32);
+
+                DWORD count = 0;
+                const DWORD chunk = (DWORD)std::min<std::size_t>(size - filled, 1u << 30);
+                if (!ReadFile(file, buffer.data() + filled, chunk, &count, &position) || count == 0) break;
+                filled += count;
+            }
+            CloseHandle(file);
+
+            if (filled < size)
+            {
+                spdlog::debug("[batch-file-reader] Failed to read {} bytes of {}", size, request.path.string());
+                continue;
+            }
+            results[i] = std::move(buffer);
+        }
+
+        return results;
+    }
+} // namespace astre::native
@@ -1,14 +1,33 @@
 #pragma once
 
 #include <expected>
+#include <optional>
 
 #include "native/native.h"
 #include <asio.hpp>
 
 #include "render/render.hpp"
+#include "render/light_clusters.hpp"
 
 namespace astre::pipeline
 {
+    // content of shadow maps rendered in previous frames, owned by RendererState and updated every frame
+    struct ShadowMapCache
+    {
+        /**
+         * @brief Remember the light and casters `slot` is rendered with
+         *
+         * @return false if the slot already holds a shadow map of `signature`, so its pass can be skipped
+         */
+        bool update(std::size_t slot, std::uint64_t signature);
+
+        // slot has to be re-rendered once it is used again
+        void invalidate(std::size_t slot);
+
+        // signature of light and casters per shadow map slot, nullopt if slot has to be re-rendered
+        std::vector<std::optional<std::uint64_t>> signatures;
+    };
+
     // const and where
     // are valid during all frames 
     struct DeferredShadingResources
@@ -18,9 +37,21 @@ namespace astre::pipeline
         std::vector<std::size_t> deferred_textures; // where
 
         std::size_t light_ssbo;
+        std::size_t light_cluster_ssbo; // offset and count of every froxel in light_index_ssbo
+        std::size_t light_index_ssbo; // light indices of all froxels, rebuilt every frame
+        std::size_t instance_ssbo; // per-instance model matrix and color, rewritten every frame
+        std::size_t draw_ssbo; // per-draw data of indirect draws, rewritten every frame
+
+        std::size_t instanced_gbuffer_shader; // const, GBuffer shader reading instance_ssbo
+
+        // every shadow caster renders into its own tile of a single atlas,
+        // tile size follows importance of the light
+        static constexpr unsigned int SHADOW_ATLAS_SIZE = 4096;
+        static constexpr unsigned int SHADOW_ATLAS_MIN_TILE_SIZE = 256;
 
-        std::vector<std::size_t> shadow_map_fbos; // where
-        std::vector<std::size_t> shadow_map_textures; // where
+        std::size_t shadow_atlas_fbo; // where
+        std::size_t shadow_atlas_texture; // where
+        render::ShadowAtlas shadow_atlas{SHADOW_ATLAS_SIZE, SHADOW_ATLAS_MIN_TILE_SIZE}; // const
 
         std::size_t screen_quad_vb; // where
         std::size_t screen_quad_shader; // const
@@ -34,6 +65,7 @@ namespace astre::pipeline
     asio::awaitable<render::FrameStats> deferredShadingStage(
         render::IRenderer & renderer,
         const DeferredShadingResources & resources,
+        ShadowMapCache & shadow_map_cache,
         const render::Frame & frame,
         std::optional<std::size_t> fbo = std::nullopt);
 }
\ No newline at end of file
@@ -68,15 +68,27 @@ namespace astre::pipeline
                 .input = ecs::system::InputSystem(input, registry)
             };
             
+            // gameplay ray casts from Lua hit proxies of the last visual run
+            script_runtime.setRaycastFunction(
+                [&systems](const math::Vec3 & origin, const math::Vec3 & direction, float max_distance) -> std::optional<script::RaycastResult>
+                {
+                    const auto hit = systems.visual.getRaycastScene().raycast(render::Ray{.origin = origin, .direction = direction}, max_distance);
+                    if(!hit) return std::nullopt;
+                    return script::RaycastResult{.entity = hit->entity, .distance = hit->distance, .position = hit->position};
+                });
+
             // Loaders (Stage 3 : memory -> runtime system)
             AppLoaders loaders(*renderer, script_runtime, registry);
 
+            // one I/O thread reads the source files of every streamer in batches
+            auto file_reader = std::make_shared<file::AsyncFileReader>();
+
             AppStreamers streamers{
                 // default to 32.0f chunk size
-                .world_streamer = asset::WorldStreamer(_process, 32.0f),
-                .shader_streamer = asset::ShaderStreamer(_process),
-                .script_streamer = asset::ScriptStreamer(_process),
-                .mesh_streamer = asset::MeshStreamer(_process)
+                .world_streamer = asset::WorldStreamer(_process, 32.0f, file_reader),
+                .shader_streamer = asset::ShaderStreamer(_process, file_reader),
+                .script_streamer = asset::ScriptStreamer(_process, file_reader),
+                .mesh_streamer = asset::MeshStreamer(_process, file_reader)
             };
 
             co_await _process.setWindowCallbacks(window->getHandle(), 
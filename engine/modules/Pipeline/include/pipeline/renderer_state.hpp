@@ -13,6 +13,8 @@ namespace astre::pipeline
         const DebugOverlayResources debug_overlay;
 
         const std::vector<std::size_t> viewport_fbo_textures;
+
+        ShadowMapCache shadow_map_cache; // updated by deferredShadingStage every frame
     };
 
     asio::awaitable<std::optional<RendererState>> buildRendererState(render::IRenderer & renderer, std::pair<unsigned,unsigned> display_size);
@@ -45,6 +45,7 @@ namespace astre::pipeline
             case S::ToReload: return math::Vec4(1.0f, 1.0f, 0.0f, 1.0f);    // yellow
             case S::Loaded:   return math::Vec4(1.0f, 1.0f, 1.0f, 1.0f);    // white
             case S::Required: return math::Vec4(0.0f, 1.0f, 0.0f, 1.0f);    // green
+            case S::Prefetched: return math::Vec4(0.0f, 0.6f, 1.0f, 1.0f);  // blue
             case S::Unloaded: return math::Vec4(0.1f, 0.1f, 0.1f, 1.0f); // gray (distinct from white loaded)
         }
         return math::Vec4(1.0f, 0.0f, 1.0f, 1.0f); // unreachable; magenta = bug
@@ -69,7 +70,7 @@ namespace astre::pipeline
         using S = asset::WorldStreamer::ChunkDebugState;
         // Enum order is already the desired priority; draw low -> high so higher
         // priority overwrites shared edges (depth_test off, last write wins).
-        constexpr S order[] = { S::Unloaded, S::Required, S::Loaded, S::ToReload, S::Dirty };
+        constexpr S order[] = { S::Unloaded, S::Prefetched, S::Required, S::Loaded, S::ToReload, S::Dirty };
 
         render::ShaderInputs inputs;
         inputs.in_mat4["uView"] = view;
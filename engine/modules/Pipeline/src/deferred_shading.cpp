@@ -1,6 +1,15 @@
 #include "pipeline/deferred_shading.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <tuple>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
 #include "ecs/ecs.hpp"
+#include "file/file_utils.hpp"
 
 namespace astre::pipeline
 {
@@ -48,28 +57,53 @@ namespace astre::pipeline
 
         resources.light_ssbo = *light_ssbo_res;
 
-        // Create shadow maps
-        for (unsigned int i = 0; i < ecs::system::LightSystem::MAX_SHADOW_CASTERS; ++i) 
-        {
-            auto fbo = co_await renderer.createFrameBufferObject(
-                "fbo::shadow_map" + std::to_string(i), size,
-                {{render::FBOAttachment::Type::Texture, render::FBOAttachment::Point::Depth, render::TextureFormat::Depth_32F}}
-            );
+        // Create SSBOs for clustered light lists
+        auto light_cluster_ssbo_res = co_await renderer.createShaderStorageBuffer("ssbo::light_cluster", 4, 0, nullptr);
+        if (!light_cluster_ssbo_res) {
+            spdlog::error("Failed to create light cluster SSBO");
+            co_return std::unexpected(false);
+        }
+        resources.light_cluster_ssbo = *light_cluster_ssbo_res;
 
-            if (!fbo) {
-                spdlog::error("Failed to create shadow map FBO {}", i);
-                co_return std::unexpected(false);
-            }
+        auto light_index_ssbo_res = co_await renderer.createShaderStorageBuffer("ssbo::light_index", 5, 0, nullptr);
+        if (!light_index_ssbo_res) {
+            spdlog::error("Failed to create light index SSBO");
+            co_return std::unexpected(false);
+        }
+        resources.light_index_ssbo = *light_index_ssbo_res;
 
-            resources.shadow_map_fbos.emplace_back(*fbo);
+        // Create SSBO for instance data
+        std::optional<std::size_t> instance_ssbo_res;
+        instance_ssbo_res = co_await renderer.createShaderStorageBuffer("ssbo::instance", 3, 0, nullptr);
+        if (!instance_ssbo_res) {
+            spdlog::error("Failed to create instance SSBO");
+            co_return std::unexpected(false);
         }
-        // obtain shadow maps depth textures
-        for (auto& shadow_fbo : resources.shadow_map_fbos) 
-        {
-            auto tex = renderer.getFrameBufferObjectTextures(shadow_fbo);
-            assert(tex.size() == 1 && "Shadow map FBO should have 1 texture");
-            resources.shadow_map_textures.emplace_back(tex[0]);
+
+        resources.instance_ssbo = *instance_ssbo_res;
+
+        // Create SSBO for per-draw data of indirect draws
+        auto draw_ssbo_res = co_await renderer.createShaderStorageBuffer("ssbo::draw", 6, 0, nullptr);
+        if (!draw_ssbo_res) {
+            spdlog::error("Failed to create draw SSBO");
+            co_return std::unexpected(false);
         }
+        resources.draw_ssbo = *draw_ssbo_res;
+
+        // Create shadow atlas
+        auto shadow_atlas_fbo_res = co_await renderer.createFrameBufferObject(
+            "fbo::shadow_atlas", {resources.shadow_atlas.size(), resources.shadow_atlas.size()},
+            {{render::FBOAttachment::Type::Texture, render::FBOAttachment::Point::Depth, render::TextureFormat::Depth_32F}}
+        );
+        if (!shadow_atlas_fbo_res) {
+            spdlog::error("Failed to create shadow atlas FBO");
+            co_return std::unexpected(false);
+        }
+        resources.shadow_atlas_fbo = *shadow_atlas_fbo_res;
+        // obtain shadow atlas depth texture
+        auto shadow_atlas_textures = renderer.getFrameBufferObjectTextures(resources.shadow_atlas_fbo);
+        assert(shadow_atlas_textures.size() == 1 && "Shadow atlas FBO should have 1 texture");
+        resources.shadow_atlas_texture = shadow_atlas_textures.at(0);
 
         // obtain shadow pass shader
         auto shadow_shader_res = renderer.getShader("shadow_depth");
@@ -80,6 +114,15 @@ namespace astre::pipeline
         }
         resources.shadow_map_shader = *shadow_shader_res;
 
+        // obtain GBuffer shader which supports instancing
+        auto instanced_gbuffer_shader_res = renderer.getShader("deferred_shader");
+        if(!instanced_gbuffer_shader_res)
+        {
+            spdlog::error("Failed to get instanced GBuffer shader");
+            co_return std::unexpected(false);
+        }
+        resources.instanced_gbuffer_shader = *instanced_gbuffer_shader_res;
+
         // obtain screen quad vertex buffer
         auto screen_quad_vb_res = renderer.getVertexBuffer("NDC_quad_prefab");
         if(!screen_quad_vb_res)
@@ -101,85 +144,675 @@ namespace astre::pipeline
         co_return resources;
     }
 
+    // Proxies sharing vertex buffer, shader and options are drawn with one
+    // instanced draw. Only model matrix and color differ between instances,
+    // remaining shader inputs are taken from the first proxy of the batch.
+    using InstanceBatchKey = std::tuple<std::size_t, std::size_t, render::RenderOptions>;
+
+    struct InstanceBatch
+    {
+        std::size_t vertex_buffer;
+        std::size_t shader;
+        render::RenderOptions options;
+        const render::ShaderInputs * inputs;
+
+        std::uint32_t base_instance = 0;
+        std::uint32_t instance_count = 0;
+
+        float depth = 0.0f; // distance from camera to nearest instance
+    };
+
+    struct ShadowMapBatches
+    {
+        std::size_t shadow_caster_id;
+        render::ViewportRect tile; // in shadow atlas
+        std::vector<InstanceBatch> batches;
+    };
+
+    struct InstanceBatches
+    {
+        std::vector<InstanceBatch> gbuffer;
+        std::vector<const render::RenderProxy *> gbuffer_single; // shader does not support instancing
+        std::vector<ShadowMapBatches> shadow; // only shadow maps which need re-rendering
+        std::vector<std::optional<render::ViewportRect>> shadow_tiles; // atlas tile of every active shadow caster
+
+        std::vector<render::GPUInstance> instances; // content of the instance SSBO
+
+        std::uint32_t culled = 0; // proxies outside of the camera or light frustum
+    };
+
+    static math::Mat4 _modelMatrix(const render::RenderProxy & proxy)
+    {
+        const auto model_it = proxy.inputs.in_mat4.find("uModel");
+        return model_it != proxy.inputs.in_mat4.end() ? model_it->second : math::Mat4(1.0f);
+    }
+
+    static render::GPUInstance _toGPUInstance(const render::RenderProxy & proxy)
+    {
+        render::GPUInstance instance;
+
+        instance.model = _modelMatrix(proxy);
+
+        const auto color_it = proxy.inputs.in_vec4.find("uColor");
+        instance.color = color_it != proxy.inputs.in_vec4.end() ? color_it->second : math::Vec4(1.0f, 0.0f, 1.0f, 1.0f);
+
+        return instance;
+    }
+
+    static std::vector<InstanceBatch> _flattenBatches(
+            const absl::flat_hash_map<InstanceBatchKey, std::vector<const render::RenderProxy *>> & groups,
+            const math::Vec3 & camera_position,
+            std::vector<render::GPUInstance> & instances)
+    {
+        std::vector<InstanceBatch> batches;
+        batches.reserve(groups.size());
+
+        for(const auto & [key, proxies] : groups)
+        {
+            batches.emplace_back(InstanceBatch{
+                .vertex_buffer = std::get<0>(key),
+                .shader = std::get<1>(key),
+                .options = std::get<2>(key),
+                .inputs = &proxies.front()->inputs,
+                .base_instance = (std::uint32_t)instances.size(),
+                .instance_count = (std::uint32_t)proxies.size()
+            });
+
+            auto & batch = batches.back();
+            batch.depth = std::numeric_limits<float>::max();
+            for(const auto * proxy : proxies)
+            {
+                instances.emplace_back(_toGPUInstance(*proxy));
+                batch.depth = std::min(batch.depth, math::length(proxy->position - camera_position));
+            }
+        }
+
+        return batches;
+    }
+
+    // Identifies content of a shadow map: atlas tile, light transform and every caster drawn into it.
+    static std::uint64_t _shadowMapSignature(
+            const render::ViewportRect & tile,
+            const math::Mat4 & light_space_matrix,
+            const std::vector<const render::RenderProxy *> & casters)
+    {
+        std::uint64_t hash = file::hashBytes(&tile, sizeof(tile));
+        hash = file::hashBytes(hash, math::value_ptr(light_space_matrix), sizeof(math::Mat4));
+        for(const auto * caster : casters)
+        {
+            const math::Mat4 model = _modelMatrix(*caster);
+            hash = file::hashBytes(hash, &caster->vertex_buffer, sizeof(caster->vertex_buffer));
+            hash = file::hashBytes(hash, math::value_ptr(model), sizeof(math::Mat4));
+        }
+        return hash;
+    }
+
+    bool ShadowMapCache::update(std::size_t slot, std::uint64_t signature)
+    {
+        if(slot >= signatures.size()) signatures.resize(slot + 1);
+        if(signatures.at(slot) == signature) return false;
+        signatures.at(slot) = signature;
+        return true;
+    }
+
+    void ShadowMapCache::invalidate(std::size_t slot)
+    {
+        if(slot < signatures.size()) signatures.at(slot).reset();
+    }
+
+    // Directional lights cover the whole visible scene and get the largest tile.
+    // Local lights get smaller tiles the smaller they appear from the camera,
+    // one halving per halving of range / distance.
+    static unsigned int _shadowTileSize(
+            const render::GPULight & light,
+            const math::Vec3 & camera_position,
+            const render::ShadowAtlas & atlas)
+    {
+        if(light.direction.w == render::GPU_LIGHT_TYPE_DIRECTIONAL) return atlas.size() / 2;
+
+        const float range = render::lightRange(light);
+        const float distance = math::length(math::Vec3(light.position) - camera_position);
+
+        unsigned int tile_size = atlas.size() / 4;
+        for(float importance = range / std::max(distance, 1e-3f);
+            importance < 0.5f && tile_size > atlas.minTileSize(); importance *= 2.0f)
+        {
+            tile_size /= 2;
+        }
+        return tile_size;
+    }
+
+    static InstanceBatches _buildInstanceBatches(
+            const render::Frame & frame,
+            const DeferredShadingResources & resources,
+            ShadowMapCache & shadow_map_cache)
+    {
+        absl::flat_hash_map<InstanceBatchKey, std::vector<const render::RenderProxy *>> gbuffer_groups;
+
+        InstanceBatches batches;
+
+        // opaque proxies which passed camera frustum culling
+        std::vector<const render::RenderProxy *> opaque;
+        std::vector<const render::RenderProxy *> opaque_bounded;
+        std::vector<math::Vec4> opaque_spheres;
+        opaque.reserve(frame.render_proxies.size());
+
+        std::vector<const render::RenderProxy *> casters_unbounded;
+        std::vector<const render::RenderProxy *> casters_bounded;
+        std::vector<math::Vec4> caster_spheres;
+
+        for(const auto & [_, proxy] : frame.render_proxies)
+        {
+            if(proxy.visible == false)continue;
+
+            if (render::hasFlags(proxy.phases & render::RenderPhase::Opaque))
+            {
+                if(proxy.bounds)
+                {
+                    opaque_bounded.emplace_back(&proxy);
+                    opaque_spheres.emplace_back(render::transformBoundingSphere(*proxy.bounds, _modelMatrix(proxy)));
+                }
+                else
+                {
+                    opaque.emplace_back(&proxy);
+                }
+            }
+
+            if (render::hasFlags(proxy.phases & render::RenderPhase::ShadowCaster))
+            {
+                if(proxy.bounds)
+                {
+                    casters_bounded.emplace_back(&proxy);
+                    caster_spheres.emplace_back(render::transformBoundingSphere(*proxy.bounds, _modelMatrix(proxy)));
+                }
+                else
+                {
+                    casters_unbounded.emplace_back(&proxy);
+                }
+            }
+        }
+
+        std::vector<std::uint8_t> opaque_visible;
+        render::cullSpheres(render::extractFrustum(frame.proj_matrix * frame.view_matrix), opaque_spheres, opaque_visible);
+        for(std::size_t i = 0; i < opaque_bounded.size(); ++i)
+        {
+            if(opaque_visible[i]) opaque.emplace_back(opaque_bounded[i]);
+            else batches.culled++;
+        }
+
+        for(const auto * proxy : opaque)
+        {
+            if(proxy->shader == resources.instanced_gbuffer_shader)
+            {
+                gbuffer_groups[{proxy->vertex_buffer, proxy->shader, resources.gbuffer_render_options}].emplace_back(proxy);
+            }
+            else
+            {
+                batches.gbuffer_single.emplace_back(proxy);
+            }
+        }
+
+        batches.instances.reserve(frame.render_proxies.size() * 2);
+        batches.gbuffer = _flattenBatches(gbuffer_groups, frame.camera_position, batches.instances);
+
+        // only slots used by shadow casting lights this frame
+        const std::size_t active_shadow_maps = std::min({
+            (std::size_t)ecs::system::LightSystem::MAX_SHADOW_CASTERS,
+            frame.light_space_matrices.size(),
+            (std::size_t)frame.shadow_casters_count});
+
+        // share shadow atlas between active shadow casters
+        std::vector<unsigned int> tile_sizes(active_shadow_maps, resources.shadow_atlas.minTileSize());
+        for(const auto & [_, light] : frame.gpu_lights)
+        {
+            if(light.castShadows.x == 0)continue;
+            const std::size_t shadow_caster_id = static_cast<std::size_t>(light.castShadows.y);
+            if(shadow_caster_id >= active_shadow_maps)continue;
+            tile_sizes.at(shadow_caster_id) = _shadowTileSize(light, frame.camera_position, resources.shadow_atlas);
+        }
+        batches.shadow_tiles = resources.shadow_atlas.allocate(tile_sizes);
+
+        // unused slots have to be rendered again once reused
+        for(std::size_t shadow_caster_id = active_shadow_maps; shadow_caster_id < shadow_map_cache.signatures.size(); ++shadow_caster_id)
+        {
+            shadow_map_cache.invalidate(shadow_caster_id);
+        }
+
+        std::vector<std::uint8_t> caster_visible;
+        std::vector<const render::RenderProxy *> light_casters;
+        for(std::size_t shadow_caster_id = 0; shadow_caster_id < active_shadow_maps; ++shadow_caster_id)
+        {
+            // atlas is full, light is rendered without shadows
+            const auto & tile = batches.shadow_tiles.at(shadow_caster_id);
+            if(!tile)
+            {
+                shadow_map_cache.invalidate(shadow_caster_id);
+                continue;
+            }
+
+            const auto & light_space_matrix = frame.light_space_matrices.at(shadow_caster_id);
+
+            // point lights use single 90 degree frustum, so this is their only face
+            render::cullSpheres(render::extractFrustum(light_space_matrix), caster_spheres, caster_visible);
+
+            light_casters = casters_unbounded;
+            for(std::size_t i = 0; i < casters_bounded.size(); ++i)
+            {
+                if(caster_visible[i]) light_casters.emplace_back(casters_bounded[i]);
+                else batches.culled++;
+            }
+
+            // neither light nor its casters changed, shadow map from previous frame is still valid
+            if(!shadow_map_cache.update(shadow_caster_id, _shadowMapSignature(*tile, light_space_matrix, light_casters))) continue;
+
+            // shadow pass uses single shader, so casters are grouped only by mesh
+            absl::flat_hash_map<InstanceBatchKey, std::vector<const render::RenderProxy *>> shadow_groups;
+            for(const auto * caster : light_casters)
+            {
+                shadow_groups[{caster->vertex_buffer, resources.shadow_map_shader, resources.shadow_map_render_options}].emplace_back(caster);
+            }
+
+            batches.shadow.emplace_back(ShadowMapBatches{
+                .shadow_caster_id = shadow_caster_id,
+                .tile = *tile,
+                .batches = _flattenBatches(shadow_groups, frame.camera_position, batches.instances)
+            });
+        }
+
+        return batches;
+    }
+
+    // GBuffer batches drawn with the same shader inputs besides the instance data
+    struct IndirectGBufferPass
+    {
+        render::IndirectDrawList list;
+        std::uint32_t draw_base = 0;
+        const render::ShaderInputs * inputs;
+    };
+
+    // Instanced batches of GBuffer and re-rendered shadow maps as multi-draw lists,
+    // every list addresses its part of the shared draw data SSBO through its draw base.
+    struct IndirectPasses
+    {
+        std::vector<IndirectGBufferPass> gbuffer; // one per distinct set of shared inputs
+
+        std::vector<render::IndirectDrawList> shadow; // one per InstanceBatches::shadow
+        std::vector<std::uint32_t> shadow_draw_base;
+
+        std::vector<render::GPUDrawData> draw_data; // content of the draw SSBO
+    };
+
+    static std::vector<render::IndirectDraw> _toIndirectDraws(const std::vector<InstanceBatch> & batches)
+    {
+        std::vector<render::IndirectDraw> draws;
+        draws.reserve(batches.size());
+        for(const auto & batch : batches)
+        {
+            draws.emplace_back(render::IndirectDraw{
+                .vertex_buffer = batch.vertex_buffer,
+                .base_instance = batch.base_instance,
+                .instance_count = batch.instance_count
+            });
+        }
+        return draws;
+    }
+
+    template<class Value>
+    static bool _equalExcept(const absl::flat_hash_map<std::string, Value> & lhs,
+        const absl::flat_hash_map<std::string, Value> & rhs, const std::string & ignored)
+    {
+        const auto counted = [&ignored](const auto & map){ return map.size() - (map.contains(ignored) ? 1 : 0); };
+        if(counted(lhs) != counted(rhs)) return false;
+
+        for(const auto & [name, value] : lhs)
+        {
+            if(name == ignored) continue;
+            const auto it = rhs.find(name);
+            if(it == rhs.end() || !(it->second == value)) return false;
+        }
+        return true;
+    }
+
+    // Whether both can be drawn in one indirect command, model matrix and color come from the instance SSBO.
+    static bool _sharesInputs(const render::ShaderInputs & lhs, const render::ShaderInputs & rhs)
+    {
+        if(&lhs == &rhs) return true;
+
+        return lhs.in_bool == rhs.in_bool &&
+            lhs.in_int == rhs.in_int &&
+            lhs.in_uint == rhs.in_uint &&
+            lhs.in_float == rhs.in_float &&
+            lhs.in_vec2 == rhs.in_vec2 &&
+            lhs.in_vec3 == rhs.in_vec3 &&
+            _equalExcept(lhs.in_vec4, rhs.in_vec4, "uColor") &&
+            lhs.in_mat2 == rhs.in_mat2 &&
+            lhs.in_mat3 == rhs.in_mat3 &&
+            _equalExcept(lhs.in_mat4, rhs.in_mat4, "uModel") &&
+            lhs.in_mat4_array == rhs.in_mat4_array &&
+            lhs.in_samplers == rhs.in_samplers &&
+            lhs.in_samplers_array == rhs.in_samplers_array &&
+            lhs.storage_buffers == rhs.storage_buffers;
+    }
+
+    // Draw lists of every pass are built in parallel on the worker pool.
+    static asio::awaitable<IndirectPasses> _buildIndirectPasses(
+        const render::IRenderer & renderer,
+        const InstanceBatches & batches)
+    {
+        // location of every drawn mesh in shared geometry storage, missing ones are drawn directly
+        absl::flat_hash_map<std::size_t, render::IndirectDrawGeometry> geometry;
+        absl::flat_hash_set<std::size_t> direct;
+        const auto addGeometry = [&](const std::vector<InstanceBatch> & pass_batches)
+        {
+            for(const auto & batch : pass_batches)
+            {
+                if(geometry.contains(batch.vertex_buffer) || direct.contains(batch.vertex_buffer))continue;
+
+                const auto draw_geometry = renderer.getIndirectDrawGeometry(batch.vertex_buffer);
+                if(draw_geometry) geometry.emplace(batch.vertex_buffer, *draw_geometry);
+                else direct.emplace(batch.vertex_buffer);
+            }
+        };
+
+        // GBuffer front to back, shadow maps in any order
+        std::vector<InstanceBatch> gbuffer = batches.gbuffer;
+        std::sort(gbuffer.begin(), gbuffer.end(), [](const InstanceBatch & lhs, const InstanceBatch & rhs){ return lhs.depth < rhs.depth; });
+        addGeometry(gbuffer);
+        for(const auto & shadow_map : batches.shadow) addGeometry(shadow_map.batches);
+
+        // an indirect command binds one set of inputs, batches differing in any (textures,
+        // material uniforms) get a list of their own, each still front to back
+        std::vector<std::vector<InstanceBatch>> gbuffer_groups;
+        for(const auto & batch : gbuffer)
+        {
+            auto group = std::find_if(gbuffer_groups.begin(), gbuffer_groups.end(),
+                [&batch](const std::vector<InstanceBatch> & group){ return _sharesInputs(*group.front().inputs, *batch.inputs); });
+            if(group == gbuffer_groups.end()) gbuffer_groups.emplace_back().emplace_back(batch);
+            else group->emplace_back(batch);
+        }
+
+        auto ex = co_await asio::this_coro::executor;
+
+        auto buildList = [&geometry](std::vector<render::IndirectDraw> draws) -> asio::awaitable<render::IndirectDrawList>
+        {
+            co_return render::buildIndirectDrawList(draws, geometry);
+        };
+
+        using op_type = decltype(asio::co_spawn(ex, buildList({}), asio::deferred));
+        std::vector<op_type> ops;
+        for(const auto & group : gbuffer_groups)
+        {
+            ops.emplace_back(asio::co_spawn(ex, buildList(_toIndirectDraws(group)), asio::deferred));
+        }
+        for(const auto & shadow_map : batches.shadow)
+        {
+            ops.emplace_back(asio::co_spawn(ex, buildList(_toIndirectDraws(shadow_map.batches)), asio::deferred));
+        }
+
+        auto g = asio::experimental::make_parallel_group(std::move(ops));
+        const auto no_cancel = asio::bind_cancellation_slot(asio::cancellation_slot{}, asio::use_awaitable);
+        auto [order, excs, results] = co_await g.async_wait(asio::experimental::wait_for_all(), no_cancel);
+
+        for(const auto & exc : excs)
+        {
+            if(exc) std::rethrow_exception(exc);
+        }
+
+        // results follow ops order, GBuffer groups first
+        IndirectPasses passes;
+        const auto appendDrawData = [&passes](const render::IndirectDrawList & list)
+        {
+            const std::uint32_t draw_base = (std::uint32_t)passes.draw_data.size();
+            passes.draw_data.insert(passes.draw_data.end(), list.draw_data.begin(), list.draw_data.end());
+            return draw_base;
+        };
+
+        for(std::size_t i = 0; i < gbuffer_groups.size(); ++i)
+        {
+            auto & pass = passes.gbuffer.emplace_back(IndirectGBufferPass{
+                .list = std::move(results.at(i)),
+                .inputs = gbuffer_groups.at(i).front().inputs
+            });
+            pass.draw_base = appendDrawData(pass.list);
+        }
+        for(std::size_t i = gbuffer_groups.size(); i < results.size(); ++i)
+        {
+            passes.shadow.emplace_back(std::move(results.at(i)));
+            passes.shadow_draw_base.emplace_back(appendDrawData(passes.shadow.back()));
+        }
+
+        co_return passes;
+    }
+
+    // Reorders draw list by state key so consecutive draws share as much
+    // of FBO, shader and vertex buffer as possible.
+    static std::vector<render::DrawCommand> _sortDrawCommands(
+            std::vector<render::DrawCommand> commands,
+            const std::vector<float> & depths)
+    {
+        std::vector<render::DrawSortItem> items;
+        items.reserve(commands.size());
+        for(std::uint32_t i = 0; i < commands.size(); ++i)
+        {
+            const auto & command = commands.at(i);
+            items.emplace_back(render::DrawSortItem{
+                .key = render::makeDrawSortKey(command.fbo, command.shader, command.vertex_buffer, command.options, depths.at(i)),
+                .index = i
+            });
+        }
+
+        render::radixSortDrawItems(items);
+
+        std::vector<render::DrawCommand> sorted;
+        sorted.reserve(commands.size());
+        for(const auto & item : items)
+        {
+            sorted.emplace_back(std::move(commands.at(item.index)));
+        }
+        return sorted;
+    }
+
+    // Instanced batches go through a single indirect submission when `indirect` is set.
     static asio::awaitable<render::FrameStats> _renderFrameToGBuffer(
             render::IRenderer & renderer,
             const render::Frame & frame,
-            const DeferredShadingResources & resources)
+            const DeferredShadingResources & resources,
+            const InstanceBatches & batches,
+            const IndirectPasses * indirect)
     {
+        render::FrameStats stats;
+
         // clear GBuffer
         co_await renderer.clearScreen({0.0f, 0.0f, 0.0f, 1.0f}, resources.deferred_fbo);
+
+        if(indirect && indirect->gbuffer.empty() == false)
+        {
+            // one command per set of shader inputs, all in one submission
+            std::vector<render::IndirectDrawCommand> indirect_commands;
+            indirect_commands.reserve(indirect->gbuffer.size());
+            for(const auto & pass : indirect->gbuffer)
+            {
+                render::IndirectDrawCommand & command = indirect_commands.emplace_back(render::IndirectDrawCommand{
+                    .list = pass.list,
+                    .draw_data_base = pass.draw_base,
+                    .shader = resources.instanced_gbuffer_shader,
+                    .inputs = *pass.inputs,
+                    .options = resources.gbuffer_render_options,
+                    .fbo = resources.deferred_fbo
+                });
+                command.inputs.in_mat4.erase("uModel");
+                command.inputs.in_vec4.erase("uColor");
+                command.inputs.in_mat4["uView"] = frame.view_matrix;
+                command.inputs.in_mat4["uProjection"] = frame.proj_matrix;
+                command.inputs.storage_buffers.emplace_back(resources.instance_ssbo);
+                command.inputs.storage_buffers.emplace_back(resources.draw_ssbo);
+            }
+            stats += co_await renderer.submitIndirect(std::move(indirect_commands));
+        }
         
-        render::FrameStats stats;
-        render::ShaderInputs inputs;
+        std::vector<render::DrawCommand> commands;
+        std::vector<float> depths;
+        commands.reserve(batches.gbuffer.size() + batches.gbuffer_single.size());
+        depths.reserve(commands.capacity());
 
-        for(const auto & [_, proxy] : frame.render_proxies)
+        // instanced batches were drawn by the indirect submission
+        if(indirect == nullptr)
         {
-            if(proxy.visible == false)continue;
+            for(const auto & batch : batches.gbuffer)
+            {
+                render::DrawCommand & command = commands.emplace_back(render::DrawCommand{
+                    .vertex_buffer = batch.vertex_buffer,
+                    .shader = batch.shader,
+                    .instance_count = batch.instance_count,
+                    .inputs = *batch.inputs,
+                    .options = batch.options,
+                    .fbo = resources.deferred_fbo
+                });
+                command.inputs.in_mat4.erase("uModel");
+                command.inputs.in_vec4.erase("uColor");
+                command.inputs.in_mat4["uView"] = frame.view_matrix;
+                command.inputs.in_mat4["uProjection"] = frame.proj_matrix;
+                command.inputs.in_uint["uInstanceBase"] = batch.base_instance;
+                command.inputs.storage_buffers.emplace_back(resources.instance_ssbo);
+
+                depths.emplace_back(batch.depth);
+            }
+        }
 
-            //only draw those that are in opaque phase
-            if (!render::hasFlags(proxy.phases & render::RenderPhase::Opaque)) continue;
+        for(const auto * proxy : batches.gbuffer_single)
+        {
+            render::DrawCommand & command = commands.emplace_back(render::DrawCommand{
+                .vertex_buffer = proxy->vertex_buffer,
+                .shader = proxy->shader,
+                .inputs = proxy->inputs,
+                .options = resources.gbuffer_render_options,
+                .fbo = resources.deferred_fbo
+            });
+            command.inputs.in_mat4["uView"] = frame.view_matrix;
+            command.inputs.in_mat4["uProjection"] = frame.proj_matrix;
 
-            inputs = proxy.inputs;
-            inputs.in_mat4["uView"] = frame.view_matrix;
-            inputs.in_mat4["uProjection"] = frame.proj_matrix;
-            stats += co_await renderer.render(
-                proxy.vertex_buffer,
-                proxy.shader,
-                inputs,
-                resources.gbuffer_render_options,
-                resources.deferred_fbo
-            );
+            depths.emplace_back(math::length(proxy->position - frame.camera_position));
         }
 
+        stats += co_await renderer.submit(_sortDrawCommands(std::move(commands), depths));
         co_return stats;
     }
 
+    // One indirect submission for all shadow maps when `indirect` is set.
     static asio::awaitable<render::FrameStats> _renderFrameToShadowMaps(
             render::IRenderer & renderer,
             const render::Frame & frame,
-            const DeferredShadingResources & resources)
+            const DeferredShadingResources & resources,
+            const InstanceBatches & batches,
+            const IndirectPasses * indirect)
     {
-        render::FrameStats stats;
-        // for every shadow caster we need to render whole scene 
-        // using simplified shadow shader
-        for(std::size_t shadow_caster_id = 0; shadow_caster_id < resources.shadow_map_fbos.size(); ++shadow_caster_id)
+        std::vector<render::DrawCommand> commands;
+        std::vector<float> depths;
+        std::vector<render::IndirectDrawCommand> indirect_commands;
+
+        // only shadow maps of active lights whose content changed,
+        // every caster is rendered with simplified shadow shader
+        for(std::size_t shadow_map_index = 0; shadow_map_index < batches.shadow.size(); ++shadow_map_index)
         {
-            // clear shadow map
-            co_await renderer.clearScreen({0.0f, 0.0f, 0.0f, 1.0f}, resources.shadow_map_fbos.at(shadow_caster_id));
+            const auto & shadow_map = batches.shadow.at(shadow_map_index);
 
-            // render scene to shadow map
-            for(const auto & [_, proxy] : frame.render_proxies)
-            {
-                if(proxy.visible == false)continue;
+            // clear only tile of this shadow map, remaining tiles stay valid
+            co_await renderer.clearScreen({0.0f, 0.0f, 0.0f, 1.0f}, resources.shadow_atlas_fbo, shadow_map.tile);
 
-                //only draw true casters
-                if (!render::hasFlags(proxy.phases & render::RenderPhase::ShadowCaster)) continue;
+            // one multi-draw list per tile, light matrix and viewport differ between tiles
+            if(indirect)
+            {
+                indirect_commands.emplace_back(render::IndirectDrawCommand{
+                    .list = indirect->shadow.at(shadow_map_index),
+                    .draw_data_base = indirect->shadow_draw_base.at(shadow_map_index),
+                    .shader = resources.shadow_map_shader,
+                    .inputs = render::ShaderInputs{
+                        .in_mat4 = {
+                            {"uLightSpaceMatrix", frame.light_space_matrices.at(shadow_map.shadow_caster_id)}
+                        },
+                        .storage_buffers = {
+                            resources.instance_ssbo,
+                            resources.draw_ssbo
+                        }
+                    },
+                    .options = resources.shadow_map_render_options,
+                    .fbo = resources.shadow_atlas_fbo,
+                    .viewport = shadow_map.tile
+                });
+                continue;
+            }
 
-                if(shadow_caster_id >= frame.light_space_matrices.size())
-                {
-                    continue;
-                }
-                // render depth information to shadow map fbo
-                stats += co_await renderer.render(proxy.vertex_buffer, resources.shadow_map_shader,
-                    render::ShaderInputs{
+            // render depth information to atlas tile, one draw per caster mesh
+            for(const auto & batch : shadow_map.batches)
+            {
+                commands.emplace_back(render::DrawCommand{
+                    .vertex_buffer = batch.vertex_buffer,
+                    .shader = batch.shader,
+                    .instance_count = batch.instance_count,
+                    .inputs = render::ShaderInputs{
+                        .in_uint = {
+                            {"uInstanceBase", batch.base_instance}
+                        },
                         .in_mat4 = {
-                            {"uModel", proxy.inputs.in_mat4.at("uModel")},
-                            {"uLightSpaceMatrix", frame.light_space_matrices.at(shadow_caster_id)}
+                            {"uLightSpaceMatrix", frame.light_space_matrices.at(shadow_map.shadow_caster_id)}
+                        },
+                        .storage_buffers = {
+                            resources.instance_ssbo
                         }
                     },
-                    resources.shadow_map_render_options,
-                    resources.shadow_map_fbos.at(shadow_caster_id)
-                );
+                    .options = batch.options,
+                    .fbo = resources.shadow_atlas_fbo,
+                    .viewport = shadow_map.tile
+                });
+                // depth only pass, order does not matter,
+                // viewport is switched per draw so tiles may interleave after sorting
+                depths.emplace_back(0.0f);
             }
         }
 
-        co_return stats;
+        if(indirect) co_return co_await renderer.submitIndirect(std::move(indirect_commands));
+        co_return co_await renderer.submit(_sortDrawCommands(std::move(commands), depths));
     }
     
+    // Froxel light lists, depth slices are split between tasks on the worker pool.
+    static asio::awaitable<render::LightClusters> _buildLightClusters(
+        const render::LightClusterGrid & grid,
+        const std::vector<render::GPULight> & lights)
+    {
+        static constexpr std::uint32_t SLICES_PER_TASK = 4;
+
+        auto ex = co_await asio::this_coro::executor;
+
+        auto buildSlices = [&grid, &lights](std::uint32_t slice_begin) -> asio::awaitable<render::LightClusters>
+        {
+            co_return render::buildLightClusters(grid, lights, slice_begin, slice_begin + SLICES_PER_TASK);
+        };
+
+        using op_type = decltype(asio::co_spawn(ex, buildSlices(0), asio::deferred));
+        std::vector<op_type> ops;
+        for(std::uint32_t slice = 0; slice < render::LightClusterGrid::SLICES; slice += SLICES_PER_TASK)
+        {
+            ops.emplace_back(asio::co_spawn(ex, buildSlices(slice), asio::deferred));
+        }
+
+        auto g = asio::experimental::make_parallel_group(std::move(ops));
+        const auto no_cancel = asio::bind_cancellation_slot(asio::cancellation_slot{}, asio::use_awaitable);
+        auto [order, excs, results] = co_await g.async_wait(asio::experimental::wait_for_all(), no_cancel);
+
+        for(const auto & exc : excs)
+        {
+            if(exc) std::rethrow_exception(exc);
+        }
+
+        // results follow ops order, so slices stay sorted
+        co_return render::mergeLightClusters(std::move(results));
+    }
+
     static asio::awaitable<render::FrameStats> _renderGBuffer(    
         render::IRenderer & renderer,
         const render::Frame & frame,
         const DeferredShadingResources & resources,
+        const render::LightClusterGrid & grid,
         std::optional<std::size_t> fbo)
     {
         render::FrameStats stats;
@@ -191,22 +824,28 @@ namespace astre::pipeline
         stats += co_await renderer.render(resources.screen_quad_vb, resources.screen_quad_shader,
             render::ShaderInputs{
             .in_uint = {
-                {"lightCount", (std::uint32_t)frame.gpu_lights.size()},
                 {"shadowCastersCount", frame.shadow_casters_count}
             },
+            .in_float = {
+                {"clusterNear", grid.near_plane},
+                {"clusterFar", grid.far_plane}
+            },
+            .in_mat4 = {
+                {"uView", frame.view_matrix}
+            },
             .in_mat4_array = {
                 {"lightSpaceMatrices", frame.light_space_matrices}
             },
             .in_samplers = {
                 {"gPosition",   resources.deferred_textures.at(0)},
                 {"gNormal",     resources.deferred_textures.at(1)},
-                {"gAlbedoSpec", resources.deferred_textures.at(2)}
-            },
-            .in_samplers_array = {
-                {"shadowMaps", resources.shadow_map_textures}
+                {"gAlbedoSpec", resources.deferred_textures.at(2)},
+                {"shadowAtlas", resources.shadow_atlas_texture}
             },
             .storage_buffers = {
-                resources.light_ssbo
+                resources.light_ssbo,
+                resources.light_cluster_ssbo,
+                resources.light_index_ssbo
             }
             },
             render::RenderOptions{
@@ -221,22 +860,60 @@ namespace astre::pipeline
     asio::awaitable<render::FrameStats> deferredShadingStage(
             render::IRenderer & renderer,
             const DeferredShadingResources & render_resources,
+            ShadowMapCache & shadow_map_cache,
             const render::Frame & frame,
             std::optional<std::size_t> fbo)
     {
+        const InstanceBatches batches = _buildInstanceBatches(frame, render_resources, shadow_map_cache);
+
         // update light SSBO
         std::vector<render::GPULight> lights_buffer;
         lights_buffer.reserve(frame.gpu_lights.size());
         for (auto& [e, light] : frame.gpu_lights) {
-            lights_buffer.emplace_back(std::move(light));
+            auto & gpu_light = lights_buffer.emplace_back(light);
+            if(gpu_light.castShadows.x == 0)continue;
+
+            // point light to its atlas tile, lights which did not fit are not shadowed
+            const std::size_t shadow_caster_id = static_cast<std::size_t>(gpu_light.castShadows.y);
+            if(shadow_caster_id < batches.shadow_tiles.size() && batches.shadow_tiles.at(shadow_caster_id))
+            {
+                gpu_light.shadowAtlasRect = render_resources.shadow_atlas.toUV(*batches.shadow_tiles.at(shadow_caster_id));
+            }
+            else
+            {
+                gpu_light.castShadows.x = 0;
+            }
         }
          co_await renderer.updateShaderStorageBuffer(
               render_resources.light_ssbo, sizeof(render::GPULight) * lights_buffer.size(), lights_buffer.data());
+
+        // update clustered light lists, indices point into light SSBO
+        const render::LightClusterGrid light_cluster_grid = render::makeLightClusterGrid(frame.view_matrix, frame.proj_matrix);
+        const render::LightClusters light_clusters = co_await _buildLightClusters(light_cluster_grid, lights_buffer);
+        co_await renderer.updateShaderStorageBuffer(render_resources.light_cluster_ssbo,
+            sizeof(render::GPULightCluster) * light_clusters.clusters.size(), light_clusters.clusters.data());
+        co_await renderer.updateShaderStorageBuffer(render_resources.light_index_ssbo,
+            sizeof(std::uint32_t) * light_clusters.light_indices.size(), light_clusters.light_indices.data());
         
+        // update instance SSBO, shared by GBuffer and shadow passes
+        co_await renderer.updateShaderStorageBuffer(
+            render_resources.instance_ssbo, sizeof(render::GPUInstance) * batches.instances.size(), batches.instances.data());
+
+        // multi-draw indirect when supported, otherwise one draw per batch
+        std::optional<IndirectPasses> indirect;
+        if(renderer.supportsIndirectDraw())
+        {
+            indirect = co_await _buildIndirectPasses(renderer, batches);
+            co_await renderer.updateShaderStorageBuffer(
+                render_resources.draw_ssbo, sizeof(render::GPUDrawData) * indirect->draw_data.size(), indirect->draw_data.data());
+        }
+        const IndirectPasses * indirect_passes = indirect ? &*indirect : nullptr;
+
         render::FrameStats stats;
-        stats += co_await _renderFrameToGBuffer(renderer, frame, render_resources);
-        stats += co_await _renderFrameToShadowMaps(renderer, frame, render_resources);
-        stats += co_await _renderGBuffer(renderer, frame, render_resources, fbo);
+        stats.culled = batches.culled;
+        stats += co_await _renderFrameToGBuffer(renderer, frame, render_resources, batches, indirect_passes);
+        stats += co_await _renderFrameToShadowMaps(renderer, frame, render_resources, batches, indirect_passes);
+        stats += co_await _renderGBuffer(renderer, frame, render_resources, light_cluster_grid, fbo);
 
         co_return stats;
     }
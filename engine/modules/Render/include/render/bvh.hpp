@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "render/raycast.hpp"
+
+namespace astre::render
+{
+    /**
+     * @brief Bounding volume hierarchy over boxes of items
+     *
+     * Built top down by splitting at the median centroid of the longest axis.
+     * Moving items only need `refit`, which keeps the tree and recomputes its boxes,
+     * so the tree gets looser over time and should be rebuilt when the item set changes.
+     */
+    class BoundingVolumeHierarchy
+    {
+        public:
+            struct Hit
+            {
+                std::size_t item; // index into boxes passed to build
+                float distance;
+            };
+
+            /**
+             * @brief Exact test of an item whose box is hit by the ray
+             *
+             * Receives the item and the closest distance found so far,
+             * returns distance of the hit or `std::nullopt` if the item is missed.
+             */
+            using ItemTest = std::function<std::optional<float>(std::size_t item, float max_distance)>;
+
+            void build(std::vector<AABB> boxes);
+
+            /**
+             * @brief Update boxes of the items the tree was built from
+             *
+             * @return `false` if number of boxes differs from the built one, tree is left untouched then
+             */
+            bool refit(const std::vector<AABB> & boxes);
+
+            /**
+             * @brief Closest item hit by the ray
+             *
+             * @param test exact test of items, their boxes are used without it
+             */
+            std::optional<Hit> raycast(const Ray & ray, float max_distance, const ItemTest & test = {}) const;
+
+            std::size_t size() const;
+
+            bool empty() const;
+
+        private:
+            struct Node
+            {
+                AABB box;
+                std::uint32_t first; // first item for leaves, right child for inner nodes
+                std::uint32_t count; // 0 for inner nodes, left child is the next node
+            };
+
+            static constexpr std::uint32_t MAX_LEAF_ITEMS = 4;
+
+            std::uint32_t buildNode(std::uint32_t first, std::uint32_t count, const std::vector<math::Vec3> & centroids);
+
+            std::vector<Node> _nodes;
+            std::vector<std::uint32_t> _items; // item indices ordered by leaves
+            std::vector<AABB> _boxes;
+    };
+}
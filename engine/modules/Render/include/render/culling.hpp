@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "math/math.hpp"
+
+#include "render/vertex.hpp"
+
+namespace astre::render
+{
+    /**
+     * @brief Compute AABB and bounding sphere of the mesh vertices
+     * 
+     * @note Empty mesh results in a zero sized volume at the origin.
+     */
+    BoundingVolume computeBoundingVolume(const Mesh & mesh);
+
+    /**
+     * @brief Transform bounding sphere into world space
+     * 
+     * Radius is scaled by the largest axis scale of the model matrix,
+     * so the sphere stays conservative for non uniform scales.
+     * 
+     * @return xyz = world space center, w = radius
+     */
+    math::Vec4 transformBoundingSphere(const BoundingVolume & bounds, const math::Mat4 & model);
+
+    /**
+     * @brief Six normalized planes of the view frustum
+     * 
+     * Plane is stored as (normal.xyz, distance), normals point inside the frustum.
+     * Order: left, right, bottom, top, near, far.
+     */
+    struct Frustum
+    {
+        std::array<math::Vec4, 6> planes;
+    };
+
+    /**
+     * @brief Extract frustum planes from combined projection * view matrix
+     */
+    Frustum extractFrustum(const math::Mat4 & view_projection);
+
+    /**
+     * @brief Test bounding spheres against the frustum
+     * 
+     * Spheres are tested four at a time with SSE where available,
+     * remaining spheres use scalar path.
+     * 
+     * @param frustum frustum to test against
+     * @param spheres xyz = center, w = radius
+     * @param visible output, `visible[i]` is 1 if sphere `i` intersects the frustum, 0 otherwise
+     */
+    void cullSpheres(const Frustum & frustum, const std::vector<math::Vec4> & spheres, std::vector<std::uint8_t> & visible);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "render/render_options.hpp"
+
+namespace astre::render
+{
+    /**
+     * @brief 64-bit draw sort key
+     * 
+     * Most expensive state lives in the most significant bits, so sorting keys
+     * in ascending order groups draws by frame buffer, then shader, then vertex
+     * buffer, then render options and finally front-to-back by depth.
+     * 
+     * | bits  | field          |
+     * |-------|----------------|
+     * | 63-56 | fbo            |
+     * | 55-44 | shader         |
+     * | 43-28 | vertex buffer  |
+     * | 27-23 | render options |
+     * | 22-0  | depth          |
+     * 
+     * IDs wider than their field are truncated, which can only interleave
+     * groups, never reorder draws with equal keys. Render options take one bit
+     * per switched state (wireframe, lines, polygon offset, no depth write,
+     * no depth test), so distinct states never share a group.
+     */
+    using DrawSortKey = std::uint64_t;
+
+    // low bits of a vertex buffer ID kept by the key, IDs equal in them share a group
+    constexpr unsigned DRAW_SORT_VERTEX_BUFFER_BITS = 16;
+    constexpr std::uint64_t DRAW_SORT_VERTEX_BUFFER_MASK = (std::uint64_t(1) << DRAW_SORT_VERTEX_BUFFER_BITS) - 1;
+
+    /**
+     * @brief Build sort key of a single draw
+     * 
+     * @param fbo target frame buffer, `std::nullopt` for default frame buffer
+     * @param shader shader ID
+     * @param vertex_buffer vertex buffer ID
+     * @param options render options of the draw
+     * @param depth non-negative distance from the camera, negative values are treated as 0
+     */
+    DrawSortKey makeDrawSortKey(std::optional<std::size_t> fbo, std::size_t shader, std::size_t vertex_buffer,
+        const RenderOptions & options, float depth);
+
+    struct DrawSortItem
+    {
+        DrawSortKey key;
+        std::uint32_t index; // index of the draw in the pass draw list
+    };
+
+    /**
+     * @brief Stable LSD radix sort of draw items by key, 8 bits per pass
+     * 
+     * Passes in which every key shares the same byte are skipped, so lists that
+     * differ only in a few fields cost only a few passes.
+     */
+    void radixSortDrawItems(std::vector<DrawSortItem> & items);
+}
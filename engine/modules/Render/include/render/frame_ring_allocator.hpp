@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+namespace astre::render
+{
+    /**
+     * @brief Linear allocator over a buffer split into per-frame regions
+     * 
+     * Every frame allocates from its own region, which is reset once the ring wraps around to it.
+     * Owner is responsible for making sure that GPU finished reading a region before `nextFrame`
+     * hands it out again (e.g. by fencing every region).
+     */
+    class FrameRingAllocator
+    {
+        public:
+            FrameRingAllocator(std::size_t region_size, std::uint32_t region_count);
+
+            /**
+             * @brief Allocate space in region of the current frame
+             * 
+             * @param alignment power of two alignment of returned offset
+             * @return offset from the beginning of the whole buffer, `std::nullopt` if region has no space left
+             */
+            std::optional<std::size_t> allocate(std::size_t size, std::size_t alignment);
+
+            /**
+             * @brief Move to region of the next frame and reset it
+             * 
+             * @return index of the new current region
+             */
+            std::uint32_t nextFrame();
+
+            std::uint32_t region() const;
+            std::uint32_t regionOf(std::size_t offset) const;
+            std::uint32_t regionCount() const;
+            std::size_t regionSize() const;
+            std::size_t size() const;
+
+            // bytes used in region of the current frame, including alignment padding
+            std::size_t used() const;
+
+        private:
+            std::size_t _region_size;
+            std::uint32_t _region_count;
+
+            std::uint32_t _region;
+            std::size_t _offset; // inside of the current region
+    };
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "math/math.hpp"
+
+#include "render/vertex_format.hpp"
+#include "render/vertex_buffer.hpp"
+
+namespace astre::render
+{
+    #pragma pack(push, 1)
+    // layout expected by glMultiDrawElementsIndirect
+    struct DrawElementsIndirectCommand
+    {
+        std::uint32_t count;
+        std::uint32_t instance_count;
+        std::uint32_t first_index;
+        std::int32_t base_vertex;
+        std::uint32_t base_instance;
+    };
+
+    // per-draw data read by shaders as draws[uDrawBase + gl_DrawIDARB]
+    struct GPUDrawData
+    {
+        math::Vec4 position_offset; // w unused
+        math::Vec4 position_scale;  // w unused
+    };
+    #pragma pack(pop)
+
+    /**
+     * @brief Where a vertex buffer lives in shared geometry storage
+     *
+     */
+    struct IndirectDrawGeometry
+    {
+        std::size_t vertex_array;
+        std::size_t index_size;
+        VertexFormat format;
+        VertexQuantization quantization;
+        GeometryRange range;
+    };
+
+    /**
+     * @brief Single draw of an indirect submission
+     *
+     * Instances are read from `base_instance`, the same way `uInstanceBase` is used by direct draws.
+     */
+    struct IndirectDraw
+    {
+        std::size_t vertex_buffer;
+        std::uint32_t base_instance = 0;
+        std::uint32_t instance_count = 1;
+    };
+
+    /**
+     * @brief Consecutive commands sharing vertex array and index type, issued with one multi-draw
+     *
+     */
+    struct IndirectDrawGroup
+    {
+        std::size_t vertex_array;
+        std::size_t index_size;
+        VertexFormat format;
+        std::uint32_t first_command;
+        std::uint32_t command_count;
+    };
+
+    /**
+     * @brief Draws of one pass laid out for multi-draw indirect submission
+     *
+     */
+    struct IndirectDrawList
+    {
+        std::vector<DrawElementsIndirectCommand> commands;
+        std::vector<GPUDrawData> draw_data; // one per command
+        std::vector<IndirectDraw> draws; // source of every command, one per command
+        std::vector<IndirectDrawGroup> groups;
+
+        std::vector<IndirectDraw> fallback; // vertex buffers outside of shared storage, drawn one by one
+    };
+
+    /**
+     * @brief Translate draws into indirect commands grouped by vertex array and index type
+     *
+     * Order of draws is kept inside of every group, groups follow the first draw using them.
+     * Draws without instances are dropped.
+     *
+     * @param geometry shared storage location of vertex buffers, missing buffers end up in `fallback`
+     */
+    IndirectDrawList buildIndirectDrawList(const std::vector<IndirectDraw> & draws,
+        const absl::flat_hash_map<std::size_t, IndirectDrawGeometry> & geometry);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math/math.hpp"
+
+#include "render/render.hpp"
+
+namespace astre::render
+{
+    // values of GPULight::direction.w, match LIGHT_TYPE_* defines of lighting shaders
+    static constexpr float GPU_LIGHT_TYPE_DIRECTIONAL = 1.0f;
+    static constexpr float GPU_LIGHT_TYPE_POINT = 2.0f;
+    static constexpr float GPU_LIGHT_TYPE_SPOT = 3.0f;
+
+    /**
+     * @brief Distance at which light contribution drops below 1/256 of its intensity
+     * 
+     * @return `std::numeric_limits<float>::max()` for lights without attenuation
+     */
+    float lightRange(const GPULight & light);
+
+    /**
+     * @brief Range of the light index list which belongs to a single cluster
+     * 
+     * Layout matches `uvec2` of the cluster SSBO read by the lighting pass.
+     */
+    struct GPULightCluster
+    {
+        std::uint32_t offset;
+        std::uint32_t count;
+    };
+
+    /**
+     * @brief View frustum split into froxels
+     * 
+     * Screen is split into `TILES_X` x `TILES_Y` tiles and depth into `SLICES`
+     * exponential slices between near and far plane, so froxels keep roughly cubic
+     * shape along the whole depth. Cluster index is `x + y * TILES_X + z * TILES_X * TILES_Y`.
+     */
+    struct LightClusterGrid
+    {
+        static constexpr std::uint32_t TILES_X = 16;
+        static constexpr std::uint32_t TILES_Y = 9;
+        static constexpr std::uint32_t SLICES = 24;
+        static constexpr std::uint32_t CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+
+        math::Mat4 view_matrix{1.0f};
+
+        // view space distances of the near and far plane
+        float near_plane = 0.1f;
+        float far_plane = 1.0f;
+
+        // view space AABB of every cluster, indexed as clusters
+        std::vector<math::Vec3> cluster_min;
+        std::vector<math::Vec3> cluster_max;
+    };
+
+    /**
+     * @brief Compute froxel bounds of the camera
+     * 
+     * Works for both perspective and orthographic projections.
+     */
+    LightClusterGrid makeLightClusterGrid(const math::Mat4 & view_matrix, const math::Mat4 & proj_matrix);
+
+    /**
+     * @brief Light index lists of a range of depth slices
+     * 
+     */
+    struct LightClusters
+    {
+        std::uint32_t slice_begin = 0;
+        std::uint32_t slice_end = 0;
+
+        std::vector<GPULightCluster> clusters; // clusters of [slice_begin, slice_end)
+        std::vector<std::uint32_t> light_indices; // indices into the light buffer
+    };
+
+    /**
+     * @brief Assign lights to clusters of depth slices [slice_begin, slice_end)
+     * 
+     * Point and spot lights are tested as spheres of `lightRange` against cluster bounds,
+     * directional lights are assigned to every cluster. Slice ranges are independent,
+     * so they can be built concurrently and joined with `mergeLightClusters`.
+     */
+    LightClusters buildLightClusters(const LightClusterGrid & grid, const std::vector<GPULight> & lights,
+        std::uint32_t slice_begin, std::uint32_t slice_end);
+
+    /**
+     * @brief Join consecutive slice ranges into one set of lists covering the whole grid
+     * 
+     * @param parts ordered by `slice_begin`, together covering all slices
+     */
+    LightClusters mergeLightClusters(std::vector<LightClusters> parts);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "math/math.hpp"
+
+#include "render/culling.hpp"
+
+namespace astre::render
+{
+    /**
+     * @brief Single level of detail of a vertex buffer
+     * 
+     */
+    struct VertexBufferLOD
+    {
+        std::size_t vertex_buffer;
+        float error = 0.0f; // deviation from LOD 0 surface in mesh units
+    };
+
+    // largest accepted deviation from LOD 0 on screen, in pixels
+    constexpr float LOD_PIXEL_ERROR = 1.0f;
+
+    // current LOD is kept while its error stays inside of this band around LOD_PIXEL_ERROR
+    constexpr float LOD_HYSTERESIS = 0.25f;
+
+    /**
+     * @brief Screen size of one mesh unit at the nearest point of the bounding sphere
+     * 
+     * @param projection perspective projection, only the vertical focal length `[1][1]` is used
+     * @param viewport_height height of the render target in pixels
+     * 
+     * @return pixels per mesh unit, infinity when camera is inside of the bounding sphere
+     */
+    float pixelsPerMeshUnit(const BoundingVolume & bounds, const math::Mat4 & model,
+        const math::Vec3 & camera_position, const math::Mat4 & projection, unsigned int viewport_height);
+
+    /**
+     * @brief Choose the coarsest LOD whose error stays below `pixel_error` on screen
+     * 
+     * Moving to a coarser LOD requires its error to be below `pixel_error * (1 - hysteresis)`,
+     * current LOD is dropped for a finer one only once its error exceeds `pixel_error * (1 + hysteresis)`,
+     * so proxies near the threshold do not flicker between levels.
+     * 
+     * @param lods LOD chain ordered from finest, errors non decreasing
+     * @param current_lod LOD selected in previous frame
+     * 
+     * @return index into `lods`
+     */
+    std::size_t selectLOD(const std::vector<VertexBufferLOD> & lods, float pixels_per_unit, std::size_t current_lod,
+        float pixel_error = LOD_PIXEL_ERROR, float hysteresis = LOD_HYSTERESIS);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <thread>
+#include <algorithm>
 
 #include <GL/glew.h>
 #ifdef WIN32
@@ -18,12 +19,15 @@
 #include "process/process.hpp"
 #include "window/window.hpp"
 
+#include "render/render.hpp"
 #include "render/render_options.hpp"
 #include "render/render_stats.hpp"
 
 #include "render/vertex.hpp"
 #include "render/vertex_buffer.hpp"
+#include "render/vertex_format.hpp"
 #include "render/shader.hpp"
+#include "render/program_binary_cache.hpp"
 #include "render/shader_storage_buffer.hpp"
 #include "render/frame_buffer_object.hpp"
 #include "render/texture.hpp"
@@ -31,8 +35,13 @@
 
 #include "render/opengl/opengl_debug.hpp"
 #include "render/opengl/opengl_vertex_buffer.hpp"
+#include "render/opengl/opengl_geometry_arena.hpp"
+#include "render/opengl/opengl_arena_vertex_buffer.hpp"
+#include "render/opengl/opengl_indirect_buffer.hpp"
+#include "render/opengl/opengl_pixel_readback.hpp"
 #include "render/opengl/opengl_shader.hpp"
 #include "render/opengl/opengl_shader_storage_buffer.hpp"
+#include "render/opengl/opengl_stream_buffer.hpp"
 #include "render/opengl/opengl_frame_buffer_object.hpp"
 #include "render/opengl/opengl_texture.hpp"
 #include "render/opengl/opengl_render_buffer_object.hpp"
@@ -74,12 +83,22 @@ namespace astre::render::opengl
 
             asio::awaitable<void> close();
 
-            asio::awaitable<void> clearScreen(math::Vec4 color, std::optional<std::size_t> fbo);
+            asio::awaitable<void> clearScreen(math::Vec4 color, std::optional<std::size_t> fbo, std::optional<ViewportRect> region);
             asio::awaitable<FrameStats> render(std::size_t vertex_buffer,
                 std::size_t shader,
                 ShaderInputs shader_inputs,
                 RenderOptions options,
                 std::optional<std::size_t> fbo);
+            asio::awaitable<FrameStats> renderInstanced(std::size_t vertex_buffer,
+                std::size_t shader,
+                std::uint32_t instance_count,
+                ShaderInputs shader_inputs,
+                RenderOptions options,
+                std::optional<std::size_t> fbo);
+            asio::awaitable<FrameStats> submit(std::vector<DrawCommand> commands);
+            bool supportsIndirectDraw() const;
+            std::optional<IndirectDrawGeometry> getIndirectDrawGeometry(std::size_t vertex_buffer) const;
+            asio::awaitable<FrameStats> submitIndirect(std::vector<IndirectDrawCommand> commands);
             
             asio::awaitable<void> present();
             asio::awaitable<void> updateViewportSize(unsigned int width, unsigned int height);
@@ -87,9 +106,14 @@ namespace astre::render::opengl
             asio::awaitable<void> enableVSync();
             asio::awaitable<void> disableVSync();
 
-            asio::awaitable<std::optional<std::size_t>> createVertexBuffer(std::string name, const Mesh & mesh);
+            asio::awaitable<std::optional<std::size_t>> createVertexBuffer(std::string name, const Mesh & mesh, VertexFormat format);
             asio::awaitable<bool> eraseVertexBuffer(std::size_t id);
             std::optional<std::size_t> getVertexBuffer(std::string name) const;
+            std::optional<BoundingVolume> getVertexBufferBounds(std::size_t id) const;
+            std::vector<VertexBufferLOD> getVertexBufferLODs(std::size_t id) const;
+            std::shared_ptr<const TriangleMesh> getVertexBufferTriangles(std::size_t id) const;
+            GeometryArenaStats getGeometryArenaStats() const;
+            asio::awaitable<bool> enableProgramBinaryCache(std::filesystem::path directory);
 
             asio::awaitable<std::optional<std::size_t>> createShader(std::string name, std::vector<std::string> vertex_code);
             asio::awaitable<std::optional<std::size_t>> createShader(std::string name, std::vector<std::string> vertex_code, std::vector<std::string> fragment_code);
@@ -114,6 +138,7 @@ namespace astre::render::opengl
             void join();
 
             asio::awaitable<std::optional<std::uint64_t>> readPixelUint64(std::size_t fbo, unsigned attachment, int x, int y);
+            asio::awaitable<std::optional<PixelRegionUint64>> readRegionUint64(std::size_t fbo, unsigned attachment, PixelRect rect);
 
         protected:
 
@@ -198,8 +223,34 @@ namespace astre::render::opengl
                 co_return true;
             }
 
+            // dedicated buffers when the mesh does not fit the geometry arena
+            asio::awaitable<std::optional<std::size_t>> createMeshVertexBuffer(std::string name,
+                const std::vector<unsigned int> & indices, const std::vector<GPUVertex> & vertices, VertexFormat format);
+
             void assignShaderInputs(const std::size_t & shader_ID, const ShaderInputs & shader_inputs);
 
+            // must be called on render strand
+            bool streamShaderStorageBuffer(std::size_t id, std::size_t size, const void * data);
+            void nextStreamFrame();
+
+            // must be called on render strand
+            bool bindFrameBufferObject(const std::optional<std::size_t> & fbo, FrameStats & stats);
+            void unbindFrameBufferObject(const std::optional<std::size_t> & fbo);
+            bool bindShaderProgram(Shader & shader, FrameStats & stats);
+            FrameStats drawElements(std::size_t vertex_buffer, std::size_t shader, std::uint32_t instance_count,
+                const ShaderInputs & shader_inputs, const RenderOptions & options);
+            // one multi-draw per group, indirect buffer holds list commands from `first_command`
+            FrameStats multiDrawElements(const IndirectDrawCommand & command, std::size_t first_command);
+            // must be called on render strand
+            std::unique_ptr<OpenGLPixelReadback> acquirePixelReadback(std::size_t size);
+            void releasePixelReadback(std::unique_ptr<OpenGLPixelReadback> readback);
+            // wakes up reads finished by the GPU, called once per presented frame
+            void pollPixelReads();
+
+            // returns previous depth write mask
+            GLboolean applyRenderOptions(const RenderOptions & options);
+            void restoreRenderOptions(const RenderOptions & options, GLboolean prev_write_depth_mask);
+
         private:
             window::IWindow & _window;
 
@@ -208,6 +259,28 @@ namespace astre::render::opengl
             std::pair<unsigned int, unsigned int> _viewport_resolution;
 
             absl::flat_hash_map<std::size_t, VertexBuffer> _vertex_buffers;
+            absl::flat_hash_map<std::size_t, BoundingVolume> _vertex_buffer_bounds;
+            absl::flat_hash_map<std::size_t, std::vector<VertexBufferLOD>> _vertex_buffer_lods; // only buffers with coarser levels
+            absl::flat_hash_map<std::size_t, std::shared_ptr<const TriangleMesh>> _vertex_buffer_triangles; // LOD buffers share their base
+
+            // initial capacity of shared mesh storage, per vertex format and in index bytes
+            static constexpr std::size_t GEOMETRY_ARENA_VERTICES = 64 * 1024;
+            static constexpr std::size_t GEOMETRY_ARENA_INDEX_BYTES = 1024 * 1024;
+
+            std::unique_ptr<OpenGLGeometryArena> _geometry_arena; // created with the first vertex buffer
+            absl::flat_hash_map<std::size_t, IndirectDrawGeometry> _indirect_draw_geometry; // vertex buffers living in geometry arena
+            std::unique_ptr<OpenGLIndirectBuffer> _indirect_buffer; // created on first indirect submission
+
+            // bindings made by the current submission, so binds and their stats skip glGet round trips;
+            // `std::nullopt` is unknown, reset when a submission starts as anything may have rebound since
+            struct BoundState
+            {
+                std::optional<std::size_t> fbo; // 0 is the default frame buffer
+                std::optional<std::size_t> shader_program;
+                std::optional<std::size_t> vertex_array;
+            };
+            BoundState _bound_state;
+            std::unique_ptr<ProgramBinaryCache> _program_binary_cache; // set when shader binaries are cached
             absl::flat_hash_map<std::size_t, Shader> _shaders;
             absl::flat_hash_map<std::size_t, ShaderStorageBuffer> _shader_storage_buffers;
             absl::flat_hash_map<std::size_t, FrameBufferObject> _frame_buffer_objects;
@@ -221,7 +294,32 @@ namespace astre::render::opengl
             absl::flat_hash_map<std::string, std::size_t> _textures_names;
             absl::flat_hash_map<std::string, std::size_t> _rbos_names;
 
+            // per-frame SSBO uploads, region size per frame and number of frames in flight
+            static constexpr std::size_t STREAM_BUFFER_REGION_SIZE = 8 * 1024 * 1024;
+            static constexpr std::uint32_t STREAM_BUFFER_REGIONS = 3;
+
+            std::unique_ptr<OpenGLStreamBuffer> _stream_buffer; // created on first SSBO update
+            std::size_t _stream_buffer_alignment = 1; // GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, queried with the buffer
+            absl::flat_hash_map<std::size_t, OpenGLStreamBuffer::Allocation> _shader_storage_buffer_streams; // SSBO content living in stream buffer
+
             // Render thread initialized at the end of the constructor
             std::unique_ptr<OpenGLRenderThreadContext> _render_context; // dedicated single thread
+
+            // read in flight, `signal` is cancelled to wake up the awaiting reader
+            struct PendingPixelRead
+            {
+                std::unique_ptr<OpenGLPixelReadback> readback; // reset when renderer closes
+                asio::steady_timer signal;
+                std::uint32_t frames = 0; // presented since the read was issued
+            };
+
+            // reads not done after that many frames are completed by a blocking map
+            static constexpr std::uint32_t PIXEL_READ_MAX_FRAMES = 3;
+            static constexpr std::size_t PIXEL_READBACK_POOL_SIZE = 4;
+            static constexpr std::size_t PIXEL_READBACK_MIN_SIZE = 16 * 16 * 8; // 16x16 region of 64-bit values
+
+            // declared after the render context, timers bound to its strand are destroyed first
+            std::vector<std::shared_ptr<PendingPixelRead>> _pending_pixel_reads;
+            std::vector<std::unique_ptr<OpenGLPixelReadback>> _pixel_readbacks; // idle, reused by next reads
     };
 }
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <optional>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+#include <GL/glew.h>
+
+#include "render/vertex.hpp"
+#include "render/vertex_format.hpp"
+#include "render/vertex_buffer.hpp"
+
+#include "render/opengl/opengl_debug.hpp"
+#include "render/opengl/opengl_geometry_arena.hpp"
+
+namespace astre::render::opengl
+{
+    /**
+     * @brief Vertex buffer living in `OpenGLGeometryArena`
+     *
+     * Holds only its range of the shared buffers, freed on destruction,
+     * so the arena must outlive every buffer allocated from it.
+     * IDs have the top bit set and share their low `DRAW_SORT_VERTEX_BUFFER_BITS` per vertex format,
+     * so they never collide with `OpenGLVertexBuffer` IDs and draw sort keys
+     * group arena buffers by the VAO they bind.
+     */
+    class OpenGLArenaVertexBuffer
+    {
+        public:
+            OpenGLArenaVertexBuffer(OpenGLGeometryArena & arena, const std::vector<unsigned int> & indices,
+                const std::vector<GPUVertex> & vertices, VertexFormat format = VertexFormat::Full);
+
+            ~OpenGLArenaVertexBuffer();
+
+            OpenGLArenaVertexBuffer(OpenGLArenaVertexBuffer && other);
+
+            std::size_t ID() const;
+
+            bool good() const;
+
+            std::size_t numberOfElements() const;
+
+            std::size_t indexSize() const;
+
+            VertexFormat vertexFormat() const;
+
+            const VertexQuantization & vertexQuantization() const;
+
+            GeometryRange range() const;
+
+            std::size_t vertexArrayID() const;
+            //
+            bool enable() const;
+            //
+            void disable() const;
+
+        private:
+            OpenGLGeometryArena * _arena;
+            std::optional<OpenGLGeometryArena::Allocation> _allocation;
+
+            std::size_t _ID;
+            std::size_t _index_count;
+            std::size_t _index_size;
+
+            VertexFormat _format;
+            VertexQuantization _quantization;
+    };
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include <spdlog/spdlog.h>
+
+#include <GL/glew.h>
+
+#include "render/vertex_format.hpp"
+#include "render/range_allocator.hpp"
+#include "render/render_stats.hpp"
+#include "render/opengl/opengl_debug.hpp"
+
+namespace astre::render::opengl
+{
+    /**
+     * @brief Shared vertex and index storage for static meshes
+     *
+     * One vertex buffer + VAO per `VertexFormat` and a single index buffer shared by all of them,
+     * each suballocated with a `RangeAllocator`. Meshes are addressed by base vertex and index
+     * byte offset, so meshes of the same format draw without rebinding the VAO.
+     * Buffers double in size when full, contents are copied on the GPU.
+     * Requires `GL_ARB_direct_state_access`, `good()` is false without it.
+     */
+    class OpenGLGeometryArena
+    {
+        public:
+            struct Allocation
+            {
+                VertexFormat format;
+                std::size_t base_vertex;
+                std::size_t vertex_count;
+                std::size_t index_offset; // in bytes
+                std::size_t index_bytes;
+            };
+
+            OpenGLGeometryArena(std::size_t initial_vertices, std::size_t initial_index_bytes);
+
+            ~OpenGLGeometryArena();
+
+            OpenGLGeometryArena(OpenGLGeometryArena && other);
+
+            bool good() const;
+
+            /**
+             * @brief Copy mesh into the arena
+             *
+             * @param vertex_data `vertex_count` vertices laid out as `format`
+             * @param index_size 2 or 4 bytes, index offset is aligned to it
+             *
+             * @return `std::nullopt` if buffers cannot grow
+             */
+            std::optional<Allocation> allocate(VertexFormat format,
+                const void * vertex_data, std::size_t vertex_count,
+                const void * index_data, std::size_t index_count, std::size_t index_size);
+
+            void free(const Allocation & allocation);
+
+            GLuint vertexArray(VertexFormat format) const;
+
+            // unique handle for every allocation, never reused
+            std::size_t nextHandle();
+
+            GeometryArenaStats stats() const;
+
+        private:
+            struct Pool
+            {
+                GLuint VAO = 0;
+                GLuint VBO = 0;
+                std::size_t stride = 0;
+                RangeAllocator allocator{0};
+            };
+
+            bool growBuffer(GLuint & buffer, std::size_t old_size, std::size_t new_size);
+            bool growPool(Pool & pool, std::size_t min_vertices);
+            bool growIndices(std::size_t min_bytes);
+
+            static void setAttributes(GLuint VAO, VertexFormat format);
+
+            std::array<Pool, VERTEX_FORMAT_COUNT> _pools;
+            GLuint _EBO;
+            RangeAllocator _indices;
+
+            std::size_t _next_handle;
+    };
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+#include <spdlog/spdlog.h>
+
+#include <GL/glew.h>
+
+#include "render/opengl/opengl_debug.hpp"
+
+namespace astre::render::opengl
+{
+    /**
+     * @brief `GL_DRAW_INDIRECT_BUFFER` holding commands of a single submission
+     * 
+     * Every upload orphans previous storage, so commands still read by the GPU
+     * are not overwritten. Storage grows to the largest submission seen.
+     */
+    class OpenGLIndirectBuffer
+    {
+        public:
+            OpenGLIndirectBuffer();
+
+            ~OpenGLIndirectBuffer();
+
+            OpenGLIndirectBuffer(OpenGLIndirectBuffer && other);
+
+            std::size_t ID() const;
+
+            bool good() const;
+
+            /**
+             * @brief Replace buffer content and leave it bound to `GL_DRAW_INDIRECT_BUFFER`
+             */
+            bool upload(const void * data, std::size_t size);
+
+        private:
+            GLuint _buffer;
+            std::size_t _capacity;
+    };
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <GL/glew.h>
+
+#include "render/opengl/opengl_debug.hpp"
+
+namespace astre::render::opengl
+{
+    /**
+     * @brief `GL_PIXEL_PACK_BUFFER` receiving a single pixel read without stalling the pipeline
+     *
+     * `issue` only queues the copy and places a fence behind it,
+     * data is mapped once `ready` reports the fence as signalled.
+     */
+    class OpenGLPixelReadback
+    {
+        public:
+            OpenGLPixelReadback(std::size_t capacity);
+
+            ~OpenGLPixelReadback();
+
+            OpenGLPixelReadback(OpenGLPixelReadback && other);
+
+            std::size_t ID() const;
+
+            bool good() const;
+
+            std::size_t capacity() const;
+
+            /**
+             * @brief Queue read of a rectangle of the current read buffer into the pack buffer
+             *
+             * @param size bytes written by the read, at most `capacity()`
+             */
+            bool issue(int x, int y, unsigned int width, unsigned int height, GLenum format, GLenum type, std::size_t size);
+
+            /**
+             * @brief Non blocking check if the GPU finished the issued read
+             */
+            bool ready() const;
+
+            /**
+             * @brief Copy out data of the issued read, waits for it if not `ready()`
+             */
+            std::optional<std::vector<std::uint8_t>> read();
+
+        private:
+            void releaseFence();
+
+            GLuint _buffer;
+            GLsync _fence;
+            std::size_t _capacity;
+            std::size_t _size; // of the issued read
+    };
+}
@@ -14,6 +14,7 @@
 
 #include "render/vertex.hpp"
 #include "render/texture.hpp"
+#include "render/program_binary_cache.hpp"
 
 #include "render/opengl/opengl_debug.hpp"
 #include "render/opengl/glsl_variable.hpp"
@@ -24,8 +25,9 @@ namespace astre::render::opengl
     {
     public:
         //ctor
-        OpenGLShader(std::vector<std::string> vertex_code);
-        OpenGLShader(std::vector<std::string> vertex_code, std::vector<std::string> fragment_code);
+        // linked program is taken from `cache` when present there, and stored into it otherwise
+        OpenGLShader(std::vector<std::string> vertex_code, const ProgramBinaryCache * cache = nullptr);
+        OpenGLShader(std::vector<std::string> vertex_code, std::vector<std::string> fragment_code, const ProgramBinaryCache * cache = nullptr);
         OpenGLShader(OpenGLShader && other);
         ~OpenGLShader();
 
@@ -34,6 +36,8 @@ namespace astre::render::opengl
         bool enable();
         bool disable();
 
+        bool hasUniform(const std::string & name) const;
+
         void setUniform(const std::string & name, bool value);
 
         void setUniform(const std::string & name, int value);
@@ -80,6 +84,13 @@ namespace astre::render::opengl
         bool linkProgram();
         bool validateProgram() const;
 
+        static bool programBinarySupported();
+        // sets `cache_key` whenever `cache` is usable, so a program built from source can be stored
+        bool loadCachedProgram(const ProgramBinaryCache * cache, const std::vector<std::vector<std::string>> & stages, std::optional<std::uint64_t> & cache_key);
+        // evicts the entry when the driver rejects it
+        bool loadProgramBinary(const ProgramBinaryCache & cache, std::uint64_t key);
+        void storeProgramBinary(const ProgramBinaryCache & cache, std::uint64_t key) const;
+
         void fetchAttributes();
         void fetchUniforms();
 
@@ -29,6 +29,8 @@ namespace astre::render::opengl
 
             void update(std::size_t size, const void * data);
 
+            unsigned int bindingPoint() const;
+
         protected:
             bool setGPUAttributes(GLuint binding_point);
             bool generateBuffer();
@@ -37,6 +39,7 @@ namespace astre::render::opengl
 
         private:
             GLuint _SSBO;
+            GLuint _binding_point;
 
             GLsizeiptr _size;
             const void * _data;
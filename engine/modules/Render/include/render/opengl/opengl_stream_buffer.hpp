@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include <GL/glew.h>
+
+#include "render/frame_ring_allocator.hpp"
+#include "render/opengl/opengl_debug.hpp"
+
+namespace astre::render::opengl
+{
+    /**
+     * @brief Persistently mapped buffer for per-frame uploads
+     * 
+     * Buffer is split into `region_count` frame regions. Data written during a frame goes to
+     * its region, and a fence placed at the end of the frame guards the region until GPU
+     * is done with it. Requires `GL_ARB_buffer_storage`, `good()` is false without it.
+     */
+    class OpenGLStreamBuffer
+    {
+        public:
+            struct Allocation
+            {
+                std::size_t offset;
+                std::size_t size;
+            };
+
+            OpenGLStreamBuffer(std::size_t region_size, std::uint32_t region_count);
+
+            ~OpenGLStreamBuffer();
+
+            OpenGLStreamBuffer(OpenGLStreamBuffer && other);
+
+            std::size_t ID() const;
+
+            bool good() const;
+
+            /**
+             * @brief Copy data into region of the current frame
+             * 
+             * @return `std::nullopt` if region has no space left
+             */
+            std::optional<Allocation> write(std::size_t size, const void * data, std::size_t alignment);
+
+            /**
+             * @brief Content of an earlier allocation, valid until its region is reused
+             */
+            const void * data(const Allocation & allocation) const;
+
+            /**
+             * @brief Fence current region and move to the next one
+             * 
+             * Blocks until GPU finished reading the next region in case it is still in use.
+             * 
+             * @return index of the new current region
+             */
+            std::uint32_t nextFrame();
+
+            std::uint32_t regionOf(const Allocation & allocation) const;
+
+        private:
+            void waitForFence(std::uint32_t region);
+
+            GLuint _buffer;
+            std::uint8_t * _mapped;
+
+            FrameRingAllocator _allocator;
+            std::vector<GLsync> _fences;
+    };
+}
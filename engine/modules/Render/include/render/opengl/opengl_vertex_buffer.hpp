@@ -6,6 +6,8 @@
 #include <GL/glew.h>
 
 #include "render/vertex.hpp"
+#include "render/vertex_format.hpp"
+#include "render/vertex_buffer.hpp"
 
 #include "render/opengl/opengl_debug.hpp"
 
@@ -14,7 +16,7 @@ namespace astre::render::opengl
     class OpenGLVertexBuffer
     {
         public:
-            OpenGLVertexBuffer(std::vector<unsigned int> indices, std::vector<GPUVertex> vertices);
+            OpenGLVertexBuffer(std::vector<unsigned int> indices, std::vector<GPUVertex> vertices, VertexFormat format = VertexFormat::Full);
             
             ~OpenGLVertexBuffer();
 
@@ -25,6 +27,16 @@ namespace astre::render::opengl
             bool good() const;
 
             std::size_t numberOfElements() const;
+
+            std::size_t indexSize() const;
+
+            VertexFormat vertexFormat() const;
+
+            const VertexQuantization & vertexQuantization() const;
+
+            GeometryRange range() const;
+
+            std::size_t vertexArrayID() const;
             //
             bool enable() const;
             //
@@ -43,5 +55,9 @@ namespace astre::render::opengl
 
             std::vector<GLuint> _indices;
             std::vector<GPUVertex> _vertices;
+
+            VertexFormat _format;
+            VertexQuantization _quantization;
+            std::size_t _index_size; // 16-bit indices whenever vertex count allows
     };
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace astre::render
+{
+    /**
+     * @brief Rectangle of pixels in OpenGL window coordinates, origin at the bottom left
+     *
+     */
+    struct PixelRect
+    {
+        int x = 0;
+        int y = 0;
+        unsigned int width = 1;
+        unsigned int height = 1;
+    };
+
+    /**
+     * @brief Part of `rect` lying inside of a surface of `resolution`
+     *
+     * @return `std::nullopt` if nothing is left
+     */
+    std::optional<PixelRect> clipPixelRect(const PixelRect & rect, std::pair<unsigned int, unsigned int> resolution);
+
+    /**
+     * @brief 64-bit values read back from a rectangle of a frame buffer attachment
+     *
+     * Values are stored row by row, bottom row first.
+     */
+    struct PixelRegionUint64
+    {
+        PixelRect rect;
+        std::vector<std::uint64_t> values; // rect.width * rect.height
+
+        /**
+         * @return value at window coordinates, `std::nullopt` outside of the region
+         */
+        std::optional<std::uint64_t> at(int x, int y) const;
+
+        /**
+         * @brief Non zero value closest to window coordinates, ties resolved by row then column order
+         *
+         * @return `std::nullopt` if every value of the region is zero
+         */
+        std::optional<std::uint64_t> nearestNonZero(int x, int y) const;
+    };
+}
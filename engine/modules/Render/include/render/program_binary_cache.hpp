@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace astre::render
+{
+    /**
+     * @brief Linked shader program as returned by the driver
+     *
+     */
+    struct ProgramBinary
+    {
+        std::uint32_t format = 0; // driver specific binary format
+        std::vector<std::uint8_t> data;
+    };
+
+    /**
+     * @brief On-disk cache of linked shader programs
+     *
+     * Programs are keyed by a hash of their stage sources and the driver description,
+     * so a driver update or source change simply misses the cache.
+     * Every program is one file in `directory`, replaced with file::writeFileAtomically.
+     */
+    class ProgramBinaryCache
+    {
+        public:
+            /**
+             * @param driver vendor, renderer and version of the driver producing the binaries
+             */
+            ProgramBinaryCache(std::filesystem::path directory, std::string driver);
+
+            /**
+             * @brief Key of a program built from `stages`, each stage given as its source strings
+             */
+            std::uint64_t key(const std::vector<std::vector<std::string>> & stages) const;
+
+            /**
+             * @return `std::nullopt` if there is no entry or it is damaged or written for another key
+             */
+            std::optional<ProgramBinary> load(std::uint64_t key) const;
+
+            bool store(std::uint64_t key, const ProgramBinary & binary) const;
+
+            // drop entry rejected by the driver
+            bool erase(std::uint64_t key) const;
+
+            const std::filesystem::path & directory() const;
+
+        private:
+            std::filesystem::path entryPath(std::uint64_t key) const;
+
+            std::filesystem::path _directory;
+            std::string _driver;
+    };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+
+namespace astre::render
+{
+    /**
+     * @brief Usage of a `RangeAllocator`, in allocator units
+     *
+     */
+    struct RangeAllocatorStats
+    {
+        std::size_t capacity = 0;
+        std::size_t used = 0;
+        std::size_t allocations = 0;
+        std::size_t free_blocks = 0;
+        std::size_t largest_free_block = 0;
+
+        // 0 when all free space is one block, approaches 1 as it splinters
+        float fragmentation = 0.0f;
+    };
+
+    /**
+     * @brief Best fit free list allocator over an abstract range `[0, capacity)`
+     *
+     * Manages offsets only, owner maps them onto its own storage (GPU buffer elements, bytes, ...).
+     * Free blocks are indexed both by offset, for coalescing neighbours on free,
+     * and by size, for O(log n) best fit lookup.
+     */
+    class RangeAllocator
+    {
+        public:
+            explicit RangeAllocator(std::size_t capacity);
+
+            /**
+             * @brief Allocate `size` units
+             *
+             * @param alignment offset alignment, does not have to be a power of two
+             * @return offset of the allocation, `std::nullopt` if no free block fits
+             */
+            std::optional<std::size_t> allocate(std::size_t size, std::size_t alignment = 1);
+
+            /**
+             * @brief Return an allocation to the free list
+             *
+             * @return false if `offset` is not the start of a live allocation
+             */
+            bool free(std::size_t offset);
+
+            /**
+             * @brief Extend the range to `capacity`, new space joins the tail free block
+             *
+             * Shrinking is not supported, smaller capacities are ignored.
+             */
+            void grow(std::size_t capacity);
+
+            std::size_t capacity() const;
+
+            RangeAllocatorStats stats() const;
+
+        private:
+            void insertFreeBlock(std::size_t offset, std::size_t size);
+            void eraseFreeBlock(std::map<std::size_t, std::size_t>::iterator it);
+
+            std::size_t _capacity;
+            std::size_t _used;
+
+            std::map<std::size_t, std::size_t> _free_by_offset; // offset -> size
+            std::set<std::pair<std::size_t, std::size_t>> _free_by_size; // (size, offset)
+            absl::flat_hash_map<std::size_t, std::size_t> _allocations; // offset -> size
+    };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "math/math.hpp"
+
+#include "render/vertex.hpp"
+#include "render/culling.hpp"
+
+namespace astre::render
+{
+    /**
+     * @brief Axis aligned box
+     *
+     */
+    struct AABB
+    {
+        math::Vec3 min{0.0f};
+        math::Vec3 max{0.0f};
+    };
+
+    /**
+     * @brief Half line `origin + t * direction`, t >= 0
+     *
+     * Direction does not need to be normalized, distances are then measured in its lengths.
+     */
+    struct Ray
+    {
+        math::Vec3 origin{0.0f};
+        math::Vec3 direction{0.0f, 0.0f, -1.0f};
+    };
+
+    /**
+     * @brief Triangles of a mesh kept on CPU for exact ray tests
+     *
+     */
+    struct TriangleMesh
+    {
+        std::vector<math::Vec3> positions;
+        std::vector<unsigned int> indices; // three per triangle
+    };
+
+    TriangleMesh makeTriangleMesh(const Mesh & mesh);
+
+    /**
+     * @brief World space box enclosing local bounds transformed by `model`
+     */
+    AABB transformAABB(const BoundingVolume & bounds, const math::Mat4 & model);
+
+    /**
+     * @brief Same ray expressed in space transformed by `matrix`, distances along it are kept
+     */
+    Ray transformRay(const Ray & ray, const math::Mat4 & matrix);
+
+    /**
+     * @brief Ray through a point of the screen, from near towards far plane
+     *
+     * @param ndc point in normalized device coordinates, y pointing up
+     * @return ray in world space with normalized direction
+     */
+    Ray screenPointToRay(const math::Vec2 & ndc, const math::Mat4 & view, const math::Mat4 & projection);
+
+    /**
+     * @return distance of the entry point, 0 if ray starts inside of the box, `std::nullopt` if box is missed or further than `max_distance`
+     */
+    std::optional<float> intersectRayAABB(const Ray & ray, const AABB & box, float max_distance);
+
+    /**
+     * @brief Möller–Trumbore test, both triangle sides are hit
+     */
+    std::optional<float> intersectRayTriangle(const Ray & ray, const math::Vec3 & a, const math::Vec3 & b, const math::Vec3 & c);
+
+    /**
+     * @return distance of the closest triangle hit not further than `max_distance`
+     */
+    std::optional<float> intersectRayMesh(const Ray & ray, const TriangleMesh & mesh, float max_distance);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "math/math.hpp"
+
+#include "render/render.hpp"
+#include "render/raycast.hpp"
+#include "render/bvh.hpp"
+
+namespace astre::render
+{
+    struct RaycastHit
+    {
+        std::size_t entity;
+        float distance;
+        math::Vec3 position; // world space
+    };
+
+    /**
+     * @brief CPU ray queries against render proxies of a frame
+     *
+     * Keeps a BVH over world space bounds of visible opaque proxies. While the set of
+     * proxies stays the same the tree is only refitted, otherwise it is rebuilt.
+     * Not synchronized, update and queries must not overlap.
+     */
+    class RaycastScene
+    {
+        public:
+            /**
+             * @brief Track proxies of a frame, proxies without bounds are skipped
+             *
+             * @param renderer source of triangles of proxy vertex buffers
+             */
+            void update(const absl::flat_hash_map<std::size_t, RenderProxy> & proxies, const IRenderer & renderer);
+
+            /**
+             * @brief Closest proxy hit by the ray
+             *
+             * @param exact test triangles of the mesh after its bounds are hit, bounds alone are used without it
+             *      or when triangles of the proxy are not known
+             */
+            std::optional<RaycastHit> raycast(const Ray & ray, float max_distance, bool exact = true) const;
+
+            std::size_t size() const;
+
+        private:
+            struct Entry
+            {
+                std::size_t entity;
+                math::Mat4 model;
+                AABB box; // world space
+                std::shared_ptr<const TriangleMesh> triangles;
+            };
+
+            std::vector<Entry> _entries; // ordered by entity, index is the BVH item
+            BoundingVolumeHierarchy _bvh;
+    };
+}
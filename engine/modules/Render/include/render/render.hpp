@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <filesystem>
 
 #include <absl/container/flat_hash_map.h>
 #include <absl/container/flat_hash_set.h>
@@ -12,14 +14,21 @@
 
 #include "render/render_options.hpp"
 #include "render/render_stats.hpp"
+#include "render/draw_sort.hpp"
 
 #include "render/vertex.hpp"
 #include "render/vertex_buffer.hpp"
+#include "render/culling.hpp"
+#include "render/mesh_lod.hpp"
+#include "render/indirect_draw.hpp"
+#include "render/pixel_region.hpp"
+#include "render/raycast.hpp"
 
 #include "render/shader.hpp"
 #include "render/shader_storage_buffer.hpp"
 
 #include "render/frame_buffer_object.hpp"
+#include "render/shadow_atlas.hpp"
 #include "render/texture.hpp"
 
 
@@ -58,6 +67,44 @@ namespace astre::render
         ShaderInputs inputs;
 
         render::RenderOptions options;
+
+        // local space bounds of the vertex buffer, proxies without bounds are never culled
+        std::optional<BoundingVolume> bounds;
+    };
+
+    /**
+     * @brief Single draw submitted as part of a draw list
+     * 
+     * @see IRenderer::submit
+     */
+    struct DrawCommand
+    {
+        std::size_t vertex_buffer;
+        std::size_t shader;
+        std::uint32_t instance_count = 1;
+
+        ShaderInputs inputs;
+        RenderOptions options;
+        std::optional<std::size_t> fbo;
+
+        // sub-rectangle of the target to draw into (e.g. shadow atlas tile), whole target if not set
+        std::optional<ViewportRect> viewport;
+    };
+
+    /**
+     * @brief Draws sharing shader, inputs, options and target, submitted with multi-draw indirect
+     * 
+     */
+    struct IndirectDrawCommand
+    {
+        IndirectDrawList list;
+        std::uint32_t draw_data_base = 0; // offset of `list.draw_data` in the draw data SSBO bound through `inputs`
+
+        std::size_t shader;
+        ShaderInputs inputs;
+        RenderOptions options;
+        std::optional<std::size_t> fbo;
+        std::optional<ViewportRect> viewport;
     };
 
     #pragma pack(push, 1)
@@ -68,6 +115,13 @@ namespace astre::render
         math::Vec4 attenuation;  // x=constant, y=linear, z=quadratic, w=unused
         math::Vec2 cutoff;       // x=inner, y=outer
         math::Vec2 castShadows;  // x=enabled, y=shadowMapIndex
+        math::Vec4 shadowAtlasRect; // xy=offset, zw=size of the shadow tile in atlas UV space
+    };
+
+    // per-instance data read by instanced shaders as instances[uInstanceBase + gl_InstanceID]
+    struct GPUInstance {
+        math::Mat4 model;
+        math::Vec4 color;
     };
     #pragma pack(pop)
 
@@ -121,9 +175,11 @@ namespace astre::render
          * @brief Clear the screen with a color
          * 
          * @param color Color to clear the screen with
+         * @param fbo Optional frame buffer object to clear, default frame buffer if not provided
+         * @param region Optional rectangle to clear, whole target if not provided
          * @return asio::awaitable<void> 
          */
-        virtual asio::awaitable<void> clearScreen(math::Vec4 color, std::optional<std::size_t> fbo = std::nullopt) = 0;
+        virtual asio::awaitable<void> clearScreen(math::Vec4 color, std::optional<std::size_t> fbo = std::nullopt, std::optional<ViewportRect> region = std::nullopt) = 0;
 
         /**
          * @brief Render a vertex buffer using a specified shader.
@@ -147,6 +203,74 @@ namespace astre::render
                 RenderOptions options = RenderOptions{},
                 std::optional<std::size_t> fbo = std::nullopt) = 0;
 
+        /**
+         * @brief Render `instance_count` instances of a vertex buffer with a single draw call.
+         * 
+         * Behaves like `render`, but issues an instanced draw. Per-instance data is not
+         * managed by the renderer, shader is expected to read it from a storage buffer
+         * passed in `shader_inputs` using `gl_InstanceID`.
+         * 
+         * @param vertex_buffer ID of the vertex buffer to render.
+         * @param shader ID of the shader to use for rendering.
+         * @param instance_count Number of instances to draw.
+         * @param shader_inputs Inputs shared by all instances.
+         * @param options Options for rendering.
+         * @param fbo Optional frame buffer object to render into.
+         * 
+         * @return stats of the draw, `instances` holds number of drawn instances
+         */
+        virtual asio::awaitable<FrameStats> renderInstanced(
+                std::size_t vertex_buffer,
+                std::size_t shader,
+                std::uint32_t instance_count,
+                ShaderInputs shader_inputs = ShaderInputs{},
+                RenderOptions options = RenderOptions{},
+                std::optional<std::size_t> fbo = std::nullopt) = 0;
+
+        /**
+         * @brief Execute a list of draws in the given order.
+         * 
+         * Equivalent to calling `renderInstanced` for every command, but frame buffer
+         * objects stay bound between consecutive commands targeting the same FBO
+         * and the whole list is executed with a single hop to the render thread.
+         * Callers should sort the list by state (see `render/draw_sort.hpp`) to
+         * minimise shader, vertex array and FBO binds.
+         * 
+         * @param commands draw list
+         * 
+         * @return accumulated stats of all draws
+         */
+        virtual asio::awaitable<FrameStats> submit(std::vector<DrawCommand> commands) = 0;
+
+        /**
+         * @brief Check if `submitIndirect` issues multi-draws instead of single draws.
+         * 
+         * Requires multi-draw indirect and shader draw parameters support.
+         */
+        virtual bool supportsIndirectDraw() const = 0;
+
+        /**
+         * @brief Get location of a vertex buffer in shared geometry storage.
+         * 
+         * @param vertex_buffer ID of the VBO.
+         * 
+         * @return geometry of the VBO, or std::nullopt if it has dedicated buffers and can only be drawn directly.
+         */
+        virtual std::optional<IndirectDrawGeometry> getIndirectDrawGeometry(std::size_t vertex_buffer) const = 0;
+
+        /**
+         * @brief Execute lists of indirect draws, one multi-draw per group of every list.
+         * 
+         * Shader reads instance and draw data through `gl_BaseInstanceARB` and `gl_DrawIDARB`
+         * when `uIndirect` is set. Fallback draws, and every draw when indirect drawing
+         * is not supported, are executed one by one with `uInstanceBase` set instead.
+         * 
+         * @param commands indirect draw lists, executed in the given order
+         * 
+         * @return accumulated stats of all draws
+         */
+        virtual asio::awaitable<FrameStats> submitIndirect(std::vector<IndirectDrawCommand> commands) = 0;
+
         /**
          * @brief Present the rendered frame
          * 
@@ -182,12 +306,13 @@ namespace astre::render
          * 
          * @param name a unique name for the VBO
          * @param mesh the mesh data
+         * @param format layout of the vertices in GPU memory, index width is chosen from the vertex count
          * 
          * @return ID of the VBO, or std::nullopt if failed
          * 
          * @note This function must be called on the render thread strand.
          */
-        virtual asio::awaitable<std::optional<std::size_t>> createVertexBuffer(std::string name, const Mesh & mesh) = 0;
+        virtual asio::awaitable<std::optional<std::size_t>> createVertexBuffer(std::string name, const Mesh & mesh, VertexFormat format = VertexFormat::Full) = 0;
 
         /**
          * @brief Erase a vertex buffer object (VBO) by ID.
@@ -211,6 +336,48 @@ namespace astre::render
          */
         virtual std::optional<std::size_t> getVertexBuffer(std::string name) const = 0;
 
+        /**
+         * @brief Get local space bounds of a vertex buffer, computed from the mesh at creation.
+         * 
+         * @param id ID of the VBO.
+         * 
+         * @return bounds of the VBO, or std::nullopt if not found.
+         */
+        virtual std::optional<BoundingVolume> getVertexBufferBounds(std::size_t id) const = 0;
+
+        /**
+         * @brief Get levels of detail of a vertex buffer, created from `Mesh::lods`.
+         * 
+         * @param id ID of the VBO.
+         * 
+         * @return LOD chain starting with the VBO itself, empty if the VBO has no coarser levels.
+         */
+        virtual std::vector<VertexBufferLOD> getVertexBufferLODs(std::size_t id) const = 0;
+
+        /**
+         * @brief Get triangles of the mesh a vertex buffer was created from, kept for CPU ray casts.
+         * 
+         * @param id ID of the VBO, coarser levels share triangles of their base buffer.
+         * 
+         * @return triangles of the mesh, nullptr if the VBO is not known.
+         */
+        virtual std::shared_ptr<const TriangleMesh> getVertexBufferTriangles(std::size_t id) const = 0;
+
+        /**
+         * @brief Get usage and fragmentation of the shared vertex and index storage.
+         * 
+         * @return stats of the geometry arena, all zero if vertex buffers do not share storage.
+         */
+        virtual GeometryArenaStats getGeometryArenaStats() const = 0;
+
+        /**
+         * @brief Keep linked shader programs in `directory` and reuse them in shaders created afterwards
+         * 
+         * Cached programs are bound to the driver, after a driver change shaders are compiled from source again.
+         * @return `false` if the renderer cannot retrieve program binaries
+         */
+        virtual asio::awaitable<bool> enableProgramBinaryCache(std::filesystem::path directory) = 0;
+
         /**
          * @brief Construct a new shader object with the given name and vertex code
          * @param name Name of the shader
@@ -330,6 +497,18 @@ namespace astre::render
 
 
         virtual asio::awaitable<std::optional<std::uint64_t>> readPixelUint64(std::size_t fbo, unsigned attachment, int x, int y) = 0;
+
+        /**
+         * @brief Read 64-bit values of a rectangle of a Frame Buffer Object (FBO) attachment without stalling the GPU
+         * 
+         * The read is queued behind already submitted work and the awaitable completes
+         * once GPU finished it, usually one or two `present` calls later.
+         * Do not await it from a stage `present` depends on, spawn it instead.
+         * 
+         * @param rect rectangle to read, clipped to the FBO resolution
+         * @return values of the clipped rectangle, or std::nullopt if nothing could be read
+         */
+        virtual asio::awaitable<std::optional<PixelRegionUint64>> readRegionUint64(std::size_t fbo, unsigned attachment, PixelRect rect) = 0;
     };
 
     template<class RendererImplType>
@@ -353,8 +532,8 @@ namespace astre::render
             inline void join() override { return base::impl().join();}
             inline async::AsyncContext<asio::io_context> & getAsyncContext() override { return base::impl().getAsyncContext();}
 
-            inline asio::awaitable<void> clearScreen(math::Vec4 color, std::optional<std::size_t> fbo) override { 
-                return base::impl().clearScreen(std::move(color), std::move(fbo));
+            inline asio::awaitable<void> clearScreen(math::Vec4 color, std::optional<std::size_t> fbo, std::optional<ViewportRect> region) override { 
+                return base::impl().clearScreen(std::move(color), std::move(fbo), std::move(region));
             }
 
             inline asio::awaitable<FrameStats> render(std::size_t vertex_buffer, std::size_t shader, 
@@ -369,6 +548,38 @@ namespace astre::render
                 );
             }
 
+            inline asio::awaitable<FrameStats> renderInstanced(std::size_t vertex_buffer, std::size_t shader,
+                std::uint32_t instance_count,
+                ShaderInputs shader_inputs,
+                RenderOptions options,
+                std::optional<std::size_t> fbo) override
+            { 
+                return base::impl().renderInstanced(std::move(vertex_buffer), std::move(shader),
+                    instance_count,
+                    std::move(shader_inputs),
+                    std::move(options),
+                    std::move(fbo)
+                );
+            }
+
+            inline asio::awaitable<FrameStats> submit(std::vector<DrawCommand> commands) override
+            {
+                return base::impl().submit(std::move(commands));
+            }
+
+            inline bool supportsIndirectDraw() const override { 
+                return base::impl().supportsIndirectDraw();
+            }
+
+            inline std::optional<IndirectDrawGeometry> getIndirectDrawGeometry(std::size_t vertex_buffer) const override {
+                return base::impl().getIndirectDrawGeometry(std::move(vertex_buffer));
+            }
+
+            inline asio::awaitable<FrameStats> submitIndirect(std::vector<IndirectDrawCommand> commands) override
+            {
+                return base::impl().submitIndirect(std::move(commands));
+            }
+
             inline asio::awaitable<void> present() override { 
                 return base::impl().present();
             }
@@ -389,8 +600,8 @@ namespace astre::render
                 return base::impl().disableVSync();
             }
 
-            inline asio::awaitable<std::optional<std::size_t>> createVertexBuffer(std::string name, const Mesh & mesh) override{ 
-                return base::impl().createVertexBuffer(std::move(name), mesh);
+            inline asio::awaitable<std::optional<std::size_t>> createVertexBuffer(std::string name, const Mesh & mesh, VertexFormat format = VertexFormat::Full) override{ 
+                return base::impl().createVertexBuffer(std::move(name), mesh, format);
             }
         
             inline asio::awaitable<bool> eraseVertexBuffer(std::size_t id) override {
@@ -401,6 +612,26 @@ namespace astre::render
                 return base::impl().getVertexBuffer(std::move(name));
             }
 
+            inline std::optional<BoundingVolume> getVertexBufferBounds(std::size_t id) const override{
+                return base::impl().getVertexBufferBounds(std::move(id));
+            }
+
+            inline std::vector<VertexBufferLOD> getVertexBufferLODs(std::size_t id) const override{
+                return base::impl().getVertexBufferLODs(std::move(id));
+            }
+
+            inline std::shared_ptr<const TriangleMesh> getVertexBufferTriangles(std::size_t id) const override{
+                return base::impl().getVertexBufferTriangles(std::move(id));
+            }
+
+            inline GeometryArenaStats getGeometryArenaStats() const override{
+                return base::impl().getGeometryArenaStats();
+            }
+
+            inline asio::awaitable<bool> enableProgramBinaryCache(std::filesystem::path directory) override{
+                return base::impl().enableProgramBinaryCache(std::move(directory));
+            }
+
             inline asio::awaitable<std::optional<std::size_t>> createShader(std::string name, std::vector<std::string> vertex_code) override { 
                 return base::impl().createShader(std::move(name), std::move(vertex_code));
             }
@@ -453,6 +684,10 @@ namespace astre::render
                 return base::impl().readPixelUint64(std::move(fbo), std::move(attachment), std::move(x), std::move(y));
             }
 
+            inline asio::awaitable<std::optional<PixelRegionUint64>> readRegionUint64(std::size_t fbo, unsigned attachment, PixelRect rect) override {
+                return base::impl().readRegionUint64(std::move(fbo), std::move(attachment), std::move(rect));
+            }
+
     };
 
     template<class RendererImplType>
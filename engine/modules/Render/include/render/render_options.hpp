@@ -1,6 +1,7 @@
 #pragma once
 
 #include <optional>
+#include <utility>
 
 namespace astre::render
 {   
@@ -35,6 +36,27 @@ namespace astre::render
     {
         float factor;
         float units;
+
+        bool operator==(const PolygonOffset &) const = default;
+
+        template <typename H>
+        friend H AbslHashValue(H h, const PolygonOffset & offset) {
+            return H::combine(std::move(h), offset.factor, offset.units);
+        }
+    };
+
+    /**
+     * @brief Rectangle inside of a render target, in pixels
+     * 
+     */
+    struct ViewportRect
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+
+        bool operator==(const ViewportRect &) const = default;
     };
 
     /**
@@ -48,5 +70,15 @@ namespace astre::render
         bool write_depth = true;
         bool depth_test = true; // set false to draw always-on-top (e.g. debug overlays)
         PrimitiveTopology topology = PrimitiveTopology::Triangles;
+
+        bool operator==(const RenderOptions &) const = default;
+
+        // options are part of the instancing batch key
+        template <typename H>
+        friend H AbslHashValue(H h, const RenderOptions & options) {
+            return H::combine(std::move(h), options.mode,
+                options.polygon_offset.has_value(), options.polygon_offset.value_or(PolygonOffset{0.0f, 0.0f}),
+                options.write_depth, options.depth_test, options.topology);
+        }
     };
 }
\ No newline at end of file
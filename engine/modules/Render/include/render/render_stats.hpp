@@ -1,20 +1,36 @@
 #pragma once
 
+#include <array>
 #include <utility>
 
+#include "render/range_allocator.hpp"
+#include "render/vertex_format.hpp"
+
 namespace astre::render
 {   
     struct FrameStats 
     {
         std::uint32_t draw_calls = 0;
+        std::uint32_t instances = 0; // objects drawn, instanced draws count every instance
         std::uint32_t vertices = 0;
         std::uint32_t triangles = 0;
-        // optionally: shader switches, FBO binds, texture binds, etc.
+        std::uint32_t culled = 0; // proxies rejected by frustum culling
+
+        // pipeline state changes, counted only when binding actually changes
+        std::uint32_t shader_binds = 0;
+        std::uint32_t vao_binds = 0;
+        std::uint32_t fbo_binds = 0;
+        // optionally: texture binds, etc.
 
         inline FrameStats & operator+=(const FrameStats & rhs) {
             draw_calls += rhs.draw_calls;
+            instances += rhs.instances;
             vertices += rhs.vertices;
             triangles += rhs.triangles;
+            culled += rhs.culled;
+            shader_binds += rhs.shader_binds;
+            vao_binds += rhs.vao_binds;
+            fbo_binds += rhs.fbo_binds;
             return *this;
         }
     };
@@ -23,9 +39,23 @@ namespace astre::render
     { 
         return {    
             lhs.draw_calls + rhs.draw_calls,
+            lhs.instances + rhs.instances,
             lhs.vertices + rhs.vertices,
-            lhs.triangles + rhs.triangles
+            lhs.triangles + rhs.triangles,
+            lhs.culled + rhs.culled,
+            lhs.shader_binds + rhs.shader_binds,
+            lhs.vao_binds + rhs.vao_binds,
+            lhs.fbo_binds + rhs.fbo_binds
         }; 
     }
 
+    /**
+     * @brief Usage of the shared geometry buffers
+     * 
+     */
+    struct GeometryArenaStats
+    {
+        std::array<RangeAllocatorStats, VERTEX_FORMAT_COUNT> vertices; // per VertexFormat, in vertices
+        RangeAllocatorStats indices; // in bytes
+    };
 }
\ No newline at end of file
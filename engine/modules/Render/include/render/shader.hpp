@@ -71,6 +71,14 @@ namespace astre::render
          */
         virtual bool disable() = 0;
 
+        /**
+         * @brief Check if the shader program uses the uniform.
+         * 
+         * @param name The name of the uniform.
+         * @return True if the uniform is active in the shader program, false otherwise.
+         */
+        virtual bool hasUniform(const std::string & name) const = 0;
+
         /**
          * @brief Set boolean uniform value in the shader.
          * 
@@ -215,6 +223,7 @@ namespace astre::render
 
             inline bool enable() override { return base::impl().enable();}
             inline bool disable() override { return base::impl().disable();}
+            inline bool hasUniform(const std::string & name) const override { return base::impl().hasUniform(name);}
 
             inline void setUniform(const std::string & name, bool value) override { return base::impl().setUniform(name, value);}
 
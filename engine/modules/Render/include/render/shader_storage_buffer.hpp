@@ -64,6 +64,13 @@ namespace astre::render
          * @note This function must be called on the render thread strand.
          */
         virtual void update(std::size_t size, const void * data) = 0;
+
+        /**
+         * @brief Get the binding point the shader storage buffer is attached to.
+         * 
+         * @return Index of the shader storage buffer binding point.
+         */
+        virtual unsigned int bindingPoint() const = 0;
     };
 
     template<class ShaderStorageBufferImplType>
@@ -91,6 +98,7 @@ namespace astre::render
             inline bool enable() const override { return base::impl().enable();}
             inline void disable() const override { return base::impl().disable();}
             inline void update(std::size_t size, const void * data) override { return base::impl().update(std::move(size), std::move(data));}
+            inline unsigned int bindingPoint() const override { return base::impl().bindingPoint();}
     };
 
     template<class ShaderStorageBufferImplType>
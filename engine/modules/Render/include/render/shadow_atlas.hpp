@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "math/math.hpp"
+
+#include "render/render_options.hpp"
+
+namespace astre::render
+{
+    /**
+     * @brief Tile allocator of a square shadow atlas
+     * 
+     * Atlas is recursively split into quadrants, so every tile is a power-of-two square.
+     * Requests are served from the largest to the smallest, which keeps the atlas free of holes
+     * that could not fit a later request. When requested area exceeds the atlas, the smallest
+     * tiles are downgraded to half of their size first, and only when every remaining tile is
+     * at the minimum size the least important requests are dropped.
+     */
+    class ShadowAtlas
+    {
+        public:
+            /**
+             * @param size atlas resolution in pixels, rounded down to power of two
+             * @param min_tile_size smallest tile that can be handed out, rounded down to power of two
+             */
+            ShadowAtlas(unsigned int size, unsigned int min_tile_size);
+
+            unsigned int size() const;
+            unsigned int minTileSize() const;
+
+            /**
+             * @brief Allocate tiles for a single frame
+             * 
+             * @param tile_sizes requested tile size for every shadow caster, clamped to [min tile size, atlas size],
+             *  on equal sizes earlier requests are more important
+             * @return tile of every request in pixels, `std::nullopt` if it did not fit at all
+             */
+            std::vector<std::optional<ViewportRect>> allocate(const std::vector<unsigned int> & tile_sizes) const;
+
+            /**
+             * @brief Tile expressed in atlas UV space
+             * 
+             * @return xy=offset, zw=size
+             */
+            math::Vec4 toUV(const ViewportRect & tile) const;
+
+        private:
+            unsigned int _size;
+            unsigned int _min_tile_size;
+    };
+}
@@ -3,6 +3,7 @@
 #include <vector>
 #include <algorithm>
 #include <array>
+#include <optional>
 
 #include "math/math.hpp"
 
@@ -24,6 +25,31 @@ namespace astre::render
     };
     #pragma pack(pop) // each vertex is now exactly 8 floats = 32 bytes, no extra padding
 
+    /**
+     * @brief Coarser level of detail of a mesh
+     * 
+     */
+    struct MeshLOD
+    {
+        std::vector<unsigned int> indices;
+        std::vector<GPUVertex> vertices;
+        float error = 0.0f; // deviation from the full mesh surface in mesh units
+    };
+
+    /**
+     * @brief Bounding volume of a mesh in its local space
+     * 
+     */
+    struct BoundingVolume
+    {
+        math::Vec3 aabb_min{0.0f};
+        math::Vec3 aabb_max{0.0f};
+
+        // bounding sphere centered in the middle of the AABB
+        math::Vec3 center{0.0f};
+        float radius = 0.0f;
+    };
+
     /**
      * @brief Mesh
      * 
@@ -32,6 +58,8 @@ namespace astre::render
     {
         std::vector<unsigned int> indices;
         std::vector<GPUVertex> vertices;
+        std::vector<MeshLOD> lods; // LOD 1 onwards, coarser each
+        std::optional<BoundingVolume> bounds; // known in advance (cooked meshes), computed from `vertices` otherwise
     };
 
     /**
@@ -6,8 +6,21 @@
 
 #include "type/type.hpp"
 
+#include "render/vertex_format.hpp"
+
 namespace astre::render
 {
+    /**
+     * @brief Part of the bound index and vertex storage used by a single vertex buffer
+     * 
+     */
+    struct GeometryRange
+    {
+        std::size_t base_vertex = 0;
+        std::size_t first_index = 0;
+        std::size_t index_count = 0;
+    };
+
     /**
      * @brief Vertex Buffer Interface
      * 
@@ -40,6 +53,41 @@ namespace astre::render
          */
         virtual std::size_t numberOfElements() const = 0;
 
+        /**
+         * @brief Get the size of a single index in bytes.
+         * 
+         * @return 2 for 16-bit indices, 4 for 32-bit indices.
+         */
+        virtual std::size_t indexSize() const = 0;
+
+        /**
+         * @brief Get the layout of vertices stored in the buffer.
+         * 
+         * @return The vertex format.
+         */
+        virtual VertexFormat vertexFormat() const = 0;
+
+        /**
+         * @brief Get the mapping of stored positions back to mesh space.
+         * 
+         * @return The vertex quantization, identity unless format is `VertexFormat::Quantized`.
+         */
+        virtual const VertexQuantization & vertexQuantization() const = 0;
+
+        /**
+         * @brief Get the range of indices and vertices to draw once enabled.
+         * 
+         * @return The geometry range, non-zero offsets when the buffer lives in shared storage.
+         */
+        virtual GeometryRange range() const = 0;
+
+        /**
+         * @brief Get the vertex array bound by `enable()`.
+         * 
+         * @return The vertex array ID, shared by buffers of the same format in shared storage.
+         */
+        virtual std::size_t vertexArrayID() const = 0;
+
         /**
          * @brief Enable the vertex buffer for rendering.
          * 
@@ -77,6 +125,11 @@ namespace astre::render
             inline std::size_t ID() const override { return base::impl().ID();}
             inline bool good() const override { return base::impl().good();}
             inline std::size_t numberOfElements() const override { return base::impl().numberOfElements();}
+            inline std::size_t indexSize() const override { return base::impl().indexSize();}
+            inline VertexFormat vertexFormat() const override { return base::impl().vertexFormat();}
+            inline const VertexQuantization & vertexQuantization() const override { return base::impl().vertexQuantization();}
+            inline GeometryRange range() const override { return base::impl().range();}
+            inline std::size_t vertexArrayID() const override { return base::impl().vertexArrayID();}
             inline bool enable() const override { return base::impl().enable();}
             inline void disable() const override { return base::impl().disable();}    
     };
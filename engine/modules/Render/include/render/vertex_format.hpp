@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "math/math.hpp"
+
+#include "render/vertex.hpp"
+
+namespace astre::render
+{
+    /**
+     * @brief Layout of vertices in GPU memory
+     * 
+     */
+    enum class VertexFormat : std::uint8_t
+    {
+        Full,       // GPUVertex, 32 bytes
+        Compact,    // CompactGPUVertex, 20 bytes
+        Quantized   // QuantizedGPUVertex, 16 bytes
+    };
+
+    constexpr std::size_t VERTEX_FORMAT_COUNT = 3;
+
+    #pragma pack(push, 1)
+    /**
+     * @brief Vertex with octahedral encoded normal and half-float UV
+     * 
+     */
+    struct CompactGPUVertex
+    {
+        math::Vec3 position;
+        std::array<std::int16_t, 2> normal;  // octahedral, snorm16
+        std::array<std::uint16_t, 2> uv;     // half-float
+    };
+
+    /**
+     * @brief Compact vertex with position quantized to 16 bits inside of the mesh bounds
+     * 
+     */
+    struct QuantizedGPUVertex
+    {
+        std::array<std::uint16_t, 4> position; // unorm16 inside of mesh AABB, w unused
+        std::array<std::int16_t, 2> normal;    // octahedral, snorm16
+        std::array<std::uint16_t, 2> uv;       // half-float
+    };
+    #pragma pack(pop)
+
+    /**
+     * @brief Maps stored position back to mesh space, `position = offset + stored * scale`
+     * 
+     */
+    struct VertexQuantization
+    {
+        math::Vec3 offset{0.0f};
+        math::Vec3 scale{1.0f};
+    };
+
+    std::size_t vertexStride(VertexFormat format);
+
+    std::array<std::int16_t, 2> encodeOctahedralNormal(const math::Vec3 & normal);
+    math::Vec3 decodeOctahedralNormal(const std::array<std::int16_t, 2> & encoded);
+
+    std::uint16_t floatToHalf(float value);
+    float halfToFloat(std::uint16_t value);
+
+    /**
+     * @brief Quantization spanning AABB of the mesh, identity for `VertexFormat::Full` and `VertexFormat::Compact`
+     */
+    VertexQuantization computeVertexQuantization(const std::vector<GPUVertex> & vertices, VertexFormat format);
+
+    std::vector<CompactGPUVertex> toCompactVertices(const std::vector<GPUVertex> & vertices);
+    std::vector<QuantizedGPUVertex> toQuantizedVertices(const std::vector<GPUVertex> & vertices, const VertexQuantization & quantization);
+
+    /**
+     * @brief Smallest index width able to address every vertex
+     * 
+     * @return 2 or 4 bytes
+     */
+    std::size_t indexSize(std::size_t vertex_count);
+}
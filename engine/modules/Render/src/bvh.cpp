@@ -0,0 +1,175 @@
+#include "render/bvh.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace astre::render
+{
+    static AABB _merge(const AABB & a, const AABB & b)
+    {
+        return AABB{
+            .min = glm::min(a.min, b.min),
+            .max = glm::max(a.max, b.max)
+        };
+    }
+
+    void BoundingVolumeHierarchy::build(std::vector<AABB> boxes)
+    {
+        _boxes = std::move(boxes);
+        _nodes.clear();
+        _items.resize(_boxes.size());
+        std::iota(_items.begin(), _items.end(), 0u);
+
+        if(_boxes.empty())return;
+
+        std::vector<math::Vec3> centroids;
+        centroids.reserve(_boxes.size());
+        for(const auto & box : _boxes)
+        {
+            centroids.emplace_back((box.min + box.max) * 0.5f);
+        }
+
+        _nodes.reserve(2 * _boxes.size());
+        buildNode(0, (std::uint32_t)_items.size(), centroids);
+    }
+
+    std::uint32_t BoundingVolumeHierarchy::buildNode(std::uint32_t first, std::uint32_t count, const std::vector<math::Vec3> & centroids)
+    {
+        const std::uint32_t node_index = (std::uint32_t)_nodes.size();
+        _nodes.emplace_back();
+
+        AABB box = _boxes[_items[first]];
+        AABB centroid_box{.min = centroids[_items[first]], .max = centroids[_items[first]]};
+        for(std::uint32_t i = first + 1; i < first + count; ++i)
+        {
+            box = _merge(box, _boxes[_items[i]]);
+            centroid_box.min = glm::min(centroid_box.min, centroids[_items[i]]);
+            centroid_box.max = glm::max(centroid_box.max, centroids[_items[i]]);
+        }
+        _nodes[node_index].box = box;
+
+        if(count <= MAX_LEAF_ITEMS)
+        {
+            _nodes[node_index].first = first;
+            _nodes[node_index].count = count;
+            return node_index;
+        }
+
+        const math::Vec3 extent = centroid_box.max - centroid_box.min;
+        int axis = 0;
+        if(extent.y > extent[axis])axis = 1;
+        if(extent.z > extent[axis])axis = 2;
+
+        const std::uint32_t half = count / 2;
+        std::nth_element(_items.begin() + first, _items.begin() + first + half, _items.begin() + first + count,
+            [&centroids, axis](std::uint32_t a, std::uint32_t b){ return centroids[a][axis] < centroids[b][axis]; });
+
+        // left child directly follows its parent
+        buildNode(first, half, centroids);
+        const std::uint32_t right = buildNode(first + half, count - half, centroids);
+
+        _nodes[node_index].first = right;
+        _nodes[node_index].count = 0;
+        return node_index;
+    }
+
+    bool BoundingVolumeHierarchy::refit(const std::vector<AABB> & boxes)
+    {
+        if(boxes.size() != _boxes.size())return false;
+
+        _boxes = boxes;
+
+        // children are always stored after their parent
+        for(std::size_t i = _nodes.size(); i-- > 0;)
+        {
+            Node & node = _nodes[i];
+            if(node.count > 0)
+            {
+                node.box = _boxes[_items[node.first]];
+                for(std::uint32_t item = node.first + 1; item < node.first + node.count; ++item)
+                {
+                    node.box = _merge(node.box, _boxes[_items[item]]);
+                }
+            }
+            else
+            {
+                node.box = _merge(_nodes[i + 1].box, _nodes[node.first].box);
+            }
+        }
+        return true;
+    }
+
+    std::optional<BoundingVolumeHierarchy::Hit> BoundingVolumeHierarchy::raycast(const Ray & ray, float max_distance, const ItemTest & test) const
+    {
+        if(_nodes.empty())return std::nullopt;
+        if(!intersectRayAABB(ray, _nodes.front().box, max_distance))return std::nullopt;
+
+        std::optional<Hit> closest;
+        float closest_distance = max_distance;
+
+        // node index with entry distance of its box
+        std::vector<std::pair<std::uint32_t, float>> stack;
+        stack.reserve(64);
+        stack.emplace_back(0u, 0.0f);
+
+        while(stack.empty() == false)
+        {
+            const auto [node_index, entry] = stack.back();
+            stack.pop_back();
+            if(entry > closest_distance)continue;
+
+            const Node & node = _nodes[node_index];
+            if(node.count > 0)
+            {
+                for(std::uint32_t i = node.first; i < node.first + node.count; ++i)
+                {
+                    const std::uint32_t item = _items[i];
+                    const auto box_distance = intersectRayAABB(ray, _boxes[item], closest_distance);
+                    if(!box_distance)continue;
+
+                    const std::optional<float> distance = test ? test(item, closest_distance) : box_distance;
+                    if(distance && *distance <= closest_distance)
+                    {
+                        closest_distance = *distance;
+                        closest = Hit{.item = item, .distance = *distance};
+                    }
+                }
+                continue;
+            }
+
+            const std::uint32_t left = node_index + 1;
+            const std::uint32_t right = node.first;
+            const auto left_distance = intersectRayAABB(ray, _nodes[left].box, closest_distance);
+            const auto right_distance = intersectRayAABB(ray, _nodes[right].box, closest_distance);
+
+            // nearer child is pushed last to be visited first
+            if(left_distance && right_distance)
+            {
+                if(*left_distance < *right_distance)
+                {
+                    stack.emplace_back(right, *right_distance);
+                    stack.emplace_back(left, *left_distance);
+                }
+                else
+                {
+                    stack.emplace_back(left, *left_distance);
+                    stack.emplace_back(right, *right_distance);
+                }
+            }
+            else if(left_distance) stack.emplace_back(left, *left_distance);
+            else if(right_distance) stack.emplace_back(right, *right_distance);
+        }
+
+        return closest;
+    }
+
+    std::size_t BoundingVolumeHierarchy::size() const
+    {
+        return _boxes.size();
+    }
+
+    bool BoundingVolumeHierarchy::empty() const
+    {
+        return _boxes.empty();
+    }
+}
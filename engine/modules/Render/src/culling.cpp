@@ -0,0 +1,136 @@
+#include "render/culling.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define ASTRE_CULLING_SSE
+    #include <emmintrin.h>
+#endif
+
+namespace astre::render
+{
+    static_assert(sizeof(math::Vec4) == 4 * sizeof(float), "math::Vec4 must be tightly packed for batched culling");
+
+    BoundingVolume computeBoundingVolume(const Mesh & mesh)
+    {
+        BoundingVolume bounds;
+        if(mesh.vertices.empty()) return bounds;
+
+        bounds.aabb_min = math::Vec3(std::numeric_limits<float>::max());
+        bounds.aabb_max = math::Vec3(std::numeric_limits<float>::lowest());
+
+        for(const auto & vertex : mesh.vertices)
+        {
+            bounds.aabb_min = glm::min(bounds.aabb_min, vertex.position);
+            bounds.aabb_max = glm::max(bounds.aabb_max, vertex.position);
+        }
+
+        bounds.center = (bounds.aabb_min + bounds.aabb_max) * 0.5f;
+
+        // tighter than half of the AABB diagonal for round meshes
+        float radius2 = 0.0f;
+        for(const auto & vertex : mesh.vertices)
+        {
+            const math::Vec3 offset = vertex.position - bounds.center;
+            radius2 = std::max(radius2, glm::dot(offset, offset));
+        }
+        bounds.radius = math::sqrt(radius2);
+
+        return bounds;
+    }
+
+    math::Vec4 transformBoundingSphere(const BoundingVolume & bounds, const math::Mat4 & model)
+    {
+        const math::Vec4 center = model * math::Vec4(bounds.center, 1.0f);
+
+        const math::Vec3 axis_x(model[0]);
+        const math::Vec3 axis_y(model[1]);
+        const math::Vec3 axis_z(model[2]);
+        const float max_scale2 = std::max({
+            glm::dot(axis_x, axis_x),
+            glm::dot(axis_y, axis_y),
+            glm::dot(axis_z, axis_z)
+        });
+
+        return math::Vec4(math::Vec3(center), bounds.radius * math::sqrt(max_scale2));
+    }
+
+    Frustum extractFrustum(const math::Mat4 & view_projection)
+    {
+        // matrix is column major, row i = (m[0][i], m[1][i], m[2][i], m[3][i])
+        const auto row = [&](int i) {
+            return math::Vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+        };
+
+        Frustum frustum;
+        frustum.planes[0] = row(3) + row(0); // left
+        frustum.planes[1] = row(3) - row(0); // right
+        frustum.planes[2] = row(3) + row(1); // bottom
+        frustum.planes[3] = row(3) - row(1); // top
+        frustum.planes[4] = row(3) + row(2); // near
+        frustum.planes[5] = row(3) - row(2); // far
+
+        for(auto & plane : frustum.planes)
+        {
+            const float length = math::length(math::Vec3(plane));
+            if(length > 0.0f) plane /= length;
+        }
+
+        return frustum;
+    }
+
+    static bool _sphereInFrustum(const Frustum & frustum, const math::Vec4 & sphere)
+    {
+        for(const auto & plane : frustum.planes)
+        {
+            const float distance = plane.x * sphere.x + plane.y * sphere.y + plane.z * sphere.z + plane.w;
+            if(distance + sphere.w < 0.0f) return false;
+        }
+        return true;
+    }
+
+    void cullSpheres(const Frustum & frustum, const std::vector<math::Vec4> & spheres, std::vector<std::uint8_t> & visible)
+    {
+        visible.assign(spheres.size(), 0);
+
+        std::size_t i = 0;
+
+    #ifdef ASTRE_CULLING_SSE
+        const float * data = &spheres.data()->x;
+        const __m128 zero = _mm_setzero_ps();
+
+        for(; i + 4 <= spheres.size(); i += 4)
+        {
+            // AoS -> SoA, x = (x0, x1, x2, x3) ...
+            __m128 x = _mm_loadu_ps(data + 4 * i);
+            __m128 y = _mm_loadu_ps(data + 4 * (i + 1));
+            __m128 z = _mm_loadu_ps(data + 4 * (i + 2));
+            __m128 r = _mm_loadu_ps(data + 4 * (i + 3));
+            _MM_TRANSPOSE4_PS(x, y, z, r);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for(const auto & plane : frustum.planes)
+            {
+                __m128 distance = _mm_mul_ps(x, _mm_set1_ps(plane.x));
+                distance = _mm_add_ps(distance, _mm_mul_ps(y, _mm_set1_ps(plane.y)));
+                distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(plane.z)));
+                distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, r), zero));
+            }
+
+            const int mask = _mm_movemask_ps(inside);
+            visible[i + 0] = (mask >> 0) & 1;
+            visible[i + 1] = (mask >> 1) & 1;
+            visible[i + 2] = (mask >> 2) & 1;
+            visible[i + 3] = (mask >> 3) & 1;
+        }
+    #endif
+
+        for(; i < spheres.size(); ++i)
+        {
+            visible[i] = _sphereInFrustum(frustum, spheres[i]) ? 1 : 0;
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#include "render/draw_sort.hpp"
+
+#include <array>
+#include <bit>
+#include <cmath>
+
+namespace astre::render
+{
+    static constexpr unsigned FBO_SHIFT = 56;
+    static constexpr unsigned SHADER_SHIFT = 44;
+    static constexpr unsigned VERTEX_BUFFER_SHIFT = 28;
+    static constexpr unsigned OPTIONS_SHIFT = 23;
+
+    static constexpr std::uint64_t FBO_MASK = 0xFF;
+    static constexpr std::uint64_t SHADER_MASK = 0xFFF;
+    static constexpr std::uint64_t VERTEX_BUFFER_MASK = DRAW_SORT_VERTEX_BUFFER_MASK;
+    static constexpr std::uint64_t OPTIONS_MASK = 0x1F;
+    static constexpr std::uint64_t DEPTH_MASK = 0x7FFFFF;
+
+    // one bit per state the options switch, polygon offset values are left out
+    static constexpr std::uint64_t OPTION_WIREFRAME = 1u << 0;
+    static constexpr std::uint64_t OPTION_LINES = 1u << 1;
+    static constexpr std::uint64_t OPTION_POLYGON_OFFSET = 1u << 2;
+    static constexpr std::uint64_t OPTION_NO_DEPTH_WRITE = 1u << 3;
+    static constexpr std::uint64_t OPTION_NO_DEPTH_TEST = 1u << 4;
+    static_assert((OPTION_NO_DEPTH_TEST << 1) - 1 == OPTIONS_MASK, "render options must fill their key field");
+    static_assert(((OPTIONS_MASK << OPTIONS_SHIFT) & DEPTH_MASK) == 0, "options overlap depth");
+    static_assert(OPTIONS_SHIFT + std::bit_width(OPTIONS_MASK) == VERTEX_BUFFER_SHIFT, "options overlap vertex buffer");
+    static_assert(VERTEX_BUFFER_SHIFT + DRAW_SORT_VERTEX_BUFFER_BITS == SHADER_SHIFT, "vertex buffer overlaps shader");
+
+    static std::uint64_t _depthBits(float depth)
+    {
+        if(std::isnan(depth) || depth < 0.0f) depth = 0.0f;
+        // bit pattern of a non-negative float grows monotonically with its value,
+        // the 23 bits under the sign keep the exponent and most significant part of the mantissa
+        return (std::bit_cast<std::uint32_t>(depth) >> 8) & DEPTH_MASK;
+    }
+
+    static std::uint64_t _optionsBits(const RenderOptions & options)
+    {
+        std::uint64_t bits = 0;
+        if(options.mode == RenderMode::Wireframe) bits |= OPTION_WIREFRAME;
+        if(options.topology == PrimitiveTopology::Lines) bits |= OPTION_LINES;
+        if(options.polygon_offset) bits |= OPTION_POLYGON_OFFSET;
+        if(!options.write_depth) bits |= OPTION_NO_DEPTH_WRITE;
+        if(!options.depth_test) bits |= OPTION_NO_DEPTH_TEST;
+        return bits;
+    }
+
+    DrawSortKey makeDrawSortKey(std::optional<std::size_t> fbo, std::size_t shader, std::size_t vertex_buffer,
+        const RenderOptions & options, float depth)
+    {
+        return ((fbo.value_or(0) & FBO_MASK) << FBO_SHIFT) |
+               ((shader & SHADER_MASK) << SHADER_SHIFT) |
+               ((vertex_buffer & VERTEX_BUFFER_MASK) << VERTEX_BUFFER_SHIFT) |
+               (_optionsBits(options) << OPTIONS_SHIFT) |
+               _depthBits(depth);
+    }
+
+    void radixSortDrawItems(std::vector<DrawSortItem> & items)
+    {
+        if(items.size() < 2) return;
+
+        std::vector<DrawSortItem> scratch(items.size());
+
+        // all histograms in a single read of the keys
+        std::array<std::array<std::uint32_t, 256>, sizeof(DrawSortKey)> histograms{};
+        for(const auto & item : items)
+        {
+            for(std::size_t byte = 0; byte < sizeof(DrawSortKey); ++byte)
+            {
+                histograms[byte][(item.key >> (byte * 8)) & 0xFF]++;
+            }
+        }
+
+        auto * src = &items;
+        auto * dst = &scratch;
+
+        for(std::size_t byte = 0; byte < sizeof(DrawSortKey); ++byte)
+        {
+            auto & histogram = histograms[byte];
+
+            // every key has the same value of this byte
+            const std::uint32_t first_byte_value = ((*src)[0].key >> (byte * 8)) & 0xFF;
+            if(histogram[first_byte_value] == items.size()) continue;
+
+            std::uint32_t offset = 0;
+            for(auto & count : histogram)
+            {
+                const std::uint32_t bucket_size = count;
+                count = offset;
+                offset += bucket_size;
+            }
+
+            for(const auto & item : *src)
+            {
+                (*dst)[histogram[(item.key >> (byte * 8)) & 0xFF]++] = item;
+            }
+
+            std::swap(src, dst);
+        }
+
+        if(src != &items)
+        {
+            items = std::move(*src);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#include "render/frame_ring_allocator.hpp"
+
+#include <algorithm>
+
+namespace astre::render
+{
+    FrameRingAllocator::FrameRingAllocator(std::size_t region_size, std::uint32_t region_count)
+        :   _region_size(region_size),
+            _region_count(std::max(region_count, 1u)),
+            _region(0),
+            _offset(0)
+    {}
+
+    std::optional<std::size_t> FrameRingAllocator::allocate(std::size_t size, std::size_t alignment)
+    {
+        if(size == 0)return std::nullopt;
+        if(alignment == 0)alignment = 1;
+
+        const std::size_t region_begin = (std::size_t)_region * _region_size;
+        // align absolute offset, regions themselves do not have to be aligned
+        const std::size_t absolute = region_begin + _offset;
+        const std::size_t aligned = (absolute + alignment - 1) & ~(alignment - 1);
+
+        if(aligned - region_begin > _region_size || size > _region_size - (aligned - region_begin))
+        {
+            return std::nullopt;
+        }
+
+        _offset = aligned - region_begin + size;
+        return aligned;
+    }
+
+    std::uint32_t FrameRingAllocator::nextFrame()
+    {
+        _region = (_region + 1) % _region_count;
+        _offset = 0;
+        return _region;
+    }
+
+    std::uint32_t FrameRingAllocator::region() const
+    {
+        return _region;
+    }
+
+    std::uint32_t FrameRingAllocator::regionOf(std::size_t offset) const
+    {
+        if(_region_size == 0)return 0;
+        return (std::uint32_t)std::min<std::size_t>(offset / _region_size, _region_count - 1);
+    }
+
+    std::uint32_t FrameRingAllocator::regionCount() const
+    {
+        return _region_count;
+    }
+
+    std::size_t FrameRingAllocator::regionSize() const
+    {
+        return _region_size;
+    }
+
+    std::size_t FrameRingAllocator::size() const
+    {
+        return _region_size * _region_count;
+    }
+
+    std::size_t FrameRingAllocator::used() const
+    {
+        return _offset;
+    }
+}
@@ -0,0 +1,72 @@
+#include "render/indirect_draw.hpp"
+
+#include <utility>
+
+namespace astre::render
+{
+    IndirectDrawList buildIndirectDrawList(const std::vector<IndirectDraw> & draws,
+        const absl::flat_hash_map<std::size_t, IndirectDrawGeometry> & geometry)
+    {
+        IndirectDrawList list;
+
+        // draws bucketed by (vertex array, index size), buckets in order of first use
+        absl::flat_hash_map<std::pair<std::size_t, std::size_t>, std::size_t> bucket_of;
+        std::vector<std::vector<std::pair<const IndirectDraw *, const IndirectDrawGeometry *>>> buckets;
+
+        for(const auto & draw : draws)
+        {
+            if(draw.instance_count == 0)continue;
+
+            const auto geometry_it = geometry.find(draw.vertex_buffer);
+            if(geometry_it == geometry.end())
+            {
+                list.fallback.emplace_back(draw);
+                continue;
+            }
+
+            const IndirectDrawGeometry & draw_geometry = geometry_it->second;
+            const auto [bucket_it, inserted] = bucket_of.try_emplace(
+                std::make_pair(draw_geometry.vertex_array, draw_geometry.index_size), buckets.size());
+            if(inserted) buckets.emplace_back();
+
+            buckets.at(bucket_it->second).emplace_back(&draw, &draw_geometry);
+        }
+
+        list.commands.reserve(draws.size());
+        list.draw_data.reserve(draws.size());
+        list.draws.reserve(draws.size());
+        list.groups.reserve(buckets.size());
+
+        for(const auto & bucket : buckets)
+        {
+            const IndirectDrawGeometry & first = *bucket.front().second;
+            list.groups.emplace_back(IndirectDrawGroup{
+                .vertex_array = first.vertex_array,
+                .index_size = first.index_size,
+                .format = first.format,
+                .first_command = (std::uint32_t)list.commands.size(),
+                .command_count = (std::uint32_t)bucket.size()
+            });
+
+            for(const auto & [draw, draw_geometry] : bucket)
+            {
+                list.commands.emplace_back(DrawElementsIndirectCommand{
+                    .count = (std::uint32_t)draw_geometry->range.index_count,
+                    .instance_count = draw->instance_count,
+                    .first_index = (std::uint32_t)draw_geometry->range.first_index,
+                    .base_vertex = (std::int32_t)draw_geometry->range.base_vertex,
+                    .base_instance = draw->base_instance
+                });
+
+                list.draw_data.emplace_back(GPUDrawData{
+                    .position_offset = math::Vec4(draw_geometry->quantization.offset, 0.0f),
+                    .position_scale = math::Vec4(draw_geometry->quantization.scale, 0.0f)
+                });
+
+                list.draws.emplace_back(*draw);
+            }
+        }
+
+        return list;
+    }
+}
@@ -0,0 +1,213 @@
+#include "render/light_clusters.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace astre::render
+{
+    float lightRange(const GPULight & light)
+    {
+        const float constant = light.attenuation.x;
+        const float linear = light.attenuation.y;
+        const float quadratic = light.attenuation.z;
+        const float threshold = 256.0f * std::max(light.color.w, 0.0f);
+
+        if(quadratic > 0.0f)
+        {
+            const float discriminant = linear * linear - 4.0f * quadratic * (constant - threshold);
+            return (-linear + std::sqrt(std::max(discriminant, 0.0f))) / (2.0f * quadratic);
+        }
+        if(linear > 0.0f) return std::max(threshold - constant, 0.0f) / linear;
+        return std::numeric_limits<float>::max();
+    }
+
+    static math::Vec3 _unproject(const math::Mat4 & inv_proj, float x, float y, float z)
+    {
+        const math::Vec4 point = inv_proj * math::Vec4(x, y, z, 1.0f);
+        return math::Vec3(point) / point.w;
+    }
+
+    static float _sliceDepth(const LightClusterGrid & grid, std::uint32_t slice)
+    {
+        return grid.near_plane * std::pow(grid.far_plane / grid.near_plane, (float)slice / (float)LightClusterGrid::SLICES);
+    }
+
+    static std::uint32_t _depthSlice(const LightClusterGrid & grid, float depth)
+    {
+        depth = std::clamp(depth, grid.near_plane, grid.far_plane);
+        const float slice = std::floor(std::log(depth / grid.near_plane) / std::log(grid.far_plane / grid.near_plane) * (float)LightClusterGrid::SLICES);
+        return (std::uint32_t)std::clamp(slice, 0.0f, (float)(LightClusterGrid::SLICES - 1));
+    }
+
+    LightClusterGrid makeLightClusterGrid(const math::Mat4 & view_matrix, const math::Mat4 & proj_matrix)
+    {
+        LightClusterGrid grid;
+        grid.view_matrix = view_matrix;
+
+        const math::Mat4 inv_proj = glm::inverse(proj_matrix);
+
+        grid.near_plane = std::max(-_unproject(inv_proj, 0.0f, 0.0f, -1.0f).z, 1e-3f);
+        grid.far_plane = std::max(-_unproject(inv_proj, 0.0f, 0.0f, 1.0f).z, grid.near_plane * 1.001f);
+
+        grid.cluster_min.resize(LightClusterGrid::CLUSTER_COUNT);
+        grid.cluster_max.resize(LightClusterGrid::CLUSTER_COUNT);
+
+        std::array<float, LightClusterGrid::SLICES + 1> slice_depths;
+        for(std::uint32_t z = 0; z <= LightClusterGrid::SLICES; ++z) slice_depths[z] = _sliceDepth(grid, z);
+
+        for(std::uint32_t y = 0; y < LightClusterGrid::TILES_Y; ++y)
+        {
+            for(std::uint32_t x = 0; x < LightClusterGrid::TILES_X; ++x)
+            {
+                // tile corners on near and far plane, points at any depth lie on lines between them
+                std::array<math::Vec3, 4> near_corners;
+                std::array<math::Vec3, 4> far_corners;
+                for(std::uint32_t corner = 0; corner < 4; ++corner)
+                {
+                    const float ndc_x = -1.0f + 2.0f * (float)(x + (corner & 1)) / (float)LightClusterGrid::TILES_X;
+                    const float ndc_y = -1.0f + 2.0f * (float)(y + (corner >> 1)) / (float)LightClusterGrid::TILES_Y;
+                    near_corners[corner] = _unproject(inv_proj, ndc_x, ndc_y, -1.0f);
+                    far_corners[corner] = _unproject(inv_proj, ndc_x, ndc_y, 1.0f);
+                }
+
+                for(std::uint32_t z = 0; z < LightClusterGrid::SLICES; ++z)
+                {
+                    math::Vec3 cluster_min(std::numeric_limits<float>::max());
+                    math::Vec3 cluster_max(std::numeric_limits<float>::lowest());
+
+                    for(const float depth : {slice_depths[z], slice_depths[z + 1]})
+                    {
+                        for(std::uint32_t corner = 0; corner < 4; ++corner)
+                        {
+                            const auto & a = near_corners[corner];
+                            const auto & b = far_corners[corner];
+                            const float t = (depth + a.z) / (a.z - b.z);
+                            const math::Vec3 point = a + (b - a) * t;
+                            cluster_min = glm::min(cluster_min, point);
+                            cluster_max = glm::max(cluster_max, point);
+                        }
+                    }
+
+                    const std::uint32_t index = x + y * LightClusterGrid::TILES_X + z * LightClusterGrid::TILES_X * LightClusterGrid::TILES_Y;
+                    grid.cluster_min[index] = cluster_min;
+                    grid.cluster_max[index] = cluster_max;
+                }
+            }
+        }
+
+        return grid;
+    }
+
+    LightClusters buildLightClusters(const LightClusterGrid & grid, const std::vector<GPULight> & lights,
+        std::uint32_t slice_begin, std::uint32_t slice_end)
+    {
+        constexpr std::uint32_t CLUSTERS_PER_SLICE = LightClusterGrid::TILES_X * LightClusterGrid::TILES_Y;
+
+        LightClusters result;
+        result.slice_begin = std::min(slice_begin, LightClusterGrid::SLICES);
+        result.slice_end = std::clamp(slice_end, result.slice_begin, LightClusterGrid::SLICES);
+
+        const std::uint32_t slice_count = result.slice_end - result.slice_begin;
+        result.clusters.resize(slice_count * CLUSTERS_PER_SLICE, GPULightCluster{0, 0});
+        if(slice_count == 0 || grid.cluster_min.size() != LightClusterGrid::CLUSTER_COUNT) return result;
+
+        std::vector<std::uint32_t> global_lights;
+        std::vector<math::Vec4> spheres(lights.size()); // view space center, range
+        std::vector<std::vector<std::uint32_t>> slice_lights(slice_count);
+
+        // bin local lights by depth slices they touch
+        for(std::uint32_t i = 0; i < lights.size(); ++i)
+        {
+            const auto & light = lights[i];
+            if(light.direction.w == GPU_LIGHT_TYPE_DIRECTIONAL)
+            {
+                global_lights.emplace_back(i);
+                continue;
+            }
+            if(light.direction.w != GPU_LIGHT_TYPE_POINT && light.direction.w != GPU_LIGHT_TYPE_SPOT) continue;
+
+            const math::Vec3 center(grid.view_matrix * math::Vec4(math::Vec3(light.position), 1.0f));
+            const float range = lightRange(light);
+            spheres[i] = math::Vec4(center, range);
+
+            const float depth_min = -center.z - range;
+            const float depth_max = -center.z + range;
+            if(depth_max < grid.near_plane || depth_min > grid.far_plane) continue;
+
+            const std::uint32_t first = std::max(_depthSlice(grid, depth_min), result.slice_begin);
+            const std::uint32_t last = std::min(_depthSlice(grid, depth_max) + 1, result.slice_end);
+            for(std::uint32_t z = first; z < last; ++z)
+            {
+                slice_lights[z - result.slice_begin].emplace_back(i);
+            }
+        }
+
+        result.light_indices.reserve(result.clusters.size() * global_lights.size());
+
+        for(std::uint32_t z = result.slice_begin; z < result.slice_end; ++z)
+        {
+            const auto & candidates = slice_lights[z - result.slice_begin];
+
+            for(std::uint32_t tile = 0; tile < CLUSTERS_PER_SLICE; ++tile)
+            {
+                const std::uint32_t index = tile + z * CLUSTERS_PER_SLICE;
+                const auto & cluster_min = grid.cluster_min[index];
+                const auto & cluster_max = grid.cluster_max[index];
+
+                auto & cluster = result.clusters[index - result.slice_begin * CLUSTERS_PER_SLICE];
+                cluster.offset = (std::uint32_t)result.light_indices.size();
+
+                result.light_indices.insert(result.light_indices.end(), global_lights.begin(), global_lights.end());
+
+                for(const auto i : candidates)
+                {
+                    // sphere against AABB, distance from center to the closest point of the box
+                    const math::Vec3 center(spheres[i]);
+                    const math::Vec3 closest = glm::clamp(center, cluster_min, cluster_max);
+                    const math::Vec3 delta = closest - center;
+                    if(glm::dot(delta, delta) <= spheres[i].w * spheres[i].w)
+                    {
+                        result.light_indices.emplace_back(i);
+                    }
+                }
+
+                cluster.count = (std::uint32_t)result.light_indices.size() - cluster.offset;
+            }
+        }
+
+        return result;
+    }
+
+    LightClusters mergeLightClusters(std::vector<LightClusters> parts)
+    {
+        LightClusters result;
+        if(parts.empty()) return result;
+
+        result.slice_begin = parts.front().slice_begin;
+        result.slice_end = parts.back().slice_end;
+
+        std::size_t cluster_count = 0;
+        std::size_t index_count = 0;
+        for(const auto & part : parts)
+        {
+            cluster_count += part.clusters.size();
+            index_count += part.light_indices.size();
+        }
+        result.clusters.reserve(cluster_count);
+        result.light_indices.reserve(index_count);
+
+        for(auto & part : parts)
+        {
+            const std::uint32_t base = (std::uint32_t)result.light_indices.size();
+            for(const auto & cluster : part.clusters)
+            {
+                result.clusters.emplace_back(GPULightCluster{cluster.offset + base, cluster.count});
+            }
+            result.light_indices.insert(result.light_indices.end(), part.light_indices.begin(), part.light_indices.end());
+        }
+
+        return result;
+    }
+}
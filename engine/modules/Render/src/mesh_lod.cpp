@@ -0,0 +1,53 @@
+#include "render/mesh_lod.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace astre::render
+{
+    float pixelsPerMeshUnit(const BoundingVolume & bounds, const math::Mat4 & model,
+        const math::Vec3 & camera_position, const math::Mat4 & projection, unsigned int viewport_height)
+    {
+        const math::Vec4 sphere = transformBoundingSphere(bounds, model);
+
+        const float distance = math::length(math::Vec3(sphere) - camera_position) - sphere.w;
+        if(distance <= 0.0f) return std::numeric_limits<float>::infinity();
+
+        const math::Vec3 axis_x(model[0]);
+        const math::Vec3 axis_y(model[1]);
+        const math::Vec3 axis_z(model[2]);
+        const float max_scale = math::sqrt(std::max({
+            glm::dot(axis_x, axis_x),
+            glm::dot(axis_y, axis_y),
+            glm::dot(axis_z, axis_z)
+        }));
+
+        // projection[1][1] = 1 / tan(fov / 2), maps view space height to NDC at unit distance
+        return 0.5f * (float)viewport_height * projection[1][1] * max_scale / distance;
+    }
+
+    std::size_t selectLOD(const std::vector<VertexBufferLOD> & lods, float pixels_per_unit, std::size_t current_lod,
+        float pixel_error, float hysteresis)
+    {
+        if(lods.empty()) return 0;
+        current_lod = std::min(current_lod, lods.size() - 1);
+
+        const auto coarsest = [&](float limit){
+            std::size_t level = 0;
+            for(std::size_t i = 1; i < lods.size(); ++i)
+            {
+                if(lods[i].error * pixels_per_unit > limit) break;
+                level = i;
+            }
+            return level;
+        };
+
+        const std::size_t coarser = coarsest(pixel_error * (1.0f - hysteresis));
+        if(coarser > current_lod) return coarser;
+
+        if(lods[current_lod].error * pixels_per_unit > pixel_error * (1.0f + hysteresis))
+            return coarsest(pixel_error);
+
+        return current_lod;
+    }
+}
@@ -145,9 +145,23 @@ namespace astre::render::opengl
         _oglctx_handle(std::move(other._oglctx_handle)),
 
         _vertex_buffers(std::move(other._vertex_buffers)),
+        _vertex_buffer_bounds(std::move(other._vertex_buffer_bounds)),
+        _vertex_buffer_lods(std::move(other._vertex_buffer_lods)),
+        _vertex_buffer_triangles(std::move(other._vertex_buffer_triangles)),
+        _geometry_arena(std::move(other._geometry_arena)),
+        _indirect_draw_geometry(std::move(other._indirect_draw_geometry)),
+        _indirect_buffer(std::move(other._indirect_buffer)),
+        _program_binary_cache(std::move(other._program_binary_cache)),
         _shaders(std::move(other._shaders)),
 
-        _viewport_resolution(std::move(other._viewport_resolution))
+        _stream_buffer(std::move(other._stream_buffer)),
+        _stream_buffer_alignment(other._stream_buffer_alignment),
+        _shader_storage_buffer_streams(std::move(other._shader_storage_buffer_streams)),
+
+        _viewport_resolution(std::move(other._viewport_resolution)),
+
+        _pending_pixel_reads(std::move(other._pending_pixel_reads)),
+        _pixel_readbacks(std::move(other._pixel_readbacks))
     {
         other._oglctx_handle = nullptr;
     }
@@ -194,12 +208,29 @@ namespace astre::render::opengl
         _render_context->close();
 
         _vertex_buffers.clear();
+        _vertex_buffer_bounds.clear();
+        _vertex_buffer_lods.clear();
+        _vertex_buffer_triangles.clear();
+        _indirect_draw_geometry.clear();
+        _geometry_arena.reset(); // after every buffer living in it
+        _indirect_buffer.reset();
         _shaders.clear();
+        _shader_storage_buffer_streams.clear();
+        _stream_buffer.reset();
         _shader_storage_buffers.clear();
         _frame_buffer_objects.clear();
         _textures.clear();
         _rbos.clear();
 
+        // wake up pending readers, they find their readback gone
+        for(auto & pending : _pending_pixel_reads)
+        {
+            pending->readback.reset();
+            pending->signal.cancel();
+        }
+        _pending_pixel_reads.clear();
+        _pixel_readbacks.clear();
+
         // unbind context before unregistering in winapi process
         #ifdef WIN32
             wglMakeCurrent(0, 0);
@@ -246,16 +277,106 @@ namespace astre::render::opengl
         co_return;
     }
 
-    asio::awaitable<std::optional<std::size_t>> OpenGLRenderer::createVertexBuffer(std::string name,  const Mesh & mesh)
+    asio::awaitable<std::optional<std::size_t>> OpenGLRenderer::createMeshVertexBuffer(std::string name,
+        const std::vector<unsigned int> & indices, const std::vector<GPUVertex> & vertices, VertexFormat format)
     {
+        if(good() == false)co_return std::nullopt;
+
+        co_await _render_context->ensureOnStrand();
+
+        if(_geometry_arena == nullptr)
+        {
+            _geometry_arena = std::make_unique<OpenGLGeometryArena>(GEOMETRY_ARENA_VERTICES, GEOMETRY_ARENA_INDEX_BYTES);
+        }
+
+        if(_geometry_arena->good() && _vertex_buffer_names.contains(name) == false)
+        {
+            const auto id = co_await (createInternalObject<OpenGLArenaVertexBuffer>(
+                _vertex_buffers, _vertex_buffer_names, name,
+                *_geometry_arena, indices, vertices, format));
+
+            if(id && _vertex_buffers.at(*id)->good())
+            {
+                const auto & vertex_buffer = _vertex_buffers.at(*id);
+                _indirect_draw_geometry.insert_or_assign(*id, IndirectDrawGeometry{
+                    .vertex_array = vertex_buffer->vertexArrayID(),
+                    .index_size = vertex_buffer->indexSize(),
+                    .format = vertex_buffer->vertexFormat(),
+                    .quantization = vertex_buffer->vertexQuantization(),
+                    .range = vertex_buffer->range()
+                });
+                co_return id;
+            }
+
+            // arena could not take the mesh, give it its own buffers
+            if(id) co_await eraseInternalObject(_vertex_buffers, _vertex_buffer_names, *id);
+            spdlog::warn("[opengl] Vertex buffer {} does not fit geometry arena, using dedicated buffers", name);
+        }
+
         co_return co_await (createInternalObject<OpenGLVertexBuffer>(
             _vertex_buffers, _vertex_buffer_names, std::move(name),
-            mesh.indices, mesh.vertices));
+            indices, vertices, format));
+    }
+
+    asio::awaitable<std::optional<std::size_t>> OpenGLRenderer::createVertexBuffer(std::string name,  const Mesh & mesh, VertexFormat format)
+    {
+        const auto id = co_await createMeshVertexBuffer(name, mesh.indices, mesh.vertices, format);
+
+        if(!id) co_return id;
+
+        // on render strand after createInternalObject
+        _vertex_buffer_bounds.insert_or_assign(*id, mesh.bounds ? *mesh.bounds : computeBoundingVolume(mesh));
+
+        const auto triangles = std::make_shared<const TriangleMesh>(makeTriangleMesh(mesh));
+        _vertex_buffer_triangles.insert_or_assign(*id, triangles);
+
+        if(mesh.lods.empty()) co_return id;
+
+        // coarser levels are separate buffers named after the base one
+        std::vector<VertexBufferLOD> lods{VertexBufferLOD{.vertex_buffer = *id, .error = 0.0f}};
+        for(std::size_t level = 0; level < mesh.lods.size(); ++level)
+        {
+            const MeshLOD & lod = mesh.lods[level];
+            const auto lod_id = co_await createMeshVertexBuffer(std::format("{}#lod{}", name, level + 1),
+                lod.indices, lod.vertices, format);
+
+            if(!lod_id)
+            {
+                spdlog::warn("[opengl] Cannot create LOD {} of vertex buffer {}", level + 1, name);
+                break;
+            }
+            lods.push_back(VertexBufferLOD{.vertex_buffer = *lod_id, .error = lod.error});
+            _vertex_buffer_triangles.insert_or_assign(*lod_id, triangles);
+        }
+
+        if(lods.size() > 1) _vertex_buffer_lods.insert_or_assign(*id, std::move(lods));
+
+        co_return id;
     }
 
     asio::awaitable<bool> OpenGLRenderer::eraseVertexBuffer(std::size_t id)
     {
-        co_return co_await eraseInternalObject(_vertex_buffers, _vertex_buffer_names, std::move(id));
+        const bool erased = co_await eraseInternalObject(_vertex_buffers, _vertex_buffer_names, id);
+        if(erased == false) co_return false;
+
+        _vertex_buffer_bounds.erase(id);
+        _vertex_buffer_triangles.erase(id);
+        _indirect_draw_geometry.erase(id);
+
+        auto lods_it = _vertex_buffer_lods.find(id);
+        if(lods_it != _vertex_buffer_lods.end())
+        {
+            const auto lods = std::move(lods_it->second);
+            _vertex_buffer_lods.erase(lods_it);
+            for(std::size_t level = 1; level < lods.size(); ++level)
+            {
+                co_await eraseInternalObject(_vertex_buffers, _vertex_buffer_names, lods[level].vertex_buffer);
+                _indirect_draw_geometry.erase(lods[level].vertex_buffer);
+                _vertex_buffer_triangles.erase(lods[level].vertex_buffer);
+            }
+        }
+
+        co_return true;
     }
 
     std::optional<std::size_t> OpenGLRenderer::getVertexBuffer(std::string name) const
@@ -263,18 +384,75 @@ namespace astre::render::opengl
         return getInternalObjectID(_vertex_buffers, _vertex_buffer_names, std::move(name));
     }
 
+    std::optional<BoundingVolume> OpenGLRenderer::getVertexBufferBounds(std::size_t id) const
+    {
+        if(good() == false)return std::nullopt;
+
+        auto it = _vertex_buffer_bounds.find(id);
+        if(it == _vertex_buffer_bounds.end())return std::nullopt;
+        return it->second;
+    }
+
+    std::vector<VertexBufferLOD> OpenGLRenderer::getVertexBufferLODs(std::size_t id) const
+    {
+        if(good() == false)return {};
+
+        auto it = _vertex_buffer_lods.find(id);
+        if(it == _vertex_buffer_lods.end())return {};
+        return it->second;
+    }
+
+    std::shared_ptr<const TriangleMesh> OpenGLRenderer::getVertexBufferTriangles(std::size_t id) const
+    {
+        if(good() == false)return nullptr;
+
+        auto it = _vertex_buffer_triangles.find(id);
+        if(it == _vertex_buffer_triangles.end())return nullptr;
+        return it->second;
+    }
+
+    GeometryArenaStats OpenGLRenderer::getGeometryArenaStats() const
+    {
+        if(good() == false || _geometry_arena == nullptr)return {};
+
+        return _geometry_arena->stats();
+    }
+
+    asio::awaitable<bool> OpenGLRenderer::enableProgramBinaryCache(std::filesystem::path directory)
+    {
+        if(good() == false) co_return false;
+        co_await _render_context->ensureOnStrand();
+
+        if(GLEW_ARB_get_program_binary == false)
+        {
+            spdlog::warn("[render] Program binaries not supported, shaders are always compiled from source");
+            co_return false;
+        }
+
+        const auto gl_string = [](GLenum name) -> std::string
+        {
+            const GLubyte * value = glGetString(name);
+            return value != nullptr ? reinterpret_cast<const char *>(value) : "";
+        };
+        std::string driver = std::format("{}|{}|{}", gl_string(GL_VENDOR), gl_string(GL_RENDERER), gl_string(GL_VERSION));
+
+        spdlog::info("[render] Shader program binaries cached in {}", directory.string());
+        _program_binary_cache = std::make_unique<ProgramBinaryCache>(std::move(directory), std::move(driver));
+        co_return true;
+    }
+
 
     asio::awaitable<std::optional<std::size_t>> OpenGLRenderer::createShader(std::string name, std::vector<std::string> vertex_code)
     {
         co_return co_await (createInternalObject<OpenGLShader>(
-            _shaders, _shader_names, std::move(name), std::move(vertex_code)));
+            _shaders, _shader_names, std::move(name), std::move(vertex_code), _program_binary_cache.get()));
     }
 
     asio::awaitable<std::optional<std::size_t>> OpenGLRenderer::createShader(std::string name, std::vector<std::string> vertex_code, std::vector<std::string> fragment_code)
     {
         co_return co_await (createInternalObject<OpenGLShader>(
             _shaders, _shader_names, std::move(name), std::move(vertex_code),
-            std::move(fragment_code)));
+            std::move(fragment_code), _program_binary_cache.get()));
     }
 
     asio::awaitable<bool> OpenGLRenderer::eraseShader(std::size_t id)
@@ -321,10 +499,59 @@ namespace astre::render::opengl
             co_return false;
         }
 
+        // per-frame data goes to stream buffer, SSBO own storage is only a fallback
+        if(streamShaderStorageBuffer(id, size, data))co_return true;
+
+        _shader_storage_buffer_streams.erase(id);
         _shader_storage_buffers.at(id)->update(std::move(size), std::move(data));
         co_return true;
     }
 
+    bool OpenGLRenderer::streamShaderStorageBuffer(std::size_t id, std::size_t size, const void * data)
+    {
+        if(_stream_buffer == nullptr)
+        {
+            _stream_buffer = std::make_unique<OpenGLStreamBuffer>(STREAM_BUFFER_REGION_SIZE, STREAM_BUFFER_REGIONS);
+
+            GLint alignment = 1;
+            glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            _stream_buffer_alignment = (std::size_t)std::max(alignment, 1);
+        }
+        if(_stream_buffer->good() == false)return false;
+
+        const auto allocation = _stream_buffer->write(size, data, _stream_buffer_alignment);
+        if(!allocation)
+        {
+            spdlog::debug("[render] Stream buffer region full, SSBO {} falls back to buffer reallocation", id);
+            return false;
+        }
+
+        _shader_storage_buffer_streams.insert_or_assign(id, *allocation);
+        return true;
+    }
+
+    void OpenGLRenderer::nextStreamFrame()
+    {
+        if(_stream_buffer == nullptr || _stream_buffer->good() == false)return;
+
+        const std::uint32_t region = _stream_buffer->nextFrame();
+
+        // SSBOs not updated for whole ring keep their content in own storage,
+        // GPU is done with the region so it can be read before it is overwritten
+        for(auto it = _shader_storage_buffer_streams.begin(); it != _shader_storage_buffer_streams.end();)
+        {
+            const auto current = it++;
+            if(_stream_buffer->regionOf(current->second) != region)continue;
+
+            auto ssbo_it = _shader_storage_buffers.find(current->first);
+            if(ssbo_it != _shader_storage_buffers.end())
+            {
+                ssbo_it->second->update(current->second.size, _stream_buffer->data(current->second));
+            }
+            _shader_storage_buffer_streams.erase(current);
+        }
+    }
+
 
     asio::awaitable<std::optional<std::size_t>> OpenGLRenderer::createFrameBufferObject(std::string name, std::pair<unsigned int, unsigned int> resolution, std::initializer_list<FBOAttachment> attachments)
     {
@@ -479,6 +706,19 @@ namespace astre::render::opengl
                 spdlog::error("[render] Cannot enable shader storage buffer");
                 continue;
             }
+
+            // attach current content, either range of stream buffer or SSBO own storage
+            const GLuint binding_point = shader_storage_buffer_it->second->bindingPoint();
+            const auto stream_it = _shader_storage_buffer_streams.find(storage_buffer);
+            if(stream_it != _shader_storage_buffer_streams.end())
+            {
+                glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding_point, (GLuint)_stream_buffer->ID(),
+                    (GLintptr)stream_it->second.offset, (GLsizeiptr)stream_it->second.size);
+            }
+            else
+            {
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding_point, (GLuint)shader_storage_buffer_it->second->ID());
+            }
         }
 
         // Samplers
@@ -519,7 +759,7 @@ namespace astre::render::opengl
         }
     }
 
-    asio::awaitable<void> OpenGLRenderer::clearScreen(math::Vec4 color, std::optional<std::size_t> fbo)
+    asio::awaitable<void> OpenGLRenderer::clearScreen(math::Vec4 color, std::optional<std::size_t> fbo, std::optional<ViewportRect> region)
     {
         if(good() == false)co_return;
         
@@ -549,9 +789,21 @@ namespace astre::render::opengl
                 (GLsizei)_viewport_resolution.second);
         }
 
+        if(region)
+        {
+            // glClear ignores viewport, only scissor limits it
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(region->x, region->y, (GLsizei)region->width, (GLsizei)region->height);
+        }
+
         glClearColor(color.r, color.g, color.b, color.a);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        if(region)
+        {
+            glDisable(GL_SCISSOR_TEST);
+        }
+
         if(fbo)
         {
             _frame_buffer_objects.at(*fbo)->disable();
@@ -566,61 +818,332 @@ namespace astre::render::opengl
             ShaderInputs shader_inputs,
             RenderOptions options,
             std::optional<std::size_t> fbo)
+    {
+        co_return co_await renderInstanced(vertex_buffer, shader, 1,
+            std::move(shader_inputs), std::move(options), std::move(fbo));
+    }
+
+    asio::awaitable<FrameStats> OpenGLRenderer::renderInstanced(
+            std::size_t vertex_buffer,
+            std::size_t shader,
+            std::uint32_t instance_count,
+            ShaderInputs shader_inputs,
+            RenderOptions options,
+            std::optional<std::size_t> fbo)
+    {
+        FrameStats stats;
+        if(instance_count == 0)co_return stats;
+        if(good() == false)co_return stats;
+
+        co_await _render_context->ensureOnStrand();
+        
+        if(good() == false)co_return stats;
+
+        _bound_state = {};
+        if(bindFrameBufferObject(fbo, stats) == false)co_return stats;
+
+        stats += drawElements(vertex_buffer, shader, instance_count, shader_inputs, options);
+
+        unbindFrameBufferObject(fbo);
+
+        co_return stats;
+    }
+
+    asio::awaitable<FrameStats> OpenGLRenderer::submit(std::vector<DrawCommand> commands)
+    {
+        FrameStats stats;
+        if(commands.empty())co_return stats;
+        if(good() == false)co_return stats;
+
+        co_await _render_context->ensureOnStrand();
+        
+        if(good() == false)co_return stats;
+
+        _bound_state = {};
+
+        // FBO stays bound as long as consecutive commands target it
+        std::optional<std::optional<std::size_t>> bound_fbo;
+        // nullopt = viewport covers whole bound target
+        std::optional<ViewportRect> current_viewport;
+
+        for(const auto & command : commands)
+        {
+            if(command.instance_count == 0)continue;
+
+            if(!bound_fbo || *bound_fbo != command.fbo)
+            {
+                if(bindFrameBufferObject(command.fbo, stats) == false)
+                {
+                    bound_fbo.reset();
+                    continue;
+                }
+                bound_fbo = command.fbo;
+                current_viewport.reset();
+            }
+
+            if(command.viewport != current_viewport)
+            {
+                if(command.viewport)
+                {
+                    glViewport(command.viewport->x, command.viewport->y,
+                        (GLsizei)command.viewport->width, (GLsizei)command.viewport->height);
+                }
+                else
+                {
+                    // rebinding same target restores its full viewport
+                    bindFrameBufferObject(command.fbo, stats);
+                }
+                current_viewport = command.viewport;
+            }
+
+            stats += drawElements(command.vertex_buffer, command.shader, command.instance_count, command.inputs, command.options);
+        }
+
+        if(bound_fbo)
+        {
+            unbindFrameBufferObject(*bound_fbo);
+        }
+
+        co_return stats;
+    }
+
+    bool OpenGLRenderer::supportsIndirectDraw() const
+    {
+        return good() && GLEW_ARB_multi_draw_indirect && GLEW_ARB_shader_draw_parameters;
+    }
+
+    std::optional<IndirectDrawGeometry> OpenGLRenderer::getIndirectDrawGeometry(std::size_t vertex_buffer) const
+    {
+        if(good() == false)return std::nullopt;
+
+        auto it = _indirect_draw_geometry.find(vertex_buffer);
+        if(it == _indirect_draw_geometry.end())return std::nullopt;
+        return it->second;
+    }
+
+    asio::awaitable<FrameStats> OpenGLRenderer::submitIndirect(std::vector<IndirectDrawCommand> commands)
     {
         FrameStats stats;
+        if(commands.empty())co_return stats;
         if(good() == false)co_return stats;
 
         co_await _render_context->ensureOnStrand();
         
         if(good() == false)co_return stats;
 
+        _bound_state = {};
+
+        // commands of all lists in one upload, every list starts at its offset
+        bool indirect = supportsIndirectDraw();
+        std::vector<DrawElementsIndirectCommand> indirect_commands;
+        std::vector<std::size_t> first_commands;
+        first_commands.reserve(commands.size());
+        for(const auto & command : commands)
+        {
+            first_commands.emplace_back(indirect_commands.size());
+            indirect_commands.insert(indirect_commands.end(), command.list.commands.begin(), command.list.commands.end());
+        }
+
+        if(indirect && indirect_commands.empty() == false)
+        {
+            if(_indirect_buffer == nullptr) _indirect_buffer = std::make_unique<OpenGLIndirectBuffer>();
+            indirect = _indirect_buffer->upload(indirect_commands.data(), sizeof(DrawElementsIndirectCommand) * indirect_commands.size());
+        }
+
+        for(std::size_t i = 0; i < commands.size(); ++i)
+        {
+            const auto & command = commands.at(i);
+
+            if(bindFrameBufferObject(command.fbo, stats) == false)continue;
+            if(command.viewport)
+            {
+                glViewport(command.viewport->x, command.viewport->y,
+                    (GLsizei)command.viewport->width, (GLsizei)command.viewport->height);
+            }
+
+            // single draws with uInstanceBase, same as `submit`
+            const auto drawSingle = [&](const IndirectDraw & draw)
+            {
+                ShaderInputs inputs = command.inputs;
+                inputs.in_uint["uInstanceBase"] = draw.base_instance;
+                stats += drawElements(draw.vertex_buffer, command.shader, draw.instance_count, inputs, command.options);
+            };
+
+            // shaders without draw parameters support can only draw one by one
+            const auto shader_it = _shaders.find(command.shader);
+            const bool shader_indirect = shader_it != _shaders.end() && shader_it->second->hasUniform("uIndirect");
+
+            if(indirect && shader_indirect)
+            {
+                stats += multiDrawElements(command, first_commands.at(i));
+            }
+            else
+            {
+                for(const auto & draw : command.list.draws) drawSingle(draw);
+            }
+
+            for(const auto & draw : command.list.fallback) drawSingle(draw);
+
+            unbindFrameBufferObject(command.fbo);
+        }
+
+        co_return stats;
+    }
+
+    bool OpenGLRenderer::bindFrameBufferObject(const std::optional<std::size_t> & fbo, FrameStats & stats)
+    {
+        const std::size_t target = fbo.value_or(0);
+        const bool rebind = _bound_state.fbo != target;
+
         if(fbo)
         {
-            if(_frame_buffer_objects.contains(*fbo) == false)
+            auto fbo_it = _frame_buffer_objects.find(*fbo);
+            if(fbo_it == _frame_buffer_objects.end())
             {
                 spdlog::error("[render] render() : Frame buffer object not found");
-                co_return stats;
+                return false;
             }
-            if(_frame_buffer_objects.at(*fbo)->enable() == false)
+            if(rebind && fbo_it->second->enable() == false)
             {
                 spdlog::error("[render] Cannot enable frame buffer object");
-                co_return stats;
+                _bound_state.fbo.reset();
+                return false;
             }
-            const auto & fbo_obj_ref = _frame_buffer_objects.at(*fbo);
-            glViewport(0, 0, (GLsizei)fbo_obj_ref->getResolution().first,
-                 (GLsizei)fbo_obj_ref->getResolution().second);
+            glViewport(0, 0, (GLsizei)fbo_it->second->getResolution().first,
+                 (GLsizei)fbo_it->second->getResolution().second);
         }
         else
         {
+            if(rebind) glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
             glViewport(0, 0, (GLsizei)_viewport_resolution.first, 
                 (GLsizei)_viewport_resolution.second);
         }
 
+        if(rebind) stats.fbo_binds++;
+        _bound_state.fbo = target;
+        return true;
+    }
+
+    void OpenGLRenderer::unbindFrameBufferObject(const std::optional<std::size_t> & fbo)
+    {
+        if(!fbo)return;
+
+        if(_bound_state.fbo == *fbo)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            _bound_state.fbo = 0;
+            return;
+        }
+
+        auto fbo_it = _frame_buffer_objects.find(*fbo);
+        if(fbo_it == _frame_buffer_objects.end())return;
+
+        fbo_it->second->disable();
+        _bound_state.fbo.reset();
+    }
+
+    FrameStats OpenGLRenderer::drawElements(
+            std::size_t vertex_buffer,
+            std::size_t shader,
+            std::uint32_t instance_count,
+            const ShaderInputs & shader_inputs,
+            const RenderOptions & options)
+    {
+        FrameStats stats;
+
         auto shader_it = _shaders.find(shader);
         if(shader_it == _shaders.end()){
             spdlog::warn("[render] Rendering: Shader not found");
-            co_return stats;
+            return stats;
         }
 
         auto vertex_buffer_it = _vertex_buffers.find(vertex_buffer);
         if(vertex_buffer_it == _vertex_buffers.end()){
             spdlog::warn("[render] Rendering: Vertex buffer not found");
-            co_return stats;
+            return stats;
         }
 
+        // shader and VAO stay bound after the draw, so only a change costs a bind
+        if(bindShaderProgram(shader_it->second, stats) == false)return stats;
 
-        if(shader_it->second->enable() == false){
-            spdlog::error("[render] Cannot enable shader program");
-            co_return stats;
+        const std::size_t vertex_array = vertex_buffer_it->second->vertexArrayID();
+        if(_bound_state.vertex_array != vertex_array)
+        {
+            if(vertex_buffer_it->second->enable() == false){
+                spdlog::error("[render] Cannot enable vertex buffer");
+                _bound_state.vertex_array.reset();
+                return stats;
+            }
+            _bound_state.vertex_array = vertex_array;
+            stats.vao_binds++;
         }
 
-        if(vertex_buffer_it->second->enable() == false){
-            spdlog::error("[render] Cannot enable vertex buffer");
-            co_return stats;
+        assignShaderInputs(shader, shader_inputs);
+
+        // vertex decoding parameters owned by the vertex buffer, not by the caller
+        const VertexFormat vertex_format = vertex_buffer_it->second->vertexFormat();
+        if(shader_it->second->hasUniform("uVertexFormat"))
+        {
+            shader_it->second->setUniform("uVertexFormat", static_cast<std::uint32_t>(vertex_format));
+        }
+        if(shader_it->second->hasUniform("uPositionOffset"))
+        {
+            shader_it->second->setUniform("uPositionOffset", vertex_buffer_it->second->vertexQuantization().offset);
+            shader_it->second->setUniform("uPositionScale", vertex_buffer_it->second->vertexQuantization().scale);
         }
 
-        assignShaderInputs(shader, shader_inputs);
+        const GeometryRange range = vertex_buffer_it->second->range();
+
+        stats.draw_calls = 1;
+        stats.instances = instance_count;
+        stats.vertices = range.index_count * instance_count;
+        stats.triangles = (range.index_count / 3) * instance_count;
+        
+        const GLboolean prev_write_depth_mask = applyRenderOptions(options);
+
+        const GLenum primitive = options.topology == PrimitiveTopology::Lines ? GL_LINES : GL_TRIANGLES;
+        const std::size_t index_size = vertex_buffer_it->second->indexSize();
+        const GLenum index_type = index_size == sizeof(std::uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        const void * first_index = (const void *)(range.first_index * index_size);
+        if(range.base_vertex == 0 && instance_count == 1)
+        {
+            glDrawElements(primitive, (GLsizei)range.index_count, index_type, first_index);
+        }
+        else if(range.base_vertex == 0)
+        {
+            glDrawElementsInstanced(primitive, (GLsizei)range.index_count, index_type, first_index, (GLsizei)instance_count);
+        }
+        else if(instance_count == 1)
+        {
+            glDrawElementsBaseVertex(primitive, (GLsizei)range.index_count, index_type, (void *)first_index, (GLint)range.base_vertex);
+        }
+        else
+        {
+            glDrawElementsInstancedBaseVertex(primitive, (GLsizei)range.index_count, index_type, first_index, (GLsizei)instance_count, (GLint)range.base_vertex);
+        }
+
+        restoreRenderOptions(options, prev_write_depth_mask);
 
+        return stats;
+    }
+
+    bool OpenGLRenderer::bindShaderProgram(Shader & shader, FrameStats & stats)
+    {
+        if(_bound_state.shader_program == shader->ID())return true;
+
+        if(shader->enable() == false){
+            spdlog::error("[render] Cannot enable shader program");
+            _bound_state.shader_program.reset();
+            return false;
+        }
+        _bound_state.shader_program = shader->ID();
+        stats.shader_binds++;
+        return true;
+    }
+
+    GLboolean OpenGLRenderer::applyRenderOptions(const RenderOptions & options)
+    {
         if(options.mode == RenderMode::Wireframe)glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
         
         if(options.polygon_offset)
@@ -629,10 +1152,6 @@ namespace astre::render::opengl
             glPolygonOffset(options.polygon_offset->factor, options.polygon_offset->units);
         }
 
-        stats.draw_calls = 1;
-        stats.vertices = vertex_buffer_it->second->numberOfElements();
-        stats.triangles = vertex_buffer_it->second->numberOfElements() / 3.0f;
-        
         GLboolean prev_write_depth_mask;
         glGetBooleanv(GL_DEPTH_WRITEMASK, &prev_write_depth_mask);
         if(!options.write_depth)
@@ -646,9 +1165,11 @@ namespace astre::render::opengl
 
         if(!options.depth_test) glDisable(GL_DEPTH_TEST);
 
-        const GLenum primitive = options.topology == PrimitiveTopology::Lines ? GL_LINES : GL_TRIANGLES;
-        glDrawElements(primitive, (GLsizei)vertex_buffer_it->second->numberOfElements(), GL_UNSIGNED_INT, nullptr);
+        return prev_write_depth_mask;
+    }
 
+    void OpenGLRenderer::restoreRenderOptions(const RenderOptions & options, GLboolean prev_write_depth_mask)
+    {
         if(!options.depth_test) glEnable(GL_DEPTH_TEST); // restore global default (enabled at init)
 
         glDepthMask(prev_write_depth_mask);
@@ -659,14 +1180,62 @@ namespace astre::render::opengl
         }
 
         if(options.mode == RenderMode::Wireframe)glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); // restore default
+    }
+
+    FrameStats OpenGLRenderer::multiDrawElements(const IndirectDrawCommand & command, std::size_t first_command)
+    {
+        FrameStats stats;
 
+        auto shader_it = _shaders.find(command.shader);
+        if(shader_it == _shaders.end()){
+            spdlog::warn("[render] Rendering: Shader not found");
+            return stats;
+        }
 
-        if(fbo)
+        if(bindShaderProgram(shader_it->second, stats) == false)return stats;
+
+        assignShaderInputs(command.shader, command.inputs);
+
+        // instance and decoding data come from draw parameters and the draw data SSBO
+        shader_it->second->setUniform("uIndirect", 1u);
+
+        const GLboolean prev_write_depth_mask = applyRenderOptions(command.options);
+        const GLenum primitive = command.options.topology == PrimitiveTopology::Lines ? GL_LINES : GL_TRIANGLES;
+
+        for(const auto & group : command.list.groups)
         {
-            _frame_buffer_objects.at(*fbo)->disable();
+            if(_bound_state.vertex_array != group.vertex_array)
+            {
+                glBindVertexArray((GLuint)group.vertex_array);
+                _bound_state.vertex_array = group.vertex_array;
+                stats.vao_binds++;
+            }
+
+            if(shader_it->second->hasUniform("uVertexFormat"))
+            {
+                shader_it->second->setUniform("uVertexFormat", static_cast<std::uint32_t>(group.format));
+            }
+            shader_it->second->setUniform("uDrawBase", command.draw_data_base + group.first_command);
+
+            const GLenum index_type = group.index_size == sizeof(std::uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            const std::size_t offset = (first_command + group.first_command) * sizeof(DrawElementsIndirectCommand);
+            glMultiDrawElementsIndirect(primitive, index_type, (const void *)offset, (GLsizei)group.command_count, 0);
+
+            stats.draw_calls++;
+            for(std::uint32_t i = group.first_command; i < group.first_command + group.command_count; ++i)
+            {
+                const auto & indirect = command.list.commands.at(i);
+                stats.instances += indirect.instance_count;
+                stats.vertices += indirect.count * indirect.instance_count;
+                stats.triangles += (indirect.count / 3) * indirect.instance_count;
+            }
         }
 
-        co_return stats;
+        restoreRenderOptions(command.options, prev_write_depth_mask);
+
+        shader_it->second->setUniform("uIndirect", 0u);
+
+        return stats;
     }
 
     asio::awaitable<void> OpenGLRenderer::present()
@@ -681,6 +1250,9 @@ namespace astre::render::opengl
             SwapBuffers(_render_context->getDeviceContext());
         #endif
 
+        nextStreamFrame();
+        pollPixelReads();
+
         co_return;
     }
 
@@ -727,5 +1299,98 @@ namespace astre::render::opengl
         co_return (std::uint64_t{rg[0]} | (std::uint64_t{rg[1]} << 32)); // lo | (hi<<32)
     }
 
+    asio::awaitable<std::optional<PixelRegionUint64>> OpenGLRenderer::readRegionUint64(std::size_t fbo, unsigned attachment, PixelRect rect)
+    {
+        if (!good()) co_return std::nullopt;
+        co_await _render_context->ensureOnStrand();
+
+        auto it = _frame_buffer_objects.find(fbo);
+        if (it == _frame_buffer_objects.end()) co_return std::nullopt;
+
+        const auto& f = it->second;
+        const auto clipped = clipPixelRect(rect, f->getResolution());
+        if (!clipped) co_return std::nullopt;
+
+        const std::size_t size = (std::size_t)clipped->width * clipped->height * sizeof(std::uint32_t) * 2; // RG 32-bit
+        std::unique_ptr<OpenGLPixelReadback> readback = acquirePixelReadback(size);
+        if (readback == nullptr) co_return std::nullopt;
+
+        if (!f->enable()) 
+        {
+            releasePixelReadback(std::move(readback));
+            co_return std::nullopt;
+        }
+
+        glReadBuffer(GL_COLOR_ATTACHMENT0 + attachment);
+        const bool issued = readback->issue(clipped->x, clipped->y, clipped->width, clipped->height, GL_RG_INTEGER, GL_UNSIGNED_INT, size);
+        f->disable();
+
+        if (!issued)
+        {
+            releasePixelReadback(std::move(readback));
+            co_return std::nullopt;
+        }
+
+        auto pending = std::make_shared<PendingPixelRead>(PendingPixelRead{
+            .readback = std::move(readback),
+            .signal = asio::steady_timer(_render_context->getAsyncContext(), asio::steady_timer::time_point::max())
+        });
+        _pending_pixel_reads.emplace_back(pending);
+
+        // cancelled by pollPixelReads once GPU is done, or by close
+        asio::error_code ec;
+        co_await pending->signal.async_wait(asio::redirect_error(asio::use_awaitable, ec));
+
+        if (!good()) co_return std::nullopt;
+        co_await _render_context->ensureOnStrand();
+        if (pending->readback == nullptr) co_return std::nullopt;
+
+        const auto data = pending->readback->read();
+        releasePixelReadback(std::move(pending->readback));
+        if (!data) co_return std::nullopt;
+
+        PixelRegionUint64 region{.rect = *clipped};
+        region.values.resize((std::size_t)clipped->width * clipped->height);
+        const auto * rg = reinterpret_cast<const std::uint32_t *>(data->data());
+        for (std::size_t i = 0; i < region.values.size(); ++i)
+        {
+            region.values[i] = std::uint64_t{rg[2 * i]} | (std::uint64_t{rg[2 * i + 1]} << 32); // lo | (hi<<32)
+        }
+        co_return region;
+    }
+
+    std::unique_ptr<OpenGLPixelReadback> OpenGLRenderer::acquirePixelReadback(std::size_t size)
+    {
+        auto it = std::ranges::find_if(_pixel_readbacks, [size](const auto & readback){ return readback->capacity() >= size; });
+        if(it != _pixel_readbacks.end())
+        {
+            std::unique_ptr<OpenGLPixelReadback> readback = std::move(*it);
+            _pixel_readbacks.erase(it);
+            return readback;
+        }
+
+        auto readback = std::make_unique<OpenGLPixelReadback>(std::max(size, PIXEL_READBACK_MIN_SIZE));
+        if(readback->good() == false)return nullptr;
+        return readback;
+    }
+
+    void OpenGLRenderer::releasePixelReadback(std::unique_ptr<OpenGLPixelReadback> readback)
+    {
+        if(readback == nullptr || _pixel_readbacks.size() >= PIXEL_READBACK_POOL_SIZE)return;
+        _pixel_readbacks.emplace_back(std::move(readback));
+    }
+
+    void OpenGLRenderer::pollPixelReads()
+    {
+        std::erase_if(_pending_pixel_reads, [](const std::shared_ptr<PendingPixelRead> & pending)
+        {
+            ++pending->frames;
+            if(pending->readback->ready() == false && pending->frames < PIXEL_READ_MAX_FRAMES)return false;
+
+            pending->signal.cancel();
+            return true;
+        });
+    }
+
 
 }
@@ -0,0 +1,172 @@
+#include "render/opengl/opengl_arena_vertex_buffer.hpp"
+
+#include "render/draw_sort.hpp"
+
+namespace astre::render::opengl
+{
+    // the bits a draw sort key keeps hold a per format tag, the handle lives above them
+    static constexpr std::size_t ARENA_ID_BIT = std::size_t(1) << 63;
+    static constexpr std::size_t ARENA_ID_HANDLE_SHIFT = DRAW_SORT_VERTEX_BUFFER_BITS;
+    static constexpr std::size_t ARENA_ID_FORMAT_MASK = 0xF;
+    static constexpr std::size_t ARENA_ID_FORMAT_BITS = DRAW_SORT_VERTEX_BUFFER_MASK & ~ARENA_ID_FORMAT_MASK;
+
+    static_assert(VERTEX_FORMAT_COUNT <= ARENA_ID_FORMAT_MASK + 1, "arena vertex formats do not fit the ID bits reserved for them");
+    static_assert(ARENA_ID_HANDLE_SHIFT < 63, "arena handle overlaps the arena ID bit");
+
+    OpenGLArenaVertexBuffer::OpenGLArenaVertexBuffer(OpenGLGeometryArena & arena, const std::vector<unsigned int> & indices,
+        const std::vector<GPUVertex> & vertices, VertexFormat format)
+    :   _arena(&arena),
+        _allocation(std::nullopt),
+        _ID(ARENA_ID_BIT | (arena.nextHandle() << ARENA_ID_HANDLE_SHIFT) | ARENA_ID_FORMAT_BITS | static_cast<std::size_t>(format)),
+        _index_count(indices.size()),
+        _index_size(render::indexSize(vertices.size())),
+        _format(format),
+        _quantization(computeVertexQuantization(vertices, format))
+    {
+        if(indices.empty() || vertices.empty())
+        {
+            spdlog::error("OpenGL arena vertex buffer empty indices or vertices list");
+            return;
+        }
+
+        std::vector<std::uint16_t> short_indices;
+        const void * index_data = indices.data();
+        if(_index_size == sizeof(std::uint16_t))
+        {
+            short_indices.assign(indices.begin(), indices.end());
+            index_data = short_indices.data();
+        }
+
+        switch(_format)
+        {
+            case VertexFormat::Compact:
+            {
+                const auto compact = toCompactVertices(vertices);
+                _allocation = _arena->allocate(_format, compact.data(), compact.size(), index_data, _index_count, _index_size);
+                break;
+            }
+            case VertexFormat::Quantized:
+            {
+                const auto quantized = toQuantizedVertices(vertices, _quantization);
+                _allocation = _arena->allocate(_format, quantized.data(), quantized.size(), index_data, _index_count, _index_size);
+                break;
+            }
+            case VertexFormat::Full:
+            default:
+                _allocation = _arena->allocate(_format, vertices.data(), vertices.size(), index_data, _index_count, _index_size);
+                break;
+        }
+
+        if(!_allocation)
+        {
+            spdlog::error("OpenGL arena vertex buffer allocation failed");
+        }
+    }
+
+    OpenGLArenaVertexBuffer::OpenGLArenaVertexBuffer(OpenGLArenaVertexBuffer && other)
+    :   _arena(other._arena),
+        _allocation(std::move(other._allocation)),
+        _ID(other._ID),
+        _index_count(other._index_count),
+        _index_size(other._index_size),
+        _format(other._format),
+        _quantization(other._quantization)
+    {
+        other._arena = nullptr;
+        other._allocation.reset();
+    }
+
+    OpenGLArenaVertexBuffer::~OpenGLArenaVertexBuffer()
+    {
+        if(good() == false)return;
+
+        _arena->free(*_allocation);
+        _allocation.reset();
+
+        spdlog::debug("OpenGL arena vertex buffer {} released", _ID);
+    }
+
+    std::size_t OpenGLArenaVertexBuffer::ID() const
+    {
+        return _ID;
+    }
+
+    bool OpenGLArenaVertexBuffer::good() const
+    {
+        return _arena != nullptr && _allocation.has_value();
+    }
+
+    std::size_t OpenGLArenaVertexBuffer::numberOfElements() const
+    {
+        return _index_count;
+    }
+
+    std::size_t OpenGLArenaVertexBuffer::indexSize() const
+    {
+        return _index_size;
+    }
+
+    VertexFormat OpenGLArenaVertexBuffer::vertexFormat() const
+    {
+        return _format;
+    }
+
+    const VertexQuantization & OpenGLArenaVertexBuffer::vertexQuantization() const
+    {
+        return _quantization;
+    }
+
+    GeometryRange OpenGLArenaVertexBuffer::range() const
+    {
+        if(good() == false)return GeometryRange{};
+
+        return GeometryRange{
+            .base_vertex = _allocation->base_vertex,
+            .first_index = _allocation->index_offset / _index_size,
+            .index_count = _index_count
+        };
+    }
+
+    std::size_t OpenGLArenaVertexBuffer::vertexArrayID() const
+    {
+        if(_arena == nullptr)return 0;
+        return _arena->vertexArray(_format);
+    }
+
+    bool OpenGLArenaVertexBuffer::enable() const
+    {
+        if(good() == false)
+        {
+            spdlog::error("Use of uninitialized OpenGL arena vertex buffer");
+            return false;
+        }
+
+        const GLuint VAO = _arena->vertexArray(_format);
+
+        // buffers of the same format share the VAO, bind only on change
+        GLint currently_bound_VAO = 0;
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &currently_bound_VAO);
+        if(currently_bound_VAO == (GLint)VAO)return true;
+
+        glBindVertexArray(VAO);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Arena VAO binding failed, OpenGL error : {}", check.error());
+            return false;
+        }
+        return true;
+    }
+
+    void OpenGLArenaVertexBuffer::disable() const
+    {
+        if(_arena == nullptr)return;
+
+        GLint currently_bound_VAO = 0;
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &currently_bound_VAO);
+        if(currently_bound_VAO != (GLint)_arena->vertexArray(_format))return;
+
+        glBindVertexArray(0);
+    }
+}
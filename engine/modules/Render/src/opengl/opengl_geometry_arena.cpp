@@ -0,0 +1,244 @@
+#include "render/opengl/opengl_geometry_arena.hpp"
+
+#include <algorithm>
+
+namespace astre::render::opengl
+{
+    OpenGLGeometryArena::OpenGLGeometryArena(std::size_t initial_vertices, std::size_t initial_index_bytes)
+    :   _pools(),
+        _EBO(0),
+        _indices(0),
+        _next_handle(1)
+    {
+        if(GLEW_ARB_direct_state_access == false)
+        {
+            spdlog::warn("[opengl] GL_ARB_direct_state_access not supported, geometry arena disabled");
+            return;
+        }
+
+        initial_vertices = std::max<std::size_t>(initial_vertices, 1);
+        initial_index_bytes = std::max<std::size_t>(initial_index_bytes, sizeof(std::uint32_t));
+
+        glCreateBuffers(1, &_EBO);
+        glNamedBufferData(_EBO, (GLsizeiptr)initial_index_bytes, nullptr, GL_STATIC_DRAW);
+        _indices.grow(initial_index_bytes);
+
+        for(std::size_t i = 0; i < VERTEX_FORMAT_COUNT; ++i)
+        {
+            const VertexFormat format = static_cast<VertexFormat>(i);
+            Pool & pool = _pools[i];
+            pool.stride = vertexStride(format);
+
+            glCreateVertexArrays(1, &pool.VAO);
+            glCreateBuffers(1, &pool.VBO);
+            glNamedBufferData(pool.VBO, (GLsizeiptr)(initial_vertices * pool.stride), nullptr, GL_STATIC_DRAW);
+
+            glVertexArrayVertexBuffer(pool.VAO, 0, pool.VBO, 0, (GLsizei)pool.stride);
+            glVertexArrayElementBuffer(pool.VAO, _EBO);
+            setAttributes(pool.VAO, format);
+
+            pool.allocator.grow(initial_vertices);
+        }
+
+        const auto check = checkOpenGLState();
+        if(!check || good() == false)
+        {
+            spdlog::error("[opengl] Geometry arena creation failed, OpenGL error : {}", check ? "none" : check.error());
+            return;
+        }
+
+        spdlog::debug("[opengl] Geometry arena created, {} vertices per format, {} index bytes", initial_vertices, initial_index_bytes);
+    }
+
+    OpenGLGeometryArena::OpenGLGeometryArena(OpenGLGeometryArena && other)
+    :   _pools(std::move(other._pools)),
+        _EBO(other._EBO),
+        _indices(std::move(other._indices)),
+        _next_handle(other._next_handle)
+    {
+        for(auto & pool : other._pools)
+        {
+            pool.VAO = 0;
+            pool.VBO = 0;
+        }
+        other._EBO = 0;
+    }
+
+    OpenGLGeometryArena::~OpenGLGeometryArena()
+    {
+        for(auto & pool : _pools)
+        {
+            if(pool.VAO != 0) glDeleteVertexArrays(1, &pool.VAO);
+            if(pool.VBO != 0) glDeleteBuffers(1, &pool.VBO);
+            pool.VAO = 0;
+            pool.VBO = 0;
+        }
+
+        if(_EBO != 0)
+        {
+            glDeleteBuffers(1, &_EBO);
+            _EBO = 0;
+            spdlog::info("[opengl] Geometry arena destroyed");
+        }
+    }
+
+    bool OpenGLGeometryArena::good() const
+    {
+        if(_EBO == 0) return false;
+        return std::all_of(_pools.begin(), _pools.end(), [](const Pool & pool){ return pool.VAO != 0 && pool.VBO != 0; });
+    }
+
+    std::optional<OpenGLGeometryArena::Allocation> OpenGLGeometryArena::allocate(VertexFormat format,
+        const void * vertex_data, std::size_t vertex_count,
+        const void * index_data, std::size_t index_count, std::size_t index_size)
+    {
+        if(good() == false || vertex_count == 0 || index_count == 0) return std::nullopt;
+
+        Pool & pool = _pools[static_cast<std::size_t>(format)];
+
+        auto base_vertex = pool.allocator.allocate(vertex_count);
+        if(!base_vertex && growPool(pool, vertex_count)) base_vertex = pool.allocator.allocate(vertex_count);
+        if(!base_vertex)
+        {
+            spdlog::error("[opengl] Geometry arena cannot fit {} vertices", vertex_count);
+            return std::nullopt;
+        }
+
+        const std::size_t index_bytes = index_count * index_size;
+        auto index_offset = _indices.allocate(index_bytes, index_size);
+        if(!index_offset && growIndices(index_bytes + index_size)) index_offset = _indices.allocate(index_bytes, index_size);
+        if(!index_offset)
+        {
+            spdlog::error("[opengl] Geometry arena cannot fit {} index bytes", index_bytes);
+            pool.allocator.free(*base_vertex);
+            return std::nullopt;
+        }
+
+        glNamedBufferSubData(pool.VBO, (GLintptr)(*base_vertex * pool.stride), (GLsizeiptr)(vertex_count * pool.stride), vertex_data);
+        glNamedBufferSubData(_EBO, (GLintptr)*index_offset, (GLsizeiptr)index_bytes, index_data);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Geometry arena upload failed, OpenGL error : {}", check.error());
+            pool.allocator.free(*base_vertex);
+            _indices.free(*index_offset);
+            return std::nullopt;
+        }
+
+        return Allocation{
+            .format = format,
+            .base_vertex = *base_vertex,
+            .vertex_count = vertex_count,
+            .index_offset = *index_offset,
+            .index_bytes = index_bytes
+        };
+    }
+
+    void OpenGLGeometryArena::free(const Allocation & allocation)
+    {
+        _pools[static_cast<std::size_t>(allocation.format)].allocator.free(allocation.base_vertex);
+        _indices.free(allocation.index_offset);
+    }
+
+    GLuint OpenGLGeometryArena::vertexArray(VertexFormat format) const
+    {
+        return _pools[static_cast<std::size_t>(format)].VAO;
+    }
+
+    std::size_t OpenGLGeometryArena::nextHandle()
+    {
+        return _next_handle++;
+    }
+
+    GeometryArenaStats OpenGLGeometryArena::stats() const
+    {
+        GeometryArenaStats stats;
+        for(std::size_t i = 0; i < VERTEX_FORMAT_COUNT; ++i)
+            stats.vertices[i] = _pools[i].allocator.stats();
+        stats.indices = _indices.stats();
+        return stats;
+    }
+
+    bool OpenGLGeometryArena::growBuffer(GLuint & buffer, std::size_t old_size, std::size_t new_size)
+    {
+        GLuint grown = 0;
+        glCreateBuffers(1, &grown);
+        if(grown == 0) return false;
+
+        glNamedBufferData(grown, (GLsizeiptr)new_size, nullptr, GL_STATIC_DRAW);
+        glCopyNamedBufferSubData(buffer, grown, 0, 0, (GLsizeiptr)old_size);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Geometry arena buffer growth failed, OpenGL error : {}", check.error());
+            glDeleteBuffers(1, &grown);
+            return false;
+        }
+
+        glDeleteBuffers(1, &buffer);
+        buffer = grown;
+        return true;
+    }
+
+    bool OpenGLGeometryArena::growPool(Pool & pool, std::size_t min_vertices)
+    {
+        const std::size_t capacity = pool.allocator.capacity();
+        const std::size_t grown = std::max(capacity * 2, capacity + min_vertices);
+
+        if(growBuffer(pool.VBO, capacity * pool.stride, grown * pool.stride) == false) return false;
+
+        glVertexArrayVertexBuffer(pool.VAO, 0, pool.VBO, 0, (GLsizei)pool.stride);
+        pool.allocator.grow(grown);
+
+        spdlog::debug("[opengl] Geometry arena vertex pool grown to {} vertices", grown);
+        return true;
+    }
+
+    bool OpenGLGeometryArena::growIndices(std::size_t min_bytes)
+    {
+        const std::size_t capacity = _indices.capacity();
+        const std::size_t grown = std::max(capacity * 2, capacity + min_bytes);
+
+        if(growBuffer(_EBO, capacity, grown) == false) return false;
+
+        for(const auto & pool : _pools) glVertexArrayElementBuffer(pool.VAO, _EBO);
+        _indices.grow(grown);
+
+        spdlog::debug("[opengl] Geometry arena index buffer grown to {} bytes", grown);
+        return true;
+    }
+
+    void OpenGLGeometryArena::setAttributes(GLuint VAO, VertexFormat format)
+    {
+        const auto attribute = [VAO](GLuint location, GLint size, GLenum type, GLboolean normalized, std::size_t offset){
+            glVertexArrayAttribFormat(VAO, location, size, type, normalized, (GLuint)offset);
+            glVertexArrayAttribBinding(VAO, location, 0);
+            glEnableVertexArrayAttrib(VAO, location);
+        };
+
+        // same layouts as OpenGLVertexBuffer::setGPUAttributes
+        switch(format)
+        {
+            case VertexFormat::Compact:
+                attribute(0, 3, GL_FLOAT, GL_FALSE, offsetof(CompactGPUVertex, position));
+                attribute(1, 2, GL_SHORT, GL_TRUE, offsetof(CompactGPUVertex, normal));
+                attribute(2, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(CompactGPUVertex, uv));
+                break;
+
+            case VertexFormat::Quantized:
+                attribute(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, offsetof(QuantizedGPUVertex, position));
+                attribute(1, 2, GL_SHORT, GL_TRUE, offsetof(QuantizedGPUVertex, normal));
+                attribute(2, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(QuantizedGPUVertex, uv));
+                break;
+
+            case VertexFormat::Full:
+            default:
+                attribute(0, 3, GL_FLOAT, GL_FALSE, offsetof(GPUVertex, position));
+                attribute(1, 3, GL_FLOAT, GL_FALSE, offsetof(GPUVertex, normal));
+                attribute(2, 2, GL_FLOAT, GL_FALSE, offsetof(GPUVertex, uv));
+                break;
+        }
+    }
+}
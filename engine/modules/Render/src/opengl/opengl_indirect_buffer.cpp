@@ -0,0 +1,66 @@
+#include "render/opengl/opengl_indirect_buffer.hpp"
+
+namespace astre::render::opengl
+{
+    OpenGLIndirectBuffer::OpenGLIndirectBuffer()
+    :   _buffer(0),
+        _capacity(0)
+    {
+        glGenBuffers(1, &_buffer);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Indirect buffer creation failed, OpenGL error : {}", check.error());
+        }
+    }
+
+    OpenGLIndirectBuffer::OpenGLIndirectBuffer(OpenGLIndirectBuffer && other)
+    :   _buffer(other._buffer),
+        _capacity(other._capacity)
+    {
+        other._buffer = 0;
+        other._capacity = 0;
+    }
+
+    OpenGLIndirectBuffer::~OpenGLIndirectBuffer()
+    {
+        if(_buffer == 0)return;
+
+        glDeleteBuffers(1, &_buffer);
+        _buffer = 0;
+
+        spdlog::info("[opengl] Indirect buffer destroyed");
+    }
+
+    std::size_t OpenGLIndirectBuffer::ID() const
+    {
+        return _buffer;
+    }
+
+    bool OpenGLIndirectBuffer::good() const
+    {
+        return _buffer != 0;
+    }
+
+    bool OpenGLIndirectBuffer::upload(const void * data, std::size_t size)
+    {
+        if(good() == false)return false;
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _buffer);
+
+        if(size > _capacity) _capacity = size;
+
+        // orphan previous storage, then fill the fresh one
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, (GLsizeiptr)_capacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, (GLsizeiptr)size, data);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Indirect buffer upload failed, OpenGL error : {}", check.error());
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,138 @@
+#include "render/opengl/opengl_pixel_readback.hpp"
+
+#include <cstring>
+
+namespace astre::render::opengl
+{
+    OpenGLPixelReadback::OpenGLPixelReadback(std::size_t capacity)
+    :   _buffer(0),
+        _fence(nullptr),
+        _capacity(capacity),
+        _size(0)
+    {
+        glGenBuffers(1, &_buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, _buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)_capacity, nullptr, GL_STREAM_READ);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Pixel readback buffer creation failed, OpenGL error : {}", check.error());
+            if(_buffer != 0)glDeleteBuffers(1, &_buffer);
+            _buffer = 0;
+        }
+    }
+
+    OpenGLPixelReadback::OpenGLPixelReadback(OpenGLPixelReadback && other)
+    :   _buffer(other._buffer),
+        _fence(other._fence),
+        _capacity(other._capacity),
+        _size(other._size)
+    {
+        other._buffer = 0;
+        other._fence = nullptr;
+        other._capacity = 0;
+        other._size = 0;
+    }
+
+    OpenGLPixelReadback::~OpenGLPixelReadback()
+    {
+        releaseFence();
+
+        if(_buffer == 0)return;
+
+        glDeleteBuffers(1, &_buffer);
+        _buffer = 0;
+
+        spdlog::debug("[opengl] Pixel readback buffer destroyed");
+    }
+
+    std::size_t OpenGLPixelReadback::ID() const
+    {
+        return _buffer;
+    }
+
+    bool OpenGLPixelReadback::good() const
+    {
+        return _buffer != 0;
+    }
+
+    std::size_t OpenGLPixelReadback::capacity() const
+    {
+        return _capacity;
+    }
+
+    bool OpenGLPixelReadback::issue(int x, int y, unsigned int width, unsigned int height, GLenum format, GLenum type, std::size_t size)
+    {
+        if(good() == false)return false;
+        if(size > _capacity)
+        {
+            spdlog::error("[opengl] Pixel read of {} bytes exceeds readback buffer of {} bytes", size, _capacity);
+            return false;
+        }
+
+        releaseFence();
+
+        // with a pack buffer bound the last argument is an offset, call returns without waiting for the GPU
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, _buffer);
+        glReadPixels(x, y, (GLsizei)width, (GLsizei)height, format, type, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        _fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        _size = size;
+
+        const auto check = checkOpenGLState();
+        if(!check)
+        {
+            spdlog::error("[opengl] Pixel read failed, OpenGL error : {}", check.error());
+            releaseFence();
+            return false;
+        }
+        return true;
+    }
+
+    bool OpenGLPixelReadback::ready() const
+    {
+        if(_fence == nullptr)return false;
+
+        // flush makes sure the fence eventually signals, zero timeout keeps it a poll
+        const GLenum result = glClientWaitSync(_fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    }
+
+    std::optional<std::vector<std::uint8_t>> OpenGLPixelReadback::read()
+    {
+        if(good() == false || _fence == nullptr)return std::nullopt;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, _buffer);
+        const void * mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)_size, GL_MAP_READ_BIT);
+
+        std::optional<std::vector<std::uint8_t>> data;
+        if(mapped != nullptr)
+        {
+            data.emplace(_size);
+            std::memcpy(data->data(), mapped, _size);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        releaseFence();
+
+        const auto check = checkOpenGLState();
+        if(!check || !data)
+        {
+            spdlog::error("[opengl] Pixel readback mapping failed, OpenGL error : {}", check ? "none" : check.error());
+            return std::nullopt;
+        }
+        return data;
+    }
+
+    void OpenGLPixelReadback::releaseFence()
+    {
+        if(_fence == nullptr)return;
+
+        glDeleteSync(_fence);
+        _fence = nullptr;
+    }
+}
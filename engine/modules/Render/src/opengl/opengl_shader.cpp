@@ -120,7 +120,7 @@ namespace astre::render::opengl
         }    
     }
 
-    OpenGLShader::OpenGLShader(std::vector<std::string> vertex_code)
+    OpenGLShader::OpenGLShader(std::vector<std::string> vertex_code, const ProgramBinaryCache * cache)
     :   OpenGLShader()
     {
         if(_shader_program_ID == 0)
@@ -129,6 +129,14 @@ namespace astre::render::opengl
             return;
         }
 
+        std::optional<std::uint64_t> cache_key;
+        if(loadCachedProgram(cache, {vertex_code}, cache_key))
+        {
+            fetchAttributes();
+            fetchUniforms();
+            return;
+        }
+
         spdlog::debug(std::format("Compiling OpenGL shader[{}] : [Vertex Stage] ", _shader_program_ID));
         
         _vertex_stage = Stage(_shader_program_ID, GL_VERTEX_SHADER, std::move(vertex_code));
@@ -145,11 +153,13 @@ namespace astre::render::opengl
             return; 
         }
 
+        if(cache_key) storeProgramBinary(*cache, *cache_key);
+
         fetchAttributes();
         fetchUniforms();
     }
 
-    OpenGLShader::OpenGLShader(std::vector<std::string> vertex_code, std::vector<std::string> fragment_code)
+    OpenGLShader::OpenGLShader(std::vector<std::string> vertex_code, std::vector<std::string> fragment_code, const ProgramBinaryCache * cache)
     :   OpenGLShader()
     {
         if(_shader_program_ID == 0)
@@ -158,6 +168,14 @@ namespace astre::render::opengl
             return;
         }
 
+        std::optional<std::uint64_t> cache_key;
+        if(loadCachedProgram(cache, {vertex_code, fragment_code}, cache_key))
+        {
+            fetchAttributes();
+            fetchUniforms();
+            return;
+        }
+
         spdlog::debug(std::format("Compiling OpenGL shader[{}] : [Vertex Stage] ", _shader_program_ID));
         
         _vertex_stage = Stage(_shader_program_ID, GL_VERTEX_SHADER, std::move(vertex_code));
@@ -175,6 +193,8 @@ namespace astre::render::opengl
             return; 
         }
 
+        if(cache_key) storeProgramBinary(*cache, *cache_key);
+
         fetchAttributes();
         fetchUniforms();
     }
@@ -268,6 +288,11 @@ namespace astre::render::opengl
         return true;
     }
 
+    bool OpenGLShader::hasUniform(const std::string & name) const
+    {
+        return _uniforms.contains(name);
+    }
+
     bool OpenGLShader::linkProgram()
     {
         GLint result = GL_FALSE;
@@ -319,6 +344,74 @@ namespace astre::render::opengl
         return true;
     }
 
+    bool OpenGLShader::programBinarySupported()
+    {
+        if(GLEW_ARB_get_program_binary == false)return false;
+
+        GLint formats_count = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats_count);
+        return formats_count > 0;
+    }
+
+    bool OpenGLShader::loadCachedProgram(const ProgramBinaryCache * cache, const std::vector<std::vector<std::string>> & stages, std::optional<std::uint64_t> & cache_key)
+    {
+        if(cache == nullptr || programBinarySupported() == false)return false;
+
+        cache_key = cache->key(stages);
+        if(loadProgramBinary(*cache, *cache_key))return true;
+
+        // built from source instead, binary is retrieved afterwards to replace the entry
+        glProgramParameteri(_shader_program_ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        return false;
+    }
+
+    bool OpenGLShader::loadProgramBinary(const ProgramBinaryCache & cache, std::uint64_t key)
+    {
+        const auto binary = cache.load(key);
+        if(!binary)return false;
+
+        glProgramBinary(_shader_program_ID, (GLenum)binary->format, binary->data.data(), (GLsizei)binary->data.size());
+
+        // driver rejects binaries of other drivers or versions, program is then built from source
+        const auto check = checkOpenGLState(); // unknown binary format raises an error
+        GLint result = GL_FALSE;
+        glGetProgramiv(_shader_program_ID, GL_LINK_STATUS, &result);
+        if(!check || result == GL_FALSE || validateProgram() == false)
+        {
+            spdlog::warn(std::format("OpenGL shader[{}] cached binary {:016x} rejected, compiling from source", _shader_program_ID, key));
+            cache.erase(key);
+            return false;
+        }
+
+        spdlog::debug(std::format("OpenGL shader[{}] loaded from cached binary {:016x}", _shader_program_ID, key));
+        return true;
+    }
+
+    void OpenGLShader::storeProgramBinary(const ProgramBinaryCache & cache, std::uint64_t key) const
+    {
+        GLint length = 0;
+        glGetProgramiv(_shader_program_ID, GL_PROGRAM_BINARY_LENGTH, &length);
+        if(length <= 0)return;
+
+        ProgramBinary binary;
+        binary.data.resize((std::size_t)length);
+
+        GLenum format = 0;
+        GLsizei written = 0;
+        glGetProgramBinary(_shader_program_ID, length, &written, &format, binary.data.data());
+
+        const auto check = checkOpenGLState();
+        if(!check || written <= 0)
+        {
+            spdlog::warn("[opengl] Cannot retrieve program binary of shader[{}]", _shader_program_ID);
+            return;
+        }
+
+        binary.format = (std::uint32_t)format;
+        binary.data.resize((std::size_t)written);
+        cache.store(key, binary);
+    }
+
     void OpenGLShader::fetchAttributes()
     {
         GLint attributes_count = 0;
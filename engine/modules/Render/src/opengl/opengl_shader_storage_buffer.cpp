@@ -5,7 +5,8 @@ namespace astre::render::opengl
     OpenGLShaderStorageBuffer::OpenGLShaderStorageBuffer(unsigned int binding_point, std::size_t size, const void * data)
     :   _size(std::move(size)),
         _data(std::move(data)),
-        _SSBO(0)
+        _SSBO(0),
+        _binding_point(binding_point)
     {
         if(generateBuffer() == false) 
         { 
@@ -28,6 +29,7 @@ namespace astre::render::opengl
     
     OpenGLShaderStorageBuffer::OpenGLShaderStorageBuffer(OpenGLShaderStorageBuffer && other)
     :   _SSBO(other._SSBO),
+        _binding_point(other._binding_point),
         _size(std::move(other._size)),
         _data(std::move(other._data))
     {
@@ -63,6 +65,11 @@ namespace astre::render::opengl
         copyDataToGPU();
     }
 
+    unsigned int OpenGLShaderStorageBuffer::bindingPoint() const
+    {
+        return _binding_point;
+    }
+
     bool OpenGLShaderStorageBuffer::removeBuffer()
     {
         if(_SSBO != 0)
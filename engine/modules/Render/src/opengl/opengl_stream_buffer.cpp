@@ -0,0 +1,143 @@
+#include "render/opengl/opengl_stream_buffer.hpp"
+
+#include <cstring>
+
+namespace astre::render::opengl
+{
+    OpenGLStreamBuffer::OpenGLStreamBuffer(std::size_t region_size, std::uint32_t region_count)
+    :   _buffer(0),
+        _mapped(nullptr),
+        _allocator(region_size, region_count),
+        _fences(_allocator.regionCount(), nullptr)
+    {
+        if(GLEW_ARB_buffer_storage == false)
+        {
+            spdlog::warn("[opengl] GL_ARB_buffer_storage not supported, stream buffer disabled");
+            return;
+        }
+
+        glGenBuffers(1, &_buffer);
+        if(_buffer == 0)
+        {
+            spdlog::error("[opengl] Stream buffer generation failed");
+            return;
+        }
+
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, _buffer);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, (GLsizeiptr)_allocator.size(), nullptr, flags);
+        _mapped = static_cast<std::uint8_t *>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)_allocator.size(), flags));
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        const auto check = checkOpenGLState();
+        if(!check || _mapped == nullptr)
+        {
+            spdlog::error("[opengl] Stream buffer mapping failed, OpenGL error : {}", check ? "none" : check.error());
+            glDeleteBuffers(1, &_buffer);
+            _buffer = 0;
+            _mapped = nullptr;
+            return;
+        }
+
+        spdlog::debug("[opengl] Stream buffer {} created, {} regions of {} bytes", _buffer, _allocator.regionCount(), _allocator.regionSize());
+    }
+
+    OpenGLStreamBuffer::OpenGLStreamBuffer(OpenGLStreamBuffer && other)
+    :   _buffer(other._buffer),
+        _mapped(other._mapped),
+        _allocator(std::move(other._allocator)),
+        _fences(std::move(other._fences))
+    {
+        other._buffer = 0;
+        other._mapped = nullptr;
+        other._fences.clear();
+    }
+
+    OpenGLStreamBuffer::~OpenGLStreamBuffer()
+    {
+        for(auto & fence : _fences)
+        {
+            if(fence != nullptr)glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        if(good() == false)return;
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, _buffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glDeleteBuffers(1, &_buffer);
+
+        spdlog::info("OpenGL stream buffer destroyed");
+    }
+
+    std::size_t OpenGLStreamBuffer::ID() const
+    {
+        return _buffer;
+    }
+
+    bool OpenGLStreamBuffer::good() const
+    {
+        return _buffer != 0 && _mapped != nullptr;
+    }
+
+    std::optional<OpenGLStreamBuffer::Allocation> OpenGLStreamBuffer::write(std::size_t size, const void * data, std::size_t alignment)
+    {
+        if(good() == false || data == nullptr)return std::nullopt;
+
+        const auto offset = _allocator.allocate(size, alignment);
+        if(!offset)return std::nullopt;
+
+        // coherent mapping, visible to GPU without explicit flush
+        std::memcpy(_mapped + *offset, data, size);
+        return Allocation{*offset, size};
+    }
+
+    const void * OpenGLStreamBuffer::data(const Allocation & allocation) const
+    {
+        if(good() == false)return nullptr;
+        return _mapped + allocation.offset;
+    }
+
+    std::uint32_t OpenGLStreamBuffer::nextFrame()
+    {
+        if(good() == false)return _allocator.region();
+
+        auto & fence = _fences.at(_allocator.region());
+        if(fence != nullptr)glDeleteSync(fence);
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+        const std::uint32_t region = _allocator.nextFrame();
+        waitForFence(region);
+        return region;
+    }
+
+    std::uint32_t OpenGLStreamBuffer::regionOf(const Allocation & allocation) const
+    {
+        return _allocator.regionOf(allocation.offset);
+    }
+
+    void OpenGLStreamBuffer::waitForFence(std::uint32_t region)
+    {
+        auto & fence = _fences.at(region);
+        if(fence == nullptr)return;
+
+        // flush on first wait so the fence is guaranteed to signal
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        while(true)
+        {
+            const GLenum result = glClientWaitSync(fence, flags, 1'000'000); // 1 ms
+            if(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)break;
+            if(result == GL_WAIT_FAILED)
+            {
+                spdlog::error("[opengl] Stream buffer fence wait failed");
+                break;
+            }
+            flags = 0;
+        }
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
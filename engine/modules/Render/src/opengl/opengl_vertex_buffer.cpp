@@ -2,12 +2,15 @@
 
 namespace astre::render::opengl
 {
-    OpenGLVertexBuffer::OpenGLVertexBuffer(std::vector<unsigned int> indices, std::vector<GPUVertex> vertices)
+    OpenGLVertexBuffer::OpenGLVertexBuffer(std::vector<unsigned int> indices, std::vector<GPUVertex> vertices, VertexFormat format)
     :   _indices(std::move(indices)),
         _vertices(std::move(vertices)),
         _VAO(0),
         _VBO(0),
-        _EBO(0)
+        _EBO(0),
+        _format(format),
+        _quantization(computeVertexQuantization(_vertices, format)),
+        _index_size(render::indexSize(_vertices.size()))
     {
         if(_indices.size() == 0)
         {
@@ -38,7 +41,10 @@ namespace astre::render::opengl
         _VBO(other._VBO),
         _EBO(other._EBO),
         _indices(std::move(other._indices)),
-        _vertices(std::move(other._vertices))
+        _vertices(std::move(other._vertices)),
+        _format(other._format),
+        _quantization(other._quantization),
+        _index_size(other._index_size)
     {
         other._VAO = 0;
         other._VBO = 0;
@@ -72,6 +78,31 @@ namespace astre::render::opengl
         return _indices.size();
     }
 
+    std::size_t OpenGLVertexBuffer::indexSize() const
+    {
+        return _index_size;
+    }
+
+    VertexFormat OpenGLVertexBuffer::vertexFormat() const
+    {
+        return _format;
+    }
+
+    const VertexQuantization & OpenGLVertexBuffer::vertexQuantization() const
+    {
+        return _quantization;
+    }
+
+    GeometryRange OpenGLVertexBuffer::range() const
+    {
+        return GeometryRange{.base_vertex = 0, .first_index = 0, .index_count = _indices.size()};
+    }
+
+    std::size_t OpenGLVertexBuffer::vertexArrayID() const
+    {
+        return _VAO;
+    }
+
     bool OpenGLVertexBuffer::removeBuffers()
     {
         bool success = true;
@@ -251,6 +282,41 @@ namespace astre::render::opengl
 
     bool OpenGLVertexBuffer::setGPUAttributes()
     {
+        switch(_format)
+        {
+            case VertexFormat::Compact:
+                spdlog::debug("Setting vertex attribute [{}] to be {} x float", 0, 3);
+                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(CompactGPUVertex), (void*)offsetof(CompactGPUVertex, position));
+                glEnableVertexAttribArray(0);
+
+                spdlog::debug("Setting vertex attribute [{}] to be {} x snorm16", 1, 2);
+                glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(CompactGPUVertex), (void*)offsetof(CompactGPUVertex, normal));
+                glEnableVertexAttribArray(1);
+
+                spdlog::debug("Setting vertex attribute [{}] to be {} x half float", 2, 2);
+                glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(CompactGPUVertex), (void*)offsetof(CompactGPUVertex, uv));
+                glEnableVertexAttribArray(2);
+                return true;
+
+            case VertexFormat::Quantized:
+                spdlog::debug("Setting vertex attribute [{}] to be {} x unorm16", 0, 3);
+                glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(QuantizedGPUVertex), (void*)offsetof(QuantizedGPUVertex, position));
+                glEnableVertexAttribArray(0);
+
+                spdlog::debug("Setting vertex attribute [{}] to be {} x snorm16", 1, 2);
+                glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(QuantizedGPUVertex), (void*)offsetof(QuantizedGPUVertex, normal));
+                glEnableVertexAttribArray(1);
+
+                spdlog::debug("Setting vertex attribute [{}] to be {} x half float", 2, 2);
+                glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(QuantizedGPUVertex), (void*)offsetof(QuantizedGPUVertex, uv));
+                glEnableVertexAttribArray(2);
+                return true;
+
+            case VertexFormat::Full:
+            default:
+                break;
+        }
+
         spdlog::debug("Setting vertex attribute [{}] to be {} x float",0, 3);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(GPUVertex), (void*)offsetof(GPUVertex, position));
         glEnableVertexAttribArray(0);
@@ -275,14 +341,46 @@ namespace astre::render::opengl
         }
 
         // copy indices array 
-        spdlog::debug(std::format("Sending {} bytes, from {} address to GPU GL_ELEMENT_ARRAY_BUFFER", 
-            sizeof(GLuint) * _indices.size(), (void*)_indices.data()));
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * _indices.size(), _indices.data(), GL_STATIC_DRAW);
+        if(_index_size == sizeof(std::uint16_t))
+        {
+            std::vector<std::uint16_t> short_indices(_indices.begin(), _indices.end());
+            spdlog::debug(std::format("Sending {} bytes, from {} address to GPU GL_ELEMENT_ARRAY_BUFFER", 
+                sizeof(std::uint16_t) * short_indices.size(), (void*)short_indices.data()));
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(std::uint16_t) * short_indices.size(), short_indices.data(), GL_STATIC_DRAW);
+        }
+        else
+        {
+            spdlog::debug(std::format("Sending {} bytes, from {} address to GPU GL_ELEMENT_ARRAY_BUFFER", 
+                sizeof(GLuint) * _indices.size(), (void*)_indices.data()));
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * _indices.size(), _indices.data(), GL_STATIC_DRAW);
+        }
         
         // copy our vertices array
-        spdlog::debug(std::format("Sending {} bytes, from {} address to GPU GL_ARRAY_BUFFER", 
-            sizeof(GPUVertex) *_vertices.size(), (void*)_vertices.data()));
-        glBufferData(GL_ARRAY_BUFFER, sizeof(GPUVertex) *_vertices.size(), _vertices.data(), GL_STATIC_DRAW);
+        switch(_format)
+        {
+            case VertexFormat::Compact:
+            {
+                const auto compact = toCompactVertices(_vertices);
+                spdlog::debug(std::format("Sending {} bytes, from {} address to GPU GL_ARRAY_BUFFER", 
+                    sizeof(CompactGPUVertex) * compact.size(), (void*)compact.data()));
+                glBufferData(GL_ARRAY_BUFFER, sizeof(CompactGPUVertex) * compact.size(), compact.data(), GL_STATIC_DRAW);
+                break;
+            }
+            case VertexFormat::Quantized:
+            {
+                const auto quantized = toQuantizedVertices(_vertices, _quantization);
+                spdlog::debug(std::format("Sending {} bytes, from {} address to GPU GL_ARRAY_BUFFER", 
+                    sizeof(QuantizedGPUVertex) * quantized.size(), (void*)quantized.data()));
+                glBufferData(GL_ARRAY_BUFFER, sizeof(QuantizedGPUVertex) * quantized.size(), quantized.data(), GL_STATIC_DRAW);
+                break;
+            }
+            case VertexFormat::Full:
+            default:
+                spdlog::debug(std::format("Sending {} bytes, from {} address to GPU GL_ARRAY_BUFFER", 
+                    sizeof(GPUVertex) *_vertices.size(), (void*)_vertices.data()));
+                glBufferData(GL_ARRAY_BUFFER, sizeof(GPUVertex) *_vertices.size(), _vertices.data(), GL_STATIC_DRAW);
+                break;
+        }
         
         const auto check = checkOpenGLState();
         if(!check)
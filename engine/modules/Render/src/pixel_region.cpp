@@ -0,0 +1,60 @@
+#include "render/pixel_region.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace astre::render
+{
+    std::optional<PixelRect> clipPixelRect(const PixelRect & rect, std::pair<unsigned int, unsigned int> resolution)
+    {
+        const long long min_x = std::max<long long>(rect.x, 0);
+        const long long min_y = std::max<long long>(rect.y, 0);
+        const long long max_x = std::min<long long>((long long)rect.x + rect.width, resolution.first);
+        const long long max_y = std::min<long long>((long long)rect.y + rect.height, resolution.second);
+
+        if(min_x >= max_x || min_y >= max_y)return std::nullopt;
+
+        return PixelRect{
+            .x = (int)min_x,
+            .y = (int)min_y,
+            .width = (unsigned int)(max_x - min_x),
+            .height = (unsigned int)(max_y - min_y)
+        };
+    }
+
+    std::optional<std::uint64_t> PixelRegionUint64::at(int x, int y) const
+    {
+        const long long local_x = (long long)x - rect.x;
+        const long long local_y = (long long)y - rect.y;
+        if(local_x < 0 || local_y < 0 || local_x >= rect.width || local_y >= rect.height)return std::nullopt;
+
+        const std::size_t index = (std::size_t)local_y * rect.width + (std::size_t)local_x;
+        if(index >= values.size())return std::nullopt;
+        return values[index];
+    }
+
+    std::optional<std::uint64_t> PixelRegionUint64::nearestNonZero(int x, int y) const
+    {
+        std::optional<std::uint64_t> nearest;
+        long long nearest_distance = std::numeric_limits<long long>::max();
+
+        for(unsigned int row = 0; row < rect.height; ++row)
+        {
+            for(unsigned int column = 0; column < rect.width; ++column)
+            {
+                const std::size_t index = (std::size_t)row * rect.width + column;
+                if(index >= values.size() || values[index] == 0)continue;
+
+                const long long dx = (long long)rect.x + column - x;
+                const long long dy = (long long)rect.y + row - y;
+                const long long distance = dx * dx + dy * dy;
+                if(distance < nearest_distance)
+                {
+                    nearest_distance = distance;
+                    nearest = values[index];
+                }
+            }
+        }
+        return nearest;
+    }
+}
@@ -0,0 +1,133 @@
+#include "render/program_binary_cache.hpp"
+
+#include <format>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+
+#include <spdlog/spdlog.h>
+
+#include "file/file_utils.hpp"
+
+namespace astre::render
+{
+    static constexpr std::uint32_t PROGRAM_BINARY_MAGIC = 0x42505341; // "ASPB"
+    static constexpr std::uint32_t PROGRAM_BINARY_VERSION = 1;
+
+    #pragma pack(push, 1)
+    struct ProgramBinaryHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t key;
+        std::uint32_t format;
+        std::uint64_t size;
+        std::uint64_t checksum; // of the binary data
+    };
+    #pragma pack(pop)
+
+    ProgramBinaryCache::ProgramBinaryCache(std::filesystem::path directory, std::string driver)
+    :   _directory(std::move(directory)),
+        _driver(std::move(driver))
+    {}
+
+    std::uint64_t ProgramBinaryCache::key(const std::vector<std::vector<std::string>> & stages) const
+    {
+        std::uint64_t hash = file::hashBytes(_driver.data(), _driver.size());
+
+        // lengths keep ("ab", "c") and ("a", "bc") apart
+        for(const auto & stage : stages)
+        {
+            const std::uint64_t stage_size = stage.size();
+            hash = file::hashBytes(hash, &stage_size, sizeof(stage_size));
+            for(const auto & source : stage)
+            {
+                const std::uint64_t source_size = source.size();
+                hash = file::hashBytes(hash, &source_size, sizeof(source_size));
+                hash = file::hashBytes(hash, source.data(), source.size());
+            }
+        }
+        return hash;
+    }
+
+    std::optional<ProgramBinary> ProgramBinaryCache::load(std::uint64_t key) const
+    {
+        const std::filesystem::path path = entryPath(key);
+        std::ifstream file(path, std::ios::binary);
+        if(!file.is_open())return std::nullopt;
+
+        std::error_code ec;
+        const std::uintmax_t file_size = std::filesystem::file_size(path, ec);
+        if(ec)return std::nullopt;
+
+        ProgramBinaryHeader header;
+        if(!file.read(reinterpret_cast<char *>(&header), sizeof(header)))return std::nullopt;
+
+        if(header.magic != PROGRAM_BINARY_MAGIC || header.version != PROGRAM_BINARY_VERSION || header.key != key)
+        {
+            spdlog::debug("[render] Program binary cache entry {:016x} has unexpected header", key);
+            return std::nullopt;
+        }
+
+        // checked before allocating, a damaged size must not turn into a huge allocation
+        if(header.size != file_size - sizeof(header))
+        {
+            spdlog::debug("[render] Program binary cache entry {:016x} is truncated", key);
+            return std::nullopt;
+        }
+
+        ProgramBinary binary;
+        binary.format = header.format;
+        binary.data.resize(header.size);
+        if(!file.read(reinterpret_cast<char *>(binary.data.data()), (std::streamsize)binary.data.size()))
+        {
+            spdlog::debug("[render] Program binary cache entry {:016x} is truncated", key);
+            return std::nullopt;
+        }
+
+        if(file::hashBytes(binary.data.data(), binary.data.size()) != header.checksum)
+        {
+            spdlog::debug("[render] Program binary cache entry {:016x} is damaged", key);
+            return std::nullopt;
+        }
+
+        return binary;
+    }
+
+    bool ProgramBinaryCache::store(std::uint64_t key, const ProgramBinary & binary) const
+    {
+        const ProgramBinaryHeader header{
+            .magic = PROGRAM_BINARY_MAGIC,
+            .version = PROGRAM_BINARY_VERSION,
+            .key = key,
+            .format = binary.format,
+            .size = binary.data.size(),
+            .checksum = file::hashBytes(binary.data.data(), binary.data.size())
+        };
+
+        if(!file::writeFileAtomically(entryPath(key), {
+            std::string_view(reinterpret_cast<const char *>(&header), sizeof(header)),
+            std::string_view(reinterpret_cast<const char *>(binary.data.data()), binary.data.size())}))
+        {
+            spdlog::warn("[render] Cannot store program binary cache entry {:016x}", key);
+            return false;
+        }
+        return true;
+    }
+
+    bool ProgramBinaryCache::erase(std::uint64_t key) const
+    {
+        std::error_code ec;
+        return std::filesystem::remove(entryPath(key), ec);
+    }
+
+    const std::filesystem::path & ProgramBinaryCache::directory() const
+    {
+        return _directory;
+    }
+
+    std::filesystem::path ProgramBinaryCache::entryPath(std::uint64_t key) const
+    {
+        return _directory / std::format("{:016x}.bin", key);
+    }
+}
@@ -0,0 +1,128 @@
+#include "render/range_allocator.hpp"
+
+#include <iterator>
+
+namespace astre::render
+{
+    RangeAllocator::RangeAllocator(std::size_t capacity)
+    :   _capacity(capacity),
+        _used(0)
+    {
+        if(_capacity > 0) insertFreeBlock(0, _capacity);
+    }
+
+    std::optional<std::size_t> RangeAllocator::allocate(std::size_t size, std::size_t alignment)
+    {
+        if(size == 0) return std::nullopt;
+        if(alignment == 0) alignment = 1;
+
+        // smallest block that fits, larger blocks are tried only when alignment padding does not fit
+        for(auto it = _free_by_size.lower_bound({size, 0}); it != _free_by_size.end(); ++it)
+        {
+            const auto [block_size, block_offset] = *it;
+
+            const std::size_t aligned = (block_offset + alignment - 1) / alignment * alignment;
+            const std::size_t padding = aligned - block_offset;
+            if(padding + size > block_size) continue;
+
+            eraseFreeBlock(_free_by_offset.find(block_offset));
+
+            // padding and tail stay free
+            if(padding > 0) insertFreeBlock(block_offset, padding);
+            if(padding + size < block_size) insertFreeBlock(aligned + size, block_size - padding - size);
+
+            _allocations.emplace(aligned, size);
+            _used += size;
+            return aligned;
+        }
+
+        return std::nullopt;
+    }
+
+    bool RangeAllocator::free(std::size_t offset)
+    {
+        const auto allocation_it = _allocations.find(offset);
+        if(allocation_it == _allocations.end()) return false;
+
+        std::size_t block_offset = offset;
+        std::size_t block_size = allocation_it->second;
+        _used -= block_size;
+        _allocations.erase(allocation_it);
+
+        // coalesce with free neighbours
+        auto next = _free_by_offset.lower_bound(block_offset);
+        if(next != _free_by_offset.end() && next->first == block_offset + block_size)
+        {
+            block_size += next->second;
+            eraseFreeBlock(next);
+        }
+
+        auto previous = _free_by_offset.lower_bound(block_offset);
+        if(previous != _free_by_offset.begin())
+        {
+            previous = std::prev(previous);
+            if(previous->first + previous->second == block_offset)
+            {
+                block_offset = previous->first;
+                block_size += previous->second;
+                eraseFreeBlock(previous);
+            }
+        }
+
+        insertFreeBlock(block_offset, block_size);
+        return true;
+    }
+
+    void RangeAllocator::grow(std::size_t capacity)
+    {
+        if(capacity <= _capacity) return;
+
+        std::size_t block_offset = _capacity;
+        std::size_t block_size = capacity - _capacity;
+
+        if(_free_by_offset.empty() == false)
+        {
+            auto last = std::prev(_free_by_offset.end());
+            if(last->first + last->second == _capacity)
+            {
+                block_offset = last->first;
+                block_size += last->second;
+                eraseFreeBlock(last);
+            }
+        }
+
+        insertFreeBlock(block_offset, block_size);
+        _capacity = capacity;
+    }
+
+    std::size_t RangeAllocator::capacity() const
+    {
+        return _capacity;
+    }
+
+    RangeAllocatorStats RangeAllocator::stats() const
+    {
+        RangeAllocatorStats stats;
+        stats.capacity = _capacity;
+        stats.used = _used;
+        stats.allocations = _allocations.size();
+        stats.free_blocks = _free_by_offset.size();
+        stats.largest_free_block = _free_by_size.empty() ? 0 : _free_by_size.rbegin()->first;
+
+        const std::size_t free = _capacity - _used;
+        stats.fragmentation = free == 0 ? 0.0f : 1.0f - (float)stats.largest_free_block / (float)free;
+        return stats;
+    }
+
+    void RangeAllocator::insertFreeBlock(std::size_t offset, std::size_t size)
+    {
+        _free_by_offset.emplace(offset, size);
+        _free_by_size.emplace(size, offset);
+    }
+
+    void RangeAllocator::eraseFreeBlock(std::map<std::size_t, std::size_t>::iterator it)
+    {
+        _free_by_size.erase({it->second, it->first});
+        _free_by_offset.erase(it);
+    }
+}
@@ -0,0 +1,143 @@
+#include "render/raycast.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace astre::render
+{
+    TriangleMesh makeTriangleMesh(const Mesh & mesh)
+    {
+        TriangleMesh triangles;
+        triangles.positions.reserve(mesh.vertices.size());
+        for(const auto & vertex : mesh.vertices)
+        {
+            triangles.positions.emplace_back(vertex.position);
+        }
+
+        // drop trailing incomplete triangle
+        const std::size_t index_count = mesh.indices.size() - mesh.indices.size() % 3;
+        triangles.indices.assign(mesh.indices.begin(), mesh.indices.begin() + index_count);
+        return triangles;
+    }
+
+    AABB transformAABB(const BoundingVolume & bounds, const math::Mat4 & model)
+    {
+        // Arvo: extent along every world axis is the sum of absolute matrix terms times local extents
+        const math::Vec3 center = (bounds.aabb_min + bounds.aabb_max) * 0.5f;
+        const math::Vec3 extent = (bounds.aabb_max - bounds.aabb_min) * 0.5f;
+
+        const math::Vec3 world_center(model * math::Vec4(center, 1.0f));
+        math::Vec3 world_extent(0.0f);
+        for(int axis = 0; axis < 3; ++axis)
+        {
+            world_extent[axis] =
+                std::abs(model[0][axis]) * extent.x +
+                std::abs(model[1][axis]) * extent.y +
+                std::abs(model[2][axis]) * extent.z;
+        }
+
+        return AABB{
+            .min = world_center - world_extent,
+            .max = world_center + world_extent
+        };
+    }
+
+    Ray transformRay(const Ray & ray, const math::Mat4 & matrix)
+    {
+        // affine transform keeps the ray parameter, so distances carry over
+        return Ray{
+            .origin = math::Vec3(matrix * math::Vec4(ray.origin, 1.0f)),
+            .direction = math::Vec3(matrix * math::Vec4(ray.direction, 0.0f))
+        };
+    }
+
+    Ray screenPointToRay(const math::Vec2 & ndc, const math::Mat4 & view, const math::Mat4 & projection)
+    {
+        const math::Mat4 inverse_view_projection = glm::inverse(projection * view);
+
+        math::Vec4 near_point = inverse_view_projection * math::Vec4(ndc.x, ndc.y, -1.0f, 1.0f);
+        math::Vec4 far_point = inverse_view_projection * math::Vec4(ndc.x, ndc.y, 1.0f, 1.0f);
+
+        const math::Vec3 origin = math::Vec3(near_point) / near_point.w;
+        const math::Vec3 target = math::Vec3(far_point) / far_point.w;
+
+        return Ray{
+            .origin = origin,
+            .direction = math::normalize(target - origin)
+        };
+    }
+
+    std::optional<float> intersectRayAABB(const Ray & ray, const AABB & box, float max_distance)
+    {
+        float t_min = 0.0f;
+        float t_max = max_distance;
+
+        for(int axis = 0; axis < 3; ++axis)
+        {
+            const float origin = ray.origin[axis];
+            const float direction = ray.direction[axis];
+
+            if(std::abs(direction) < std::numeric_limits<float>::epsilon())
+            {
+                // parallel to the slab, must already be between its planes
+                if(origin < box.min[axis] || origin > box.max[axis])return std::nullopt;
+                continue;
+            }
+
+            const float inverse_direction = 1.0f / direction;
+            float t_near = (box.min[axis] - origin) * inverse_direction;
+            float t_far = (box.max[axis] - origin) * inverse_direction;
+            if(t_near > t_far)std::swap(t_near, t_far);
+
+            t_min = std::max(t_min, t_near);
+            t_max = std::min(t_max, t_far);
+            if(t_min > t_max)return std::nullopt;
+        }
+
+        return t_min;
+    }
+
+    std::optional<float> intersectRayTriangle(const Ray & ray, const math::Vec3 & a, const math::Vec3 & b, const math::Vec3 & c)
+    {
+        constexpr float EPSILON = 1e-7f;
+
+        const math::Vec3 edge_1 = b - a;
+        const math::Vec3 edge_2 = c - a;
+        const math::Vec3 p = glm::cross(ray.direction, edge_2);
+        const float determinant = glm::dot(edge_1, p);
+        if(std::abs(determinant) < EPSILON)return std::nullopt;
+
+        const float inverse_determinant = 1.0f / determinant;
+        const math::Vec3 s = ray.origin - a;
+        const float u = glm::dot(s, p) * inverse_determinant;
+        if(u < 0.0f || u > 1.0f)return std::nullopt;
+
+        const math::Vec3 q = glm::cross(s, edge_1);
+        const float v = glm::dot(ray.direction, q) * inverse_determinant;
+        if(v < 0.0f || u + v > 1.0f)return std::nullopt;
+
+        const float t = glm::dot(edge_2, q) * inverse_determinant;
+        if(t < 0.0f)return std::nullopt;
+        return t;
+    }
+
+    std::optional<float> intersectRayMesh(const Ray & ray, const TriangleMesh & mesh, float max_distance)
+    {
+        std::optional<float> closest;
+        for(std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            const unsigned int i0 = mesh.indices[i];
+            const unsigned int i1 = mesh.indices[i + 1];
+            const unsigned int i2 = mesh.indices[i + 2];
+            if(i0 >= mesh.positions.size() || i1 >= mesh.positions.size() || i2 >= mesh.positions.size())continue;
+
+            const auto t = intersectRayTriangle(ray, mesh.positions[i0], mesh.positions[i1], mesh.positions[i2]);
+            if(t && *t <= max_distance && (!closest || *t < *closest))
+            {
+                closest = t;
+            }
+        }
+        return closest;
+    }
+}
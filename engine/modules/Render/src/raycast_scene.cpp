@@ -0,0 +1,81 @@
+#include "render/raycast_scene.hpp"
+
+#include <algorithm>
+
+namespace astre::render
+{
+    void RaycastScene::update(const absl::flat_hash_map<std::size_t, RenderProxy> & proxies, const IRenderer & renderer)
+    {
+        std::vector<Entry> entries;
+        std::vector<AABB> boxes;
+        entries.reserve(proxies.size());
+        boxes.reserve(proxies.size());
+
+        std::vector<std::size_t> order;
+        order.reserve(proxies.size());
+        for(const auto & [entity, proxy] : proxies)
+        {
+            if(proxy.visible == false || proxy.bounds.has_value() == false)continue;
+            if(hasFlags(proxy.phases & RenderPhase::Opaque) == false)continue;
+            if(proxy.inputs.in_mat4.contains("uModel") == false)continue;
+            order.push_back(entity);
+        }
+
+        // map iteration order is unspecified, sorted ids let an unchanged set be refitted
+        std::ranges::sort(order);
+
+        for(const std::size_t entity : order)
+        {
+            const RenderProxy & proxy = proxies.at(entity);
+            const math::Mat4 & model = proxy.inputs.in_mat4.at("uModel");
+
+            entries.push_back(Entry{
+                .entity = entity,
+                .model = model,
+                .box = transformAABB(*proxy.bounds, model),
+                .triangles = renderer.getVertexBufferTriangles(proxy.vertex_buffer)
+            });
+            boxes.push_back(entries.back().box);
+        }
+
+        const bool same_entities = std::ranges::equal(entries, _entries,
+            [](const Entry & a, const Entry & b){ return a.entity == b.entity; });
+
+        _entries = std::move(entries);
+
+        if(same_entities && _bvh.refit(boxes))return;
+        _bvh.build(std::move(boxes));
+    }
+
+    std::optional<RaycastHit> RaycastScene::raycast(const Ray & ray, float max_distance, bool exact) const
+    {
+        BoundingVolumeHierarchy::ItemTest triangle_test;
+        if(exact)
+        {
+            triangle_test = [this, &ray](std::size_t item, float closest_distance) -> std::optional<float>
+            {
+                const Entry & entry = _entries[item];
+                if(entry.triangles == nullptr)
+                {
+                    return intersectRayAABB(ray, entry.box, closest_distance);
+                }
+
+                return intersectRayMesh(transformRay(ray, glm::inverse(entry.model)), *entry.triangles, closest_distance);
+            };
+        }
+
+        const auto hit = _bvh.raycast(ray, max_distance, triangle_test);
+        if(!hit)return std::nullopt;
+
+        return RaycastHit{
+            .entity = _entries[hit->item].entity,
+            .distance = hit->distance,
+            .position = ray.origin + ray.direction * hit->distance
+        };
+    }
+
+    std::size_t RaycastScene::size() const
+    {
+        return _entries.size();
+    }
+}
@@ -0,0 +1,106 @@
+#include "render/shadow_atlas.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+namespace astre::render
+{
+    ShadowAtlas::ShadowAtlas(unsigned int size, unsigned int min_tile_size)
+        :   _size(std::bit_floor(std::max(size, 1u))),
+            _min_tile_size(std::min(std::bit_floor(std::max(min_tile_size, 1u)), _size))
+    {}
+
+    unsigned int ShadowAtlas::size() const
+    {
+        return _size;
+    }
+
+    unsigned int ShadowAtlas::minTileSize() const
+    {
+        return _min_tile_size;
+    }
+
+    std::vector<std::optional<ViewportRect>> ShadowAtlas::allocate(const std::vector<unsigned int> & tile_sizes) const
+    {
+        std::vector<std::optional<ViewportRect>> tiles(tile_sizes.size(), std::nullopt);
+
+        std::vector<unsigned int> sizes(tile_sizes.size());
+        for(std::size_t i = 0; i < tile_sizes.size(); ++i)
+        {
+            sizes[i] = std::clamp(std::bit_floor(std::max(tile_sizes[i], 1u)), _min_tile_size, _size);
+        }
+
+        // largest first, ties keep request order
+        std::vector<std::size_t> order(tile_sizes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){ return sizes[a] > sizes[b]; });
+
+        // downgrade smallest tiles first until requested area fits into the atlas,
+        // drop the last ones when even the minimum tiles do not fit
+        const std::uint64_t atlas_area = (std::uint64_t)_size * _size;
+        std::uint64_t area = 0;
+        for(const auto s : sizes)area += (std::uint64_t)s * s;
+
+        while(area > atlas_area && order.empty() == false)
+        {
+            auto it = std::find_if(order.rbegin(), order.rend(), [&](std::size_t i){ return sizes[i] > _min_tile_size; });
+            if(it == order.rend())
+            {
+                area -= (std::uint64_t)sizes[order.back()] * sizes[order.back()];
+                order.pop_back();
+                continue;
+            }
+            area -= (std::uint64_t)sizes[*it] * sizes[*it];
+            sizes[*it] /= 2;
+            area += (std::uint64_t)sizes[*it] * sizes[*it];
+        }
+
+        // served largest first every free square is at least as big as the current request,
+        // so tiles pack without holes
+        std::vector<ViewportRect> free_tiles{ViewportRect{0, 0, (int)_size, (int)_size}};
+
+        for(const auto i : order)
+        {
+            const int tile_size = (int)sizes[i];
+
+            // smallest free square that can fit the tile, lowest position on ties
+            auto best = free_tiles.end();
+            for(auto it = free_tiles.begin(); it != free_tiles.end(); ++it)
+            {
+                if(it->width < tile_size)continue;
+                if(best == free_tiles.end() || it->width < best->width ||
+                    (it->width == best->width && std::pair(it->y, it->x) < std::pair(best->y, best->x)))
+                {
+                    best = it;
+                }
+            }
+            if(best == free_tiles.end())continue;
+
+            ViewportRect tile = *best;
+            free_tiles.erase(best);
+
+            // split down to requested size, returning unused quadrants
+            while(tile.width > tile_size)
+            {
+                const int half = tile.width / 2;
+                free_tiles.push_back({tile.x + half, tile.y, half, half});
+                free_tiles.push_back({tile.x, tile.y + half, half, half});
+                free_tiles.push_back({tile.x + half, tile.y + half, half, half});
+                tile = {tile.x, tile.y, half, half};
+            }
+
+            tiles[i] = tile;
+        }
+
+        return tiles;
+    }
+
+    math::Vec4 ShadowAtlas::toUV(const ViewportRect & tile) const
+    {
+        const float size = (float)_size;
+        return math::Vec4{
+            (float)tile.x / size, (float)tile.y / size,
+            (float)tile.width / size, (float)tile.height / size};
+    }
+}
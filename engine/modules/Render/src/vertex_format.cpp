@@ -0,0 +1,186 @@
+#include "render/vertex_format.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace astre::render
+{
+    static_assert(sizeof(CompactGPUVertex) == 20, "CompactGPUVertex must be tightly packed");
+    static_assert(sizeof(QuantizedGPUVertex) == 16, "QuantizedGPUVertex must be tightly packed");
+
+    std::size_t vertexStride(VertexFormat format)
+    {
+        switch(format)
+        {
+            case VertexFormat::Compact: return sizeof(CompactGPUVertex);
+            case VertexFormat::Quantized: return sizeof(QuantizedGPUVertex);
+            case VertexFormat::Full:
+            default: return sizeof(GPUVertex);
+        }
+    }
+
+    static float _signNotZero(float value)
+    {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    static std::int16_t _toSnorm16(float value)
+    {
+        return (std::int16_t)std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f);
+    }
+
+    std::array<std::int16_t, 2> encodeOctahedralNormal(const math::Vec3 & normal)
+    {
+        const float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if(l1 <= 0.0f) return {0, 0};
+
+        float x = normal.x / l1;
+        float y = normal.y / l1;
+
+        // lower hemisphere is folded over the diagonals
+        if(normal.z < 0.0f)
+        {
+            const float folded_x = (1.0f - std::abs(y)) * _signNotZero(x);
+            const float folded_y = (1.0f - std::abs(x)) * _signNotZero(y);
+            x = folded_x;
+            y = folded_y;
+        }
+
+        return {_toSnorm16(x), _toSnorm16(y)};
+    }
+
+    math::Vec3 decodeOctahedralNormal(const std::array<std::int16_t, 2> & encoded)
+    {
+        const float x = std::max((float)encoded[0] / 32767.0f, -1.0f);
+        const float y = std::max((float)encoded[1] / 32767.0f, -1.0f);
+
+        math::Vec3 normal(x, y, 1.0f - std::abs(x) - std::abs(y));
+        if(normal.z < 0.0f)
+        {
+            normal.x = (1.0f - std::abs(y)) * _signNotZero(x);
+            normal.y = (1.0f - std::abs(x)) * _signNotZero(y);
+        }
+
+        const float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+        return length > 0.0f ? normal / length : math::Vec3(0.0f, 0.0f, 1.0f);
+    }
+
+    std::uint16_t floatToHalf(float value)
+    {
+        const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+        const std::uint16_t sign = (std::uint16_t)((bits >> 16) & 0x8000u);
+        const std::uint32_t exponent = (bits >> 23) & 0xFFu;
+        std::uint32_t mantissa = bits & 0x7FFFFFu;
+
+        // NaN and infinity
+        if(exponent == 0xFFu) return sign | 0x7C00u | (mantissa ? 0x200u : 0u);
+
+        const int half_exponent = (int)exponent - 127 + 15;
+
+        // overflow to infinity
+        if(half_exponent >= 0x1F) return sign | 0x7C00u;
+
+        // subnormal or zero
+        if(half_exponent <= 0)
+        {
+            if(half_exponent < -10) return sign;
+            mantissa |= 0x800000u;
+            const unsigned shift = (unsigned)(14 - half_exponent);
+            std::uint32_t half_mantissa = mantissa >> shift;
+            // round to nearest even
+            const std::uint32_t remainder = mantissa & ((1u << shift) - 1u);
+            const std::uint32_t halfway = 1u << (shift - 1u);
+            if(remainder > halfway || (remainder == halfway && (half_mantissa & 1u))) half_mantissa++;
+            return sign | (std::uint16_t)half_mantissa;
+        }
+
+        std::uint32_t half = ((std::uint32_t)half_exponent << 10) | (mantissa >> 13);
+        // round to nearest even, carry may propagate into exponent which is still correct
+        const std::uint32_t remainder = mantissa & 0x1FFFu;
+        if(remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) half++;
+        return sign | (std::uint16_t)half;
+    }
+
+    float halfToFloat(std::uint16_t value)
+    {
+        const std::uint32_t sign = (std::uint32_t)(value & 0x8000u) << 16;
+        const std::uint32_t exponent = (value >> 10) & 0x1Fu;
+        std::uint32_t mantissa = value & 0x3FFu;
+
+        if(exponent == 0)
+        {
+            if(mantissa == 0) return std::bit_cast<float>(sign);
+            // subnormal
+            const float magnitude = std::ldexp((float)mantissa, -24);
+            return sign ? -magnitude : magnitude;
+        }
+        if(exponent == 0x1Fu) return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+
+        return std::bit_cast<float>(sign | ((exponent - 15 + 127) << 23) | (mantissa << 13));
+    }
+
+    VertexQuantization computeVertexQuantization(const std::vector<GPUVertex> & vertices, VertexFormat format)
+    {
+        VertexQuantization quantization;
+        if(format != VertexFormat::Quantized || vertices.empty()) return quantization;
+
+        math::Vec3 aabb_min(std::numeric_limits<float>::max());
+        math::Vec3 aabb_max(std::numeric_limits<float>::lowest());
+        for(const auto & vertex : vertices)
+        {
+            aabb_min = glm::min(aabb_min, vertex.position);
+            aabb_max = glm::max(aabb_max, vertex.position);
+        }
+
+        quantization.offset = aabb_min;
+        // flat axes keep non-zero scale, stored value is 0 on them anyway
+        quantization.scale = glm::max(aabb_max - aabb_min, math::Vec3(std::numeric_limits<float>::min()));
+        return quantization;
+    }
+
+    std::vector<CompactGPUVertex> toCompactVertices(const std::vector<GPUVertex> & vertices)
+    {
+        std::vector<CompactGPUVertex> compact;
+        compact.reserve(vertices.size());
+        for(const auto & vertex : vertices)
+        {
+            compact.emplace_back(CompactGPUVertex{
+                .position = vertex.position,
+                .normal = encodeOctahedralNormal(vertex.normal),
+                .uv = {floatToHalf(vertex.uv.x), floatToHalf(vertex.uv.y)}
+            });
+        }
+        return compact;
+    }
+
+    static std::uint16_t _toUnorm16(float value, float offset, float scale)
+    {
+        return (std::uint16_t)std::lround(std::clamp((value - offset) / scale, 0.0f, 1.0f) * 65535.0f);
+    }
+
+    std::vector<QuantizedGPUVertex> toQuantizedVertices(const std::vector<GPUVertex> & vertices, const VertexQuantization & quantization)
+    {
+        std::vector<QuantizedGPUVertex> quantized;
+        quantized.reserve(vertices.size());
+        for(const auto & vertex : vertices)
+        {
+            quantized.emplace_back(QuantizedGPUVertex{
+                .position = {
+                    _toUnorm16(vertex.position.x, quantization.offset.x, quantization.scale.x),
+                    _toUnorm16(vertex.position.y, quantization.offset.y, quantization.scale.y),
+                    _toUnorm16(vertex.position.z, quantization.offset.z, quantization.scale.z),
+                    0},
+                .normal = encodeOctahedralNormal(vertex.normal),
+                .uv = {floatToHalf(vertex.uv.x), floatToHalf(vertex.uv.y)}
+            });
+        }
+        return quantized;
+    }
+
+    std::size_t indexSize(std::size_t vertex_count)
+    {
+        return vertex_count <= (std::size_t)std::numeric_limits<std::uint16_t>::max() + 1 ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+    }
+}
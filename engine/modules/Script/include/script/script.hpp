@@ -1,6 +1,8 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -11,6 +13,16 @@
 
 namespace astre::script
 {
+    struct RaycastResult
+    {
+        std::size_t entity;
+        float distance;
+        math::Vec3 position;
+    };
+
+    // world space ray query provided by the host, direction is normalized
+    using RaycastFunction = std::function<std::optional<RaycastResult>(const math::Vec3 & origin, const math::Vec3 & direction, float max_distance)>;
+
     class ScriptRuntime
     {
     public:
@@ -28,10 +40,16 @@ namespace astre::script
 
         const sol::function & getScript(const std::string & name) const { return _scripts.at(name); }
 
+        // backs `astre.raycast`, which returns nil until it is set
+        void setRaycastFunction(RaycastFunction raycast) { _raycast = std::move(raycast); }
+
     private:
+        static constexpr float DEFAULT_RAYCAST_DISTANCE = 1000.0f;
+
         void bindMath();
         void bindUtility();
         void bindComponents();
+        void bindQueries();
 
         sol::state _lua;
         sol::table _astre_table;
@@ -39,6 +57,8 @@ namespace astre::script
         absl::flat_hash_map<std::string, sol::function> _scripts;
 
         absl::flat_hash_map<std::size_t, sol::environment> _environments;
+
+        RaycastFunction _raycast;
     };
 
 }
@@ -17,6 +17,7 @@ namespace astre::script
         bindMath();
         bindUtility();
         bindComponents();
+        bindQueries();
     }
 
     ScriptRuntime::~ScriptRuntime()
@@ -150,6 +151,28 @@ namespace astre::script
         );
     }
 
+    void ScriptRuntime::bindQueries()
+    {
+        spdlog::debug("[script] Binding world queries");
+
+        assert(_astre_table.valid());
+
+        _astre_table.new_usertype<RaycastResult>("RaycastResult",
+            sol::no_constructor,
+            "entity", sol::readonly(&RaycastResult::entity),
+            "distance", sol::readonly(&RaycastResult::distance),
+            "position", sol::readonly(&RaycastResult::position)
+        );
+
+        // astre.raycast(origin, direction [, max_distance]) -> RaycastResult or nil
+        _astre_table.set_function("raycast", [this](const math::Vec3 & origin, const math::Vec3 & direction, sol::optional<float> max_distance)
+            -> std::optional<RaycastResult>
+        {
+            if(!_raycast || math::length(direction) <= 0.0f) return std::nullopt;
+            return _raycast(origin, math::normalize(direction), max_distance.value_or(DEFAULT_RAYCAST_DISTANCE));
+        });
+    }
+
     sol::environment & ScriptRuntime::getEnviroment(std::size_t id)
     {
         if(_environments.contains(id))
@@ -3,6 +3,15 @@ layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTex;
 
+// vertex decoding, set by renderer from the vertex buffer format
+uniform vec3 uPositionOffset;
+uniform vec3 uPositionScale;
+
+vec3 decodePosition(vec3 p)
+{
+    return uPositionOffset + p * uPositionScale;
+}
+
 uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProjection;
@@ -11,7 +20,7 @@ out vec3 WorldPos;
 
 void main()
 {
-    vec4 wp = uModel * vec4(aPos, 1.0);
+    vec4 wp = uModel * vec4(decodePosition(aPos), 1.0);
     WorldPos = wp.xyz;
     gl_Position = uProjection * uView * wp;
 }
\ No newline at end of file
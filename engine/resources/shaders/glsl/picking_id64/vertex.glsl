@@ -4,11 +4,20 @@ layout(location=0) in vec3 aPos;
 layout(location=1) in vec3 aNormal;
 layout(location=2) in vec2 aUV;
 
+// vertex decoding, set by renderer from the vertex buffer format
+uniform vec3 uPositionOffset;
+uniform vec3 uPositionScale;
+
+vec3 decodePosition(vec3 p)
+{
+    return uPositionOffset + p * uPositionScale;
+}
+
 uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProjection;
 
 void main()
 {
-    gl_Position = uProjection * uView * uModel * vec4(aPos,1.0);
+    gl_Position = uProjection * uView * uModel * vec4(decodePosition(aPos),1.0);
 }
\ No newline at end of file
@@ -1,11 +1,53 @@
-#version 330 core
+#version 450 core
+#extension GL_ARB_shader_draw_parameters : enable
 
 layout(location = 0) in vec3 aPos;
 
-uniform mat4 uModel;
+// vertex decoding, set by renderer from the vertex buffer format
+uniform vec3 uPositionOffset;
+uniform vec3 uPositionScale;
+
+// per-draw data of multi-draw indirect submission, draw starts at uDrawBase
+struct GPUDraw {
+    vec4 positionOffset;
+    vec4 positionScale;
+};
+
+layout(std430, binding = 6) readonly buffer DrawBuffer {
+    GPUDraw draws[];
+};
+uniform uint uIndirect;
+uniform uint uDrawBase;
+
+vec3 decodePosition(vec3 p, vec3 offset, vec3 scale)
+{
+    return offset + p * scale;
+}
+
+struct GPUInstance {
+    mat4 model;
+    vec4 color;
+};
+
+layout(std430, binding = 3) readonly buffer InstanceBuffer {
+    GPUInstance instances[];
+};
+uniform uint uInstanceBase;
+
 uniform mat4 uLightSpaceMatrix;
 
 void main()
 {
-    gl_Position = uLightSpaceMatrix * uModel * vec4(aPos, 1.0);
+    uint instanceIndex = uInstanceBase + gl_InstanceID;
+    vec3 positionOffset = uPositionOffset;
+    vec3 positionScale = uPositionScale;
+#ifdef GL_ARB_shader_draw_parameters
+    if(uIndirect != 0u)
+    {
+        instanceIndex = gl_BaseInstanceARB + gl_InstanceID;
+        positionOffset = draws[uDrawBase + gl_DrawIDARB].positionOffset.xyz;
+        positionScale = draws[uDrawBase + gl_DrawIDARB].positionScale.xyz;
+    }
+#endif
+    gl_Position = uLightSpaceMatrix * instances[instanceIndex].model * vec4(decodePosition(aPos, positionOffset, positionScale), 1.0);
 }
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+
+#include "asset/chunk_prefetcher.hpp"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    constexpr float CHUNK_SIZE = 10.0f;
+
+    astre::proto::file::ChunkID chunkId(int x, int y, int z)
+    {
+        astre::proto::file::ChunkID id;
+        id.set_x(x);
+        id.set_y(y);
+        id.set_z(z);
+        return id;
+    }
+
+    // flat world, one layer of chunks
+    absl::flat_hash_set<astre::proto::file::ChunkID> flatWorld(int half_extent)
+    {
+        absl::flat_hash_set<astre::proto::file::ChunkID> chunks;
+        for(int x = -half_extent; x <= half_extent; ++x)
+            for(int z = -half_extent; z <= half_extent; ++z)
+                chunks.insert(chunkId(x, 0, z));
+        return chunks;
+    }
+
+    absl::flat_hash_set<astre::proto::file::ChunkID> ids(astre::asset::PrefetchQueue queue)
+    {
+        absl::flat_hash_set<astre::proto::file::ChunkID> out;
+        for(; !queue.empty(); queue.pop()) out.insert(queue.top().id);
+        return out;
+    }
+}
+
+TEST(ChunkPrefetcherTest, NothingBeforeFirstUpdate)
+{
+    const astre::asset::ChunkPrefetcher prefetcher(CHUNK_SIZE);
+    EXPECT_TRUE(prefetcher.predict(chunkId(0, 0, 0), astre::asset::StreamingRadius{}, flatWorld(8)).empty());
+}
+
+TEST(ChunkPrefetcherTest, EstimatesVelocityFromPositions)
+{
+    astre::asset::ChunkPrefetcher prefetcher(CHUNK_SIZE, {.velocity_smoothing = 1.0f});
+    const auto start = std::chrono::steady_clock::now();
+
+    prefetcher.update({0.0f, 0.0f, 0.0f}, start);
+    prefetcher.update({20.0f, 0.0f, -10.0f}, start + 2s);
+
+    EXPECT_FLOAT_EQ(prefetcher.velocity().x, 10.0f);
+    EXPECT_FLOAT_EQ(prefetcher.velocity().y, 0.0f);
+    EXPECT_FLOAT_EQ(prefetcher.velocity().z, -5.0f);
+}
+
+TEST(ChunkPrefetcherTest, StillCameraPrefetchesOnlyTheAdjacentRing)
+{
+    astre::asset::ChunkPrefetcher prefetcher(CHUNK_SIZE);
+    const auto start = std::chrono::steady_clock::now();
+    prefetcher.update({5.0f, 5.0f, 5.0f}, start);
+    prefetcher.update({5.0f, 5.0f, 5.0f}, start + 100ms);
+
+    const auto predicted = ids(prefetcher.predict(chunkId(0, 0, 0), astre::asset::StreamingRadius{}, flatWorld(8)));
+    ASSERT_FALSE(predicted.empty());
+    for(const auto & id : predicted)
+    {
+        EXPECT_EQ(std::max(std::abs(id.x()), std::abs(id.z())), 2);
+        EXPECT_EQ(id.y(), 0);
+    }
+    EXPECT_TRUE(predicted.contains(chunkId(2, 0, 0)));
+    EXPECT_TRUE(predicted.contains(chunkId(-2, 0, 0)));
+    EXPECT_TRUE(predicted.contains(chunkId(0, 0, 2)));
+}
+
+TEST(ChunkPrefetcherTest, MovingCameraReachesFurtherAheadThanBehind)
+{
+    astre::asset::ChunkPrefetcher prefetcher(CHUNK_SIZE, {.velocity_smoothing = 1.0f});
+    const auto start = std::chrono::steady_clock::now();
+    // 3 chunks per second along +x
+    prefetcher.update({-25.0f, 5.0f, 5.0f}, start);
+    prefetcher.update({5.0f, 5.0f, 5.0f}, start + 1s);
+
+    auto queue = prefetcher.predict(chunkId(0, 0, 0), astre::asset::StreamingRadius{}, flatWorld(8));
+    ASSERT_FALSE(queue.empty());
+
+    // most urgent request lies in the direction of travel
+    EXPECT_GT(queue.top().id.x(), 0);
+
+    const auto predicted = ids(queue);
+    EXPECT_TRUE(predicted.contains(chunkId(4, 0, 0)));
+    EXPECT_FALSE(predicted.contains(chunkId(-4, 0, 0)));
+    EXPECT_FALSE(predicted.contains(chunkId(0, 0, 0)));
+}
+
+TEST(ChunkPrefetcherTest, RequestsAreOrderedByTimeToArrival)
+{
+    astre::asset::ChunkPrefetcher prefetcher(CHUNK_SIZE, {.velocity_smoothing = 1.0f});
+    const auto start = std::chrono::steady_clock::now();
+    prefetcher.update({-5.0f, 5.0f, 5.0f}, start);
+    prefetcher.update({5.0f, 5.0f, 5.0f}, start + 1s);
+
+    auto queue = prefetcher.predict(chunkId(0, 0, 0), astre::asset::StreamingRadius{}, flatWorld(8));
+    float previous = 0.0f;
+    for(; !queue.empty(); queue.pop())
+    {
+        EXPECT_GE(queue.top().time_to_arrival, previous);
+        EXPECT_LE(queue.top().time_to_arrival, prefetcher.settings().lookahead);
+        previous = queue.top().time_to_arrival;
+    }
+}
+
+TEST(ChunkPrefetcherTest, SkipsChunksMissingFromTheArchive)
+{
+    astre::asset::ChunkPrefetcher prefetcher(CHUNK_SIZE);
+    const auto start = std::chrono::steady_clock::now();
+    prefetcher.update({5.0f, 5.0f, 5.0f}, start);
+
+    const absl::flat_hash_set<astre::proto::file::ChunkID> available{chunkId(2, 0, 0), chunkId(1, 0, 0)};
+    const auto predicted = ids(prefetcher.predict(chunkId(0, 0, 0), astre::asset::StreamingRadius{}, available));
+
+    EXPECT_EQ(predicted.size(), 1u);
+    EXPECT_TRUE(predicted.contains(chunkId(2, 0, 0)));
+}
+
+TEST(ChunkPrefetcherTest, RingFollowsTheShapeOfTheLoadRadius)
+{
+    astre::asset::ChunkPrefetcher prefetcher(CHUNK_SIZE);
+    const auto start = std::chrono::steady_clock::now();
+    prefetcher.update({5.0f, 5.0f, 5.0f}, start);
+
+    const astre::asset::StreamingRadius load{.shape = astre::asset::RadiusShape::Sphere, .x = 2, .y = 0, .z = 1};
+    const auto predicted = ids(prefetcher.predict(chunkId(0, 0, 0), load, flatWorld(8)));
+    ASSERT_FALSE(predicted.empty());
+    for(const auto & id : predicted)
+        EXPECT_FALSE(load.contains(id.x(), id.y(), id.z()));
+
+    EXPECT_TRUE(predicted.contains(chunkId(3, 0, 0)));
+    EXPECT_TRUE(predicted.contains(chunkId(0, 0, 2)));
+    EXPECT_FALSE(predicted.contains(chunkId(2, 0, 0)));
+}
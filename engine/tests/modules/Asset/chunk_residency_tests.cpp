@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include "asset/chunk_residency.hpp"
+
+namespace
+{
+    astre::proto::file::ChunkID chunkId(int x)
+    {
+        astre::proto::file::ChunkID id;
+        id.set_x(x);
+        return id;
+    }
+
+    const auto any_chunk = [](const astre::proto::file::ChunkID &){ return true; };
+}
+
+TEST(StreamingRadiusTest, BoxContainsEveryChunkWithinEachAxis)
+{
+    const astre::asset::StreamingRadius radius{.shape = astre::asset::RadiusShape::Box, .x = 2, .y = 0, .z = 1};
+
+    EXPECT_TRUE(radius.contains(0, 0, 0));
+    EXPECT_TRUE(radius.contains(2, 0, -1));
+    EXPECT_TRUE(radius.contains(-2, 0, 1));
+    EXPECT_FALSE(radius.contains(3, 0, 0));
+    EXPECT_FALSE(radius.contains(0, 1, 0));
+    EXPECT_FALSE(radius.contains(0, 0, 2));
+}
+
+TEST(StreamingRadiusTest, SphereDropsTheCorners)
+{
+    const astre::asset::StreamingRadius radius{.shape = astre::asset::RadiusShape::Sphere};
+
+    EXPECT_TRUE(radius.contains(1, 0, 0));
+    EXPECT_TRUE(radius.contains(1, 1, 0));
+    EXPECT_FALSE(radius.contains(1, 1, 1));
+    EXPECT_FALSE(radius.contains(2, 0, 0));
+}
+
+TEST(StreamingRadiusTest, GrownKeepsShape)
+{
+    const astre::asset::StreamingRadius radius{.shape = astre::asset::RadiusShape::Sphere, .x = 1, .y = 0, .z = 2};
+    const auto unload = radius.grown(1);
+
+    EXPECT_EQ(unload.shape, astre::asset::RadiusShape::Sphere);
+    EXPECT_EQ(unload.x, 2);
+    EXPECT_EQ(unload.y, 1);
+    EXPECT_EQ(unload.z, 3);
+    EXPECT_EQ(unload.largest(), 3);
+}
+
+TEST(ChunkResidencyTest, UnlimitedBudgetEvictsNothing)
+{
+    astre::asset::ChunkResidency residency;
+    for(int i = 0; i < 100; ++i) residency.touch(chunkId(i));
+
+    EXPECT_TRUE(residency.overBudget({}, any_chunk).empty());
+}
+
+TEST(ChunkResidencyTest, EvictsLeastRecentlyUsedFirst)
+{
+    astre::asset::ChunkResidency residency;
+    for(int i = 0; i < 4; ++i) residency.touch(chunkId(i));
+    residency.touch(chunkId(0)); // 0 is now the most recent
+
+    const auto evicted = residency.overBudget({.max_chunks = 2}, any_chunk);
+    ASSERT_EQ(evicted.size(), 2u);
+    EXPECT_EQ(evicted[0].x(), 1);
+    EXPECT_EQ(evicted[1].x(), 2);
+}
+
+TEST(ChunkResidencyTest, SkipsChunksThatMustStay)
+{
+    astre::asset::ChunkResidency residency;
+    for(int i = 0; i < 4; ++i) residency.touch(chunkId(i));
+
+    const auto evicted = residency.overBudget({.max_chunks = 1},
+        [](const astre::proto::file::ChunkID & id){ return id.x() != 0 && id.x() != 1; });
+
+    // the budget can't be met, everything allowed goes
+    ASSERT_EQ(evicted.size(), 2u);
+    EXPECT_EQ(evicted[0].x(), 2);
+    EXPECT_EQ(evicted[1].x(), 3);
+}
+
+TEST(ChunkResidencyTest, ByteBudget)
+{
+    astre::asset::ChunkResidency residency;
+    for(int i = 0; i < 3; ++i)
+    {
+        residency.touch(chunkId(i));
+        residency.resize(chunkId(i), 100);
+    }
+    residency.resize(chunkId(0), 500);
+    EXPECT_EQ(residency.bytes(), 700u);
+
+    const auto evicted = residency.overBudget({.max_bytes = 250}, any_chunk);
+    ASSERT_EQ(evicted.size(), 1u);
+    EXPECT_EQ(evicted[0].x(), 0);
+
+    residency.forget(chunkId(0));
+    EXPECT_EQ(residency.bytes(), 200u);
+    EXPECT_EQ(residency.chunks(), 2u);
+    EXPECT_FALSE(residency.contains(chunkId(0)));
+}
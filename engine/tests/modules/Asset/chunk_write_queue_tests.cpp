@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+#include "asset/chunk_write_queue.hpp"
+
+using namespace std::chrono_literals;
+
+class ChunkWriteQueueTest : public ::testing::Test {
+protected:
+    std::filesystem::path temp_dir;
+    std::shared_ptr<astre::file::IWorldFile> archive;
+
+    void SetUp() override {
+        temp_dir = std::filesystem::current_path() / "chunk_write_queue_test_data";
+        std::filesystem::create_directories(temp_dir);
+        archive = astre::file::openWorldArchive(temp_dir / "world.bin", astre::file::use_binary);
+        ASSERT_NE(archive, nullptr);
+    }
+
+    void TearDown() override {
+        archive.reset();
+        std::filesystem::remove_all(temp_dir);
+    }
+
+    static astre::proto::file::WorldChunk chunk(int x, const std::string & name) {
+        astre::proto::file::WorldChunk chunk;
+        chunk.mutable_id()->set_x(x);
+        chunk.add_entities()->set_name(name);
+        return chunk;
+    }
+
+    static bool drain(astre::asset::ChunkWriteQueue & queue) {
+        asio::io_context context;
+        auto future = asio::co_spawn(context, queue.drain(), asio::use_future);
+        context.run();
+        return future.get();
+    }
+};
+
+TEST_F(ChunkWriteQueueTest, CoalescesWritesOfTheSameChunk) {
+    astre::asset::ChunkWriteQueue queue(1h);
+    queue.open(archive);
+
+    queue.push(chunk(1, "first"));
+    queue.push(chunk(1, "second"));
+    queue.push(chunk(2, "other"));
+    EXPECT_EQ(queue.size(), 2u);
+
+    // not written before the latency bound, but visible to readers
+    EXPECT_FALSE(archive->getAllChunks().contains(chunk(1, "").id()));
+    ASSERT_TRUE(queue.pending(chunk(1, "").id()).has_value());
+    EXPECT_EQ(queue.pending(chunk(1, "").id())->entities(0).name(), "second");
+
+    ASSERT_TRUE(drain(queue));
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_FALSE(queue.pending(chunk(1, "").id()).has_value());
+
+    const auto written = archive->read(chunk(1, "").id());
+    ASSERT_TRUE(written.has_value());
+    EXPECT_EQ(written->entities(0).name(), "second");
+    EXPECT_TRUE(archive->getAllChunks().contains(chunk(2, "").id()));
+}
+
+TEST_F(ChunkWriteQueueTest, FlushesWithinLatencyBound) {
+    astre::asset::ChunkWriteQueue queue(10ms);
+    queue.open(archive);
+    queue.push(chunk(3, "late"));
+
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while(queue.size() > 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(1ms);
+
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_TRUE(archive->read(chunk(3, "").id()).has_value());
+}
+
+TEST_F(ChunkWriteQueueTest, DiscardDropsQueuedSnapshot) {
+    astre::asset::ChunkWriteQueue queue(1h);
+    queue.open(archive);
+
+    queue.push(chunk(4, "stale"));
+    queue.discard(chunk(4, "").id());
+
+    ASSERT_TRUE(drain(queue));
+    EXPECT_FALSE(archive->getAllChunks().contains(chunk(4, "").id()));
+}
+
+TEST_F(ChunkWriteQueueTest, DestructorWritesQueuedChunks) {
+    {
+        astre::asset::ChunkWriteQueue queue(1h);
+        queue.open(archive);
+        queue.push(chunk(5, "shutdown"));
+    }
+
+    const auto written = archive->read(chunk(5, "").id());
+    ASSERT_TRUE(written.has_value());
+    EXPECT_EQ(written->entities(0).name(), "shutdown");
+}
+
+TEST_F(ChunkWriteQueueTest, DrainWithoutArchiveFails) {
+    astre::asset::ChunkWriteQueue queue;
+    queue.push(chunk(6, "nowhere"));
+
+    EXPECT_FALSE(drain(queue));
+    EXPECT_TRUE(queue.pending(chunk(6, "").id()).has_value());
+}
+
+TEST_F(ChunkWriteQueueTest, FindsEntitiesOfQueuedSnapshots) {
+    astre::asset::ChunkWriteQueue queue(1h);
+    queue.open(archive);
+
+    auto moved = chunk(4, "moved");
+    moved.mutable_entities(0)->set_id(21);
+    moved.mutable_entities(0)->mutable_transform()->mutable_position()->set_y(4.0f);
+    queue.push(moved);
+
+    const auto location = queue.findEntity(21);
+    ASSERT_TRUE(location.has_value());
+    EXPECT_EQ(location->chunk, moved.id());
+    ASSERT_TRUE(location->position.has_value());
+    EXPECT_FLOAT_EQ(location->position->y(), 4.0f);
+    EXPECT_TRUE(queue.contains(moved.id()));
+    EXPECT_FALSE(queue.findEntity(22).has_value());
+
+    // once written the archive's entity index takes over
+    ASSERT_TRUE(drain(queue));
+    EXPECT_FALSE(queue.findEntity(21).has_value());
+    EXPECT_FALSE(queue.contains(moved.id()));
+    ASSERT_TRUE(archive->findEntity(21).has_value());
+    EXPECT_EQ(archive->findEntity(21)->chunk, moved.id());
+}
+
+TEST_F(ChunkWriteQueueTest, ArchiveReadableWhileFlushing) {
+    astre::asset::ChunkWriteQueue queue(1ms);
+    queue.open(archive);
+
+    // streaming iterates the chunk set on its strand while the I/O thread writes
+    std::atomic<bool> done = false;
+    std::size_t iterated = 0;
+    std::thread reader([&]() {
+        while(!done) {
+            for(const auto & id : archive->getAllChunks()) iterated += id.x() >= 0;
+            archive->findEntity(1);
+        }
+    });
+
+    for(int x = 0; x < 512; ++x) queue.push(chunk(x, "flushed"));
+    ASSERT_TRUE(drain(queue));
+
+    done = true;
+    reader.join();
+    EXPECT_EQ(archive->getAllChunks().size(), 512u);
+}
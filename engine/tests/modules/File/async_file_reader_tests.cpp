@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include <asio.hpp>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "file/file.hpp"
+
+class AsyncFileReaderTest : public ::testing::Test {
+protected:
+    std::filesystem::path temp_dir;
+
+    void SetUp() override {
+        temp_dir = std::filesystem::current_path() / "async_file_reader_test_data";
+        std::filesystem::create_directories(temp_dir);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(temp_dir);
+    }
+
+    void writeFile(const std::filesystem::path & path, const std::string & content) {
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+    }
+
+    template<class T>
+    static T run(asio::io_context & context, asio::awaitable<T> awaitable) {
+        auto future = asio::co_spawn(context, std::move(awaitable), asio::use_future);
+        context.run();
+        return future.get();
+    }
+};
+
+TEST_F(AsyncFileReaderTest, ReadsBatchOffTheCallingThread) {
+    writeFile(temp_dir / "a.lua", "print('a')");
+    writeFile(temp_dir / "b.lua", "print('b')");
+
+    astre::file::AsyncFileReader reader;
+    asio::io_context context;
+
+    std::vector<astre::native::ReadRequest> requests{
+        astre::native::ReadRequest{.path = temp_dir / "a.lua"},
+        astre::native::ReadRequest{.path = temp_dir / "missing.lua"},
+        astre::native::ReadRequest{.path = temp_dir / "b.lua", .offset = 7, .size = 1}
+    };
+
+    std::thread::id resumed_on;
+    const auto contents = run(context, [&]() -> asio::awaitable<std::vector<std::optional<std::string>>>
+    {
+        auto result = co_await reader.read(std::move(requests));
+        resumed_on = std::this_thread::get_id();
+        co_return result;
+    }());
+
+    // the coroutine continues on its own executor, not the I/O thread
+    EXPECT_EQ(resumed_on, std::this_thread::get_id());
+    ASSERT_EQ(contents.size(), 3u);
+    EXPECT_EQ(contents[0], "print('a')");
+    EXPECT_FALSE(contents[1].has_value());
+    EXPECT_EQ(contents[2], "b");
+}
+
+TEST_F(AsyncFileReaderTest, SourcesParseBatchedContents) {
+    writeFile(temp_dir / "move.lua", "return 1");
+    std::filesystem::create_directories(temp_dir / "basic");
+    writeFile(temp_dir / "basic" / "vertex.glsl", "void main(){}\r\n// second line");
+
+    astre::file::ScriptFile script_file;
+    astre::file::ShaderFile shader_file;
+
+    const auto script = script_file.parse(temp_dir / "move.lua", astre::file::readFiles(script_file.requests(temp_dir / "move.lua")));
+    ASSERT_TRUE(script.has_value());
+    EXPECT_EQ(script->name(), "move");
+    EXPECT_EQ(script->code(0), "return 1");
+
+    // fragment stage is optional
+    const auto shader = shader_file.read(temp_dir / "basic");
+    ASSERT_TRUE(shader.has_value());
+    EXPECT_EQ(shader->name(), "basic");
+    ASSERT_EQ(shader->vertex_code_size(), 2);
+    EXPECT_EQ(shader->vertex_code(0), "void main(){}\n");
+    EXPECT_EQ(shader->fragment_code_size(), 0);
+
+    EXPECT_FALSE(script_file.parse(temp_dir / "gone.lua", {std::nullopt}).has_value());
+}
+
+TEST_F(AsyncFileReaderTest, WorldArchiveParsesRequestedRecords) {
+    const std::filesystem::path file = temp_dir / "world.bin";
+    astre::proto::file::WorldChunk chunk;
+    chunk.mutable_id()->set_x(3);
+    chunk.add_entities()->set_name("batched");
+
+    astre::file::WorldFile<astre::file::use_binary_t> archive(file);
+    ASSERT_TRUE(archive.writeChunk(chunk));
+
+    const auto requests = archive.requests(chunk.id());
+    ASSERT_EQ(requests.size(), 1u);
+    auto contents = astre::file::readFiles(requests);
+
+    // rewritten in between, the requested record is stale and the chunk is read again
+    chunk.mutable_entities(0)->set_name("rewritten");
+    ASSERT_TRUE(archive.writeChunk(chunk));
+    const auto stale = archive.parse(chunk.id(), contents);
+    ASSERT_TRUE(stale.has_value());
+    EXPECT_EQ(stale->entities(0).name(), "rewritten");
+
+    const auto fresh = archive.parse(chunk.id(), astre::file::readFiles(archive.requests(chunk.id())));
+    ASSERT_TRUE(fresh.has_value());
+    EXPECT_EQ(fresh->entities(0).name(), "rewritten");
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "file/file_utils.hpp"
+
+using namespace astre;
+using namespace astre::file;
+
+namespace {
+
+class FileUtilsTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        directory = std::filesystem::temp_directory_path() / "astre_file_utils_tests";
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    static std::string readAll(const std::filesystem::path & path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), {});
+    }
+
+    std::filesystem::path directory;
+};
+
+} // namespace
+
+// ==== TESTS ====
+
+TEST_F(FileUtilsTest, HashBytesIsFnv1a)
+{
+    EXPECT_EQ(hashBytes("", 0), FNV_OFFSET_BASIS);
+    EXPECT_EQ(hashBytes("a", 1), 0xaf63dc4c8601ec8cull);
+    EXPECT_EQ(hashBytes("foobar", 6), 0x85944171f73967e8ull);
+
+    // chained hashing equals hashing the concatenation
+    EXPECT_EQ(hashBytes(hashBytes("foo", 3), "bar", 3), hashBytes("foobar", 6));
+}
+
+TEST_F(FileUtilsTest, WriteFileAtomicallyCreatesAndReplaces)
+{
+    const auto path = directory / "nested" / "entry.bin";
+
+    ASSERT_TRUE(writeFileAtomically(path, {"head", "", "tail"}));
+    EXPECT_EQ(readAll(path), "headtail");
+
+    ASSERT_TRUE(writeFileAtomically(path, {"x"}));
+    EXPECT_EQ(readAll(path), "x");
+
+    // no temporaries left behind
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(path.parent_path()), {}), 1);
+}
+
+TEST_F(FileUtilsTest, ConcurrentWritersLeaveOneWholeFile)
+{
+    const auto path = directory / "entry.bin";
+    const std::string a(64 * 1024, 'a');
+    const std::string b(64 * 1024, 'b');
+
+    std::vector<std::thread> writers;
+    for(int i = 0; i < 8; ++i)
+    {
+        writers.emplace_back([&, i]{
+            // a rename can lose against another on some platforms, the file must stay whole either way
+            for(int n = 0; n < 16; ++n) writeFileAtomically(path, {i % 2 ? a : b});
+        });
+    }
+    for(auto & writer : writers) writer.join();
+
+    const std::string contents = readAll(path);
+    EXPECT_TRUE(contents == a || contents == b);
+}
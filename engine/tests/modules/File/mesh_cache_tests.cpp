@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+#include "math/math.hpp"
+#include "file/mesh_cache.hpp"
+
+using namespace astre;
+using namespace astre::file;
+
+namespace {
+
+class CookedMeshCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        directory = std::filesystem::temp_directory_path() / "astre_cooked_mesh_cache_tests";
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    std::filesystem::path directory;
+};
+
+const std::string SOURCE =
+    "v 0.0 0.0 0.0\n"
+    "v 1.0 0.0 0.0\n"
+    "v 0.0 1.0 0.0\n"
+    "f 1 2 3\n";
+
+void addVertex(google::protobuf::RepeatedPtrField<proto::render::VertexDefinition> & vertices, math::Vec3 position, math::Vec2 uv)
+{
+    auto * vertex = vertices.Add();
+    *vertex->mutable_position() = math::serialize(position);
+    *vertex->mutable_normal() = math::serialize(math::Vec3{0.0f, 0.0f, 1.0f});
+    *vertex->mutable_uv() = math::serialize(uv);
+}
+
+proto::render::MeshDefinition quad()
+{
+    proto::render::MeshDefinition mesh_def;
+    mesh_def.set_name("quad");
+    addVertex(*mesh_def.mutable_vertices(), {-1.0f, -2.0f, 0.0f}, {0.0f, 0.0f});
+    addVertex(*mesh_def.mutable_vertices(), { 1.0f, -2.0f, 0.5f}, {1.0f, 0.0f});
+    addVertex(*mesh_def.mutable_vertices(), { 1.0f,  2.0f, 0.0f}, {1.0f, 1.0f});
+    addVertex(*mesh_def.mutable_vertices(), {-1.0f,  2.0f, 0.0f}, {0.0f, 1.0f});
+    for(std::uint32_t index : {0u, 1u, 2u, 0u, 2u, 3u}) mesh_def.add_indices(index);
+
+    auto * lod = mesh_def.add_lods();
+    addVertex(*lod->mutable_vertices(), {-1.0f, -2.0f, 0.0f}, {0.0f, 0.0f});
+    addVertex(*lod->mutable_vertices(), { 1.0f,  2.0f, 0.0f}, {1.0f, 1.0f});
+    addVertex(*lod->mutable_vertices(), {-1.0f,  2.0f, 0.0f}, {0.0f, 1.0f});
+    for(std::uint32_t index : {0u, 1u, 2u}) lod->add_indices(index);
+    lod->set_error(0.25f);
+
+    auto * bounds = mesh_def.mutable_bounds();
+    *bounds->mutable_aabb_min() = math::serialize(math::Vec3{-1.0f, -2.0f, 0.0f});
+    *bounds->mutable_aabb_max() = math::serialize(math::Vec3{1.0f, 2.0f, 0.5f});
+    bounds->set_radius(2.3f);
+    return mesh_def;
+}
+
+} // namespace
+
+// ==== TESTS ====
+
+TEST_F(CookedMeshCacheTest, StoreThenLoad)
+{
+    CookedMeshCache cache(directory);
+    const auto key = cache.key(SOURCE, "obj", 0x8);
+
+    EXPECT_FALSE(cache.load(key).has_value());
+    ASSERT_TRUE(cache.store(key, quad()));
+
+    const auto loaded = cache.load(key);
+    ASSERT_TRUE(loaded.has_value());
+
+    // the name belongs to whichever file shares the source, it is not stored
+    auto expected = quad();
+    expected.clear_name();
+    EXPECT_EQ(loaded->SerializeAsString(), expected.SerializeAsString());
+}
+
+TEST_F(CookedMeshCacheTest, StoresBoundsOnlyWhenSet)
+{
+    CookedMeshCache cache(directory);
+    const auto key = cache.key(SOURCE, "obj", 0x8);
+
+    ASSERT_TRUE(cache.store(key, quad()));
+    const auto loaded = cache.load(key);
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_TRUE(loaded->has_bounds());
+    EXPECT_EQ(loaded->bounds().SerializeAsString(), quad().bounds().SerializeAsString());
+
+    auto unbounded = quad();
+    unbounded.clear_bounds();
+    ASSERT_TRUE(cache.store(key, unbounded));
+    EXPECT_FALSE(cache.load(key)->has_bounds());
+}
+
+TEST_F(CookedMeshCacheTest, ChangedDependencyMisses)
+{
+    CookedMeshCache cache(directory);
+    const auto key = cache.key(SOURCE, "obj", 0x8);
+
+    const auto source_directory = directory / "models";
+    std::filesystem::create_directories(source_directory);
+    const auto material = source_directory / "quad.mtl";
+    std::ofstream(material) << "newmtl red\nKd 1 0 0\n";
+
+    ASSERT_TRUE(cache.store(key, quad(), source_directory, {material}));
+    EXPECT_TRUE(cache.load(key, source_directory).has_value());
+
+    // resolved against the directory given to load, not the one given to store
+    EXPECT_FALSE(cache.load(key, directory).has_value());
+
+    std::ofstream(material) << "newmtl red\nKd 0 1 0\n";
+    EXPECT_FALSE(cache.load(key, source_directory).has_value());
+
+    std::filesystem::remove(material);
+    EXPECT_FALSE(cache.load(key, source_directory).has_value());
+
+    // nothing to store against without the dependency
+    EXPECT_FALSE(cache.store(key, quad(), source_directory, {material}));
+}
+
+TEST_F(CookedMeshCacheTest, KeyDependsOnSourceFormatAndFlags)
+{
+    CookedMeshCache cache(directory);
+
+    std::string edited = SOURCE;
+    edited[4] = '5';
+
+    EXPECT_EQ(cache.key(SOURCE, "obj", 0x8), cache.key(SOURCE, "obj", 0x8));
+    EXPECT_NE(cache.key(SOURCE, "obj", 0x8), cache.key(edited, "obj", 0x8));
+    EXPECT_NE(cache.key(SOURCE, "obj", 0x8), cache.key(SOURCE, "fbx", 0x8));
+    EXPECT_NE(cache.key(SOURCE, "obj", 0x8), cache.key(SOURCE, "obj", 0x9));
+    EXPECT_NE(cache.key(SOURCE, "obj", 0x8), cache.key("j" + SOURCE, "ob", 0x8));
+}
+
+TEST_F(CookedMeshCacheTest, DamagedEntryMisses)
+{
+    CookedMeshCache cache(directory);
+    const auto key = cache.key(SOURCE, "obj", 0x8);
+    ASSERT_TRUE(cache.store(key, quad()));
+
+    // flip last byte of the index data
+    const auto path = directory / std::format("{:016x}.mesh", key);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put(42);
+    }
+    EXPECT_FALSE(cache.load(key).has_value());
+
+    // truncated
+    std::filesystem::resize_file(path, 10);
+    EXPECT_FALSE(cache.load(key).has_value());
+
+    // entry of another key under this name
+    ASSERT_TRUE(cache.store(key + 1, quad()));
+    std::filesystem::rename(directory / std::format("{:016x}.mesh", key + 1), path);
+    EXPECT_FALSE(cache.load(key).has_value());
+}
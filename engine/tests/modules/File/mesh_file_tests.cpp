@@ -32,3 +32,135 @@ TEST(MeshFileTest, ReadsSimpleObjTriangle) {
 
     std::filesystem::remove_all(dir);
 }
+
+// The buffer of a .gltf is a separate file next to it; the import has to open it
+// from disk even though the model itself comes from the batched read.
+TEST(MeshFileTest, ReadsGltfWithExternalBuffer) {
+    const std::filesystem::path dir = std::filesystem::current_path() / "mesh_file_gltf_test_data";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::filesystem::path gltf = dir / "tri.gltf";
+
+    {
+        const float positions[] = {
+            0.0f, 0.0f, 0.0f,
+            1.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f};
+        std::ofstream out(dir / "tri.bin", std::ios::binary);
+        out.write(reinterpret_cast<const char *>(positions), sizeof(positions));
+    }
+    {
+        std::ofstream out(gltf);
+        out << R"({
+            "asset": {"version": "2.0"},
+            "scene": 0,
+            "scenes": [{"nodes": [0]}],
+            "nodes": [{"mesh": 0}],
+            "meshes": [{"primitives": [{"attributes": {"POSITION": 0}}]}],
+            "buffers": [{"uri": "tri.bin", "byteLength": 36}],
+            "bufferViews": [{"buffer": 0, "byteOffset": 0, "byteLength": 36}],
+            "accessors": [{"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3",
+                           "min": [0.0, 0.0, 0.0], "max": [1.0, 1.0, 0.0]}]
+        })";
+    }
+
+    astre::file::MeshFile mesh_file;
+    auto def = mesh_file.read(gltf);
+
+    ASSERT_TRUE(def.has_value());
+    EXPECT_EQ(def->name(), "tri");
+    EXPECT_EQ(def->vertices_size(), 3);
+    EXPECT_EQ(def->indices_size(), 3);
+
+    std::filesystem::remove(dir / "tri.bin");
+    EXPECT_FALSE(mesh_file.read(gltf).has_value());
+
+    std::filesystem::remove_all(dir);
+}
+
+// A cooked entry written by the first import is what later reads of the same
+// bytes return, under whichever stem the file has.
+TEST(MeshFileTest, ReadsCookedMeshOnSecondImport) {
+    const std::filesystem::path dir = std::filesystem::current_path() / "mesh_file_cooked_test_data";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::filesystem::path obj = dir / "tri.obj";
+    const std::filesystem::path copy = dir / "copy.obj";
+
+    {
+        std::ofstream out(obj);
+        out << "v 0.0 0.0 0.0\n"
+               "v 1.0 0.0 0.0\n"
+               "v 0.0 1.0 0.0\n"
+               "f 1 2 3\n";
+    }
+    std::filesystem::copy_file(obj, copy);
+
+    auto cache = std::make_shared<const astre::file::CookedMeshCache>(dir / "cooked");
+    astre::file::MeshFile mesh_file(cache);
+
+    auto imported = mesh_file.read(obj);
+    ASSERT_TRUE(imported.has_value());
+    ASSERT_TRUE(std::filesystem::exists(cache->directory()));
+    EXPECT_FALSE(std::filesystem::is_empty(cache->directory()));
+
+    auto cooked = mesh_file.read(copy);
+    ASSERT_TRUE(cooked.has_value());
+    EXPECT_EQ(cooked->name(), "copy");
+    cooked->set_name(imported->name());
+    EXPECT_EQ(cooked->SerializeAsString(), imported->SerializeAsString());
+
+    std::filesystem::remove_all(dir);
+}
+
+// The cooked entry of a .gltf is only good while its buffer is unchanged, the
+// source bytes alone would return the old geometry.
+TEST(MeshFileTest, ReimportsWhenReferencedFileChanges) {
+    const std::filesystem::path dir = std::filesystem::current_path() / "mesh_file_dependency_test_data";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    const std::filesystem::path gltf = dir / "tri.gltf";
+
+    const auto writeBuffer = [&](float scale) {
+        const float positions[] = {
+            0.0f, 0.0f, 0.0f,
+            scale, 0.0f, 0.0f,
+            0.0f, scale, 0.0f};
+        std::ofstream out(dir / "tri.bin", std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(positions), sizeof(positions));
+    };
+    writeBuffer(1.0f);
+    {
+        std::ofstream out(gltf);
+        out << R"({
+            "asset": {"version": "2.0"},
+            "scene": 0,
+            "scenes": [{"nodes": [0]}],
+            "nodes": [{"mesh": 0}],
+            "meshes": [{"primitives": [{"attributes": {"POSITION": 0}}]}],
+            "buffers": [{"uri": "tri.bin", "byteLength": 36}],
+            "bufferViews": [{"buffer": 0, "byteOffset": 0, "byteLength": 36}],
+            "accessors": [{"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3"}]
+        })";
+    }
+
+    auto cache = std::make_shared<const astre::file::CookedMeshCache>(dir / "cooked");
+    astre::file::MeshFile mesh_file(cache);
+
+    auto first = mesh_file.read(gltf);
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(first->has_bounds());
+    EXPECT_FLOAT_EQ(first->bounds().aabb_max().x(), 1.0f);
+
+    writeBuffer(2.0f);
+    auto second = mesh_file.read(gltf);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_FLOAT_EQ(second->bounds().aabb_max().x(), 2.0f);
+
+    // and the entry written for the new buffer is the one read next
+    auto cooked = mesh_file.read(gltf);
+    ASSERT_TRUE(cooked.has_value());
+    EXPECT_EQ(cooked->SerializeAsString(), second->SerializeAsString());
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <tuple>
+
+#include "file/file.hpp"
+
+using namespace astre;
+
+namespace
+{
+    // n x n quad grid, triangles shuffled to mimic an unordered import
+    std::pair<std::vector<std::uint32_t>, std::vector<math::Vec3>> makeShuffledGrid(std::uint32_t n)
+    {
+        std::vector<math::Vec3> positions;
+        for(std::uint32_t y = 0; y <= n; ++y)
+            for(std::uint32_t x = 0; x <= n; ++x)
+                positions.emplace_back((float)x, (float)y, 0.0f);
+
+        std::vector<std::array<std::uint32_t, 3>> triangles;
+        for(std::uint32_t y = 0; y < n; ++y)
+        {
+            for(std::uint32_t x = 0; x < n; ++x)
+            {
+                const std::uint32_t i = y * (n + 1) + x;
+                triangles.push_back({i, i + 1, i + n + 1});
+                triangles.push_back({i + 1, i + n + 2, i + n + 1});
+            }
+        }
+
+        std::mt19937 rng(1234);
+        std::shuffle(triangles.begin(), triangles.end(), rng);
+
+        std::vector<std::uint32_t> indices;
+        for(const auto & t : triangles) indices.insert(indices.end(), t.begin(), t.end());
+        return {indices, positions};
+    }
+
+    using TrianglePositions = std::tuple<float, float, float, float, float, float>;
+
+    // triangles by their corner positions, independent of vertex numbering and rotation
+    std::multiset<TrianglePositions> triangleSet(const proto::render::MeshDefinition & mesh_def)
+    {
+        std::multiset<TrianglePositions> result;
+        for(int t = 0; t < mesh_def.indices_size(); t += 3)
+        {
+            std::array<std::pair<float, float>, 3> corners;
+            for(int k = 0; k < 3; ++k)
+            {
+                const auto & p = mesh_def.vertices(mesh_def.indices(t + k)).position();
+                corners[k] = {p.x(), p.y()};
+            }
+            std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end()), corners.end());
+            result.insert({corners[0].first, corners[0].second, corners[1].first, corners[1].second, corners[2].first, corners[2].second});
+        }
+        return result;
+    }
+}
+
+TEST(MeshOptimizerTest, ACMRBounds)
+{
+    // every vertex of every triangle new -> 3, strip through one triangle fan -> low
+    EXPECT_FLOAT_EQ(file::computeACMR({0, 1, 2, 3, 4, 5}, 6, 16), 3.0f);
+    EXPECT_FLOAT_EQ(file::computeACMR({0, 1, 2, 0, 2, 3, 0, 3, 4}, 5, 16), 5.0f / 3.0f);
+}
+
+TEST(MeshOptimizerTest, VertexCacheImprovesACMR)
+{
+    const auto [indices, positions] = makeShuffledGrid(32);
+
+    const float before = file::computeACMR(indices, positions.size(), 16);
+    const auto optimized = file::optimizeVertexCache(indices, positions.size());
+    const float after = file::computeACMR(optimized, positions.size(), 16);
+
+    ASSERT_EQ(optimized.size(), indices.size());
+    EXPECT_GT(before, 2.0f);
+    EXPECT_LT(after, 1.0f);
+}
+
+TEST(MeshOptimizerTest, OverdrawKeepsCacheEfficiency)
+{
+    const auto [indices, positions] = makeShuffledGrid(32);
+    const auto cache_ordered = file::optimizeVertexCache(indices, positions.size());
+    const auto optimized = file::optimizeOverdraw(cache_ordered, positions, 1.05f);
+
+    ASSERT_EQ(optimized.size(), cache_ordered.size());
+    EXPECT_LE(file::computeACMR(optimized, positions.size(), file::VERTEX_CACHE_SIZE),
+        file::computeACMR(cache_ordered, positions.size(), file::VERTEX_CACHE_SIZE) * 1.05f);
+}
+
+TEST(MeshOptimizerTest, VertexFetchRemapFollowsFirstUse)
+{
+    const auto remap = file::optimizeVertexFetchRemap({3, 1, 3, 0}, 5);
+    EXPECT_EQ(remap[3], 0u);
+    EXPECT_EQ(remap[1], 1u);
+    EXPECT_EQ(remap[0], 2u);
+    EXPECT_EQ(remap[2], UINT32_MAX);
+    EXPECT_EQ(remap[4], UINT32_MAX);
+}
+
+TEST(MeshOptimizerTest, OptimizeMeshPreservesTriangles)
+{
+    const auto [indices, positions] = makeShuffledGrid(16);
+
+    proto::render::MeshDefinition mesh_def;
+    mesh_def.set_name("grid");
+    for(const auto & p : positions)
+    {
+        auto * vertex = mesh_def.add_vertices();
+        *vertex->mutable_position() = math::serialize(p);
+    }
+    // unreferenced vertex is dropped
+    *mesh_def.add_vertices()->mutable_position() = math::serialize(math::Vec3(-1.0f));
+    for(const auto i : indices) mesh_def.add_indices(i);
+
+    const auto triangles_before = triangleSet(mesh_def);
+    const float acmr_before = file::computeACMR(indices, positions.size(), 16);
+
+    ASSERT_TRUE(file::optimizeMesh(mesh_def));
+
+    EXPECT_EQ(mesh_def.vertices_size(), (int)positions.size());
+    EXPECT_EQ(triangleSet(mesh_def), triangles_before);
+
+    const std::vector<std::uint32_t> optimized(mesh_def.indices().begin(), mesh_def.indices().end());
+    EXPECT_LT(file::computeACMR(optimized, positions.size(), 16), acmr_before);
+
+    // vertex fetch order: every index is at most one past the highest seen so far
+    std::uint32_t next = 0;
+    for(const auto i : optimized)
+    {
+        ASSERT_LE(i, next);
+        if(i == next) next++;
+    }
+}
+
+TEST(MeshOptimizerTest, RejectsInvalidMesh)
+{
+    proto::render::MeshDefinition mesh_def;
+    mesh_def.add_vertices();
+    mesh_def.add_indices(0);
+    mesh_def.add_indices(0);
+    EXPECT_FALSE(file::optimizeMesh(mesh_def));
+
+    mesh_def.add_indices(5);
+    EXPECT_FALSE(file::optimizeMesh(mesh_def));
+    EXPECT_EQ(mesh_def.indices(2), 5u);
+}
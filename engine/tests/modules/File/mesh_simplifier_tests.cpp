@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "file/file.hpp"
+
+using namespace astre;
+
+namespace
+{
+    // n x n quad grid in XY, z displaced by `height(x, y)`
+    template<class Height>
+    std::pair<std::vector<std::uint32_t>, std::vector<math::Vec3>> makeGrid(std::uint32_t n, Height height)
+    {
+        std::vector<math::Vec3> positions;
+        for(std::uint32_t y = 0; y <= n; ++y)
+            for(std::uint32_t x = 0; x <= n; ++x)
+                positions.emplace_back((float)x, (float)y, height((float)x, (float)y));
+
+        std::vector<std::uint32_t> indices;
+        for(std::uint32_t y = 0; y < n; ++y)
+        {
+            for(std::uint32_t x = 0; x < n; ++x)
+            {
+                const std::uint32_t i = y * (n + 1) + x;
+                indices.insert(indices.end(), {i, i + 1, i + n + 1, i + 1, i + n + 2, i + n + 1});
+            }
+        }
+        return {indices, positions};
+    }
+
+    float projectedArea(const std::vector<std::uint32_t> & indices, const std::vector<math::Vec3> & positions)
+    {
+        float area = 0.0f;
+        for(std::size_t t = 0; t < indices.size(); t += 3)
+        {
+            const math::Vec3 & a = positions[indices[t]];
+            const math::Vec3 & b = positions[indices[t + 1]];
+            const math::Vec3 & c = positions[indices[t + 2]];
+            area += 0.5f * ((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y));
+        }
+        return area;
+    }
+}
+
+TEST(MeshSimplifierTest, FlatGridCollapsesWithoutError)
+{
+    const auto [indices, positions] = makeGrid(16, [](float, float){ return 0.0f; });
+
+    float error = 1.0f;
+    const auto simplified = file::simplifyMesh(indices, positions, indices.size() / 4, 0.01f, &error);
+
+    EXPECT_LE(simplified.size(), indices.size() / 4);
+    EXPECT_NEAR(error, 0.0f, 1e-4f);
+    // no holes, no folded triangles: covered area is unchanged
+    EXPECT_NEAR(projectedArea(simplified, positions), 16.0f * 16.0f, 1e-2f);
+}
+
+TEST(MeshSimplifierTest, StopsAtTargetError)
+{
+    const auto [indices, positions] = makeGrid(16, [](float x, float y){ return std::sin(x * 0.8f) * std::cos(y * 0.8f); });
+
+    float error = 0.0f;
+    const auto simplified = file::simplifyMesh(indices, positions, 0, 0.05f, &error);
+
+    EXPECT_LT(simplified.size(), indices.size());
+    EXPECT_GT(simplified.size(), 0u);
+    EXPECT_LE(error, 0.05f);
+}
+
+TEST(MeshSimplifierTest, SeamVerticesStayInPlace)
+{
+    // two halves of a grid share the middle column by position only, like a uv seam
+    auto [indices, positions] = makeGrid(8, [](float, float){ return 0.0f; });
+    const std::uint32_t seam_x = 4;
+    std::vector<std::uint32_t> seam_twins;
+    for(std::uint32_t y = 0; y <= 8; ++y)
+    {
+        seam_twins.push_back((std::uint32_t)positions.size());
+        positions.push_back(positions[y * 9 + seam_x]);
+    }
+    for(std::size_t t = 0; t < indices.size(); t += 3)
+    {
+        const float cx = (positions[indices[t]].x + positions[indices[t + 1]].x + positions[indices[t + 2]].x) / 3.0f;
+        if(cx < (float)seam_x) continue;
+        for(int k = 0; k < 3; ++k)
+        {
+            const auto & p = positions[indices[t + k]];
+            if(p.x == (float)seam_x) indices[t + k] = seam_twins[(std::uint32_t)p.y];
+        }
+    }
+
+    const auto simplified = file::simplifyMesh(indices, positions, 0, 0.01f);
+
+    // every seam position still has both twins referenced
+    for(std::uint32_t y = 0; y <= 8; ++y)
+    {
+        EXPECT_NE(std::find(simplified.begin(), simplified.end(), y * 9 + seam_x), simplified.end());
+        EXPECT_NE(std::find(simplified.begin(), simplified.end(), seam_twins[y]), simplified.end());
+    }
+    EXPECT_NEAR(projectedArea(simplified, positions), 64.0f, 1e-2f);
+}
+
+TEST(MeshSimplifierTest, GeneratesCoarserLODs)
+{
+    const auto [indices, positions] = makeGrid(32, [](float x, float y){ return 0.2f * std::sin(x * 0.3f) * std::cos(y * 0.3f); });
+
+    proto::render::MeshDefinition mesh_def;
+    mesh_def.set_name("terrain");
+    for(const auto & p : positions) *mesh_def.add_vertices()->mutable_position() = math::serialize(p);
+    for(const auto i : indices) mesh_def.add_indices(i);
+
+    ASSERT_GT(file::generateMeshLODs(mesh_def, 3), 0u);
+
+    int previous_indices = mesh_def.indices_size();
+    float previous_error = 0.0f;
+    for(const auto & lod : mesh_def.lods())
+    {
+        EXPECT_LT(lod.indices_size(), previous_indices);
+        EXPECT_GE(lod.error(), previous_error);
+        EXPECT_LE(lod.vertices_size(), mesh_def.vertices_size());
+        for(const auto i : lod.indices()) ASSERT_LT(i, (std::uint32_t)lod.vertices_size());
+
+        previous_indices = lod.indices_size();
+        previous_error = lod.error();
+    }
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "file/record_compressor.hpp"
+
+namespace
+{
+    std::vector<std::string> makeSamples(std::size_t count)
+    {
+        std::vector<std::string> samples;
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            std::string sample;
+            for(std::size_t j = 0; j < 16; ++j)
+                sample += "entity{visual{shader:\"deferred_gbuffer\",vertex_buffer:\"rock_" + std::to_string((i + j) % 5) + "\"}}";
+            samples.push_back(std::move(sample));
+        }
+        return samples;
+    }
+}
+
+TEST(RecordCompressorTest, RoundTripWithoutDictionary)
+{
+    const astre::file::RecordCompressor compressor;
+    const std::string data = makeSamples(1).front();
+
+    const auto frame = compressor.compress(data);
+    ASSERT_TRUE(frame.has_value());
+    EXPECT_LT(frame->size(), data.size());
+
+    const auto restored = compressor.decompress(*frame);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(*restored, data);
+}
+
+TEST(RecordCompressorTest, DisabledCompressorStillDecompresses)
+{
+    const astre::file::RecordCompressor compressor;
+    const astre::file::RecordCompressor disabled(0);
+    const std::string data = makeSamples(1).front();
+
+    EXPECT_FALSE(disabled.enabled());
+    EXPECT_FALSE(disabled.compress(data).has_value());
+    EXPECT_EQ(disabled.decompress(*compressor.compress(data)), data);
+}
+
+TEST(RecordCompressorTest, TooFewSamplesTrainNoDictionary)
+{
+    EXPECT_TRUE(astre::file::RecordCompressor::trainDictionary(makeSamples(2)).empty());
+}
+
+TEST(RecordCompressorTest, DictionaryRoundTrip)
+{
+    const auto samples = makeSamples(256);
+    std::string dictionary = astre::file::RecordCompressor::trainDictionary(samples);
+    ASSERT_FALSE(dictionary.empty());
+    EXPECT_LE(dictionary.size(), astre::file::RECORD_DICTIONARY_CAPACITY);
+
+    const astre::file::RecordCompressor with_dictionary(astre::file::DEFAULT_RECORD_COMPRESSION_LEVEL, std::move(dictionary));
+    const astre::file::RecordCompressor without_dictionary;
+
+    const std::string data = samples[17];
+    const auto frame = with_dictionary.compress(data);
+    ASSERT_TRUE(frame.has_value());
+    EXPECT_LE(frame->size(), without_dictionary.compress(data)->size());
+
+    EXPECT_EQ(with_dictionary.decompress(*frame), data);
+    // frames written with a dictionary can't be read without it
+    EXPECT_FALSE(without_dictionary.decompress(*frame).has_value());
+    // and frames written without one are still read by a compressor holding one
+    EXPECT_EQ(with_dictionary.decompress(*without_dictionary.compress(data)), data);
+}
+
+TEST(RecordCompressorTest, DamagedFrameIsRejected)
+{
+    const astre::file::RecordCompressor compressor;
+    EXPECT_FALSE(compressor.decompress("not a zstd frame").has_value());
+}
@@ -1,6 +1,16 @@
 #include <gtest/gtest.h>
+#include <atomic>
 #include <fstream>
+#include <iterator>
+#include <thread>
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+
 #include "file/file.hpp"
+#include "file/file_utils.hpp"
+
+#include "proto/File/world_archive.pb.h"
 
 class WorldFileTest : public ::testing::Test {
 protected:
@@ -27,6 +37,47 @@ protected:
 
         return chunk;
     }
+
+    // chunk of many near-identical entities, like real levels
+    astre::proto::file::WorldChunk createRepetitiveChunk(int x, int entities) {
+        auto chunk = createTestChunk(x, 0, 0, "tree_0");
+        for(int i = 1; i < entities; ++i)
+            chunk.add_entities()->set_name("forest/conifer/pine_tree_large_variant_" + std::to_string(i % 7));
+        return chunk;
+    }
+
+    // chunk holding one entity with a transform
+    astre::proto::file::WorldChunk createEntityChunk(int x, std::uint64_t entity, float position_x) {
+        auto chunk = createTestChunk(x, 0, 0, "placed");
+        auto* entity_def = chunk.mutable_entities(0);
+        entity_def->set_id(entity);
+        entity_def->mutable_transform()->mutable_position()->set_x(position_x);
+        return chunk;
+    }
+
+    static std::string readBytes(const std::filesystem::path & file) {
+        std::ifstream in(file, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+    }
+
+    // table of contents the trailer at the end of `file` frames, if any
+    static std::optional<astre::proto::file::WorldArchiveToc> readTableOfContents(const std::filesystem::path & file,
+        std::uint64_t * toc_offset = nullptr) {
+        const std::string bytes = readBytes(file);
+        if(bytes.size() < 24 || bytes.compare(bytes.size() - 4, 4, "AWLD") != 0) return std::nullopt;
+
+        std::uint64_t offset = 0;
+        std::uint32_t size = 0;
+        const auto * trailer = (const std::uint8_t *)bytes.data() + bytes.size() - 24;
+        google::protobuf::io::CodedInputStream::ReadLittleEndian64FromArray(trailer, &offset);
+        google::protobuf::io::CodedInputStream::ReadLittleEndian32FromArray(trailer + 16, &size);
+        if(offset + size + 24 != bytes.size()) return std::nullopt;
+
+        astre::proto::file::WorldArchiveToc toc;
+        if(!toc.ParseFromArray(bytes.data() + offset, (int)size)) return std::nullopt;
+        if(toc_offset != nullptr) *toc_offset = offset;
+        return toc;
+    }
 };
 
 
@@ -70,3 +121,423 @@ TEST_F(WorldFileTest, WriteAndReadChunk_JsonFormat) {
 }
 
 
+
+TEST_F(WorldFileTest, BinaryFormat_RewriteAppendsOnlyTheNewVersion) {
+    std::filesystem::path file = temp_dir / "append.bin";
+    astre::file::WorldFile<astre::file::use_binary_t> archive(file, 0);
+
+    for(int i = 0; i < 16; ++i)
+        ASSERT_TRUE(archive.writeChunk(createTestChunk(i, 0, 0, "filler")));
+
+    const auto before = std::filesystem::file_size(file);
+    auto chunk = createTestChunk(3, 0, 0, "updated");
+    ASSERT_TRUE(archive.writeChunk(chunk));
+
+    const std::size_t payload = chunk.ByteSizeLong();
+    EXPECT_EQ(std::filesystem::file_size(file) - before, payload + 1); // one byte length prefix
+    EXPECT_EQ(archive.read(chunk.id())->entities(0).name(), "updated");
+    EXPECT_GT(archive.deadBytes(), 0u);
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_ReopenReplaysLatestVersionsAndTombstones) {
+    std::filesystem::path file = temp_dir / "replay.bin";
+    auto kept = createTestChunk(1, 0, 0, "first");
+    auto removed = createTestChunk(2, 0, 0, "removed");
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> writer(file);
+        ASSERT_TRUE(writer.writeChunk(kept));
+        ASSERT_TRUE(writer.writeChunk(removed));
+        ASSERT_TRUE(writer.writeChunk(createTestChunk(1, 0, 0, "second")));
+        ASSERT_TRUE(writer.removeChunk(removed.id()));
+    }
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(file);
+    ASSERT_TRUE(reader.good());
+    EXPECT_EQ(reader.getAllChunks().size(), 1u);
+    EXPECT_FALSE(reader.read(removed.id()).has_value());
+
+    auto result = reader.read(kept.id());
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->entities(0).name(), "second");
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_CompactDropsDeadRecords) {
+    std::filesystem::path file = temp_dir / "compact.bin";
+    auto a = createTestChunk(1, 0, 0, "a");
+    auto b = createTestChunk(2, 0, 0, "b");
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> archive(file, 0);
+        for(int i = 0; i < 8; ++i)
+            ASSERT_TRUE(archive.writeChunk(a));
+        ASSERT_TRUE(archive.writeChunk(b));
+        ASSERT_TRUE(archive.writeChunk(createTestChunk(3, 0, 0, "c")));
+        ASSERT_TRUE(archive.removeChunk(createTestChunk(3, 0, 0).id()));
+
+        const auto before = std::filesystem::file_size(file);
+        ASSERT_TRUE(archive.compact());
+        EXPECT_EQ(archive.deadBytes(), 0u);
+        EXPECT_LT(std::filesystem::file_size(file), before);
+        EXPECT_EQ(archive.read(a.id())->entities(0).name(), "a");
+
+        // appends continue after the compacted records
+        ASSERT_TRUE(archive.writeChunk(createTestChunk(2, 0, 0, "b2")));
+    }
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(file);
+    EXPECT_EQ(reader.getAllChunks().size(), 2u);
+    EXPECT_EQ(reader.read(a.id())->entities(0).name(), "a");
+    EXPECT_EQ(reader.read(b.id())->entities(0).name(), "b2");
+    EXPECT_EQ(reader.deadBytes(), b.ByteSizeLong() + 1);
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_ReopenWithoutTableOfContentsReplaysLog) {
+    std::filesystem::path file = temp_dir / "crashed.bin";
+    std::filesystem::path copy = temp_dir / "crashed_copy.bin";
+    auto chunk = createTestChunk(1, 2, 3, "unclosed");
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> writer(file);
+        ASSERT_TRUE(writer.writeChunk(chunk));
+
+        // snapshot while still open, the table of contents is only written on close
+        std::filesystem::copy_file(file, copy);
+    }
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(copy);
+    ASSERT_TRUE(reader.good());
+    EXPECT_EQ(reader.version(), 2u);
+    ASSERT_TRUE(reader.read(chunk.id()).has_value());
+    EXPECT_EQ(reader.read(chunk.id())->entities(0).name(), "unclosed");
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_TornTailIsTrimmedBeforeTableOfContents) {
+    std::filesystem::path file = temp_dir / "torn.bin";
+    std::filesystem::path copy = temp_dir / "torn_copy.bin";
+    auto chunk = createTestChunk(1, 2, 3, "kept");
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> writer(file);
+        ASSERT_TRUE(writer.writeChunk(chunk));
+        std::filesystem::copy_file(file, copy);
+    }
+
+    {
+        // interrupted append: a length prefix of 255 bytes with fewer following,
+        // longer than the table of contents that replaces it
+        std::ofstream out(copy, std::ios::binary | std::ios::app);
+        out.put((char)0xff);
+        out.put((char)0x01);
+        out << std::string(200, 'x');
+    }
+
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> recovered(copy);
+        ASSERT_TRUE(recovered.good());
+        ASSERT_TRUE(recovered.read(chunk.id()).has_value());
+    }
+
+    // the trailer is at the end again, so the next open uses it
+    const auto toc = readTableOfContents(copy);
+    ASSERT_TRUE(toc.has_value());
+    EXPECT_EQ(toc->chunks_size(), 1);
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(copy);
+    ASSERT_TRUE(reader.read(chunk.id()).has_value());
+    EXPECT_EQ(reader.read(chunk.id())->entities(0).name(), "kept");
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_LegacyArchiveIsReadAndUpgradedByCompaction) {
+    std::filesystem::path file = temp_dir / "legacy.bin";
+    auto a = createTestChunk(1, 0, 0, "a");
+    auto b = createTestChunk(2, 0, 0, "b");
+    {
+        // plain stream of delimited chunks, no header
+        std::ofstream out(file, std::ios::binary);
+        google::protobuf::io::OstreamOutputStream raw(&out);
+        google::protobuf::io::CodedOutputStream coded(&raw);
+        for(const auto * chunk : {&a, &b})
+        {
+            coded.WriteVarint32((uint32_t)chunk->ByteSizeLong());
+            ASSERT_TRUE(chunk->SerializeToCodedStream(&coded));
+        }
+    }
+
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> archive(file);
+        ASSERT_TRUE(archive.good());
+        EXPECT_EQ(archive.version(), 0u);
+        EXPECT_EQ(archive.getAllChunks().size(), 2u);
+        EXPECT_EQ(archive.read(b.id())->entities(0).name(), "b");
+        ASSERT_TRUE(archive.compact());
+        EXPECT_EQ(archive.version(), 2u);
+    }
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(file);
+    EXPECT_EQ(reader.version(), 2u);
+    EXPECT_EQ(reader.getAllChunks().size(), 2u);
+    EXPECT_EQ(reader.read(a.id())->entities(0).name(), "a");
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_ReadRejectsCorruptedRecord) {
+    std::filesystem::path file = temp_dir / "corrupt.bin";
+    auto chunk = createTestChunk(1, 0, 0, "intact_name");
+    {
+        // raw record, so the name can be found in the file
+        astre::file::WorldFile<astre::file::use_binary_t> writer(file, 0);
+        ASSERT_TRUE(writer.writeChunk(chunk));
+    }
+
+    {
+        // flip the last byte of the entity name, the record still parses
+        std::fstream stream(file, std::ios::in | std::ios::out | std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        const auto at = bytes.find("intact_name");
+        ASSERT_NE(at, std::string::npos);
+        stream.seekp((std::streamoff)(at + 10));
+        stream.put('X');
+    }
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(file);
+    ASSERT_TRUE(reader.good());
+    EXPECT_TRUE(reader.getAllChunks().contains(chunk.id()));
+    EXPECT_FALSE(reader.read(chunk.id()).has_value());
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_MappedReadsSeeLaterWrites) {
+    std::filesystem::path file = temp_dir / "mapped.bin";
+    astre::file::WorldFile<astre::file::use_binary_t> archive(file);
+
+    auto chunk = createTestChunk(1, 0, 0, "before");
+    ASSERT_TRUE(archive.writeChunk(chunk));
+    EXPECT_EQ(archive.read(chunk.id())->entities(0).name(), "before");
+
+    ASSERT_TRUE(archive.writeChunk(createTestChunk(1, 0, 0, "after")));
+    ASSERT_TRUE(archive.writeChunk(createTestChunk(2, 0, 0, "new")));
+    EXPECT_EQ(archive.read(chunk.id())->entities(0).name(), "after");
+    EXPECT_EQ(archive.read(createTestChunk(2, 0, 0).id())->entities(0).name(), "new");
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_ConcurrentReads) {
+    std::filesystem::path file = temp_dir / "concurrent.bin";
+    astre::file::WorldFile<astre::file::use_binary_t> archive(file);
+
+    constexpr int CHUNKS = 32;
+    for(int i = 0; i < CHUNKS; ++i)
+        ASSERT_TRUE(archive.writeChunk(createTestChunk(i, 0, 0, "entity_" + std::to_string(i))));
+
+    std::atomic<int> failures = 0;
+    std::vector<std::thread> readers;
+    for(int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&]()
+        {
+            for(int i = 0; i < CHUNKS; ++i)
+            {
+                const auto chunk = archive.read(createTestChunk(i, 0, 0).id());
+                if(!chunk || chunk->entities(0).name() != "entity_" + std::to_string(i)) ++failures;
+            }
+        });
+    }
+    for(auto & reader : readers) reader.join();
+
+    EXPECT_EQ(failures, 0);
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_CompressedRecordsAreSmaller) {
+    std::filesystem::path raw_file = temp_dir / "raw.bin";
+    std::filesystem::path compressed_file = temp_dir / "compressed.bin";
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> raw(raw_file, 0);
+        astre::file::WorldFile<astre::file::use_binary_t> compressed(compressed_file);
+        for(int i = 0; i < 16; ++i)
+        {
+            ASSERT_TRUE(raw.writeChunk(createRepetitiveChunk(i, 64)));
+            ASSERT_TRUE(compressed.writeChunk(createRepetitiveChunk(i, 64)));
+        }
+    }
+    EXPECT_LT(std::filesystem::file_size(compressed_file) * 2, std::filesystem::file_size(raw_file));
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(compressed_file);
+    const auto expected = createRepetitiveChunk(5, 64);
+    const auto result = reader.read(expected.id());
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->SerializeAsString(), expected.SerializeAsString());
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_CompactTrainsDictionary) {
+    std::filesystem::path file = temp_dir / "dictionary.bin";
+    constexpr int CHUNKS = 64;
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> archive(file);
+        for(int i = 0; i < CHUNKS; ++i)
+            ASSERT_TRUE(archive.writeChunk(createRepetitiveChunk(i, 32)));
+        EXPECT_EQ(archive.dictionarySize(), 0u);
+
+        ASSERT_TRUE(archive.compact());
+        EXPECT_GT(archive.dictionarySize(), 0u);
+
+        // appended after training, compressed with the dictionary
+        ASSERT_TRUE(archive.writeChunk(createRepetitiveChunk(CHUNKS, 32)));
+    }
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(file);
+    EXPECT_GT(reader.dictionarySize(), 0u);
+    for(int i = 0; i <= CHUNKS; ++i)
+    {
+        const auto expected = createRepetitiveChunk(i, 32);
+        const auto result = reader.read(expected.id());
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(result->SerializeAsString(), expected.SerializeAsString());
+    }
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_FindEntityFollowsRewritesAndSurvivesReopen) {
+    std::filesystem::path file = temp_dir / "entities.bin";
+    const auto a = createEntityChunk(1, 7, 1.5f);
+    const auto b = createEntityChunk(2, 7, 2.5f);
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> archive(file);
+        ASSERT_TRUE(archive.writeChunk(a));
+        auto location = archive.findEntity(7);
+        ASSERT_TRUE(location.has_value());
+        EXPECT_EQ(location->chunk, a.id());
+        ASSERT_TRUE(location->position.has_value());
+        EXPECT_FLOAT_EQ(location->position->x(), 1.5f);
+
+        // entity moves to b, then a is written without it
+        ASSERT_TRUE(archive.writeChunk(b));
+        ASSERT_TRUE(archive.writeChunk(createTestChunk(1, 0, 0, "left_behind")));
+        location = archive.findEntity(7);
+        ASSERT_TRUE(location.has_value());
+        EXPECT_EQ(location->chunk, b.id());
+
+        EXPECT_FALSE(archive.findEntity(8).has_value());
+    }
+
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> reader(file);
+        const auto location = reader.findEntity(7);
+        ASSERT_TRUE(location.has_value());
+        EXPECT_EQ(location->chunk, b.id());
+        EXPECT_FLOAT_EQ(location->position->x(), 2.5f);
+
+        ASSERT_TRUE(reader.removeChunk(b.id()));
+        EXPECT_FALSE(reader.findEntity(7).has_value());
+    }
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(file);
+    EXPECT_FALSE(reader.findEntity(7).has_value());
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_EntityIndexRebuiltWhenLogIsReplayed) {
+    std::filesystem::path file = temp_dir / "entities_crashed.bin";
+    std::filesystem::path copy = temp_dir / "entities_crashed_copy.bin";
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> writer(file);
+        ASSERT_TRUE(writer.writeChunk(createEntityChunk(3, 11, 3.5f)));
+        std::filesystem::copy_file(file, copy);
+    }
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(copy);
+    const auto location = reader.findEntity(11);
+    ASSERT_TRUE(location.has_value());
+    EXPECT_EQ(location->chunk.x(), 3);
+    EXPECT_FLOAT_EQ(location->position->x(), 3.5f);
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_TableOfContentsWithoutEntityIndexIsUpgradedOnce) {
+    std::filesystem::path file = temp_dir / "entities_old_toc.bin";
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> writer(file);
+        ASSERT_TRUE(writer.writeChunk(createEntityChunk(2, 9, 2.5f)));
+    }
+
+    // rewrite the table of contents as archives before the entity index wrote it
+    {
+        std::uint64_t toc_offset = 0;
+        auto toc = readTableOfContents(file, &toc_offset);
+        ASSERT_TRUE(toc.has_value());
+        toc->clear_entities();
+        toc->set_indexed_entities(false);
+
+        const std::string toc_bytes = toc->SerializeAsString();
+        const std::uint64_t checksum = astre::file::hashBytes(toc_bytes.data(), toc_bytes.size());
+
+        std::string trailer(24, '\0');
+        google::protobuf::io::CodedOutputStream::WriteLittleEndian64ToArray(toc_offset, (std::uint8_t *)trailer.data());
+        google::protobuf::io::CodedOutputStream::WriteLittleEndian64ToArray(checksum, (std::uint8_t *)trailer.data() + 8);
+        google::protobuf::io::CodedOutputStream::WriteLittleEndian32ToArray((std::uint32_t)toc_bytes.size(), (std::uint8_t *)trailer.data() + 16);
+        trailer.replace(20, 4, "AWLD");
+
+        const std::string log = readBytes(file).substr(0, toc_offset);
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+        out << log << toc_bytes << trailer;
+    }
+    ASSERT_FALSE(readTableOfContents(file)->indexed_entities());
+
+    {
+        // first open scans the chunks and writes the index back on close
+        astre::file::WorldFile<astre::file::use_binary_t> upgraded(file);
+        ASSERT_TRUE(upgraded.findEntity(9).has_value());
+    }
+    const auto toc = readTableOfContents(file);
+    ASSERT_TRUE(toc.has_value());
+    EXPECT_TRUE(toc->indexed_entities());
+    ASSERT_EQ(toc->entities_size(), 1);
+
+    // damage the record, a second scan could no longer index the entity
+    {
+        std::fstream io(file, std::ios::binary | std::ios::in | std::ios::out);
+        io.seekp((std::streamoff)toc->chunks(0).offset() + 2);
+        io.put('\x7f');
+    }
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(file);
+    const auto location = reader.findEntity(9);
+    ASSERT_TRUE(location.has_value());
+    EXPECT_EQ(location->chunk.x(), 2);
+    EXPECT_FLOAT_EQ(location->position->x(), 2.5f);
+}
+
+
+TEST_F(WorldFileTest, BinaryFormat_EntityIndexSurvivesCompaction) {
+    std::filesystem::path file = temp_dir / "entities_compacted.bin";
+    {
+        astre::file::WorldFile<astre::file::use_binary_t> archive(file);
+        ASSERT_TRUE(archive.writeChunk(createEntityChunk(1, 5, 1.0f)));
+        ASSERT_TRUE(archive.writeChunk(createEntityChunk(1, 5, 1.25f)));
+        ASSERT_TRUE(archive.compact());
+    }
+
+    astre::file::WorldFile<astre::file::use_binary_t> reader(file);
+    const auto location = reader.findEntity(5);
+    ASSERT_TRUE(location.has_value());
+    EXPECT_FLOAT_EQ(location->position->x(), 1.25f);
+}
+
+
+TEST_F(WorldFileTest, JsonFormat_FindEntity) {
+    std::filesystem::path file = temp_dir / "entities.json";
+    {
+        astre::file::WorldFile<astre::file::use_json_t> writer(file);
+        ASSERT_TRUE(writer.writeChunk(createEntityChunk(4, 9, 4.5f)));
+        EXPECT_TRUE(writer.findEntity(9).has_value());
+    }
+
+    astre::file::WorldFile<astre::file::use_json_t> reader(file);
+    const auto location = reader.findEntity(9);
+    ASSERT_TRUE(location.has_value());
+    EXPECT_EQ(location->chunk.x(), 4);
+    EXPECT_FLOAT_EQ(location->position->x(), 4.5f);
+}
@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
+#include <fstream>
 #include "native/native.h"
 
+#if !defined(WIN32)
+#include <fcntl.h>
+#include <sys/resource.h>
+#endif
+
 using namespace astre::native;
 
 TEST(RunProcessTest, InvalidCommandReturnsError) {
@@ -25,3 +31,70 @@ TEST(RunProcessTest, ArgumentsAreHandledCorrectly) {
     EXPECT_NE(output.find("test2"), std::string::npos);
 }
 #endif
+
+TEST(BatchFileReaderTest, ReadsWholeFilesAndRanges) {
+    const std::filesystem::path dir = std::filesystem::current_path() / "batch_file_reader_test_data";
+    std::filesystem::create_directories(dir);
+    {
+        std::ofstream out(dir / "text.txt", std::ios::binary);
+        out << "hello batched world";
+    }
+
+    // more requests than the queue depth, so the batch is submitted in several rounds
+    BatchFileReader reader(4);
+    std::vector<ReadRequest> requests;
+    for(int i = 0; i < 10; ++i)
+        requests.push_back(ReadRequest{.path = dir / "text.txt", .offset = (std::uint64_t)i});
+    requests.push_back(ReadRequest{.path = dir / "text.txt", .offset = 6, .size = 7});
+    requests.push_back(ReadRequest{.path = dir / "missing.txt"});
+    requests.push_back(ReadRequest{.path = dir / "text.txt", .offset = 6, .size = 100});
+
+    const auto contents = reader.read(requests);
+    ASSERT_EQ(contents.size(), requests.size());
+    ASSERT_TRUE(contents[0].has_value());
+    EXPECT_EQ(*contents[0], "hello batched world");
+    ASSERT_TRUE(contents[9].has_value());
+    EXPECT_EQ(*contents[9], "ched world");
+    ASSERT_TRUE(contents[10].has_value());
+    EXPECT_EQ(*contents[10], "batched");
+    EXPECT_FALSE(contents[11].has_value());
+    EXPECT_FALSE(contents[12].has_value()); // reaches past the end
+
+    std::filesystem::remove_all(dir);
+}
+
+#if !defined(WIN32)
+TEST(BatchFileReaderTest, BatchLargerThanDescriptorLimit) {
+    const std::filesystem::path dir = std::filesystem::current_path() / "batch_file_reader_limit_test_data";
+    std::filesystem::create_directories(dir);
+    {
+        std::ofstream out(dir / "text.txt", std::ios::binary);
+        out << "limited";
+    }
+
+    BatchFileReader reader(8);
+    std::vector<ReadRequest> requests(256, ReadRequest{.path = dir / "text.txt"});
+
+    // room for the window but not for the whole batch
+    rlimit original;
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &original), 0);
+    const int probe = open((dir / "text.txt").c_str(), O_RDONLY);
+    ASSERT_NE(probe, -1);
+    close(probe);
+    rlimit limited = original;
+    limited.rlim_cur = (rlim_t)probe + 32;
+    ASSERT_EQ(setrlimit(RLIMIT_NOFILE, &limited), 0);
+
+    const auto contents = reader.read(requests);
+    setrlimit(RLIMIT_NOFILE, &original);
+
+    ASSERT_EQ(contents.size(), requests.size());
+    for(const auto & content : contents)
+    {
+        ASSERT_TRUE(content.has_value());
+        EXPECT_EQ(*content, "limited");
+    }
+
+    std::filesystem::remove_all(dir);
+}
+#endif
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include "pipeline/deferred_shading.hpp"
+
+using namespace astre::pipeline;
+
+// ==== TESTS ====
+
+TEST(ShadowMapCacheTest, FirstUseRendersSlot) {
+    ShadowMapCache cache;
+
+    EXPECT_TRUE(cache.update(0, 42));
+    EXPECT_TRUE(cache.update(3, 42));
+}
+
+TEST(ShadowMapCacheTest, UnchangedSignatureSkipsPass) {
+    ShadowMapCache cache;
+
+    ASSERT_TRUE(cache.update(1, 42));
+    EXPECT_FALSE(cache.update(1, 42));
+    EXPECT_FALSE(cache.update(1, 42));
+}
+
+TEST(ShadowMapCacheTest, ChangedSignatureRendersAgain) {
+    ShadowMapCache cache;
+
+    ASSERT_TRUE(cache.update(1, 42));
+    EXPECT_TRUE(cache.update(1, 43));
+    EXPECT_FALSE(cache.update(1, 43));
+
+    // other slots keep their content
+    ASSERT_TRUE(cache.update(0, 7));
+    EXPECT_TRUE(cache.update(1, 42));
+    EXPECT_FALSE(cache.update(0, 7));
+}
+
+TEST(ShadowMapCacheTest, InvalidatedSlotRendersAgain) {
+    ShadowMapCache cache;
+
+    ASSERT_TRUE(cache.update(2, 42));
+    cache.invalidate(2);
+    EXPECT_TRUE(cache.update(2, 42));
+
+    // slots never rendered are ignored
+    cache.invalidate(10);
+    EXPECT_TRUE(cache.update(10, 42));
+}
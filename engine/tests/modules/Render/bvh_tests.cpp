@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "render/bvh.hpp"
+
+using namespace astre;
+using namespace astre::render;
+
+namespace {
+
+AABB unitBoxAt(float x, float y, float z)
+{
+    return AABB{.min = math::Vec3(x - 0.5f, y - 0.5f, z - 0.5f), .max = math::Vec3(x + 0.5f, y + 0.5f, z + 0.5f)};
+}
+
+// row of boxes along x, item i centered at x = 2 * i
+std::vector<AABB> boxRow(std::size_t count)
+{
+    std::vector<AABB> boxes;
+    for(std::size_t i = 0; i < count; ++i) boxes.push_back(unitBoxAt(2.0f * i, 0.0f, 0.0f));
+    return boxes;
+}
+
+} // namespace
+
+// ==== TESTS ====
+
+TEST(BVHTest, EmptyTreeHasNoHit)
+{
+    BoundingVolumeHierarchy bvh;
+    bvh.build({});
+
+    EXPECT_TRUE(bvh.empty());
+    EXPECT_FALSE(bvh.raycast(Ray{}, 100.0f).has_value());
+}
+
+TEST(BVHTest, RayFindsItemUnderIt)
+{
+    BoundingVolumeHierarchy bvh;
+    bvh.build(boxRow(32));
+
+    const auto hit = bvh.raycast(Ray{.origin = math::Vec3(20.0f, 0.0f, 10.0f), .direction = math::Vec3(0.0f, 0.0f, -1.0f)}, 100.0f);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->item, 10u);
+    EXPECT_FLOAT_EQ(hit->distance, 9.5f);
+}
+
+TEST(BVHTest, ClosestOfSeveralItemsWins)
+{
+    BoundingVolumeHierarchy bvh;
+    bvh.build(boxRow(32));
+
+    // along the row from the far end, first box entered is the last one
+    const auto hit = bvh.raycast(Ray{.origin = math::Vec3(100.0f, 0.0f, 0.0f), .direction = math::Vec3(-1.0f, 0.0f, 0.0f)}, 1000.0f);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->item, 31u);
+}
+
+TEST(BVHTest, RefitFollowsMovedItems)
+{
+    BoundingVolumeHierarchy bvh;
+    auto boxes = boxRow(16);
+    bvh.build(boxes);
+
+    boxes[3] = unitBoxAt(6.0f, 50.0f, 0.0f);
+    ASSERT_TRUE(bvh.refit(boxes));
+
+    const auto hit = bvh.raycast(Ray{.origin = math::Vec3(6.0f, 50.0f, 10.0f), .direction = math::Vec3(0.0f, 0.0f, -1.0f)}, 100.0f);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->item, 3u);
+
+    EXPECT_FALSE(bvh.raycast(Ray{.origin = math::Vec3(6.0f, 0.0f, 10.0f), .direction = math::Vec3(0.0f, 0.0f, -1.0f)}, 100.0f).has_value());
+
+    EXPECT_FALSE(bvh.refit(boxRow(4)));
+}
+
+TEST(BVHTest, ItemTestRejectsBoxHits)
+{
+    BoundingVolumeHierarchy bvh;
+    bvh.build(boxRow(8));
+
+    const Ray ray{.origin = math::Vec3(100.0f, 0.0f, 0.0f), .direction = math::Vec3(-1.0f, 0.0f, 0.0f)};
+
+    // only even items are solid
+    const auto hit = bvh.raycast(ray, 1000.0f, [&](std::size_t item, float) -> std::optional<float>
+    {
+        if(item % 2 == 1) return std::nullopt;
+        return 100.0f - (2.0f * item + 0.5f);
+    });
+
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->item, 6u);
+}
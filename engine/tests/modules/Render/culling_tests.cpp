@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include "render/culling.hpp"
+
+using namespace astre;
+using namespace astre::render;
+
+namespace {
+
+Frustum makeCameraFrustum()
+{
+    // camera at origin looking down -Z
+    const math::Mat4 view = math::lookAt(math::Vec3(0.0f), math::Vec3(0.0f, 0.0f, -1.0f), math::Vec3(0.0f, 1.0f, 0.0f));
+    const math::Mat4 proj = math::perspective(math::radians(90.0f), 1.0f, 0.1f, 100.0f);
+    return extractFrustum(proj * view);
+}
+
+} // namespace
+
+// ==== TESTS ====
+
+TEST(CullingTest, BoundingVolumeOfCubePrefab) {
+    const BoundingVolume bounds = computeBoundingVolume(getCubePrefab());
+
+    EXPECT_FLOAT_EQ(bounds.center.x, 0.0f);
+    EXPECT_FLOAT_EQ(bounds.center.y, 0.0f);
+    EXPECT_FLOAT_EQ(bounds.center.z, 0.0f);
+    EXPECT_LE(bounds.aabb_min.x, bounds.aabb_max.x);
+    // sphere encloses every corner of the AABB
+    EXPECT_NEAR(bounds.radius, math::length(bounds.aabb_max - bounds.center), 1e-5f);
+}
+
+TEST(CullingTest, BoundingVolumeOfEmptyMeshIsZero) {
+    const BoundingVolume bounds = computeBoundingVolume(Mesh{});
+
+    EXPECT_FLOAT_EQ(bounds.radius, 0.0f);
+}
+
+TEST(CullingTest, TransformBoundingSphereUsesLargestScale) {
+    BoundingVolume bounds;
+    bounds.radius = 1.0f;
+
+    const math::Mat4 model =
+        math::translate(math::Mat4(1.0f), math::Vec3(5.0f, 0.0f, 0.0f)) *
+        math::scale(math::Mat4(1.0f), math::Vec3(1.0f, 3.0f, 2.0f));
+
+    const math::Vec4 sphere = transformBoundingSphere(bounds, model);
+
+    EXPECT_FLOAT_EQ(sphere.x, 5.0f);
+    EXPECT_NEAR(sphere.w, 3.0f, 1e-5f);
+}
+
+TEST(CullingTest, CullSpheresAgainstCameraFrustum) {
+    const Frustum frustum = makeCameraFrustum();
+
+    // 9 spheres, exercises batched path and scalar tail
+    const std::vector<math::Vec4> spheres = {
+        {0.0f, 0.0f, -10.0f, 1.0f},   // in front
+        {0.0f, 0.0f, 10.0f, 1.0f},    // behind
+        {50.0f, 0.0f, -10.0f, 1.0f},  // far right
+        {-50.0f, 0.0f, -10.0f, 1.0f}, // far left
+        {0.0f, 0.0f, -200.0f, 1.0f},  // beyond far plane
+        {11.0f, 0.0f, -10.0f, 2.0f},  // intersects right plane
+        {0.0f, 50.0f, -10.0f, 1.0f},  // above
+        {0.0f, 0.0f, -50.0f, 5.0f},   // in front
+        {0.0f, 0.0f, 0.5f, 1.0f},     // intersects near plane
+    };
+
+    std::vector<std::uint8_t> visible;
+    cullSpheres(frustum, spheres, visible);
+
+    const std::vector<std::uint8_t> expected = {1, 0, 0, 0, 0, 1, 0, 1, 1};
+    ASSERT_EQ(visible.size(), expected.size());
+    for(std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(visible[i], expected[i]) << "sphere " << i;
+    }
+}
+
+TEST(CullingTest, CullSpheresHandlesEmptyInput) {
+    std::vector<std::uint8_t> visible = {1, 1};
+    cullSpheres(makeCameraFrustum(), {}, visible);
+
+    EXPECT_TRUE(visible.empty());
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "render/draw_sort.hpp"
+
+using namespace astre::render;
+
+// ==== TESTS ====
+
+TEST(DrawSortTest, KeyOrdersByFrameBufferBeforeShader) {
+    const RenderOptions options{};
+
+    const auto a = makeDrawSortKey(1, 9, 9, options, 100.0f);
+    const auto b = makeDrawSortKey(2, 1, 1, options, 0.0f);
+
+    EXPECT_LT(a, b);
+}
+
+TEST(DrawSortTest, KeyOrdersByShaderBeforeVertexBuffer) {
+    const RenderOptions options{};
+
+    const auto a = makeDrawSortKey(std::nullopt, 1, 9, options, 100.0f);
+    const auto b = makeDrawSortKey(std::nullopt, 2, 1, options, 0.0f);
+
+    EXPECT_LT(a, b);
+}
+
+TEST(DrawSortTest, KeyOrdersFrontToBackWithinSameState) {
+    const RenderOptions options{};
+
+    const auto near_key = makeDrawSortKey(3, 4, 5, options, 1.5f);
+    const auto far_key = makeDrawSortKey(3, 4, 5, options, 250.0f);
+
+    EXPECT_LT(near_key, far_key);
+}
+
+TEST(DrawSortTest, NegativeDepthIsTreatedAsZero) {
+    const RenderOptions options{};
+
+    EXPECT_EQ(makeDrawSortKey(3, 4, 5, options, -10.0f), makeDrawSortKey(3, 4, 5, options, 0.0f));
+}
+
+TEST(DrawSortTest, EqualOptionsGiveEqualKeys) {
+    const RenderOptions a{ .mode = RenderMode::Solid, .polygon_offset = PolygonOffset{1.5f, 4.0f} };
+    const RenderOptions b{ .mode = RenderMode::Solid, .polygon_offset = PolygonOffset{1.5f, 4.0f} };
+
+    EXPECT_EQ(makeDrawSortKey(1, 2, 3, a, 7.0f), makeDrawSortKey(1, 2, 3, b, 7.0f));
+}
+
+TEST(DrawSortTest, DistinctOptionsGiveDistinctKeys) {
+    const std::vector<RenderOptions> options{
+        RenderOptions{},
+        RenderOptions{ .mode = RenderMode::Wireframe },
+        RenderOptions{ .polygon_offset = PolygonOffset{1.5f, 4.0f} },
+        RenderOptions{ .write_depth = false },
+        RenderOptions{ .depth_test = false },
+        RenderOptions{ .topology = PrimitiveTopology::Lines },
+        RenderOptions{ .write_depth = false, .depth_test = false, .topology = PrimitiveTopology::Lines }
+    };
+
+    for(std::size_t i = 0; i < options.size(); ++i)
+    {
+        for(std::size_t j = i + 1; j < options.size(); ++j)
+        {
+            EXPECT_NE(makeDrawSortKey(1, 2, 3, options[i], 7.0f), makeDrawSortKey(1, 2, 3, options[j], 7.0f)) << i << " " << j;
+        }
+    }
+}
+
+TEST(DrawSortTest, OptionsDoNotOverlapNeighbourFields) {
+    const RenderOptions all{ .mode = RenderMode::Wireframe, .polygon_offset = PolygonOffset{1.0f, 1.0f},
+        .write_depth = false, .depth_test = false, .topology = PrimitiveTopology::Lines };
+
+    // depth and vertex buffer read back unchanged around options with every bit set
+    const auto key = makeDrawSortKey(std::nullopt, 0, 0xFFFF, all, 1.0e30f);
+    const auto plain = makeDrawSortKey(std::nullopt, 0, 0xFFFF, RenderOptions{}, 1.0e30f);
+    EXPECT_EQ(key >> 28, plain >> 28);
+    EXPECT_EQ(key & 0x7FFFFF, plain & 0x7FFFFF);
+}
+
+TEST(DrawSortTest, VertexBufferIdsKeepOnlyTheirLowBits) {
+    const RenderOptions options{};
+    const std::size_t id = 0xFFF1;
+
+    // arena buffers of one format differ only above the bits the key keeps
+    EXPECT_EQ(makeDrawSortKey(1, 2, id, options, 7.0f),
+              makeDrawSortKey(1, 2, id | (std::size_t(5) << DRAW_SORT_VERTEX_BUFFER_BITS), options, 7.0f));
+    EXPECT_NE(makeDrawSortKey(1, 2, id, options, 7.0f), makeDrawSortKey(1, 2, id + 1, options, 7.0f));
+}
+
+TEST(DrawSortTest, RadixSortMatchesStableSort) {
+    std::mt19937_64 rng(1234);
+    std::uniform_int_distribution<std::uint64_t> small(0, 7);
+
+    std::vector<DrawSortItem> items;
+    for(std::uint32_t i = 0; i < 1000; ++i)
+    {
+        // few distinct values per field, like real draw lists
+        const DrawSortKey key = (small(rng) << 56) | (small(rng) << 44) | (small(rng) << 28) | rng() % 1000;
+        items.push_back(DrawSortItem{key, i});
+    }
+
+    auto expected = items;
+    std::stable_sort(expected.begin(), expected.end(),
+        [](const DrawSortItem & a, const DrawSortItem & b) { return a.key < b.key; });
+
+    radixSortDrawItems(items);
+
+    ASSERT_EQ(items.size(), expected.size());
+    for(std::size_t i = 0; i < items.size(); ++i)
+    {
+        EXPECT_EQ(items[i].key, expected[i].key);
+        EXPECT_EQ(items[i].index, expected[i].index);
+    }
+}
+
+TEST(DrawSortTest, RadixSortHandlesTrivialLists) {
+    std::vector<DrawSortItem> empty;
+    radixSortDrawItems(empty);
+    EXPECT_TRUE(empty.empty());
+
+    std::vector<DrawSortItem> same = {{42, 0}, {42, 1}, {42, 2}};
+    radixSortDrawItems(same);
+    EXPECT_EQ(same[0].index, 0u);
+    EXPECT_EQ(same[1].index, 1u);
+    EXPECT_EQ(same[2].index, 2u);
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "render/frame_ring_allocator.hpp"
+
+using namespace astre::render;
+
+// ==== TESTS ====
+
+TEST(FrameRingAllocatorTest, AllocatesInsideCurrentRegion) {
+    FrameRingAllocator allocator(1024, 3);
+
+    const auto a = allocator.allocate(100, 1);
+    const auto b = allocator.allocate(100, 1);
+
+    ASSERT_TRUE(a.has_value());
+    ASSERT_TRUE(b.has_value());
+    EXPECT_EQ(*a, 0u);
+    EXPECT_EQ(*b, 100u);
+    EXPECT_EQ(allocator.used(), 200u);
+}
+
+TEST(FrameRingAllocatorTest, RespectsAlignment) {
+    FrameRingAllocator allocator(1024, 3);
+
+    ASSERT_TRUE(allocator.allocate(10, 1).has_value());
+    const auto aligned = allocator.allocate(10, 256);
+
+    ASSERT_TRUE(aligned.has_value());
+    EXPECT_EQ(*aligned % 256, 0u);
+    EXPECT_EQ(*aligned, 256u);
+}
+
+TEST(FrameRingAllocatorTest, FailsWhenRegionIsFull) {
+    FrameRingAllocator allocator(1024, 3);
+
+    ASSERT_TRUE(allocator.allocate(1000, 1).has_value());
+    EXPECT_FALSE(allocator.allocate(100, 1).has_value());
+    EXPECT_FALSE(allocator.allocate(2048, 1).has_value());
+    EXPECT_FALSE(allocator.allocate(0, 1).has_value());
+
+    // still fits into the rest of the region
+    EXPECT_TRUE(allocator.allocate(24, 1).has_value());
+}
+
+TEST(FrameRingAllocatorTest, NextFrameMovesToNextRegionAndWraps) {
+    FrameRingAllocator allocator(1024, 3);
+
+    ASSERT_TRUE(allocator.allocate(1000, 1).has_value());
+
+    EXPECT_EQ(allocator.nextFrame(), 1u);
+    EXPECT_EQ(allocator.used(), 0u);
+
+    const auto offset = allocator.allocate(16, 1);
+    ASSERT_TRUE(offset.has_value());
+    EXPECT_EQ(*offset, 1024u);
+    EXPECT_EQ(allocator.regionOf(*offset), 1u);
+
+    EXPECT_EQ(allocator.nextFrame(), 2u);
+    EXPECT_EQ(allocator.nextFrame(), 0u);
+    EXPECT_EQ(*allocator.allocate(16, 1), 0u);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "render/indirect_draw.hpp"
+
+using namespace astre;
+using namespace astre::render;
+
+namespace {
+
+IndirectDrawGeometry geometry(std::size_t vertex_array, std::size_t index_size, std::size_t base_vertex, std::size_t first_index, std::size_t index_count)
+{
+    return IndirectDrawGeometry{
+        .vertex_array = vertex_array,
+        .index_size = index_size,
+        .format = VertexFormat::Compact,
+        .quantization = VertexQuantization{},
+        .range = GeometryRange{.base_vertex = base_vertex, .first_index = first_index, .index_count = index_count}
+    };
+}
+
+} // namespace
+
+// ==== TESTS ====
+
+TEST(IndirectDrawTest, CommandsFollowGeometryRange)
+{
+    const absl::flat_hash_map<std::size_t, IndirectDrawGeometry> buffers{
+        {1, geometry(7, 2, 100, 30, 36)}
+    };
+
+    const auto list = buildIndirectDrawList({{.vertex_buffer = 1, .base_instance = 5, .instance_count = 3}}, buffers);
+
+    ASSERT_EQ(list.commands.size(), 1u);
+    EXPECT_EQ(list.commands[0].count, 36u);
+    EXPECT_EQ(list.commands[0].instance_count, 3u);
+    EXPECT_EQ(list.commands[0].first_index, 30u);
+    EXPECT_EQ(list.commands[0].base_vertex, 100);
+    EXPECT_EQ(list.commands[0].base_instance, 5u);
+    EXPECT_EQ(list.draw_data.size(), 1u);
+    EXPECT_EQ(list.draws.size(), 1u);
+    EXPECT_TRUE(list.fallback.empty());
+}
+
+TEST(IndirectDrawTest, GroupsByVertexArrayAndIndexType)
+{
+    const absl::flat_hash_map<std::size_t, IndirectDrawGeometry> buffers{
+        {1, geometry(7, 2, 0, 0, 3)},
+        {2, geometry(8, 2, 0, 3, 3)},
+        {3, geometry(7, 2, 3, 6, 3)},
+        {4, geometry(7, 4, 6, 9, 3)}
+    };
+
+    const auto list = buildIndirectDrawList({
+        {.vertex_buffer = 1}, {.vertex_buffer = 2}, {.vertex_buffer = 3}, {.vertex_buffer = 4}
+    }, buffers);
+
+    ASSERT_EQ(list.groups.size(), 3u);
+    EXPECT_EQ(list.groups[0].vertex_array, 7u);
+    EXPECT_EQ(list.groups[0].index_size, 2u);
+    EXPECT_EQ(list.groups[0].command_count, 2u);
+    EXPECT_EQ(list.groups[1].vertex_array, 8u);
+    EXPECT_EQ(list.groups[1].first_command, 2u);
+    EXPECT_EQ(list.groups[2].index_size, 4u);
+
+    // draw order is kept inside of a group
+    EXPECT_EQ(list.draws[0].vertex_buffer, 1u);
+    EXPECT_EQ(list.draws[1].vertex_buffer, 3u);
+}
+
+TEST(IndirectDrawTest, UnknownBuffersFallBack)
+{
+    const absl::flat_hash_map<std::size_t, IndirectDrawGeometry> buffers{
+        {1, geometry(7, 2, 0, 0, 3)}
+    };
+
+    const auto list = buildIndirectDrawList({
+        {.vertex_buffer = 1}, {.vertex_buffer = 9, .base_instance = 4}, {.vertex_buffer = 1, .instance_count = 0}
+    }, buffers);
+
+    EXPECT_EQ(list.commands.size(), 1u);
+    ASSERT_EQ(list.fallback.size(), 1u);
+    EXPECT_EQ(list.fallback[0].vertex_buffer, 9u);
+    EXPECT_EQ(list.fallback[0].base_instance, 4u);
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include "render/light_clusters.hpp"
+
+using namespace astre;
+using namespace astre::render;
+
+namespace {
+
+LightClusterGrid makeCameraGrid()
+{
+    // camera at origin looking down -Z
+    const math::Mat4 view = math::lookAt(math::Vec3(0.0f), math::Vec3(0.0f, 0.0f, -1.0f), math::Vec3(0.0f, 1.0f, 0.0f));
+    const math::Mat4 proj = math::perspective(math::radians(90.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    return makeLightClusterGrid(view, proj);
+}
+
+GPULight makePointLight(const math::Vec3 & position)
+{
+    GPULight light{};
+    light.position = math::Vec4(position, 1.0f);
+    light.direction = math::Vec4(0.0f, 0.0f, -1.0f, GPU_LIGHT_TYPE_POINT);
+    light.color = math::Vec4(1.0f);
+    // range = sqrt(255) ~ 16
+    light.attenuation = math::Vec4(1.0f, 0.0f, 1.0f, 0.0f);
+    return light;
+}
+
+GPULight makeDirectionalLight()
+{
+    GPULight light{};
+    light.direction = math::Vec4(0.0f, -1.0f, 0.0f, GPU_LIGHT_TYPE_DIRECTIONAL);
+    light.color = math::Vec4(1.0f);
+    return light;
+}
+
+bool clusterContains(const LightClusters & clusters, std::uint32_t cluster, std::uint32_t light)
+{
+    const auto & range = clusters.clusters.at(cluster);
+    for(std::uint32_t i = range.offset; i < range.offset + range.count; ++i)
+    {
+        if(clusters.light_indices.at(i) == light) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+// ==== TESTS ====
+
+TEST(LightClustersTest, LightRangeFromAttenuation) {
+    const GPULight light = makePointLight(math::Vec3(0.0f));
+
+    EXPECT_NEAR(lightRange(light), std::sqrt(255.0f), 1e-3f);
+}
+
+TEST(LightClustersTest, GridNearAndFarFromProjection) {
+    const LightClusterGrid grid = makeCameraGrid();
+
+    EXPECT_NEAR(grid.near_plane, 0.1f, 1e-4f);
+    EXPECT_NEAR(grid.far_plane, 100.0f, 1e-1f);
+    EXPECT_EQ(grid.cluster_min.size(), LightClusterGrid::CLUSTER_COUNT);
+}
+
+TEST(LightClustersTest, PointLightAssignedOnlyToNearbyClusters) {
+    const LightClusterGrid grid = makeCameraGrid();
+
+    GPULight light = makePointLight(math::Vec3(0.0f, 0.0f, -50.0f));
+    light.attenuation = math::Vec4(1.0f, 0.0f, 255.0f, 0.0f); // range = 1
+
+    const LightClusters clusters = buildLightClusters(grid, {light}, 0, LightClusterGrid::SLICES);
+    ASSERT_EQ(clusters.clusters.size(), LightClusterGrid::CLUSTER_COUNT);
+
+    // light center is in the middle of the screen, deep in the frustum
+    const std::uint32_t slice = (std::uint32_t)std::floor(std::log(50.0f / grid.near_plane) / std::log(grid.far_plane / grid.near_plane) * LightClusterGrid::SLICES);
+    const std::uint32_t center = 8 + 4 * LightClusterGrid::TILES_X + slice * LightClusterGrid::TILES_X * LightClusterGrid::TILES_Y;
+    EXPECT_TRUE(clusterContains(clusters, center, 0));
+
+    // corner tile of the nearest slice is far from the light
+    EXPECT_FALSE(clusterContains(clusters, 0, 0));
+
+    // small light touches only a handful of clusters
+    EXPECT_LT(clusters.light_indices.size(), 32u);
+}
+
+TEST(LightClustersTest, LightBehindCameraIsNotAssigned) {
+    const LightClusterGrid grid = makeCameraGrid();
+
+    GPULight light = makePointLight(math::Vec3(0.0f, 0.0f, 50.0f));
+
+    const LightClusters clusters = buildLightClusters(grid, {light}, 0, LightClusterGrid::SLICES);
+
+    EXPECT_TRUE(clusters.light_indices.empty());
+}
+
+TEST(LightClustersTest, DirectionalLightAssignedToEveryCluster) {
+    const LightClusterGrid grid = makeCameraGrid();
+
+    const LightClusters clusters = buildLightClusters(grid, {makeDirectionalLight()}, 0, LightClusterGrid::SLICES);
+
+    ASSERT_EQ(clusters.clusters.size(), LightClusterGrid::CLUSTER_COUNT);
+    for(const auto & cluster : clusters.clusters)
+    {
+        EXPECT_EQ(cluster.count, 1u);
+    }
+}
+
+TEST(LightClustersTest, MergedSliceRangesMatchFullBuild) {
+    const LightClusterGrid grid = makeCameraGrid();
+
+    const std::vector<GPULight> lights = {
+        makePointLight(math::Vec3(0.0f, 0.0f, -5.0f)),
+        makeDirectionalLight(),
+        makePointLight(math::Vec3(10.0f, 2.0f, -30.0f)),
+        makePointLight(math::Vec3(-20.0f, -5.0f, -80.0f))
+    };
+
+    const LightClusters full = buildLightClusters(grid, lights, 0, LightClusterGrid::SLICES);
+
+    std::vector<LightClusters> parts;
+    for(std::uint32_t slice = 0; slice < LightClusterGrid::SLICES; slice += 5)
+    {
+        parts.emplace_back(buildLightClusters(grid, lights, slice, slice + 5));
+    }
+    const LightClusters merged = mergeLightClusters(std::move(parts));
+
+    EXPECT_EQ(merged.slice_begin, 0u);
+    EXPECT_EQ(merged.slice_end, LightClusterGrid::SLICES);
+    ASSERT_EQ(merged.clusters.size(), full.clusters.size());
+    EXPECT_EQ(merged.light_indices, full.light_indices);
+    for(std::size_t i = 0; i < full.clusters.size(); ++i)
+    {
+        EXPECT_EQ(merged.clusters[i].offset, full.clusters[i].offset);
+        EXPECT_EQ(merged.clusters[i].count, full.clusters[i].count);
+    }
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "render/mesh_lod.hpp"
+
+using namespace astre;
+using namespace astre::render;
+
+namespace {
+
+const std::vector<VertexBufferLOD> LODS{
+    {.vertex_buffer = 10, .error = 0.0f},
+    {.vertex_buffer = 11, .error = 0.01f},
+    {.vertex_buffer = 12, .error = 0.04f},
+};
+
+BoundingVolume unitSphere()
+{
+    BoundingVolume bounds;
+    bounds.aabb_min = math::Vec3(-1.0f);
+    bounds.aabb_max = math::Vec3(1.0f);
+    bounds.center = math::Vec3(0.0f);
+    bounds.radius = 1.0f;
+    return bounds;
+}
+
+} // namespace
+
+// ==== TESTS ====
+
+TEST(MeshLODTest, PixelsPerUnitFallsWithDistance)
+{
+    const math::Mat4 proj = math::perspective(math::radians(90.0f), 1.0f, 0.1f, 100.0f);
+    const math::Mat4 model(1.0f);
+
+    // 90 deg fov: at distance d the screen half height covers d units
+    const float near = pixelsPerMeshUnit(unitSphere(), model, math::Vec3(0.0f, 0.0f, 11.0f), proj, 1000);
+    const float far = pixelsPerMeshUnit(unitSphere(), model, math::Vec3(0.0f, 0.0f, 101.0f), proj, 1000);
+
+    EXPECT_NEAR(near, 50.0f, 1e-3f);
+    EXPECT_NEAR(far, 5.0f, 1e-3f);
+    EXPECT_TRUE(std::isinf(pixelsPerMeshUnit(unitSphere(), model, math::Vec3(0.5f, 0.0f, 0.0f), proj, 1000)));
+}
+
+TEST(MeshLODTest, SelectsCoarsestWithinPixelError)
+{
+    EXPECT_EQ(selectLOD(LODS, 1000.0f, 0), 0u);  // LOD 1 would be 10 px off
+    EXPECT_EQ(selectLOD(LODS, 50.0f, 0), 1u);    // 0.5 px vs 2 px
+    EXPECT_EQ(selectLOD(LODS, 10.0f, 0), 2u);    // 0.4 px
+    EXPECT_EQ(selectLOD({}, 10.0f, 3), 0u);
+}
+
+TEST(MeshLODTest, HysteresisKeepsCurrentLevelNearThreshold)
+{
+    // LOD 2 error right at the threshold: 0.04 * 25 = 1 px
+    EXPECT_EQ(selectLOD(LODS, 25.0f, 1), 1u);  // not coarsened, needs 0.75 px
+    EXPECT_EQ(selectLOD(LODS, 25.0f, 2), 2u);  // not refined, allowed up to 1.25 px
+    EXPECT_EQ(selectLOD(LODS, 32.0f, 2), 1u);  // 1.28 px, refined
+    EXPECT_EQ(selectLOD(LODS, 18.0f, 1), 2u);  // 0.72 px, coarsened
+}
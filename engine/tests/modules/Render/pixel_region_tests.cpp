@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "render/pixel_region.hpp"
+
+using namespace astre;
+using namespace astre::render;
+
+// ==== TESTS ====
+
+TEST(PixelRegionTest, ClipKeepsRectInsideSurface)
+{
+    const auto clipped = clipPixelRect(PixelRect{.x = -2, .y = 98, .width = 5, .height = 5}, {100, 100});
+
+    ASSERT_TRUE(clipped.has_value());
+    EXPECT_EQ(clipped->x, 0);
+    EXPECT_EQ(clipped->y, 98);
+    EXPECT_EQ(clipped->width, 3u);
+    EXPECT_EQ(clipped->height, 2u);
+}
+
+TEST(PixelRegionTest, ClipOutsideSurfaceIsEmpty)
+{
+    EXPECT_FALSE(clipPixelRect(PixelRect{.x = 100, .y = 0, .width = 4, .height = 4}, {100, 100}).has_value());
+    EXPECT_FALSE(clipPixelRect(PixelRect{.x = -4, .y = 0, .width = 4, .height = 4}, {100, 100}).has_value());
+    EXPECT_FALSE(clipPixelRect(PixelRect{.x = 0, .y = 0, .width = 0, .height = 4}, {100, 100}).has_value());
+}
+
+TEST(PixelRegionTest, AtUsesWindowCoordinates)
+{
+    const PixelRegionUint64 region{
+        .rect = PixelRect{.x = 10, .y = 20, .width = 2, .height = 2},
+        .values = {1, 2, 3, 4} // bottom row first
+    };
+
+    EXPECT_EQ(region.at(10, 20), 1u);
+    EXPECT_EQ(region.at(11, 20), 2u);
+    EXPECT_EQ(region.at(10, 21), 3u);
+    EXPECT_EQ(region.at(11, 21), 4u);
+    EXPECT_FALSE(region.at(12, 20).has_value());
+    EXPECT_FALSE(region.at(9, 21).has_value());
+}
+
+TEST(PixelRegionTest, NearestNonZeroSkipsBackground)
+{
+    const PixelRegionUint64 region{
+        .rect = PixelRect{.x = 0, .y = 0, .width = 3, .height = 3},
+        .values = {
+            0, 0, 0,
+            0, 0, 7,
+            5, 0, 0}
+    };
+
+    EXPECT_EQ(region.nearestNonZero(1, 1), 7u);
+    EXPECT_EQ(region.nearestNonZero(0, 2), 5u);
+
+    const PixelRegionUint64 empty{
+        .rect = PixelRect{.x = 0, .y = 0, .width = 2, .height = 1},
+        .values = {0, 0}
+    };
+    EXPECT_FALSE(empty.nearestNonZero(0, 0).has_value());
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <limits>
+
+#include "render/program_binary_cache.hpp"
+
+using namespace astre;
+using namespace astre::render;
+
+namespace {
+
+class ProgramBinaryCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        directory = std::filesystem::temp_directory_path() / "astre_program_binary_cache_tests";
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    std::filesystem::path directory;
+};
+
+const std::vector<std::vector<std::string>> SOURCES{
+    {"#version 450\n", "void main(){}\n"},
+    {"#version 450\n", "out vec4 c; void main(){ c = vec4(1); }\n"}
+};
+
+ProgramBinary binary()
+{
+    return ProgramBinary{.format = 0x8E21, .data = {1, 2, 3, 4, 5, 6, 7, 8}};
+}
+
+} // namespace
+
+// ==== TESTS ====
+
+TEST_F(ProgramBinaryCacheTest, StoreThenLoad)
+{
+    ProgramBinaryCache cache(directory, "vendor|renderer|4.6");
+    const auto key = cache.key(SOURCES);
+
+    EXPECT_FALSE(cache.load(key).has_value());
+    ASSERT_TRUE(cache.store(key, binary()));
+
+    const auto loaded = cache.load(key);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->format, binary().format);
+    EXPECT_EQ(loaded->data, binary().data);
+}
+
+TEST_F(ProgramBinaryCacheTest, KeyDependsOnSourcesAndDriver)
+{
+    ProgramBinaryCache cache(directory, "vendor|renderer|4.6");
+    ProgramBinaryCache updated_driver(directory, "vendor|renderer|4.6.1");
+
+    auto changed = SOURCES;
+    changed[1][1] = "out vec4 c; void main(){ c = vec4(0); }\n";
+
+    auto split = SOURCES;
+    split[0] = {"#version 450\nvoid main(){}\n"};
+
+    EXPECT_EQ(cache.key(SOURCES), cache.key(SOURCES));
+    EXPECT_NE(cache.key(SOURCES), updated_driver.key(SOURCES));
+    EXPECT_NE(cache.key(SOURCES), cache.key(changed));
+    EXPECT_NE(cache.key(SOURCES), cache.key(split));
+}
+
+TEST_F(ProgramBinaryCacheTest, DamagedEntryMisses)
+{
+    ProgramBinaryCache cache(directory, "vendor|renderer|4.6");
+    const auto key = cache.key(SOURCES);
+    ASSERT_TRUE(cache.store(key, binary()));
+
+    // flip last byte of the binary data
+    const auto path = directory / std::format("{:016x}.bin", key);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put(42);
+    }
+    EXPECT_FALSE(cache.load(key).has_value());
+
+    // truncated
+    std::filesystem::resize_file(path, 10);
+    EXPECT_FALSE(cache.load(key).has_value());
+}
+
+TEST_F(ProgramBinaryCacheTest, SizeBeyondFileMisses)
+{
+    ProgramBinaryCache cache(directory, "vendor|renderer|4.6");
+    const auto key = cache.key(SOURCES);
+    ASSERT_TRUE(cache.store(key, binary()));
+
+    // header size field: magic, version, key and format come first
+    const auto path = directory / std::format("{:016x}.bin", key);
+    {
+        const std::uint64_t size = std::numeric_limits<std::uint64_t>::max() / 2;
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(4 + 4 + 8 + 4);
+        file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    }
+    EXPECT_FALSE(cache.load(key).has_value());
+}
+
+TEST_F(ProgramBinaryCacheTest, EraseRemovesEntry)
+{
+    ProgramBinaryCache cache(directory, "vendor|renderer|4.6");
+    const auto key = cache.key(SOURCES);
+    ASSERT_TRUE(cache.store(key, binary()));
+
+    EXPECT_TRUE(cache.erase(key));
+    EXPECT_FALSE(cache.load(key).has_value());
+    EXPECT_FALSE(cache.erase(key));
+}
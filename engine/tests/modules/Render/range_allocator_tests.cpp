@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "render/range_allocator.hpp"
+
+using namespace astre::render;
+
+// ==== TESTS ====
+
+TEST(RangeAllocatorTest, AllocatesUntilFull)
+{
+    RangeAllocator allocator(100);
+
+    EXPECT_EQ(allocator.allocate(40), 0u);
+    EXPECT_EQ(allocator.allocate(60), 40u);
+    EXPECT_FALSE(allocator.allocate(1).has_value());
+    EXPECT_FALSE(allocator.allocate(0).has_value());
+
+    const auto stats = allocator.stats();
+    EXPECT_EQ(stats.used, 100u);
+    EXPECT_EQ(stats.allocations, 2u);
+    EXPECT_EQ(stats.free_blocks, 0u);
+    EXPECT_FLOAT_EQ(stats.fragmentation, 0.0f);
+}
+
+TEST(RangeAllocatorTest, BestFitReusesSmallestHole)
+{
+    RangeAllocator allocator(100);
+    const auto a = allocator.allocate(10);
+    allocator.allocate(10);
+    const auto c = allocator.allocate(30);
+    allocator.allocate(10);
+
+    ASSERT_TRUE(allocator.free(*a));
+    ASSERT_TRUE(allocator.free(*c));
+
+    // holes of 10, 30 and the 40 tail: 8 goes into the 10 hole, 25 into the 30 hole
+    EXPECT_EQ(allocator.allocate(8), *a);
+    EXPECT_EQ(allocator.allocate(25), *c);
+    EXPECT_FALSE(allocator.free(*a + 1));
+}
+
+TEST(RangeAllocatorTest, FreeCoalescesNeighbours)
+{
+    RangeAllocator allocator(90);
+    const auto a = allocator.allocate(30);
+    const auto b = allocator.allocate(30);
+    const auto c = allocator.allocate(30);
+
+    allocator.free(*a);
+    allocator.free(*c);
+    EXPECT_EQ(allocator.stats().free_blocks, 2u);
+    EXPECT_NEAR(allocator.stats().fragmentation, 0.5f, 1e-6f);
+    EXPECT_FALSE(allocator.allocate(60).has_value());
+
+    allocator.free(*b);
+    const auto stats = allocator.stats();
+    EXPECT_EQ(stats.free_blocks, 1u);
+    EXPECT_EQ(stats.largest_free_block, 90u);
+    EXPECT_EQ(allocator.allocate(90), 0u);
+}
+
+TEST(RangeAllocatorTest, AlignmentKeepsPaddingFree)
+{
+    RangeAllocator allocator(64);
+    EXPECT_EQ(allocator.allocate(3), 0u);
+    EXPECT_EQ(allocator.allocate(4, 4), 4u);
+    // 1 unit of padding at offset 3 stays allocatable
+    EXPECT_EQ(allocator.allocate(1), 3u);
+    EXPECT_EQ(allocator.stats().used, 8u);
+}
+
+TEST(RangeAllocatorTest, GrowExtendsTailBlock)
+{
+    RangeAllocator allocator(50);
+    allocator.allocate(40);
+
+    allocator.grow(100);
+    EXPECT_EQ(allocator.capacity(), 100u);
+    EXPECT_EQ(allocator.stats().free_blocks, 1u);
+    EXPECT_EQ(allocator.allocate(60), 40u);
+
+    allocator.grow(10);
+    EXPECT_EQ(allocator.capacity(), 100u);
+}
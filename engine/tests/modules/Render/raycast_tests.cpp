@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include "render/raycast.hpp"
+
+using namespace astre;
+using namespace astre::render;
+
+// ==== TESTS ====
+
+TEST(RaycastTest, RayHitsBoxInFront)
+{
+    const AABB box{.min = math::Vec3(-1.0f), .max = math::Vec3(1.0f)};
+    const Ray ray{.origin = math::Vec3(0.0f, 0.0f, 5.0f), .direction = math::Vec3(0.0f, 0.0f, -1.0f)};
+
+    const auto distance = intersectRayAABB(ray, box, 100.0f);
+    ASSERT_TRUE(distance.has_value());
+    EXPECT_FLOAT_EQ(*distance, 4.0f);
+}
+
+TEST(RaycastTest, RayMissesBoxBehindOrTooFar)
+{
+    const AABB box{.min = math::Vec3(-1.0f), .max = math::Vec3(1.0f)};
+
+    EXPECT_FALSE(intersectRayAABB(Ray{.origin = math::Vec3(0.0f, 0.0f, 5.0f), .direction = math::Vec3(0.0f, 0.0f, 1.0f)}, box, 100.0f).has_value());
+    EXPECT_FALSE(intersectRayAABB(Ray{.origin = math::Vec3(0.0f, 0.0f, 5.0f), .direction = math::Vec3(0.0f, 0.0f, -1.0f)}, box, 3.0f).has_value());
+    EXPECT_FALSE(intersectRayAABB(Ray{.origin = math::Vec3(3.0f, 0.0f, 5.0f), .direction = math::Vec3(0.0f, 0.0f, -1.0f)}, box, 100.0f).has_value());
+}
+
+TEST(RaycastTest, RayStartingInsideBoxHitsAtZero)
+{
+    const AABB box{.min = math::Vec3(-1.0f), .max = math::Vec3(1.0f)};
+    const auto distance = intersectRayAABB(Ray{.origin = math::Vec3(0.0f), .direction = math::Vec3(1.0f, 0.0f, 0.0f)}, box, 100.0f);
+
+    ASSERT_TRUE(distance.has_value());
+    EXPECT_FLOAT_EQ(*distance, 0.0f);
+}
+
+TEST(RaycastTest, TriangleHitInsideMissOutside)
+{
+    const math::Vec3 a(-1.0f, -1.0f, 0.0f), b(1.0f, -1.0f, 0.0f), c(0.0f, 1.0f, 0.0f);
+
+    const auto hit = intersectRayTriangle(Ray{.origin = math::Vec3(0.0f, 0.0f, 2.0f), .direction = math::Vec3(0.0f, 0.0f, -1.0f)}, a, b, c);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_FLOAT_EQ(*hit, 2.0f);
+
+    EXPECT_FALSE(intersectRayTriangle(Ray{.origin = math::Vec3(0.9f, 0.9f, 2.0f), .direction = math::Vec3(0.0f, 0.0f, -1.0f)}, a, b, c).has_value());
+}
+
+TEST(RaycastTest, MeshReturnsClosestTriangle)
+{
+    TriangleMesh mesh;
+    mesh.positions = {
+        math::Vec3(-1.0f, -1.0f, 0.0f), math::Vec3(1.0f, -1.0f, 0.0f), math::Vec3(0.0f, 1.0f, 0.0f),
+        math::Vec3(-1.0f, -1.0f, 1.0f), math::Vec3(1.0f, -1.0f, 1.0f), math::Vec3(0.0f, 1.0f, 1.0f)
+    };
+    mesh.indices = {0, 1, 2, 3, 4, 5};
+
+    const Ray ray{.origin = math::Vec3(0.0f, 0.0f, 3.0f), .direction = math::Vec3(0.0f, 0.0f, -1.0f)};
+
+    const auto hit = intersectRayMesh(ray, mesh, 100.0f);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_FLOAT_EQ(*hit, 2.0f);
+
+    EXPECT_FALSE(intersectRayMesh(ray, mesh, 1.5f).has_value());
+}
+
+TEST(RaycastTest, TransformedBoundsEncloseModel)
+{
+    BoundingVolume bounds;
+    bounds.aabb_min = math::Vec3(-1.0f);
+    bounds.aabb_max = math::Vec3(1.0f);
+
+    math::Mat4 model(1.0f);
+    model[0][0] = 2.0f;                               // scale x by two
+    model[3] = math::Vec4(10.0f, 0.0f, 0.0f, 1.0f);   // move along x
+
+    const AABB box = transformAABB(bounds, model);
+    EXPECT_FLOAT_EQ(box.min.x, 8.0f);
+    EXPECT_FLOAT_EQ(box.max.x, 12.0f);
+    EXPECT_FLOAT_EQ(box.min.y, -1.0f);
+    EXPECT_FLOAT_EQ(box.max.z, 1.0f);
+}
+
+TEST(RaycastTest, ScreenCenterRayLooksAlongView)
+{
+    const math::Mat4 view = math::lookAt(math::Vec3(0.0f, 0.0f, 5.0f), math::Vec3(0.0f), math::Vec3(0.0f, 1.0f, 0.0f));
+    const math::Mat4 projection = math::perspective(math::radians(60.0f), 1.0f, 0.1f, 100.0f);
+
+    const Ray ray = screenPointToRay(math::Vec2(0.0f, 0.0f), view, projection);
+
+    EXPECT_NEAR(ray.origin.x, 0.0f, 1e-4f);
+    EXPECT_NEAR(ray.origin.z, 4.9f, 1e-3f);
+    EXPECT_NEAR(ray.direction.z, -1.0f, 1e-4f);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "render/shadow_atlas.hpp"
+
+using namespace astre::render;
+
+static bool overlaps(const ViewportRect & a, const ViewportRect & b)
+{
+    return a.x < b.x + b.width && b.x < a.x + a.width &&
+           a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+// ==== TESTS ====
+
+TEST(ShadowAtlasTest, RoundsSizesToPowerOfTwo) {
+    const ShadowAtlas atlas(3000, 200);
+
+    EXPECT_EQ(atlas.size(), 2048u);
+    EXPECT_EQ(atlas.minTileSize(), 128u);
+}
+
+TEST(ShadowAtlasTest, TilesDoNotOverlapAndStayInside) {
+    const ShadowAtlas atlas(4096, 256);
+
+    const auto tiles = atlas.allocate({2048, 512, 1024, 256, 1024, 512, 256});
+    ASSERT_EQ(tiles.size(), 7u);
+
+    for(std::size_t i = 0; i < tiles.size(); ++i)
+    {
+        ASSERT_TRUE(tiles[i].has_value());
+        EXPECT_GE(tiles[i]->x, 0);
+        EXPECT_GE(tiles[i]->y, 0);
+        EXPECT_LE(tiles[i]->x + tiles[i]->width, 4096);
+        EXPECT_LE(tiles[i]->y + tiles[i]->height, 4096);
+
+        for(std::size_t j = i + 1; j < tiles.size(); ++j)
+        {
+            ASSERT_TRUE(tiles[j].has_value());
+            EXPECT_FALSE(overlaps(*tiles[i], *tiles[j]));
+        }
+    }
+
+    EXPECT_EQ(tiles[0]->width, 2048);
+    EXPECT_EQ(tiles[1]->width, 512);
+    EXPECT_EQ(tiles[3]->width, 256);
+}
+
+TEST(ShadowAtlasTest, DowngradesSmallestTilesWhenFull) {
+    const ShadowAtlas atlas(1024, 128);
+
+    // five quadrants do not fit, the last tiles are downgraded instead of the first ones
+    const auto tiles = atlas.allocate({512, 512, 512, 512, 512});
+
+    for(std::size_t i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(tiles[i].has_value());
+        EXPECT_EQ(tiles[i]->width, 512);
+    }
+    ASSERT_TRUE(tiles[3].has_value());
+    ASSERT_TRUE(tiles[4].has_value());
+    EXPECT_EQ(tiles[3]->width, 256);
+    EXPECT_EQ(tiles[4]->width, 128);
+    EXPECT_FALSE(overlaps(*tiles[3], *tiles[4]));
+}
+
+TEST(ShadowAtlasTest, DropsLeastImportantWhenMinimumTilesDoNotFit) {
+    const ShadowAtlas atlas(512, 256);
+
+    const auto tiles = atlas.allocate({256, 256, 256, 256, 256});
+
+    for(std::size_t i = 0; i < 4; ++i)EXPECT_TRUE(tiles[i].has_value());
+    EXPECT_FALSE(tiles[4].has_value());
+}
+
+TEST(ShadowAtlasTest, AllocationIsDeterministic) {
+    const ShadowAtlas atlas(4096, 256);
+
+    const std::vector<unsigned int> request{1024, 256, 2048, 512, 512};
+
+    EXPECT_EQ(atlas.allocate(request), atlas.allocate(request));
+}
+
+TEST(ShadowAtlasTest, UVCoversTile) {
+    const ShadowAtlas atlas(2048, 256);
+
+    const auto uv = atlas.toUV(ViewportRect{1024, 512, 512, 512});
+
+    EXPECT_FLOAT_EQ(uv.x, 0.5f);
+    EXPECT_FLOAT_EQ(uv.y, 0.25f);
+    EXPECT_FLOAT_EQ(uv.z, 0.25f);
+    EXPECT_FLOAT_EQ(uv.w, 0.25f);
+}
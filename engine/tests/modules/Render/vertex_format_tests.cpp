@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "render/vertex_format.hpp"
+
+using namespace astre;
+using namespace astre::render;
+
+// ==== TESTS ====
+
+TEST(VertexFormatTest, OctahedralNormalRoundTrip) {
+    const std::vector<math::Vec3> normals = {
+        {0.0f, 0.0f, 1.0f},
+        {0.0f, 0.0f, -1.0f},
+        {1.0f, 0.0f, 0.0f},
+        {0.0f, -1.0f, 0.0f},
+        math::normalize(math::Vec3(1.0f, 2.0f, -3.0f)),
+        math::normalize(math::Vec3(-0.3f, 0.5f, 0.8f))
+    };
+
+    for(const auto & normal : normals)
+    {
+        const math::Vec3 decoded = decodeOctahedralNormal(encodeOctahedralNormal(normal));
+        EXPECT_NEAR(decoded.x, normal.x, 1e-3f);
+        EXPECT_NEAR(decoded.y, normal.y, 1e-3f);
+        EXPECT_NEAR(decoded.z, normal.z, 1e-3f);
+    }
+}
+
+TEST(VertexFormatTest, HalfFloatRoundTrip) {
+    for(const float value : {0.0f, 1.0f, -1.0f, 0.5f, 0.25f, 2048.0f, 65504.0f})
+    {
+        EXPECT_FLOAT_EQ(halfToFloat(floatToHalf(value)), value);
+    }
+
+    // UV precision in [0, 1]
+    EXPECT_NEAR(halfToFloat(floatToHalf(0.123456f)), 0.123456f, 1e-3f);
+    EXPECT_NEAR(halfToFloat(floatToHalf(1e-6f)), 1e-6f, 1e-7f);
+
+    EXPECT_TRUE(std::isinf(halfToFloat(floatToHalf(1e6f))));
+}
+
+TEST(VertexFormatTest, QuantizedPositionsStayInsideBounds) {
+    const std::vector<GPUVertex> vertices = {
+        {{-2.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}},
+        {{ 2.0f, 4.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f}},
+        {{ 0.5f, 1.0f, 1.0f}, {0.0f, 1.0f, 0.0f}, {0.5f, 0.5f}}
+    };
+
+    const VertexQuantization quantization = computeVertexQuantization(vertices, VertexFormat::Quantized);
+    const auto quantized = toQuantizedVertices(vertices, quantization);
+    ASSERT_EQ(quantized.size(), vertices.size());
+
+    for(std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        for(int axis = 0; axis < 3; ++axis)
+        {
+            const float stored = (float)quantized[i].position[axis] / 65535.0f;
+            const float decoded = quantization.offset[axis] + stored * quantization.scale[axis];
+            EXPECT_NEAR(decoded, vertices[i].position[axis], 1e-3f);
+        }
+    }
+}
+
+TEST(VertexFormatTest, QuantizationIsIdentityForUnquantizedFormats) {
+    const std::vector<GPUVertex> vertices = {{{5.0f, 5.0f, 5.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f}}};
+
+    const VertexQuantization quantization = computeVertexQuantization(vertices, VertexFormat::Compact);
+
+    EXPECT_FLOAT_EQ(quantization.offset.x, 0.0f);
+    EXPECT_FLOAT_EQ(quantization.scale.x, 1.0f);
+}
+
+TEST(VertexFormatTest, IndexSizeFollowsVertexCount) {
+    EXPECT_EQ(indexSize(3), 2u);
+    EXPECT_EQ(indexSize(65536), 2u);
+    EXPECT_EQ(indexSize(65537), 4u);
+}
+
+TEST(VertexFormatTest, CompactFormatsAreSmaller) {
+    EXPECT_EQ(vertexStride(VertexFormat::Full), 32u);
+    EXPECT_EQ(vertexStride(VertexFormat::Compact), 20u);
+    EXPECT_EQ(vertexStride(VertexFormat::Quantized), 16u);
+}
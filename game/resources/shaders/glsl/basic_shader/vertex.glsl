@@ -4,6 +4,25 @@ layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aUV;
 
+// vertex decoding, set by renderer from the vertex buffer format
+uniform uint uVertexFormat;    // 0 full, otherwise octahedral normal
+uniform vec3 uPositionOffset;
+uniform vec3 uPositionScale;
+
+vec3 decodePosition(vec3 p)
+{
+    return uPositionOffset + p * uPositionScale;
+}
+
+vec3 decodeNormal(vec3 n)
+{
+    if(uVertexFormat == 0u) return n;
+    vec3 d = vec3(n.xy, 1.0 - abs(n.x) - abs(n.y));
+    float t = max(-d.z, 0.0);
+    d.xy += vec2(d.x >= 0.0 ? -t : t, d.y >= 0.0 ? -t : t);
+    return normalize(d);
+}
+
 uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProjection;
@@ -14,8 +33,8 @@ out vec2 TexCoord;
 
 void main()
 {
-    FragPos = vec3(uModel * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(uModel))) * aNormal;
+    FragPos = vec3(uModel * vec4(decodePosition(aPos), 1.0));
+    Normal = mat3(transpose(inverse(uModel))) * decodeNormal(aNormal);
     TexCoord = aUV;
 
     gl_Position = uProjection * uView * vec4(FragPos, 1.0);
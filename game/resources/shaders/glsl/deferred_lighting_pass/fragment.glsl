@@ -20,24 +20,39 @@ struct GPULight {
     vec4 attenuation;   // x: constant, y: linear, z: quadratic
     vec2 cutoff;        // x: inner cos, y: outer cos
     vec2 castShadows;   // x: enable, y: shadowMapIndex
+    vec4 shadowAtlasRect; // xy: offset, zw: size of shadow tile in atlas UV
 };
 
 layout(std430, binding = 2) buffer LightBuffer {
     GPULight lights[];
 };
-uniform uint lightCount;
 
-// Shadow Map
+// Clustered lights, screen is split into tiles and depth into exponential slices
+#define CLUSTER_TILES_X 16
+#define CLUSTER_TILES_Y 9
+#define CLUSTER_SLICES  24
+
+layout(std430, binding = 4) readonly buffer LightClusterBuffer {
+    uvec2 clusters[]; // x: offset, y: count in lightIndices
+};
+layout(std430, binding = 5) readonly buffer LightIndexBuffer {
+    uint lightIndices[];
+};
+uniform mat4 uView;
+uniform float clusterNear;
+uniform float clusterFar;
+
+// Shadow Atlas, every shadow caster owns one tile
 #define MAX_SHADOW_CASTERS 16
 
-layout(binding = 3) uniform sampler2DShadow shadowMaps[MAX_SHADOW_CASTERS];
+layout(binding = 3) uniform sampler2DShadow shadowAtlas;
 uniform mat4 lightSpaceMatrices[MAX_SHADOW_CASTERS];
 uniform uint shadowCastersCount;
 
 in vec2 TexCoord;
 out vec4 FragColor;
 
-float calculateShadow(vec3 fragPosWorld, int shadow_caster_id)
+float calculateShadow(vec3 fragPosWorld, int shadow_caster_id, vec4 atlasRect)
 {
     vec4 fragPosLightSpace = lightSpaceMatrices[shadow_caster_id] * vec4(fragPosWorld, 1.0);
     if (fragPosLightSpace.w <= 0.0) return 1.0; // behind the light -> no shadow data, treat as lit
@@ -53,7 +68,22 @@ float calculateShadow(vec3 fragPosWorld, int shadow_caster_id)
 
     projCoords.z -= 0.005;
 
-    return texture(shadowMaps[shadow_caster_id], projCoords); // 0 = in shadow, 1 = lit
+    // keep filtering inside of the tile so neighbouring tiles do not bleed in
+    vec2 halfTexel = 0.5 / vec2(textureSize(shadowAtlas, 0));
+    projCoords.xy = clamp(atlasRect.xy + projCoords.xy * atlasRect.zw,
+        atlasRect.xy + halfTexel, atlasRect.xy + atlasRect.zw - halfTexel);
+
+    return texture(shadowAtlas, projCoords); // 0 = in shadow, 1 = lit
+}
+
+uint clusterIndex(vec3 fragPosWorld)
+{
+    float depth = max(-(uView * vec4(fragPosWorld, 1.0)).z, clusterNear);
+    uint slice = uint(clamp(floor(log(depth / clusterNear) / log(clusterFar / clusterNear) * float(CLUSTER_SLICES)),
+        0.0, float(CLUSTER_SLICES - 1)));
+    uvec2 tile = uvec2(clamp(TexCoord * vec2(CLUSTER_TILES_X, CLUSTER_TILES_Y),
+        vec2(0.0), vec2(CLUSTER_TILES_X - 1, CLUSTER_TILES_Y - 1)));
+    return tile.x + tile.y * CLUSTER_TILES_X + slice * CLUSTER_TILES_X * CLUSTER_TILES_Y;
 }
 
 vec3 calculateLight(GPULight light, vec3 normal, vec3 fragPos, vec3 viewDir)
@@ -91,14 +121,18 @@ void main()
     vec4 Albedo  = texture(gAlbedoSpec, TexCoord);
     vec3 viewDir = normalize(viewPos - FragPos);
 
+    // only lights which reach the froxel of this fragment
+    uvec2 cluster = clusters[clusterIndex(FragPos)];
+
     vec3 lighting = vec3(0.0);
-    for (uint i = 0; i < lightCount; ++i)
+    for (uint n = 0; n < cluster.y; ++n)
     {
+        uint i = lightIndices[cluster.x + n];
         float shadow = 1.0;
         if (lights[i].castShadows.x > 0 && uint(lights[i].castShadows.y) < shadowCastersCount)
         {
             int shadowIndex = int(lights[i].castShadows.y);
-            shadow = calculateShadow(FragPos, shadowIndex);
+            shadow = calculateShadow(FragPos, shadowIndex, lights[i].shadowAtlasRect);
             shadow = mix(0.2, 1.0, shadow); // 0.2 = minimum ambient in shadow
         }
 
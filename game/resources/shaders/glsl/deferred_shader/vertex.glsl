@@ -1,23 +1,80 @@
 #version 450
+#extension GL_ARB_shader_draw_parameters : enable
 
 layout(location = 0) in vec3 aPos;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aUV;
 
-uniform mat4 uModel;
+// vertex decoding, set by renderer from the vertex buffer format
+uniform uint uVertexFormat;    // 0 full, otherwise octahedral normal
+uniform vec3 uPositionOffset;
+uniform vec3 uPositionScale;
+
+// per-draw data of multi-draw indirect submission, draw starts at uDrawBase
+struct GPUDraw {
+    vec4 positionOffset;
+    vec4 positionScale;
+};
+
+layout(std430, binding = 6) readonly buffer DrawBuffer {
+    GPUDraw draws[];
+};
+uniform uint uIndirect;
+uniform uint uDrawBase;
+
+vec3 decodePosition(vec3 p, vec3 offset, vec3 scale)
+{
+    return offset + p * scale;
+}
+
+vec3 decodeNormal(vec3 n)
+{
+    if(uVertexFormat == 0u) return n;
+    vec3 d = vec3(n.xy, 1.0 - abs(n.x) - abs(n.y));
+    float t = max(-d.z, 0.0);
+    d.xy += vec2(d.x >= 0.0 ? -t : t, d.y >= 0.0 ? -t : t);
+    return normalize(d);
+}
+
+struct GPUInstance {
+    mat4 model;
+    vec4 color;
+};
+
+// per-instance data, batch starts at uInstanceBase
+layout(std430, binding = 3) readonly buffer InstanceBuffer {
+    GPUInstance instances[];
+};
+uniform uint uInstanceBase;
+
 uniform mat4 uView;
 uniform mat4 uProjection;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
+flat out vec4 InstanceColor;
 
 void main()
 {
-    vec4 worldPos = uModel * vec4(aPos, 1.0);
+    uint instanceIndex = uInstanceBase + gl_InstanceID;
+    vec3 positionOffset = uPositionOffset;
+    vec3 positionScale = uPositionScale;
+#ifdef GL_ARB_shader_draw_parameters
+    if(uIndirect != 0u)
+    {
+        instanceIndex = gl_BaseInstanceARB + gl_InstanceID;
+        positionOffset = draws[uDrawBase + gl_DrawIDARB].positionOffset.xyz;
+        positionScale = draws[uDrawBase + gl_DrawIDARB].positionScale.xyz;
+    }
+#endif
+    GPUInstance instance = instances[instanceIndex];
+
+    vec4 worldPos = instance.model * vec4(decodePosition(aPos, positionOffset, positionScale), 1.0);
     FragPos = worldPos.xyz;
-    Normal = mat3(transpose(inverse(uModel))) * aNormal;
+    Normal = mat3(transpose(inverse(instance.model))) * decodeNormal(aNormal);
     TexCoord = aUV;
+    InstanceColor = instance.color;
 
     gl_Position = uProjection * uView * worldPos;
-}
\ No newline at end of file
+}
@@ -12,6 +12,7 @@ struct GPULight {
     vec4 attenuation;   // x: constant, y: linear, z: quadratic, w: unused
     vec2 cutoff;        // x: inner cos, y: outer cos
     vec2 castShadows;   // vec2 to have natural padding
+    vec4 shadowAtlasRect; // xy: offset, zw: size in atlas UV
 };
 
 layout(std430, binding = 2) buffer LightBuffer {
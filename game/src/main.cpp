@@ -32,8 +32,13 @@ namespace astre::entry
                     ImGui::Text("Logic FPS: %.1f", logic_fps);
                     ImGui::Text("Logic Frame Time: %.2f ms", logic_frame_time);
                     ImGui::Text("Draw Calls: %d", stats.draw_calls);
+                    ImGui::Text("Instances: %d", stats.instances);
                     ImGui::Text("Vertices: %d", stats.vertices);
                     ImGui::Text("Triangles: %d", stats.triangles);
+                    ImGui::Text("Culled: %d", stats.culled);
+                    ImGui::Text("Shader Binds: %d", stats.shader_binds);
+                    ImGui::Text("VAO Binds: %d", stats.vao_binds);
+                    ImGui::Text("FBO Binds: %d", stats.fbo_binds);
 
                     bool show = show_chunk_borders->load();
                     if (ImGui::Checkbox("Show chunk borders", &show))
@@ -106,6 +111,9 @@ namespace astre::entry
             co_return;
         }
 
+        // linked programs from previous runs skip shader compilation
+        co_await app_state.renderer.enableProgramBinaryCache(paths.cache / "shaders");
+
         // stream (import -> cache) then load (cache -> runtime)
         const std::vector<std::filesystem::path> shader_files = {
             paths.resources / "shaders" / "glsl" / "deferred_shader",
@@ -135,6 +143,8 @@ namespace astre::entry
 
         // basic prefabs already exists in memory, we only need to load them into renderer
         co_await app_state.loaders.mesh_loader.loadPrefabs();
+        // meshes imported by previous runs skip assimp
+        app_state.streamers.mesh_streamer.enableCookedCache(paths.cache / "meshes");
         const std::vector<std::filesystem::path> mesh_files = {
             paths.resources / "assets" / "meshes" / "tree0.obj"
         };
@@ -264,6 +274,7 @@ namespace astre::entry
                 game_renderer_state.frame_stats = co_await pipeline::deferredShadingStage(
                         game_state.app_state.renderer,
                         game_renderer_state.render_state.deferred_shading,
+                        game_renderer_state.render_state.shadow_map_cache,
                         interpolated_frame);
 
                 // chunk-border debug overlay directly to screen, state by state